@@ -30,6 +30,8 @@ classdef Signal < hgsetget
 %                   methods for linear regression and entropy calculation.
 %       20140623:   Implemented a static and class method for discretizing signals. Implemented a method for plotting a
 %                   histogram of signal amplitude data.
+%       20261017:   Standard deviations and z-scores are now computed from a single MEXSUMMARIZE pass over the data when
+%                   it is available. Nothing is cached here because signal data can be reassigned at any time.
    
 %% OBJECT DEPENDENCIES
 % 
@@ -315,7 +317,9 @@ classdef Signal < hgsetget
         % Calculate the standard deviation of signal amplitude
         function y = Std(x)
             %STD Calculates the standard deviation signal amplitude over time. 
-            y = std(x.Data);
+            s = Signal.summarize(x.Data);
+            if isempty(s); y = std(x.Data);
+            else y = sqrt(s.Variance); end
         end
         % Calculate the sum of the signal vector
         function y = Sum(x)
@@ -386,7 +390,14 @@ classdef Signal < hgsetget
         % Z-Score the data vector
         function ZScore(x)
             %ZSCORE Re-expresses signal amplitude as a fraction of its standard deviation.
-            x.Data = zscore(x.Data);
+            s = Signal.summarize(x.Data);
+            if isempty(s)
+                x.Data = zscore(x.Data);
+            else
+                sigma = sqrt(s.Variance);
+                sigma(sigma == 0) = 1;
+                x.Data = bsxfun(@rdivide, bsxfun(@minus, x.Data, s.Mean), sigma);
+            end
             x.ZScored = true;
         end
     end
@@ -540,5 +551,17 @@ classdef Signal < hgsetget
         end
     end
     
+    methods (Static, Access = private)
+        % Summarize signal amplitudes in one native pass, returning an empty array when that isn't possible
+        function s = summarize(data)
+            s = [];
+            if (exist('MexSummarize', 'file') ~= 3 || ~isfloat(data) || ~isreal(data) || ~ismatrix(data) || isempty(data)); return; end
+            s = MexSummarize(data, ~isrow(data));
+            nans = s.NumNaNs > 0;
+            s.Mean(nans) = NaN;
+            s.Variance(nans) = NaN;
+        end
+    end
+    
     
 end
\ No newline at end of file
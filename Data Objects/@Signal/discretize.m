@@ -42,6 +42,11 @@ function y = discretize(x, nbins, partition)
 %   Written by Josh Grooms on 20140623
 %		20141217:	Replaced a conditional error message with the ASSERT shortcut.
 %		20141219:	Updated some of the documentation for this function to conform with newer standards.
+%		20261017:	Signals are now discretized by MEXDISCRETIZE when it is available, which bins them in one pass (or
+%					after one sort) instead of masking the whole signal once per bin. Its levels are in [1, nbins].
+%					Fixed the inverted check for vector inputs.
+%		20261017:	Signals of any numeric class are converted to doubles before being handed to MEXDISCRETIZE, and
+%					unrecognized partitions now raise an error instead of returning the signal unchanged.
 
 
 
@@ -55,11 +60,23 @@ elseif nargin == 2
 end
 
 % Ensure that the input is a vector
-assert(~isvector(x), 'Inputted data must be a one-dimensional vector only. Multiple signals are not supported');
+assert(isvector(x), 'Inputted data must be a one-dimensional vector only. Multiple signals are not supported');
 
 
 
 %% Discretize the Signal
+if (exist('MexDiscretize', 'file') == 3)
+    switch lower(partition)
+        case 'equiprobable'
+            y = reshape(MexDiscretize(double(x(:)), nbins, 1), size(x));
+        case 'equidistant'
+            y = reshape(MexDiscretize(double(x(:)), nbins, 0), size(x));
+        otherwise
+            error('Unrecognized partition %s. Use ''Equidistant'' or ''Equiprobable''.', partition);
+    end
+    return;
+end
+
 y = x;
 switch lower(partition)
     case 'equiprobable'
@@ -81,4 +98,7 @@ switch lower(partition)
             y(x <= binVals(a)) = a;
             x(x <= binVals(a)) = NaN;
         end
+        
+    otherwise
+        error('Unrecognized partition %s. Use ''Equidistant'' or ''Equiprobable''.', partition);
 end      
\ No newline at end of file
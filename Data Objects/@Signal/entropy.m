@@ -81,6 +81,9 @@ function H = entropy(x, y, kind)
 %   Written by Josh Grooms on 20140610
 %		20141217:	Replaced some conditional warning messages with the WASSERT shortcut.
 %		20141219:	Updated some of the documentation for this function to conform with newer standards.
+%		20261017:	Entropies are now measured by MEXENTROPY when it is available, which takes one histogram pass over the
+%					data instead of one pass per pair of distinct values. Fixed the inverted size check for three inputs.
+%					Signals are converted into doubles before they are handed to MEXENTROPY, which reads nothing else.
 
 
 
@@ -93,7 +96,7 @@ elseif nargin == 2
     if all((size(x) == size(y))); kind = 'conditional';
 	else error('Size of the inputted data sets must match'); end
 else
-	assert(any((size(x) ~= size(y))), 'Size of the inputted data sets must match');
+	assert(all((size(x) == size(y))), 'Size of the inputted data sets must match');
 end
 
 % Print a warning if attempting to calculate anything other than marginal entropy with a single input data set
@@ -103,13 +106,17 @@ if (isempty(y) && ~strcmpi(kind, 'marginal'))
 end
 
 % Call the appropriate function to calculate the desired entropy
+useMex = (exist('MexEntropy', 'file') == 3);
 switch lower(kind)
     case 'conditional'
-        H = conditionalentropy(x, y);
+        if (useMex); H = MexEntropy(double(x(:)), double(y(:)), 1);
+        else H = conditionalentropy(x, y); end
     case 'marginal'
-        H = marginalentropy(x);
+        if (useMex); H = MexEntropy(double(x(:)));
+        else H = marginalentropy(x); end
     case 'joint'
-        H = jointentropy(x, y);
+        if (useMex); H = MexEntropy(double(x(:)), double(y(:)), 0);
+        else H = jointentropy(x, y); end
     otherwise
         error('The requested entropy measure does not exist or isn''t implemented. See documentation for supported measures.');
 end
@@ -53,6 +53,8 @@ function Filter(boldData, varargin)
 %                   up with my Window class. 
 %		20141118:	Bug fix for how FIR filter phase delay was being accounted for. Before, the whole window length was
 %					being cropped out of the time series, but it's only necessary to crop half of that length.
+%		20261017:	Filtering is now done by MEXFILTER when it is available, which applies long filters by FFT
+%					overlap-save convolution and filters all voxels in parallel.
 
 %% TODOS
 % Immediate Todos
@@ -93,18 +95,18 @@ nuisanceData = nuisanceData';
 
 % Filter the signals
 if (istrue(UseZeroPhaseFilter))
-    funData = filtfilt(filterParams, 1, funData);
+    funData = FilterSignals(filterParams, funData, true);
     funData = funData';
-    nuisanceData = filtfilt(filterParams, 1, nuisanceData);
+    nuisanceData = FilterSignals(filterParams, nuisanceData, true);
     nuisanceData = nuisanceData';
     filterShift = 0;
 else
-    funData = filter(filterParams, 1, funData);
+    funData = FilterSignals(filterParams, funData, false);
     funData = funData';
 	
 	sampleDelay = ceil(WindowLength/2);
     funData(:, 1:sampleDelay) = [];
-    nuisanceData = filter(filterParams, 1, nuisanceData);
+    nuisanceData = FilterSignals(filterParams, nuisanceData, false);
     nuisanceData = nuisanceData';
     nuisanceData(:, 1:sampleDelay) = [];
     filterShift = sampleDelay * TR;
@@ -128,4 +130,19 @@ szBOLD = size(boldData.Data.Functional);
 boldData.Data.Functional = reshape(newFunData, [szBOLD(1:3) size(newFunData, 2)]);
 
 % Fill in object properties
-Filter@humanObj(boldData, Passband, filterShift, UseZeroPhaseFilter, WindowName, WindowLength);
\ No newline at end of file
+Filter@humanObj(boldData, Passband, filterShift, UseZeroPhaseFilter, WindowName, WindowLength);
+end
+
+
+
+%% Nested Functions
+% Filter the signals in the columns of an array, using MEXFILTER whenever it is available
+function y = FilterSignals(b, x, zeroPhase)
+    if (exist('MexFilter', 'file') == 3)
+        y = MexFilter(double(x), b(:), zeroPhase);
+    elseif zeroPhase
+        y = filtfilt(b, 1, x);
+    else
+        y = filter(b, 1, x);
+    end
+end
@@ -11,6 +11,8 @@ function cohData = coherence(cohData)
 %       20131103:   Implemented RSN-EEG coherence.
 %       20140121:   Updated method for control signal regression in partial coherence. Also updated correlation mask
 %                   used on BOLD data to the latest version (20131126).
+%       20261017:   Data for every channel are now extracted first, and when MEXCOHERENCE is available coherence for
+%                   all channels of a scan is estimated in a single call. MSCOHERE is still used otherwise.
 
 % TODO: Error checking for correlation objects being z-scored
 % TODO: Automatic selection of correlation data masks
@@ -46,17 +48,36 @@ for a = 1:size(cohData, 1)
             
             % Run MS coherence between data sets
             reset(progBar, 3);
+            allData = cell(length(Channels), 2);
             for c = 1:length(Channels)
-                [extractedData, idsMask, cohParams] = extract(data, cohParams, cohData(a, b).Scan, c);
-                [currentCoh, frequencies] = mscohere(extractedData{1}, extractedData{2},...
-                    Window,...
-                    SegmentOverlap,...
-                    NFFT,...
-                    min(cohParams.Coherence.Fs));
-                if iscolumn(currentCoh); currentCoh = currentCoh'; frequencies = frequencies'; end
-                cohData(a, b).Data.(Channels{c}) = currentCoh;
-                cohData(a, b).Parameters.Coherence.Frequencies = frequencies;
-                update(progBar, 3, c/length(Channels));
+                [allData(c, :), ~, cohParams] = extract(data, cohParams, cohData(a, b).Scan, c);
+            end
+            
+            numSamples = cellfun(@numel, allData);
+            [window, noverlap, nfft] = welchParameters(Window, SegmentOverlap, NFFT, numSamples(1));
+            if (exist('MexCoherence', 'file') == 3) && all(numSamples(:) == numSamples(1)) && ~isempty(window)
+                % Estimate coherence for every channel at once, pairing each channel's data sets with each other
+                x = cell2mat(cellfun(@(d) double(d(:)), allData(:, 1)', 'UniformOutput', false));
+                y = cell2mat(cellfun(@(d) double(d(:)), allData(:, 2)', 'UniformOutput', false));
+                pairs = repmat((1:length(Channels))', 1, 2);
+                [allCoh, frequencies] = MexCoherence(x, y, window, noverlap, nfft, min(cohParams.Coherence.Fs), pairs);
+                for c = 1:length(Channels)
+                    cohData(a, b).Data.(Channels{c}) = allCoh(:, c)';
+                end
+                cohData(a, b).Parameters.Coherence.Frequencies = frequencies';
+                update(progBar, 3, 1);
+            else
+                for c = 1:length(Channels)
+                    [currentCoh, frequencies] = mscohere(allData{c, 1}, allData{c, 2},...
+                        Window,...
+                        SegmentOverlap,...
+                        NFFT,...
+                        min(cohParams.Coherence.Fs));
+                    if iscolumn(currentCoh); currentCoh = currentCoh'; frequencies = frequencies'; end
+                    cohData(a, b).Data.(Channels{c}) = currentCoh;
+                    cohData(a, b).Parameters.Coherence.Frequencies = frequencies;
+                    update(progBar, 3, c/length(Channels));
+                end
             end
             
             % Fill in remaining object properties
@@ -181,3 +202,12 @@ function [extractedData, idsMask, cohParams] = extract(data, cohParams, scan, c)
     end
 end
 
+% Fill in the segmentation that MSCOHERE would use, or return an empty window if MEXCOHERENCE can't reproduce it
+function [window, noverlap, nfft] = welchParameters(window, noverlap, nfft, numSamples)
+    if isempty(window); window = fix(numSamples/4.5); end
+    if isscalar(window); window = hamming(window); end
+    window = double(window(:));
+    if isempty(noverlap); noverlap = fix(0.5*length(window)); end
+    if isempty(nfft); nfft = max(256, 2^nextpow2(length(window))); end
+    if ~isscalar(nfft) || nfft < 2 || nfft ~= 2^nextpow2(nfft); window = []; end
+end
@@ -109,6 +109,21 @@ classdef corrObj < relationObj
     %                       used, blocking equivalent fMRI image regions from analysis.
     %                       DEFAULT: []
     %
+    %   'NullMethod':       A string dictating how null data are generated when 'GenerateNull' is
+    %                       true. Surrogate methods correlate each scan's data with surrogates of its
+    %                       own signals (see NULLCORR) instead of with mismatched data sets, and are
+    %                       only available for plain correlations.
+    %                       DEFAULT: 'Mismatch'
+    %                       OPTIONS:
+    %                           'Mismatch'  - Correlates every possible data set mismatch.
+    %                           'Shift'     - Circularly shifts signals by random amounts.
+    %                           'Phase'     - Randomizes phases, preserving power spectra.
+    %                           'Block'     - Shuffles blocks of samples.
+    %
+    %   'NullSurrogates':   The number of surrogate data sets that each scan contributes to the
+    %                       null distribution when a surrogate 'NullMethod' is used.
+    %                       DEFAULT: 100
+    %
     %   'Scans':            A cell array of scans vectors dictating which specific scans are to be
     %                       included in the correlation analysis. This parameter also accepts an
     %                       input of 'all', which will include all available scans.
@@ -166,6 +181,7 @@ classdef corrObj < relationObj
     %                   nuisance parameters as the controlling variables)
     %       20130811:   Implemented Fisher's normalized r-to-z transformation to prevent bias 
     %                   introduced during the averaging of correlation coefficients.
+    %       20261017:   Null distributions can now be built from surrogate signals (see 'NullMethod').
     
     
     % TODO: Implement single-subject plotting.
@@ -18,6 +18,12 @@ function corrData = correlation(corrData)
 %       20131029:   Implemented RSN-EEG correlations & BOLD nuisance-BOLD correlations.
 %       20131126:   Implemented BOLD-RSN correlations for testing how well ICA is doing its job.
 %       20131222:   Implemented BOLD-Motion nuisance parameter correlations.
+%       20261017:   When MEXCROSSCORRELATE is available and data are being correlated with a single signal, Fisher
+%                   transforms & unmasking are now done by the correlation kernel as it stores coefficients.
+%       20261017:   When MEXCORRELATOR is available and every signal is correlated with the same BOLD data, that data
+%                   is ingested once per scan and reused for every signal instead of being reprocessed for each one.
+%       20261017:   Surrogate null distributions (see the NullMethod parameter) are now generated by NULLCORR, which
+%                   correlates each scan's data with surrogates of its own signals.
 
 
 %% Initialize
@@ -62,13 +68,41 @@ for a = 1:size(corrData, 1)
             
             % Run cross correlation between data sets
             reset(progBar, 3)
+            correlator = [];
             for c = 1:length(DataStrs)
                 [extractedData, idsMask] = extract(data, ccParams, scan, c);
-                currentCorr = xcorrArr(extractedData{1}, extractedData{2}, 'Dim', 2, 'MaxLag', maxLags);
-                currentCorr = corrData.transform(currentCorr, size(extractedData{1}, 2));
-                corrData(a, b).Data.(DataStrs{c}) = unmask(currentCorr, idsMask);
+                if GenerateNull && ~strcmpi(NullMethod, 'mismatch')
+                    % Surrogates of the (usually few) signals in the second data set are correlated with the first
+                    seed = sub2ind(size(corrData), a, b);
+                    currentCorr = nullcorr(extractedData{2}', extractedData{1}', NullSurrogates, NullMethod, seed);
+                    corrData(a, b).Data.(DataStrs{c}) = corrData.transform(currentCorr, size(extractedData{1}, 2));
+                elseif (exist('MexCrossCorrelate', 'file') == 3) && isvector(extractedData{2})
+                    % The MEX function transforms & unmasks coefficients as it stores them
+                    epilogue = struct('FisherN', size(extractedData{1}, 2), 'Mask', idsMask);
+                    if (exist('MexCorrelator', 'file') == 3) && sharesX(ccParams)
+                        % Every signal is correlated with the same BOLD data, which then only gets ingested once per scan
+                        if isempty(correlator)
+                            correlator = MexCorrelator(double(extractedData{1}'), -maxLags:maxLags);
+                            freeCorrelator = onCleanup(@() MexCorrelator('free', correlator));
+                        end
+                        currentCorr = MexCorrelator(correlator, double(extractedData{2}(:)), epilogue);
+                    else
+                        currentCorr = MexCrossCorrelate(double(extractedData{1}'), double(extractedData{2}(:)), -maxLags:maxLags, epilogue);
+                    end
+                    if isempty(idsMask)
+                        currentCorr = currentCorr';
+                    else
+                        currentCorr = reshape(currentCorr, [91, 109, 91, size(currentCorr, 2)]);
+                    end
+                    corrData(a, b).Data.(DataStrs{c}) = currentCorr;
+                else
+                    currentCorr = xcorrArr(extractedData{1}, extractedData{2}, 'Dim', 2, 'MaxLag', maxLags);
+                    currentCorr = corrData.transform(currentCorr, size(extractedData{1}, 2));
+                    corrData(a, b).Data.(DataStrs{c}) = unmask(currentCorr, idsMask);
+                end
                 update(progBar, 3, c/length(DataStrs));
             end
+            clear freeCorrelator
             
             % Fill in remaining object properties
             corrData(a, b).Averaged = false;
@@ -154,6 +188,11 @@ function [extractedData, idsMask] = extract(data, ccParams, scan, c)
     end
 end
 
+% Determine whether every signal is correlated with the same BOLD data
+function shared = sharesX(ccParams)
+    shared = any(strcmpi(ccParams.Initialization.Modalities, {'bold-eeg', 'bold-rsn', 'bold-bold nuisance'}));
+end
+
 % Unmask BOLD data
 function finalData = unmask(currentCorr, idsMask)
     if ~isempty(idsMask)
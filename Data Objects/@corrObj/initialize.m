@@ -20,6 +20,8 @@ function corrData = initialize(corrData, ccStruct)
 %       20140217:   Added in an initialization segment for converting the general "BOLD Nuisance" control string into a
 %                   cell array of the actual object field names. Added ability to run partial correlations between BOLD
 %                   data and its global signal.
+%       20261017:   Surrogate null distributions (see the NullMethod parameter) are generated from the same subject &
+%                   scan layout as real data, since every scan is correlated with surrogates of its own signals.
 
 
 %% Initialize
@@ -50,8 +52,16 @@ end
 % Get the properties to be tranferred
 propNames = fieldnames(ccStruct.Initialization);
 
+% Surrogate nulls need every scan's own data, so only mismatched nulls use different pairings
+if ~isfield(ccStruct.Correlation, 'NullMethod'); ccStruct.Correlation.NullMethod = 'Mismatch'; end
+if ~isfield(ccStruct.Correlation, 'NullSurrogates'); ccStruct.Correlation.NullSurrogates = 100; end
+surrogates = ccStruct.Correlation.GenerateNull && ~strcmpi(ccStruct.Correlation.NullMethod, 'mismatch');
+if surrogates && ~strcmpi(ccStruct.Initialization.Relation, 'correlation')
+    error('Surrogate null distributions are only available for plain correlations. Use the ''Mismatch'' NullMethod instead.');
+end
+
 % Transfer properties (depending on whether or not a null distribution is being generated)
-if ~ccStruct.Correlation.GenerateNull
+if ~ccStruct.Correlation.GenerateNull || surrogates
     
     % Initialize the object array
     corrData(subjects(end), max(cellfun(@max, scans))) = corrObj;
@@ -20,6 +20,14 @@ function meanCorrData = mean(corrData)
 %       20130811:   Updated for compatibility with changes to PROGRESS.
 %       20130906:   Updated to work with improved correlation & initialization code for this object.
 %       20131028:   Bug fix for averaging null data sets
+%       20261017:   Averages are now streamed through MEXACCUMULATE when it is available, which ingests one scan's
+%                   correlations at a time instead of concatenating them. Memory use no longer grows with the number
+%                   of scans, so averaging null data sets can't run out of memory partway through.
+%       20261017:   Surrogate null distributions (see the NullMethod parameter) are pooled across scans instead of
+%                   averaged, since they hold sorted coefficients rather than maps. Single scan correlations vary more
+%                   than averaged ones do, so the pooled distribution errs on the side of caution.
+%       20261017:   Updated for accumulator handles in MEXACCUMULATE. Streamed null averages keep the partial group of
+%                   scans at the end, just like the concatenating method does.
 
 
 %% Initialize
@@ -42,91 +50,144 @@ meanCorrData.Scan = meanCorrData.Parameters.Correlation.Scans;
 
 
 %% Average the Data
-if GenerateNull
+if GenerateNull && isfield(corrData(1, 1).Parameters.Correlation, 'NullMethod') && ~strcmpi(NullMethod, 'mismatch')
+    
+    % Pool the surrogate null distributions of every scan
+    for a = 1:length(DataStrs)
+        pooled = arrayfun(@(c) c.Data.(DataStrs{a})(:), corrData(~cellfun(@isempty, {corrData.ParentData})), 'UniformOutput', false);
+        meanCorrData.Data.(DataStrs{a}) = sort(cat(1, pooled{:}));
+    end
+    
+elseif GenerateNull
     
     % Randomize the null data prior to averaging
     randOrder = randperm(length(corrData));
     corrData = corrData(randOrder);
     
-    % Concatenate the null data & average (try the fast method first)
-    try
+    % Stream each group of null data through the native accumulator (or try the fast concatenating method first)
+    if (exist('MexAccumulate', 'file') == 3)
         progBar = progress('Data Sets Completed', 'Null Components Averaged');
         for a = 1:length(DataStrs)
-            % Calculate data sizes & indexing parameters
             totalScans = length(cat(2, Scans{:}));
-            szCatCorr = [size(corrData(1).Data.(DataStrs{a})), totalScans];
-            catCorrData = zeros(szCatCorr);
-            catDataDim = length(szCatCorr);
+            catDataDim = ndims(corrData(1).Data.(DataStrs{a})) + 1;
             idxCat = repmat({':'}, 1, catDataDim);
             
-            % Concatenate the correlation data
+            % Groups are the same size as the real data, and any partial group at the end is averaged on its own
             d = 1;
             reset(progBar, 2)
             for b = 1:totalScans:length(corrData)
-                for c = 1:totalScans
-                    idxCat{catDataDim} = c;
-                    if (b+c-1) <= length(corrData)
-                        catCorrData(idxCat{:}) = corrData(b+c-1).Data.(DataStrs{a});
-                    else
-                        idxCat{catDataDim} = size(catCorrData, catDataDim);
-                        catCorrData(idxCat{:}) = [];
-                    end
+                h = MexAccumulate(corrData(b).Data.(DataStrs{a}));
+                for c = (b + 1):min(b + totalScans - 1, length(corrData))
+                    MexAccumulate(h, corrData(c).Data.(DataStrs{a}));
                 end
                 idxCat{catDataDim} = d; d = d + 1;
-                meanCorrData.Data.(DataStrs{a})(idxCat{:}) = nanmean(catCorrData, catDataDim);
-                catCorrData = zeros(szCatCorr);
+                meanCorrData.Data.(DataStrs{a})(idxCat{:}) = MexAccumulate(h);
+                MexAccumulate('free', h);
                 update(progBar, 2, b/length(corrData));
             end
             
             update(progBar, 1, a/length(DataStrs));
         end
-    catch
-        warning('Fast method of averaging has failed. Prepare to wait');
-        reset(progBar)
-        for a = 1:length(DataStrs)   
-            % Calculate some sizes & dimensionalities
-            totalScans = length(cat(2, Scans{:}));
-            szCorrData = size(corrData(1).Data.(DataStrs{a}));
-            permOrder = 1:(length(szCorrData)+1);
-            permOrder(1) = permOrder(end); permOrder(end) = 1;
+    else
+        try
+            progBar = progress('Data Sets Completed', 'Null Components Averaged');
+            for a = 1:length(DataStrs)
+                % Calculate data sizes & indexing parameters
+                totalScans = length(cat(2, Scans{:}));
+                szCatCorr = [size(corrData(1).Data.(DataStrs{a})), totalScans];
+                catCorrData = zeros(szCatCorr);
+                catDataDim = length(szCatCorr);
+                idxCat = repmat({':'}, 1, catDataDim);
             
-            % Pre-allocate the concatenated correlation array
-            szCatCorr = [szCorrData, totalScans]; szCatCorr = szCatCorr(permOrder);
-            currentCatCorr = zeros(szCatCorr);            
+                % Concatenate the correlation data
+                d = 1;
+                reset(progBar, 2)
+                for b = 1:totalScans:length(corrData)
+                    for c = 1:totalScans
+                        idxCat{catDataDim} = c;
+                        if (b+c-1) <= length(corrData)
+                            catCorrData(idxCat{:}) = corrData(b+c-1).Data.(DataStrs{a});
+                        else
+                            idxCat{catDataDim} = size(catCorrData, catDataDim);
+                            catCorrData(idxCat{:}) = [];
+                        end
+                    end
+                    idxCat{catDataDim} = d; d = d + 1;
+                    meanCorrData.Data.(DataStrs{a})(idxCat{:}) = nanmean(catCorrData, catDataDim);
+                    catCorrData = zeros(szCatCorr);
+                    update(progBar, 2, b/length(corrData));
+                end
             
-            % Pre-allocate the averaged correlation array
-            szMeanCorr = [szCorrData, floor(length(corrData)/totalScans)];
-            szMeanCorr = szMeanCorr(permOrder);
-            currentMeanCorr = zeros(szMeanCorr);
+                update(progBar, 1, a/length(DataStrs));
+            end
+        catch
+            warning('Fast method of averaging has failed. Prepare to wait');
+            reset(progBar)
+            for a = 1:length(DataStrs)   
+                % Calculate some sizes & dimensionalities
+                totalScans = length(cat(2, Scans{:}));
+                szCorrData = size(corrData(1).Data.(DataStrs{a}));
+                permOrder = 1:(length(szCorrData)+1);
+                permOrder(1) = permOrder(end); permOrder(end) = 1;
             
-            c = 1;
-            d = 1;
-            reset(progBar, 2)
-            for b = 1:length(corrData)
-                % Concatenate the correlation data
-                currentCatCorr(c, :) = corrData(b).Data.(DataStrs{a});
+                % Pre-allocate the concatenated correlation array
+                szCatCorr = [szCorrData, totalScans]; szCatCorr = szCatCorr(permOrder);
+                currentCatCorr = zeros(szCatCorr);            
+            
+                % Pre-allocate the averaged correlation array
+                szMeanCorr = [szCorrData, floor(length(corrData)/totalScans)];
+                szMeanCorr = szMeanCorr(permOrder);
+                currentMeanCorr = zeros(szMeanCorr);
+            
+                c = 1;
+                d = 1;
+                reset(progBar, 2)
+                for b = 1:length(corrData)
+                    % Concatenate the correlation data
+                    currentCatCorr(c, :) = corrData(b).Data.(DataStrs{a});
                 
-                % Create groupings of null data the same size as real data
-                if c == totalScans
-                    currentMeanCorr(d, :) = nanmean(currentCatCorr, 1);
-                    currentCatCorr = zeros(szCatCorr);
-                        c = 1;
-                        d = d + 1;
-                else
-                    c = c + 1;
+                    % Create groupings of null data the same size as real data
+                    if c == totalScans
+                        currentMeanCorr(d, :) = nanmean(currentCatCorr, 1);
+                        currentCatCorr = zeros(szCatCorr);
+                            c = 1;
+                            d = d + 1;
+                    else
+                        c = c + 1;
+                    end
+                    update(progBar, 2, b/length(corrData));
                 end
-                update(progBar, 2, b/length(corrData));
-            end
             
-            % Store the averaged data in the object
-            meanCorrData.Data.(DataStrs{a}) = permute(currentMeanCorr, permOrder);
-            update(progBar, 1, a/length(DataStrs));
+                % Store the averaged data in the object
+                meanCorrData.Data.(DataStrs{a}) = permute(currentMeanCorr, permOrder);
+                update(progBar, 1, a/length(DataStrs));
+            end
         end
     end
     
 else
     
     for a = 1:length(DataStrs)
+        % Stream every scan through the native accumulator when it is available
+        if (exist('MexAccumulate', 'file') == 3)
+            h = [];
+            parentDataFiles = {};
+            for b = Subjects
+                for c = Scans{b}
+                    if isempty(h)
+                        h = MexAccumulate(corrData(b, c).Data.(DataStrs{a}));
+                    else
+                        MexAccumulate(h, corrData(b, c).Data.(DataStrs{a}));
+                    end
+                end
+                parentDataFiles = cat(1, parentDataFiles, corrData(b, 1).ParentData);
+            end
+            meanCorrData.Data.(DataStrs{a}) = MexAccumulate(h);
+            MexAccumulate('free', h);
+            meanCorrData.ParentData = parentDataFiles;
+            continue;
+        end
+        
         % Initialize the concatenated data storage arrays & determine averaging dimension
         catCorrData = [];
         parentDataFiles = {};
@@ -28,6 +28,8 @@ function ccStruct = parameters(~)
 %   Written by Josh Grooms on 20130702
 %       20130707:   Updated documentation errors 
 %       20130717:   Updated to include a masking parameter during thresholding to cut down on computation time.
+%       20261017:   Added the NullMethod & NullSurrogates parameters, which allow null distributions to be built from
+%                   surrogate signals instead of mismatched data sets.
 
 
 %% The Correlation Data Object Input Parameter Structure
@@ -48,6 +50,8 @@ ccStruct = struct(...
         'GenerateNull', false,...
         'Mask', [],...
         'MaskThreshold', [],...
+        'NullMethod', 'Mismatch',...
+        'NullSurrogates', 100,...
         'Scans', [],...
         'Subjects', [],...
         'TimeShifts', [-20:2:20]),...
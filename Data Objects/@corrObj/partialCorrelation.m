@@ -13,6 +13,11 @@ function partialCorrelation(corrData)
 %                   being controlled for (using the related input in the parameter structure).
 %       20140217:   Created new nested functions to handle control variable regression (allows more flexibility in what
 %                   parameters are regressed and how). Implemented BOLD-Global partial correlations.
+%       20261017:   Control signals are now regressed and all channels are correlated in a single call per scan, so BOLD
+%                   data is no longer re-regressed for every channel. When MEXPARTIALCROSSCORRELATE is available, control
+%                   signals are factorized once natively and residuals are never materialized in MATLAB.
+%       20261017:   When MEXPARTIALCROSSCORRELATE is available, Fisher transforms & unmasking are now done by the
+%                   correlation kernel as it stores coefficients instead of in separate passes over the output.
 
 
 %% Initialize
@@ -51,11 +56,18 @@ for a = 1:size(corrData, 1)
             
             % Run cross partial correlation between data sets
             reset(progBar, 3);
+            numSamples = size(data{1}(scan(1)).Data.Functional, 4);
+            [allCorr, idsMask, fused] = extract(data, ccParams, scan, maxLags, numSamples);
             for c = 1:length(DataStrs)
-                [extractedData, idsMask] = extract(data, ccParams, scan, c);
-                currentCorr = xcorrArr(extractedData{1}, extractedData{2}, 'Dim', 2, 'MaxLag', maxLags);
-                currentCorr = corrData.transform(currentCorr, size(extractedData{1}, 2));
-                corrData(a, b).Data.(DataStrs{c}) = unmask(currentCorr, idsMask);
+                if fused
+                    % Coefficients come back from the MEX function already transformed & unmasked
+                    currentCorr = allCorr{c};
+                    if ~isempty(idsMask); currentCorr = reshape(currentCorr, [91, 109, 91, size(currentCorr, 2)]); end
+                    corrData(a, b).Data.(DataStrs{c}) = currentCorr;
+                else
+                    currentCorr = corrData.transform(allCorr{c}, numSamples);
+                    corrData(a, b).Data.(DataStrs{c}) = unmask(currentCorr, idsMask);
+                end
                 update(progBar, 3, c/length(DataStrs));
             end
             
@@ -75,8 +87,10 @@ close(progBar)
             
 end%================================================================================================
 %% Nested Functions
-% Extract the correct data from the data objects
-function [extractedData, idsMask] = extract(data, ccParams, scan, c)
+% Extract the correct data from the data objects & partially correlate all channels at once
+function [allCorr, idsMask, fused] = extract(data, ccParams, scan, maxLags, numSamples)
+    DataStrs = ccParams.Correlation.DataStrs;
+    allCorr = cell(1, length(DataStrs));
     switch lower(ccParams.Initialization.Modalities)
         case 'bold-eeg'
             % Get the current BOLD data
@@ -84,18 +98,20 @@ function [extractedData, idsMask] = extract(data, ccParams, scan, c)
             functionalData = reshape(boldData.Data.Functional, [], size(boldData.Data.Functional, 4));
             idsMask = isnan(functionalData(:, 1));
             functionalData(idsMask, :) = [];
-            extractedData{1} = functionalData;
 
-            % Get the current EEG data & regress control signals
+            % Get the current EEG data for every channel
             eegData = data{2}(scan(2));
-            idxChannel = strcmpi(ccParams.Correlation.DataStrs{c}, eegData.Channels);
-            extractedData{2} = eegData.Data.EEG(idxChannel, :);
+            idsChannels = cellfun(@(s) find(strcmpi(s, eegData.Channels), 1), DataStrs);
+            channelData = eegData.Data.EEG(idsChannels, :);
             
-            % Regress the control data
+            % Regress the control data & correlate
             boldControlData = initializeControlData(boldData, ccParams.Correlation.Control, 0);
             eegControlData = initializeControlData(boldData, ccParams.Correlation.Control, 4);
-            extractedData{1} = regress(extractedData{1}, boldControlData);
-            extractedData{2} = regress(extractedData{2}, eegControlData);
+            epilogue = struct('FisherN', numSamples, 'Mask', idsMask);
+            [cc, fused] = partialxcorr(functionalData', boldControlData, channelData', eegControlData, maxLags, epilogue);
+            for c = 1:length(DataStrs)
+                if fused; allCorr{c} = cc(:, :, c); else allCorr{c} = cc(:, :, c)'; end
+            end
             
         case 'bold-global'
             % Get the current BOLD data
@@ -103,31 +119,29 @@ function [extractedData, idsMask] = extract(data, ccParams, scan, c)
             functionalData = reshape(boldData.Data.Functional, [], size(boldData.Data.Functional, 4));
             idsMask = isnan(functionalData(:, 1));
             functionalData(idsMask, :) = [];
-            extractedData{1} = functionalData;
-            
-            % Get the current global signal
-            extractedData{2} = boldData.Data.Nuisance.Global;
             
-            % Regress the control data
+            % Regress the control data from BOLD only & correlate with the current global signal
             controlData = initializeControlData(boldData, ccParams.Correlation.Control, 0);
-            extractedData{1} = regress(extractedData{1}, controlData);
+            epilogue = struct('FisherN', numSamples, 'Mask', idsMask);
+            [cc, fused] = partialxcorr(functionalData', controlData, boldData.Data.Nuisance.Global(:), [], maxLags, epilogue);
+            if fused; allCorr(:) = {cc}; else allCorr(:) = {cc'}; end
             
         case 'rsn-eeg'
             % Get the current IC data
             boldData = data{1}(scan(1));
             icNames = fieldnames(boldData.Data.ICA);
             idsMask = [];
-            extractedData{1} = boldData.Data.ICA.(icNames{c});
+            icData = cell2mat(cellfun(@(n) boldData.Data.ICA.(n)(:), icNames(1:length(DataStrs))', 'UniformOutput', false));
             
             % Get the current EEG data
             eegData = data{2}(scan(2));
-            extractedData{2} = eegData.Data.EEG;
             
-            % Regress the control data
+            % Regress the control data & correlate
             boldControlData = initializeControlData(boldData, ccParams.Correlation.Control, 0);
             eegControlData = initializeControlData(boldData, ccParams.Correlation.Control, 4);
-            extractedData{1} = regress(extractedData{1}, boldControlData);
-            extractedData{2} = regress(extractedData{2}, eegControlData);
+            epilogue = struct('FisherN', numSamples, 'Mask', []);
+            [cc, fused] = partialxcorr(icData, boldControlData, eegData.Data.EEG', eegControlData, maxLags, epilogue);
+            for c = 1:length(DataStrs); allCorr{c} = permute(cc(:, c, :), [3 1 2]); end
     end
 end
 
@@ -148,9 +162,24 @@ function controlData = initializeControlData(boldData, controlStrs, delay)
     end
 end
 
+% Partially cross-correlate signals in columns of x & y, returning an [nlags x NX x NY] array. When the MEX function is
+% available, the epilogue is applied as coefficients are stored, and a masked output is [NR x nlags x NY] instead.
+function [cc, fused] = partialxcorr(x, zx, y, zy, maxLags, epilogue)
+    lags = -maxLags:maxLags;
+    fused = (exist('MexPartialCrossCorrelate', 'file') == 3);
+    if fused
+        cc = MexPartialCrossCorrelate(double(x), double(zx), double(y), double(zy), lags, epilogue);
+        if isempty(epilogue.Mask); cc = reshape(cc, length(lags), size(x, 2), size(y, 2)); end
+    else
+        if ~isempty(zx); x = regress(x, zx); end
+        if ~isempty(zy); y = regress(y, zy); end
+        cc = ccorr(x, y, maxLags);
+    end
+end
+
 % Regress a control signal from the data
 function regData = regress(inData, controlData)
-    regData = (inData' - controlData*(controlData\inData'))';
+    regData = inData - controlData*(controlData\inData);
 end
 
 % Unmask BOLD data
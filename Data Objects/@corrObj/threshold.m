@@ -33,6 +33,7 @@ function threshold(meanCorrData, meanNullData)
 %       20130803:   Updated for compatibility with updated progress bar code.
 %       20130920:   Updated to work with overhauled object parameter field.
 %       20131028:   Changed default signifance cutoffs (when no actual significance is found) to infinite.
+%       20261017:   Surrogate null distributions are already vectors of coefficients, so they are no longer masked.
 
 
 %% Initialize
@@ -85,10 +86,12 @@ for a = 1:length(DataStrs)
     if ~isempty(Mask)
         if isnumeric(Mask)
             currentCorr = mask(currentCorr, Mask, MaskThreshold);
-            idxStr = repmat({':'}, 1, ndims(currentNull));
-            for b = 1:size(currentNull, ndims(currentNull))
-                idxStr{end} = b;
-                currentNull(idxStr{:}) = mask(currentNull(idxStr{:}), Mask, MaskThreshold);
+            if ~isvector(currentNull)
+                idxStr = repmat({':'}, 1, ndims(currentNull));
+                for b = 1:size(currentNull, ndims(currentNull))
+                    idxStr{end} = b;
+                    currentNull(idxStr{:}) = mask(currentNull(idxStr{:}), Mask, MaskThreshold);
+                end
             end
         end
     end
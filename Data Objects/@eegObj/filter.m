@@ -47,6 +47,8 @@ function Filter(eegData, varargin)
 %       20140902:   Implemented throwing of an error if the user tries to apply anything other than a Hamming window.
 %                   Certain other windows may work out alright, but it's not safe to try for now. Made this function
 %                   compatible with new data object status properties.
+%       20261017:   Filtering is now done by MEXFILTER when it is available, which applies these very long filters by
+%                   FFT overlap-save convolution and filters all channels in parallel.
 
 
 
@@ -83,12 +85,15 @@ for a = 1:numel(eegData)
     ephysData = ephysData';
     
     % Filter the signals
+    useMex = (exist('MexFilter', 'file') == 3);
     if istrue(UseZeroPhaseFilter)
-        ephysData = filtfilt(filterParams, 1, ephysData);
+        if useMex; ephysData = MexFilter(double(ephysData), filterParams(:), true);
+        else ephysData = filtfilt(filterParams, 1, ephysData); end
         ephysData = ephysData';
         filterShift = 0;
     else
-        ephysData = filter(filterParams, 1, ephysData);
+        if useMex; ephysData = MexFilter(double(ephysData), filterParams(:), false);
+        else ephysData = filter(filterParams, 1, ephysData); end
         ephysData = ephysData';
         ephysData(:, 1:WindowLength) = [];
         filterShift = floor(WindowLength/(2*eegData(a).Fs));
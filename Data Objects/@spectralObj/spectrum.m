@@ -4,12 +4,22 @@ function spectrum(spectralData)
 %   WARNING: SPECTRUM is an internal method and is not meant to be called externally.
 %
 %   Written by Josh Grooms on 20130910
+%       20261017:   Spectra for every channel of a scan are now estimated in a single call to MEXWELCH when it is
+%                   available and the parameters are ones that it supports. Otherwise PWELCH is still called per channel.
 
 
 %% Initialize
 % Get spectral analysis input parameters
 assignInputs(spectralData(1, 1).Parameters.Spectrum, 'varsOnly');
 
+% The MEX function only produces one-sided spectra from explicit windows & power of two transform lengths
+window = Window;
+if isscalar(window); window = hamming(window); end
+useMex = (exist('MexWelch', 'file') == 3) && strcmpi(FrequencyRange, 'onesided') &&...
+    any(strcmpi(SpectrumType, {'psd', 'power'})) && ~isempty(window) && ~isempty(SegmentOverlap) &&...
+    isscalar(NFFT) && NFFT >= 2 && NFFT == 2^nextpow2(NFFT);
+window = double(window(:));
+
 
 %% Generate the Spectral Data
 % Set up progress bars
@@ -31,17 +41,26 @@ for a = 1:size(spectralData, 1)
             % Get the EEG channel data
             currentChannelData = extract(eegData(b), Channels);
             
-            % Loop through channels & generate spectra
-            for c = 1:size(currentChannelData, 1)
-                [currentSpectrum, frequencies] = pwelch(currentChannelData(c, :),...
-                    Window,...
-                    SegmentOverlap,...
-                    NFFT,...
-                    eegData(b).Fs,...
-                    FrequencyRange,...
-                    SpectrumType);
-                spectralData(a, b).Data.(Channels{c}) = currentSpectrum';
-            end            
+            if useMex
+                % Generate spectra for all channels at once
+                [allSpectra, frequencies] = MexWelch(double(currentChannelData'), window, SegmentOverlap, NFFT,...
+                    eegData(b).Fs, strcmpi(SpectrumType, 'power'));
+                for c = 1:size(currentChannelData, 1)
+                    spectralData(a, b).Data.(Channels{c}) = allSpectra(:, c)';
+                end
+            else
+                % Loop through channels & generate spectra
+                for c = 1:size(currentChannelData, 1)
+                    [currentSpectrum, frequencies] = pwelch(currentChannelData(c, :),...
+                        Window,...
+                        SegmentOverlap,...
+                        NFFT,...
+                        eegData(b).Fs,...
+                        FrequencyRange,...
+                        SpectrumType);
+                    spectralData(a, b).Data.(Channels{c}) = currentSpectrum';
+                end
+            end
 
             % Store information in the spectral data object
             spectralData(a, b).Data.Frequencies = frequencies';
@@ -3,6 +3,8 @@ classdef Range < Entity
 
 %% CHANGELOG
 %	Written by Josh Grooms on 20150212
+%		20261017:	Ranges are now found by MEXSUMMARIZE when it is available, which reads each array once in place
+%					instead of once for the minimum & again for the maximum.
 	
 	
 	
@@ -33,8 +35,17 @@ classdef Range < Entity
 		% RANGE - Constructs a standardized range object from data collections.
 			numchk = all(cellfun(@isnumeric, varargin));
 			assert(numchk, 'Range objects can only be constructed from numeric data.');
-			argmax = cellfun(@(x) max(x(:)), varargin);
-			argmin = cellfun(@(x) min(x(:)), varargin);
+			% MEXSUMMARIZE only reads real arrays of floating point or 8, 16 & 32-bit integer classes
+			native = @(x) isreal(x) && any(strcmp(class(x), {'double', 'single', 'int8', 'uint8', 'int16', 'uint16', 'int32', 'uint32'}));
+			if (exist('MexSummarize', 'file') == 3 && all(cellfun(native, varargin)))
+				s = cellfun(@MexSummarize, varargin, 'UniformOutput', false);
+				s = [s{:}];
+				argmax = [s.Max];
+				argmin = [s.Min];
+			else
+				argmax = cellfun(@(x) max(x(:)), varargin);
+				argmin = cellfun(@(x) min(x(:)), varargin);
+			end
 			R.Max = max(argmax);
 			R.Min = min(argmin);
 		end
@@ -43,8 +54,7 @@ classdef Range < Entity
 	methods (Static)
 		function R = FromData(x)
 		% FROMDATA - Constructs a range object from an array of data.
-			x = x(:);
-			R = Range(min(x), max(x));
+			R = Range(x);
 		end
 	end
 	
@@ -3,6 +3,8 @@ classdef Volume < Entity
 
 %% CHANGELOG
 %	Written by Josh Grooms on 20150212
+%		20261017:	Summary statistics are now gathered by a single MEXSUMMARIZE pass when the volume is constructed and
+%					cached in the object, so that the range, NaN flag, mean and variance never read the data again.
 
 	
 	
@@ -16,13 +18,16 @@ classdef Volume < Entity
 		Depth		@uint64			% The size of the volume along the 3rd direction.
 		Height		@uint64			% The size of the volume along the 1st dimension.
 		Max			@double			% The maximum value present in the volume.
+		Mean		@double			% The mean of the non-NaN values in the volume.
 		Min			@double			% The minimum value present in the volume.
+		Variance	@double			% The sample variance of the non-NaN values in the volume.
 		Width		@uint64			% The size of the volume along the 2nd dimension.
 	end
 	
 	properties (Hidden, Access = protected)
 		Data
 		DataRange	@Range
+		Summary		@struct			% Single-pass summary statistics of the data, which are cached here.
 		VoxelSize
 	end
 	
@@ -39,9 +44,15 @@ classdef Volume < Entity
 		function m = get.Max(V)
 			m = V.DataRange.Max;
 		end
+		function m = get.Mean(V)
+			m = V.Summary.Mean;
+		end
 		function m = get.Min(V)
 			m = V.DataRange.Min;
 		end
+		function v = get.Variance(V)
+			v = V.Summary.Variance;
+		end
 		function w = get.Width(V)
 			w = V.Size(2);
 		end
@@ -60,10 +71,7 @@ classdef Volume < Entity
 			
 			[sx, sy, sz] = size(x);
 			V.Size = [sx, sy, sz];
-			
-			x = x(:);
-			V.DataRange = Range(x);
-			V.HasNaNs = any(isnan(x));
+			V = V.Summarize();
 		end
 	end
 	
@@ -179,7 +187,35 @@ classdef Volume < Entity
 		function V = uminus(V)
 		% UMINUS - The unary minus operator that multiplies each value in a data array by negative one.
 			V.Data = uminus(V.Data);
-			V.DataRange = Range(V.Data);
+			V = V.Summarize();
+		end
+	end
+	
+	
+	
+	%% PROTECTED UTILITIES
+	methods (Access = protected)
+		function V = Summarize(V)
+		% SUMMARIZE - Caches the summary statistics of the volume's data, reading the data only once when possible.
+			% MEXSUMMARIZE only reads real arrays of floating point or 8, 16 & 32-bit integer classes
+			native = isreal(V.Data) && any(strcmp(class(V.Data), {'double', 'single', 'int8', 'uint8', 'int16', 'uint16', 'int32', 'uint32'}));
+			if (exist('MexSummarize', 'file') == 3 && native && ~isempty(V.Data))
+				V.Summary = MexSummarize(V.Data);
+			else
+				x = V.Data(:);
+				nans = isnan(x);
+				y = double(x(~nans));
+				V.Summary = struct(...
+					'Min', double(min(x)),...
+					'Max', double(max(x)),...
+					'NumNaNs', sum(nans),...
+					'Count', numel(y),...
+					'Sum', sum(y),...
+					'Mean', mean(y),...
+					'Variance', var(y));
+			end
+			V.DataRange = Range(V.Summary.Min, V.Summary.Max);
+			V.HasNaNs = V.Summary.NumNaNs > 0;
 		end
 	end
 	
@@ -0,0 +1,685 @@
+/* BENCHMARK - Times the native statistics kernels over reproducible workloads & compares results between builds.
+ *
+ *	The scenarios here rerun the studies whose results used to be kept only as screenshots under Prototyping/, so that
+ *	every change to a kernel can be measured against a baseline. Inputs are generated from a fixed seed, every workload
+ *	is run a few times untimed to warm up caches, thread pools & transform plans, and each timed repetition is reported
+ *	through its minimum, median, 90th percentile and maximum.
+ *
+ *	SYNTAX:
+ *		statbench [options]
+ *		statbench compare BASELINE CURRENT [--tolerance F]
+ *
+ *	OPTIONS:
+ *		--scenario NAMES:	A comma-separated list of the scenarios to run (see --list).			DEFAULT: every scenario
+ *		--sizes N,N,...:	The sizes that replace the default sweep of every selected scenario.	DEFAULT: see --list
+ *		--scale F:			Multiplies the swept size of every workload.							DEFAULT: 1
+ *		--warmup N:			The number of untimed runs of each workload.							DEFAULT: 1
+ *		--reps N:			The number of timed runs of each workload.								DEFAULT: 5
+ *		--threads N:		The number of threads that the kernels run on, or 0 for every processor.	DEFAULT: 0
+ *		--seed N:			The seed that the input data are generated from.						DEFAULT: 1
+ *		--format FORMAT:	Either csv or json (one JSON object per line).							DEFAULT: csv
+ *		--output PATH:		The file that results are written to.									DEFAULT: standard output
+ *		--profile PATH:		Appends the kernel profile of each workload's last run to a file as JSON (see WriteProfile).
+ *		--list:				Lists the scenarios along with their default sizes.
+ *
+ *	COMPARE:
+ *		Reads two result files in either format and matches workloads by scenario & size. Workloads whose median time grew
+ *		by more than the tolerance (a fraction of the baseline median, 0.10 by default) are flagged as regressions, and the
+ *		program then exits with status 1. Differing thread counts or instruction sets between the files are reported too.
+ */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#if !defined(_WIN32)
+	#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Random.h"
+#include "Simd.h"
+#include "Statistics.h"
+
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <time.h>
+#endif
+
+
+
+/* CONSTANTS */
+#define MAXSIZES		16			// The most sizes that one scenario can sweep over.
+#define MAXRESULTS		1024		// The most workloads that one result file can hold.
+#define NAMELENGTH		64			// The longest scenario, kernel or instruction set name, including its terminator.
+#define LINELENGTH		1024		// The longest line in a result file.
+
+
+
+/* DATA */
+/// <summary>
+/// The kernels that scenarios time.
+/// </summary>
+typedef enum
+{
+	CorrelateKernel = 0,
+	WindowKernel,
+	CrossKernel,
+	ECDFKernel,
+}Kernel;
+
+/// <summary>
+/// A family of workloads that share everything except one swept dimension.
+/// </summary>
+typedef struct
+{
+	const char*		Name;
+	Kernel			Kernel;
+	int				Samples;			// The number of samples per signal, or zero if this is the swept dimension.
+	int				SignalsX;			// The number of signals in X, or zero if this is the swept dimension.
+	int				SignalsY;			// The number of signals in Y.
+	int				Window;				// The window length of sliding window correlations.
+	int				Overlap;			// The overlap between successive windows of sliding window correlations.
+	int				Sizes[MAXSIZES];	// The default sizes of the swept dimension, terminated by a zero.
+	const char*		Study;				// The prototyping study that this scenario reruns.
+}Scenario;
+
+/// <summary>
+/// The inputs & output of one workload.
+/// </summary>
+typedef struct
+{
+	const Scenario*	Scenario;
+	int				Samples;
+	int				SignalsX;
+	int				SignalsY;
+	double*			X;
+	double*			Y;
+	double*			Out;
+}Workload;
+
+/// <summary>
+/// The timing of one workload, which is one line of a result file.
+/// </summary>
+typedef struct
+{
+	char			Scenario[NAMELENGTH];
+	char			Kernel[NAMELENGTH];
+	int				Samples;
+	int				SignalsX;
+	int				SignalsY;
+	int				Threads;
+	char			Simd[NAMELENGTH];
+	int				Reps;
+	double			Min;
+	double			Median;
+	double			P90;
+	double			Max;
+}Result;
+
+/// <summary>
+/// The settings of one benchmark run.
+/// </summary>
+typedef struct
+{
+	const char*		Scenarios;
+	int				Sizes[MAXSIZES];
+	double			Scale;
+	int				Warmup;
+	int				Reps;
+	int				Threads;
+	uint64_t		Seed;
+	int				JSON;
+	const char*		Output;
+	const char*		Profile;
+}Options;
+
+// Workloads the size of the original studies, except for sliding window correlations, whose outputs at the studied sizes
+// (up to 300,000 signals in X) need several gigabytes. Those are a tenth of the studied size; use --scale 10 to match it.
+static const Scenario Scenarios[] =
+{
+	{ "corr-vector", CorrelateKernel, 300, 0, 1, 0, 0, { 100000, 200000, 300000 }, "Correlation in C (array-vector)" },
+	{ "corr-array", CorrelateKernel, 300, 0, 10, 0, 0, { 100000, 200000, 300000 }, "Correlation in C (array-array)" },
+	{ "window", WindowKernel, 300, 0, 10, 25, 24, { 10000, 20000, 30000 }, "Sliding Window Correlation in C" },
+	{ "xcorr-vector", CrossKernel, 0, 1, 1, 0, 0, { 100000, 200000, 300000, 400000, 500000, 600000, 700000, 800000, 900000, 1000000 }, "Cross Correlation in C" },
+	{ "xcorr-array-1000", CrossKernel, 1000, 0, 1, 0, 0, { 10000, 15000, 20000 }, "Array Cross Correlation in C (1000 time points)" },
+	{ "xcorr-array-2000", CrossKernel, 2000, 0, 1, 0, 0, { 10000, 15000, 20000 }, "Array Cross Correlation in C (2000 time points)" },
+	{ "ecdf", ECDFKernel, 0, 1, 1, 0, 0, { 10000, 20000, 30000, 40000, 50000 }, "P-Value Generation in C" },
+};
+static const int NumScenarios = sizeof(Scenarios) / sizeof(Scenarios[0]);
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Gets the time in seconds since an arbitrary fixed point.
+/// </summary>
+static double now(void)
+{
+#if defined(_WIN32)
+	LARGE_INTEGER ticks, frequency;
+	QueryPerformanceCounter(&ticks);
+	QueryPerformanceFrequency(&frequency);
+	return (double)ticks.QuadPart / (double)frequency.QuadPart;
+#else
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + 1e-9 * (double)t.tv_nsec;
+#endif
+}
+/// <summary>
+/// Orders two doubles for qsort.
+/// </summary>
+static int ascending(const void* a, const void* b)
+{
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+/// <summary>
+/// Gets the name of the kernel that a scenario times.
+/// </summary>
+static const char* kernelname(Kernel kernel)
+{
+	static const char* names[] = { "Correlate", "WindowCorrelate", "CrossCorrelate", "EmpiricalCDF" };
+	return names[kernel];
+}
+/// <summary>
+/// Gets the name of the instruction set that the vectorized kernels use.
+/// </summary>
+static const char* simdname(void)
+{
+	static const char* names[] = { "Portable", "AVX2", "AVX512" };
+	return names[simdlevel()];
+}
+/// <summary>
+/// Finds a scenario by name.
+/// </summary>
+/// <returns>The scenario, or NULL if there is no scenario with that name.</returns>
+static const Scenario* findscenario(const char* name, size_t length)
+{
+	for (int a = 0; a < NumScenarios; a++)
+	{
+		if (strlen(Scenarios[a].Name) == length && strncmp(Scenarios[a].Name, name, length) == 0)
+			return &Scenarios[a];
+	}
+	return NULL;
+}
+/// <summary>
+/// Determines whether a scenario appears in a comma-separated list of names.
+/// </summary>
+static int selected(const Scenario* s, const char* names)
+{
+	if (!names) { return 1; }
+	for (const char* name = names; *name; )
+	{
+		size_t length = strcspn(name, ",");
+		if (findscenario(name, length) == s) { return 1; }
+		name += length;
+		if (*name == ',') { name++; }
+	}
+	return 0;
+}
+/// <summary>
+/// Fills an array with standard normal random numbers.
+/// </summary>
+static void gaussian(double x[], size_t n, Random* rng)
+{
+	const double pi = 3.14159265358979323846;
+	for (size_t a = 0; a < n; a += 2)
+	{
+		double u = 1.0 - rnguniform(rng);
+		double v = rnguniform(rng);
+		double radius = sqrt(-2.0 * log(u));
+
+		x[a] = radius * cos(2.0 * pi * v);
+		if (a + 1 < n) { x[a + 1] = radius * sin(2.0 * pi * v); }
+	}
+}
+/// <summary>
+/// Gets the number of values that a workload writes.
+/// </summary>
+static size_t outputsize(const Workload* w)
+{
+	const Scenario* s = w->Scenario;
+	size_t npairs = (size_t)w->SignalsX * w->SignalsY;
+	switch (s->Kernel)
+	{
+		case WindowKernel:	return npairs * WindowCount(w->Samples, s->Window, s->Overlap);
+		case CrossKernel:	return npairs * (2 * (size_t)w->Samples - 1);
+		case ECDFKernel:	return (size_t)w->Samples;
+		default:			return npairs;
+	}
+}
+/// <summary>
+/// Releases the inputs & output of a workload.
+/// </summary>
+static void freeworkload(Workload* w)
+{
+	free(w->X);
+	free(w->Y);
+	free(w->Out);
+	w->X = w->Y = w->Out = NULL;
+}
+/// <summary>
+/// Generates the inputs of a workload & allocates its output.
+/// </summary>
+/// <param name="size">The size of the scenario's swept dimension.</param>
+static ErrorCode createworkload(Workload* w, const Scenario* s, int size, uint64_t seed)
+{
+	w->Scenario = s;
+	w->Samples = s->Samples ? s->Samples : size;
+	w->SignalsX = s->SignalsX ? s->SignalsX : size;
+	w->SignalsY = s->SignalsY;
+
+	// Empirical CDFs compare as many real values as there are null values, which are held in Y
+	size_t nx = (size_t)w->Samples * w->SignalsX;
+	size_t ny = (size_t)w->Samples * w->SignalsY;
+	w->X = (double*)malloc(nx * sizeof(double));
+	w->Y = (double*)malloc(ny * sizeof(double));
+	w->Out = (double*)malloc(outputsize(w) * sizeof(double));
+	if (!w->X || !w->Y || !w->Out)
+	{
+		freeworkload(w);
+		return OutOfMemory;
+	}
+
+	Random rng;
+	rngseed(&rng, seed, 0);
+	gaussian(w->X, nx, &rng);
+	gaussian(w->Y, ny, &rng);
+	if (s->Kernel == ECDFKernel) { qsort(w->Y, ny, sizeof(double), ascending); }
+	return Success;
+}
+/// <summary>
+/// Runs the kernel of a workload once.
+/// </summary>
+static ErrorCode runworkload(Workload* w)
+{
+	const Scenario* s = w->Scenario;
+	SignalArray x = signals(w->X, w->Samples, w->SignalsX);
+	SignalArray y = signals(w->Y, w->Samples, w->SignalsY);
+	switch (s->Kernel)
+	{
+		case WindowKernel:	return WindowCorrelate(w->Out, x, y, s->Window, s->Overlap);
+		case CrossKernel:	return CrossCorrelate(w->Out, x, y);
+		case ECDFKernel:	return EmpiricalCDF(w->Out, w->X, w->Samples, w->Y, w->Samples, Both);
+		default:			return Correlate(w->Out, x, y);
+	}
+}
+/// <summary>
+/// Times one workload.
+/// </summary>
+/// <param name="r">Receives the timing of the workload.</param>
+static ErrorCode measure(Result* r, const Scenario* s, int size, const Options* o)
+{
+	Workload w;
+	ErrorCode status = createworkload(&w, s, size, o->Seed);
+	if (status != Success) { return status; }
+
+	double* times = (double*)malloc(o->Reps * sizeof(double));
+	if (!times)
+	{
+		freeworkload(&w);
+		return OutOfMemory;
+	}
+
+	for (int a = 0; a < o->Warmup && status == Success; a++)
+		status = runworkload(&w);
+
+	for (int a = 0; a < o->Reps && status == Success; a++)
+	{
+		// Only the last repetition is profiled, so that the profile describes one warm call
+		if (o->Profile && a == o->Reps - 1) { SetProfiling(1); }
+
+		double start = now();
+		status = runworkload(&w);
+		times[a] = now() - start;
+	}
+
+	if (o->Profile && GetProfiling())
+	{
+		Profile p;
+		GetProfile(&p);
+		SetProfiling(0);
+		if (status == Success) { status = WriteProfile(&p, o->Profile); }
+	}
+
+	if (status == Success)
+	{
+		qsort(times, o->Reps, sizeof(double), ascending);
+
+		int n = o->Reps;
+		snprintf(r->Scenario, NAMELENGTH, "%s", s->Name);
+		snprintf(r->Kernel, NAMELENGTH, "%s", kernelname(s->Kernel));
+		snprintf(r->Simd, NAMELENGTH, "%s", simdname());
+		r->Samples = w.Samples;
+		r->SignalsX = w.SignalsX;
+		r->SignalsY = w.SignalsY;
+		r->Threads = GetThreads();
+		r->Reps = n;
+		r->Min = times[0];
+		r->Median = (n % 2) ? times[n / 2] : 0.5 * (times[n / 2 - 1] + times[n / 2]);
+		r->P90 = times[(int)ceil(0.9 * n) - 1];
+		r->Max = times[n - 1];
+	}
+
+	free(times);
+	freeworkload(&w);
+	return status;
+}
+/// <summary>
+/// Writes the header of a CSV result file.
+/// </summary>
+static void writeheader(FILE* file)
+{
+	fprintf(file, "Scenario,Kernel,Samples,SignalsX,SignalsY,Threads,Simd,Reps,Min,Median,P90,Max\n");
+}
+/// <summary>
+/// Writes the timing of one workload as a line of a result file.
+/// </summary>
+static void writeresult(FILE* file, const Result* r, int json)
+{
+	if (json)
+	{
+		fprintf(file, "{\"Scenario\":\"%s\",\"Kernel\":\"%s\",\"Samples\":%d,\"SignalsX\":%d,\"SignalsY\":%d,", r->Scenario, r->Kernel, r->Samples, r->SignalsX, r->SignalsY);
+		fprintf(file, "\"Threads\":%d,\"Simd\":\"%s\",\"Reps\":%d,", r->Threads, r->Simd, r->Reps);
+		fprintf(file, "\"Min\":%.9g,\"Median\":%.9g,\"P90\":%.9g,\"Max\":%.9g}\n", r->Min, r->Median, r->P90, r->Max);
+	}
+	else
+	{
+		fprintf(file, "%s,%s,%d,%d,%d,%d,%s,%d,", r->Scenario, r->Kernel, r->Samples, r->SignalsX, r->SignalsY, r->Threads, r->Simd, r->Reps);
+		fprintf(file, "%.9g,%.9g,%.9g,%.9g\n", r->Min, r->Median, r->P90, r->Max);
+	}
+	fflush(file);
+}
+/// <summary>
+/// Copies the value of one key from a line of JSON that writeresult produced.
+/// </summary>
+/// <returns>Whether the key was found.</returns>
+static int jsonvalue(char value[NAMELENGTH], const char* line, const char* key)
+{
+	char pattern[NAMELENGTH + 4];
+	snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+
+	const char* start = strstr(line, pattern);
+	if (!start) { return 0; }
+	start += strlen(pattern);
+	if (*start == '"') { start++; }
+
+	size_t length = strcspn(start, "\",}");
+	if (length >= NAMELENGTH) { length = NAMELENGTH - 1; }
+	memcpy(value, start, length);
+	value[length] = '\0';
+	return 1;
+}
+/// <summary>
+/// Copies one column from a line of a CSV file.
+/// </summary>
+/// <returns>Whether the line has that many columns.</returns>
+static int csvvalue(char value[NAMELENGTH], const char* line, int column)
+{
+	for (int a = 0; a < column; a++)
+	{
+		line = strchr(line, ',');
+		if (!line) { return 0; }
+		line++;
+	}
+
+	size_t length = strcspn(line, ",\r\n");
+	if (length >= NAMELENGTH) { length = NAMELENGTH - 1; }
+	memcpy(value, line, length);
+	value[length] = '\0';
+	return 1;
+}
+/// <summary>
+/// Reads the timing of one workload from a line of a result file in either format.
+/// </summary>
+/// <param name="header">The first line of a CSV file, which names its columns, or NULL for lines of JSON.</param>
+/// <returns>Whether the line holds a complete result.</returns>
+static int parseresult(Result* r, const char* line, const char* header)
+{
+	static const char* keys[] = { "Scenario", "Kernel", "Samples", "SignalsX", "SignalsY", "Threads", "Simd", "Reps", "Min", "Median", "P90", "Max" };
+	char values[12][NAMELENGTH];
+
+	for (int a = 0; a < 12; a++)
+	{
+		if (!header)
+		{
+			if (!jsonvalue(values[a], line, keys[a])) { return 0; }
+			continue;
+		}
+
+		// Columns are found by name, so files with extra or reordered columns can still be compared
+		int column = -1;
+		char name[NAMELENGTH];
+		for (int b = 0; column < 0 && csvvalue(name, header, b); b++)
+		{
+			if (strcmp(name, keys[a]) == 0)
+				column = b;
+		}
+		if (column < 0 || !csvvalue(values[a], line, column)) { return 0; }
+	}
+
+	snprintf(r->Scenario, NAMELENGTH, "%s", values[0]);
+	snprintf(r->Kernel, NAMELENGTH, "%s", values[1]);
+	r->Samples = atoi(values[2]);
+	r->SignalsX = atoi(values[3]);
+	r->SignalsY = atoi(values[4]);
+	r->Threads = atoi(values[5]);
+	snprintf(r->Simd, NAMELENGTH, "%s", values[6]);
+	r->Reps = atoi(values[7]);
+	r->Min = atof(values[8]);
+	r->Median = atof(values[9]);
+	r->P90 = atof(values[10]);
+	r->Max = atof(values[11]);
+	return 1;
+}
+/// <summary>
+/// Reads every result from a result file in either format.
+/// </summary>
+/// <returns>The number of results read, or -1 if the file can't be read.</returns>
+static int readresults(Result r[], const char* path)
+{
+	FILE* file = fopen(path, "r");
+	if (!file) { return -1; }
+
+	char line[LINELENGTH];
+	char header[LINELENGTH];
+	int csv = 0, n = 0;
+	while (n < MAXRESULTS && fgets(line, LINELENGTH, file))
+	{
+		if (line[0] == '{')
+		{
+			n += parseresult(&r[n], line, NULL);
+		}
+		else if (!csv)
+		{
+			memcpy(header, line, LINELENGTH);
+			csv = 1;
+		}
+		else
+		{
+			n += parseresult(&r[n], line, header);
+		}
+	}
+
+	fclose(file);
+	return n;
+}
+/// <summary>
+/// Compares the median times of two result files, flagging workloads that got slower.
+/// </summary>
+/// <returns>The exit status: 0 if nothing regressed, 1 if something did or 2 if a file can't be read.</returns>
+static int compare(const char* baseline, const char* current, double tolerance)
+{
+	static Result before[MAXRESULTS], after[MAXRESULTS];
+	int nbefore = readresults(before, baseline);
+	int nafter = readresults(after, current);
+	if (nbefore < 0) { fprintf(stderr, "Unable to read %s.\n", baseline); return 2; }
+	if (nafter < 0) { fprintf(stderr, "Unable to read %s.\n", current); return 2; }
+
+	int regressions = 0, matched = 0;
+	printf("%-18s %10s %8s %8s %12s %12s %8s\n", "Scenario", "Samples", "SignalsX", "SignalsY", "Baseline", "Current", "Ratio");
+	for (int a = 0; a < nafter; a++)
+	{
+		const Result* y = &after[a];
+		const Result* x = NULL;
+		for (int b = 0; b < nbefore && !x; b++)
+		{
+			const Result* c = &before[b];
+			if (strcmp(c->Scenario, y->Scenario) == 0 && c->Samples == y->Samples && c->SignalsX == y->SignalsX && c->SignalsY == y->SignalsY)
+				x = c;
+		}
+		if (!x)
+		{
+			printf("%-18s %10d %8d %8d %12s %12.6g %8s  NEW\n", y->Scenario, y->Samples, y->SignalsX, y->SignalsY, "-", y->Median, "-");
+			continue;
+		}
+
+		double ratio = y->Median / x->Median;
+		const char* flag = "";
+		if (ratio > 1 + tolerance)			{ flag = "  REGRESSION"; regressions++; }
+		else if (ratio < 1 - tolerance)		{ flag = "  IMPROVED"; }
+		if (x->Threads != y->Threads || strcmp(x->Simd, y->Simd) != 0)
+			printf("%-18s (baseline ran on %d threads with %s, current on %d threads with %s)\n", y->Scenario, x->Threads, x->Simd, y->Threads, y->Simd);
+
+		printf("%-18s %10d %8d %8d %12.6g %12.6g %8.3f%s\n", y->Scenario, y->Samples, y->SignalsX, y->SignalsY, x->Median, y->Median, ratio, flag);
+		matched++;
+	}
+
+	printf("%d of %d workloads matched the baseline, %d regressed by more than %.0f%%.\n", matched, nafter, regressions, 100 * tolerance);
+	return regressions ? 1 : 0;
+}
+/// <summary>
+/// Lists every scenario along with its default sizes.
+/// </summary>
+static void list(void)
+{
+	for (int a = 0; a < NumScenarios; a++)
+	{
+		const Scenario* s = &Scenarios[a];
+		printf("%-18s %-16s %s\n", s->Name, kernelname(s->Kernel), s->Study);
+		if (s->Samples)	{ printf("%18s %-16s X: [%d x N], Y: [%d x %d], N:", "", "", s->Samples, s->Samples, s->SignalsY); }
+		else			{ printf("%18s %-16s X: [N x %d], Y: [N x %d], N:", "", "", s->SignalsX, s->SignalsY); }
+		for (int b = 0; b < MAXSIZES && s->Sizes[b]; b++)
+			printf("%s%d", b ? "," : " ", s->Sizes[b]);
+		printf("\n");
+	}
+}
+/// <summary>
+/// Reads a comma-separated list of sizes.
+/// </summary>
+/// <returns>Whether every size is a positive integer and there aren't more of them than a scenario can hold.</returns>
+static int parsesizes(int sizes[MAXSIZES], const char* text)
+{
+	memset(sizes, 0, MAXSIZES * sizeof(int));
+	for (int a = 0; *text; a++)
+	{
+		char* end;
+		long size = strtol(text, &end, 10);
+		if (a >= MAXSIZES || end == text || size <= 0 || size > 0x7FFFFFFF) { return 0; }
+		sizes[a] = (int)size;
+		text = (*end == ',') ? end + 1 : end;
+		if (*end && *end != ',') { return 0; }
+	}
+	return sizes[0] > 0;
+}
+/// <summary>
+/// Prints how to use the program.
+/// </summary>
+static int usage(void)
+{
+	fprintf(stderr, "Usage: statbench [--scenario NAMES] [--sizes N,N,...] [--scale F] [--warmup N] [--reps N] [--threads N]\n");
+	fprintf(stderr, "                 [--seed N] [--format csv|json] [--output PATH] [--profile PATH] [--list]\n");
+	fprintf(stderr, "       statbench compare BASELINE CURRENT [--tolerance F]\n");
+	return 2;
+}
+
+
+
+/* MAIN */
+int main(int argc, char* argv[])
+{
+	if (argc >= 2 && strcmp(argv[1], "compare") == 0)
+	{
+		double tolerance = 0.10;
+		if (argc == 6 && strcmp(argv[4], "--tolerance") == 0) { tolerance = atof(argv[5]); }
+		else if (argc != 4) { return usage(); }
+		return compare(argv[2], argv[3], tolerance);
+	}
+
+	Options o = { NULL, { 0 }, 1.0, 1, 5, 0, 1, 0, NULL, NULL };
+	for (int a = 1; a < argc; a++)
+	{
+		const char* option = argv[a];
+		const char* value = (a + 1 < argc) ? argv[a + 1] : NULL;
+		if (strcmp(option, "--list") == 0)	{ list(); return 0; }
+		if (!value)							{ return usage(); }
+
+		if (strcmp(option, "--scenario") == 0)		{ o.Scenarios = value; }
+		else if (strcmp(option, "--sizes") == 0)	{ if (!parsesizes(o.Sizes, value)) { return usage(); } }
+		else if (strcmp(option, "--scale") == 0)	{ o.Scale = atof(value); }
+		else if (strcmp(option, "--warmup") == 0)	{ o.Warmup = atoi(value); }
+		else if (strcmp(option, "--reps") == 0)		{ o.Reps = atoi(value); }
+		else if (strcmp(option, "--threads") == 0)	{ o.Threads = atoi(value); }
+		else if (strcmp(option, "--seed") == 0)		{ o.Seed = strtoull(value, NULL, 10); }
+		else if (strcmp(option, "--format") == 0)	{ o.JSON = (strcmp(value, "json") == 0); if (!o.JSON && strcmp(value, "csv") != 0) { return usage(); } }
+		else if (strcmp(option, "--output") == 0)	{ o.Output = value; }
+		else if (strcmp(option, "--profile") == 0)	{ o.Profile = value; }
+		else										{ return usage(); }
+		a++;
+	}
+	if (o.Scale <= 0 || o.Warmup < 0 || o.Reps < 1) { return usage(); }
+
+	for (const char* name = o.Scenarios; name && *name; )
+	{
+		size_t length = strcspn(name, ",");
+		if (!findscenario(name, length))
+		{
+			fprintf(stderr, "Unknown scenario '%.*s'. Use --list to see every scenario.\n", (int)length, name);
+			return 2;
+		}
+		name += length;
+		if (*name == ',') { name++; }
+	}
+
+	ErrorCode status = SetThreads(o.Threads);
+	if (status != Success) { fprintf(stderr, "%s\n", errormsg(status)); return 2; }
+
+	FILE* file = o.Output ? fopen(o.Output, "w") : stdout;
+	if (!file) { fprintf(stderr, "Unable to open %s.\n", o.Output); return 2; }
+	if (!o.JSON) { writeheader(file); }
+
+	for (int a = 0; a < NumScenarios && status == Success; a++)
+	{
+		const Scenario* s = &Scenarios[a];
+		if (!selected(s, o.Scenarios)) { continue; }
+
+		const int* sizes = o.Sizes[0] ? o.Sizes : s->Sizes;
+		for (int b = 0; b < MAXSIZES && sizes[b] && status == Success; b++)
+		{
+			int size = (int)(sizes[b] * o.Scale + 0.5);
+			size = (size < 1) ? 1 : size;
+
+			Result r;
+			status = measure(&r, s, size, &o);
+			if (status != Success)
+			{
+				fprintf(stderr, "%s (N = %d): %s\n", s->Name, size, errormsg(status));
+				break;
+			}
+
+			writeresult(file, &r, o.JSON);
+			if (o.Output) { fprintf(stderr, "%-18s N = %-8d median %.6g s\n", s->Name, size, r.Median); }
+		}
+	}
+
+	if (o.Output) { fclose(file); }
+	ReleaseWorkspace();
+	return (status == Success) ? 0 : 2;
+}
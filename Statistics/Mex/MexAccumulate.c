@@ -0,0 +1,195 @@
+/* MEXACCUMULATE - Accumulates NaN-aware running statistics across a series of equally sized arrays. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Running statistics are now held in native memory behind a handle and updated in place, instead of
+ *					being duplicated from a MATLAB structure on every call.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <matrix.h>
+#include <mex.h>
+#include "../Native/Statistics.h"
+
+
+
+/* DATA */
+/// <summary>
+/// Holds an accumulator along with the shape of the arrays that it ingests.
+/// </summary>
+typedef struct
+{
+	Accumulator		Acc;			// The running statistics of every element.
+	mwSize			NumDims;		// The number of dimensions of the ingested arrays.
+	mwSize*			Dims;			// The size of the ingested arrays along each dimension.
+}Tally;
+
+static Tally**		Live = NULL;		// Every accumulator that MATLAB holds a handle to.
+static int			NumLive = 0;		// The number of accumulators in Live.
+static int			Capacity = 0;		// The number of accumulators that Live has room for.
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Finds the position of an accumulator in the list of live accumulators.
+/// </summary>
+/// <returns>The index of the accumulator, or -1 if MATLAB doesn't hold a handle to it.</returns>
+static int find(const Tally* t)
+{
+	for (int a = 0; a < NumLive; a++)
+	{
+		if (Live[a] == t)
+			return a;
+	}
+	return -1;
+}
+/// <summary>
+/// Frees the storage of an accumulator, which may be partially allocated.
+/// </summary>
+static void destroy(Tally* t)
+{
+	free(t->Acc.Count);
+	free(t->Acc.Mean);
+	free(t->Acc.M2);
+	free(t->Dims);
+	free(t);
+}
+/// <summary>
+/// Releases one live accumulator, unlocking this function once none are left.
+/// </summary>
+static void release(int idx)
+{
+	destroy(Live[idx]);
+	Live[idx] = Live[--NumLive];
+	if (NumLive == 0 && mexIsLocked()) { mexUnlock(); }
+}
+/// <summary>
+/// Releases every live accumulator once MATLAB unloads this function.
+/// </summary>
+static void releaseall(void)
+{
+	while (NumLive > 0)
+		release(NumLive - 1);
+
+	free(Live);
+	Live = NULL;
+	Capacity = 0;
+}
+/// <summary>
+/// Gets the live accumulator that a MATLAB handle refers to.
+/// </summary>
+static Tally* handle(const mxArray* h)
+{
+	if (!mxIsUint64(h) || mxGetNumberOfElements(h) != 1) { mexErrMsgTxt("Accumulator handles must be scalar UINT64 values."); }
+
+	Tally* t = (Tally*)(uintptr_t)(*(const uint64_t*)mxGetData(h));
+	if (find(t) < 0) { mexErrMsgTxt("The accumulator handle is invalid or has already been freed."); }
+	return t;
+}
+/// <summary>
+/// Creates a zeroed accumulator for arrays that are the same size as X, returning its handle.
+/// </summary>
+static mxArray* create(const mxArray* x, Tally** out)
+{
+	if (NumLive == Capacity)
+	{
+		int capacity = Capacity ? 2 * Capacity : 8;
+		Tally** live = (Tally**)realloc(Live, capacity * sizeof(Tally*));
+		if (!live) { mexErrMsgTxt(errormsg(OutOfMemory)); }
+		Live = live;
+		Capacity = capacity;
+	}
+
+	Tally* t = (Tally*)calloc(1, sizeof(Tally));
+	if (!t) { mexErrMsgTxt(errormsg(OutOfMemory)); }
+
+	size_t n = mxGetNumberOfElements(x);
+	t->NumDims = mxGetNumberOfDimensions(x);
+	t->Dims = (mwSize*)malloc(t->NumDims * sizeof(mwSize));
+	t->Acc.Count = (double*)calloc(n, sizeof(double));
+	t->Acc.Mean = (double*)calloc(n, sizeof(double));
+	t->Acc.M2 = (double*)calloc(n, sizeof(double));
+	t->Acc.NumElements = n;
+	if (!t->Dims || !t->Acc.Count || !t->Acc.Mean || !t->Acc.M2)
+	{
+		destroy(t);
+		mexErrMsgTxt(errormsg(OutOfMemory));
+	}
+	memcpy(t->Dims, mxGetDimensions(x), t->NumDims * sizeof(mwSize));
+
+	// Accumulators outlive this call, so the function has to stay loaded for as long as any of them exist
+	if (!mexIsLocked())
+	{
+		mexLock();
+		mexAtExit(releaseall);
+	}
+	Live[NumLive++] = t;
+	*out = t;
+
+	mxArray* h = mxCreateNumericMatrix(1, 1, mxUINT64_CLASS, mxREAL);
+	*(uint64_t*)mxGetData(h) = (uint64_t)(uintptr_t)t;
+	return h;
+}
+
+
+
+/* MEX FUNCTION */
+void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argin[])
+{
+	if (nargin < 1 || nargin > 2) { mexErrMsgTxt("One or two input arguments must be provided to this function. See documentation for syntax details."); }
+
+	if (mxIsChar(argin[0]))
+	{
+		char* command = mxArrayToString(argin[0]);
+		int freeing = command && (strcmp(command, "free") == 0) && (nargin == 2);
+		int flushing = command && (strcmp(command, "flush") == 0) && (nargin == 1);
+		mxFree(command);
+
+		if (freeing)
+			release(find(handle(argin[1])));
+		else if (flushing)
+			releaseall();
+		else
+			mexErrMsgTxt("Commands must be either MexAccumulate('free', h) or MexAccumulate('flush').");
+		return;
+	}
+
+	ErrorCode status;
+	if (mxIsUint64(argin[0]) && nargin == 1)
+	{
+		// Finalize the statistics of every element
+		const Tally* t = handle(argin[0]);
+		double* outputs[3] = { NULL, NULL, NULL };
+		for (int a = 0; a < ((nargout > 1) ? nargout : 1) && a < 3; a++)
+		{
+			argout[a] = mxCreateNumericArray(t->NumDims, t->Dims, mxDOUBLE_CLASS, mxREAL);
+			outputs[a] = mxGetPr(argout[a]);
+		}
+
+		status = AccumulatorMoments(outputs[0], outputs[1], outputs[2], &t->Acc);
+		if (status != Success) { mexErrMsgTxt(errormsg(status)); }
+		return;
+	}
+
+	const mxArray* x = argin[nargin - 1];
+	if (!mxIsDouble(x) || mxIsComplex(x))	{ mexErrMsgTxt("X must be a real array of doubles."); }
+	if (mxIsEmpty(x))						{ mexErrMsgTxt("X cannot be an empty array."); }
+
+	// New accumulators start from zero, while existing ones are updated in place
+	Tally* t;
+	if (nargin == 1)
+		argout[0] = create(x, &t);
+	else
+	{
+		if (!mxIsUint64(argin[0])) { mexErrMsgTxt("Arrays can only be added to an accumulator handle returned by an earlier call to this function."); }
+		t = handle(argin[0]);
+		if (t->Acc.NumElements != mxGetNumberOfElements(x))
+			mexErrMsgTxt("X must have as many elements as the arrays that have already been accumulated.");
+	}
+
+	status = Accumulate(&t->Acc, mxGetPr(x));
+	if (status != Success) { mexErrMsgTxt(errormsg(status)); }
+}
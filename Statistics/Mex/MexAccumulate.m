@@ -0,0 +1,53 @@
+% MEXACCUMULATE - Accumulates NaN-aware running statistics across a series of equally sized arrays.
+%
+%	MEXACCUMULATE averages any number of arrays (e.g. one correlation map for every subject & scan) without ever
+%	concatenating them. Each call ingests one array and updates the running count, mean and sum of squared deviations of
+%	every element using Welford's algorithm, so memory use stays at a few copies of one array no matter how many arrays are
+%	averaged. NaNs are skipped element by element, so the final means & variances match what NANMEAN and NANVAR return
+%	across the concatenated arrays.
+%
+%	Running statistics live in native memory and are updated in place until they are freed, and this function stays
+%	loaded while any accumulators exist.
+%
+%	SYNTAX:
+%		h = MexAccumulate(x)
+%		MexAccumulate(h, x)
+%		[m, v, t] = MexAccumulate(h)
+%		MexAccumulate('free', h)
+%		MexAccumulate('flush')
+%
+%	OUTPUTS:
+%		h:				UINT64
+%						A handle to a new accumulator that has already ingested X. Pass this into later calls along with
+%						the next array to ingest.
+%
+%		m:				[ DOUBLES ]
+%						The mean of every element across the ingested arrays, or NaN where every value was a NaN.
+%
+%		v:				[ DOUBLES ]
+%						The sample variance of every element (normalized by the count minus one), or zero where only one
+%						value wasn't a NaN.
+%
+%		t:				[ DOUBLES ]
+%						The one-sample t statistic M ./ SQRT(V ./ COUNT) of every element, or NaN where fewer than two
+%						values weren't NaNs.
+%
+%						M, V and T are all the same size as the first array that the accumulator ingested.
+%
+%	INPUTS:
+%		x:				[ DOUBLES ]
+%						The next array to ingest. This must have as many elements as every other ingested array.
+%
+%		h:				UINT64
+%						A handle returned by an earlier call to this function that hasn't been freed yet.
+%
+%		'free':			Releases the accumulator that H refers to. H is invalid afterward.
+%
+%		'flush':		Releases every accumulator.
+%
+%	See also: MEAN, MEXCORRELATOR, NANMEAN, NANVAR, TTEST
+
+%% CHANGELOG
+%	Written by Josh Grooms on 20261017
+%		20261017:	Accumulators are now handles to running statistics that are updated in place, rather than structures
+%					that were copied on every call.
@@ -0,0 +1,63 @@
+/* MEXCACHE - Keeps the transform plans & scratch memory of the native library alive between calls to a MEX function. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#pragma once
+#ifndef MEXCACHE_H
+#define MEXCACHE_H
+
+#include <string.h>
+#include <matrix.h>
+#include <mex.h>
+#include "../Native/Statistics.h"
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Releases everything that the native library caches once MATLAB unloads the MEX function.
+/// </summary>
+static void mexcacheexit(void)
+{
+	ReleaseWorkspace();
+}
+
+
+
+/* FUNCTIONS */
+/// <summary>
+/// Locks the MEX function in memory so that the plans & workspaces its kernels cache survive between calls, or flushes
+/// them when the function is called with the single argument 'flush'.
+/// </summary>
+/// <remarks>
+/// Every MEX function links the same shared copy of the native library, so they all share one cache. Flushing releases
+/// that cache and unlocks the function, so that CLEAR can unload it again.
+/// </remarks>
+/// <returns>Whether the call was a request to flush the cache, in which case the MEX function has nothing left to do.</returns>
+static int mexcache(int nargin, const mxArray* argin[])
+{
+	if (nargin == 1 && mxIsChar(argin[0]))
+	{
+		char* command = mxArrayToString(argin[0]);
+		int flush = command && (strcmp(command, "flush") == 0);
+		mxFree(command);
+		if (!flush) { mexErrMsgTxt("'flush' is the only command that this function accepts."); }
+
+		ReleaseWorkspace();
+		if (mexIsLocked()) { mexUnlock(); }
+		return 1;
+	}
+
+	if (!mexIsLocked())
+	{
+		mexLock();
+		mexAtExit(mexcacheexit);
+	}
+	return 0;
+}
+
+
+
+#endif
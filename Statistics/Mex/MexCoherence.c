@@ -0,0 +1,66 @@
+/* MEXCOHERENCE - Estimates the magnitude-squared coherence between many pairs of signals at once using Welch's method. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Transform plans & workspaces are now kept between calls. Call with 'flush' to release them.
+ */
+
+#include <matrix.h>
+#include <mex.h>
+#include "../Native/Statistics.h"
+#include "MexCache.h"
+#include "MexSpectral.h"
+
+
+
+/* MEX FUNCTION */
+void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argin[])
+{
+	if (mexcache(nargin, argin)) { return; }
+
+	if (nargin != 6 && nargin != 7)
+		mexErrMsgTxt("Six or seven input arguments must be provided to this function. See documentation for syntax details.");
+
+	int ncx, nrx, ncy, nry;
+	nrx = mxGetM(argin[0]);
+	ncx = mxGetN(argin[0]);
+	nry = mxGetM(argin[1]);
+	ncy = mxGetN(argin[1]);
+
+	if (nrx == 0 || ncx == 0 || ncy == 0)				{ mexErrMsgTxt("X and Y cannot be empty arrays."); }
+	if (nrx != nry)										{ mexErrMsgTxt("X and Y must contain equivalent length signals."); }
+	if (!mxIsDouble(argin[0]) || !mxIsDouble(argin[1]))	{ mexErrMsgTxt("X and Y must be arrays of doubles."); }
+
+	Welch w;
+	mexwelch(&w, argin + 2, nrx);
+
+	// Pairs arrive as one-based [NP x 2] arrays & are handed over as zero-based (X, Y) index pairs
+	int* pairs = NULL;
+	int npairs = ncx * ncy;
+	if (nargin == 7 && !mxIsEmpty(argin[6]))
+	{
+		if (mxGetN(argin[6]) != 2 || !mxIsDouble(argin[6]))
+			mexErrMsgTxt("Pairs must be an [NP x 2] array of signal indices.");
+
+		npairs = (int)mxGetM(argin[6]);
+		pairs = (int*)mxMalloc(2 * (size_t)npairs * sizeof(int));
+		const double* p = mxGetPr(argin[6]);
+		for (int a = 0; a < npairs; a++)
+		{
+			pairs[2 * a] = (int)p[a] - 1;
+			pairs[2 * a + 1] = (int)p[a + npairs] - 1;
+			if (pairs[2 * a] < 0 || pairs[2 * a] >= ncx || pairs[2 * a + 1] < 0 || pairs[2 * a + 1] >= ncy)
+				mexErrMsgTxt("Pairs must contain indices of signals in X followed by indices of signals in Y.");
+		}
+	}
+
+	SignalArray x = signals(mxGetPr(argin[0]), nrx, ncx);
+	SignalArray y = signals(mxGetPr(argin[1]), nry, ncy);
+
+	argout[0] = mxCreateDoubleMatrix(w.NFFT / 2 + 1, npairs, mxREAL);
+	ErrorCode status = Coherence(mxGetPr(argout[0]), x, y, pairs, npairs, &w);
+	mxFree(pairs);
+	if (status != Success) { mexErrMsgTxt(errormsg(status)); }
+
+	if (nargout > 1) { argout[1] = mexfrequencies(&w); }
+}
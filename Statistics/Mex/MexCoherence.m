@@ -0,0 +1,50 @@
+% MEXCOHERENCE - Estimates the magnitude-squared coherence between many pairs of signals at once using Welch's method.
+%
+%	MEXCOHERENCE produces the same estimates as MSCOHERE does for real signals. The segment spectra of each signal are
+%	computed once and reused for every pair that the signal takes part in, so coherence between one signal and many others
+%	costs little more than their power spectra do.
+%
+%	SYNTAX:
+%		coh = MexCoherence(x, y, window, noverlap, nfft, fs)
+%		coh = MexCoherence(x, y, window, noverlap, nfft, fs, pairs)
+%		[coh, f] = MexCoherence(...)
+%		MexCoherence('flush')
+%
+%	OUTPUTS:
+%		coh:			[ NF x NP DOUBLES ]
+%						The coherence of every pair of signals, where NF = NFFT / 2 + 1. Without a list of PAIRS, every
+%						signal in X is paired with every signal in Y, so NP = NX * NY and columns are arranged exactly as
+%						they are in the output of MEXCROSSCORRELATE.
+%
+%		f:				[ NF x 1 DOUBLES ]
+%						The frequency in Hz of every row of COH.
+%
+%	INPUTS:
+%		x:				[ M x NX DOUBLES ]
+%						An array of signals. Each column of this array represents a single signal with M time points.
+%
+%		y:				[ M x NY DOUBLES ]
+%						A second array of signals. The number of time points M must always equal M from X.
+%
+%		window:			[ L x 1 DOUBLES ]
+%						The window applied to every segment. Its length L sets the length of the segments.
+%
+%		noverlap:		INTEGER
+%						The number of samples that successive segments share. This must be in [0, L - 1].
+%
+%		nfft:			INTEGER
+%						The transform length, which must be a power of two.
+%
+%		fs:				DOUBLE
+%						The sampling rate of the signals in Hz.
+%
+%	OPTIONAL INPUT:
+%		pairs:			[ NP x 2 INTEGERS ]
+%						The pairs of signals to compute coherence for. Each row holds the index of a signal in X followed
+%						by the index of a signal in Y.
+%						DEFAULT: [] (every signal in X with every signal in Y)
+%
+%	See also: MEXWELCH, MSCOHERE
+
+%% CHANGELOG
+%	Written by Josh Grooms on 20261017
@@ -2,17 +2,16 @@
 
 /* CHANGELOG
  * Written by Josh Grooms on 20150203
+ *		20261017:	Moved the correlation kernel into the native statistics library (Statistics/Native). This file is now
+ *					only responsible for translating between MATLAB arrays and the library's types.
+ *		20261017:	Added a single precision path. Single precision inputs are no longer converted in MATLAB, and they
+ *					produce single precision outputs.
+ *		20261017:	Added an optional second output that profiles the native kernels (see MexProfile.h).
  */
 
-#include <cilk/cilk.h>
-#include <mathimf.h>
 #include <mex.h>
-#include <mkl.h>
-
-
-
-/* PROTOTYPES */
-double corr(double x[], double y[], int nsamples);
+#include "../Native/Statistics.h"
+#include "MexProfile.h"
 
 
 
@@ -30,61 +29,31 @@ void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argi
 
 	if (nrx == 0 || nry == 0) { mexErrMsgTxt("Inputs cannot be empty arrays."); }
 	if (nrx != nry) { mexErrMsgTxt("X and Y must contain equivalent length signals."); }
-	
-	double* x = mxGetPr(argin[0]);
-	double* y = mxGetPr(argin[1]);
 
-	argout[0] = mxCreateDoubleMatrix(ncx, ncy, mxREAL);
-	double* r = mxGetPr(argout[0]);
+	mxClassID class = mxGetClassID(argin[0]);
+	if (class != mxGetClassID(argin[1]))						{ mexErrMsgTxt("X and Y must be of the same class."); }
+	if (class != mxDOUBLE_CLASS && class != mxSINGLE_CLASS)	{ mexErrMsgTxt("X and Y must be arrays of singles or doubles."); }
+
+	int profiled = mexprofilebegin(nargout, 1);
 
-	if (ncy == 1)
+	ErrorCode status;
+	if (class == mxSINGLE_CLASS)
 	{
-		cilk_for(int a = 0; a < ncx; a++)
-		{
-			int idxX = a * nrx;
-			r[a] = corr(x + idxX, y, nrx);
-		}
+		SignalArrayF x = signalsf((const float*)mxGetData(argin[0]), nrx, ncx);
+		SignalArrayF y = signalsf((const float*)mxGetData(argin[1]), nry, ncy);
+
+		argout[0] = mxCreateNumericMatrix(ncx, ncy, mxSINGLE_CLASS, mxREAL);
+		status = CorrelateF((float*)mxGetData(argout[0]), x, y);
 	}
 	else
 	{
-		cilk_for(int a = 0; a < ncy; a++)
-		{
-			int idxY = a * nry;
-			int idxR = a * ncx;
-			for (int b = 0; b < ncx; b++)
-			{
-				int idxX = b * nrx;
-				r[idxR + b] = corr(x + idxX, y + idxY, nrx);
-			}
-		}
-	}
-}
+		SignalArray x = signals(mxGetPr(argin[0]), nrx, ncx);
+		SignalArray y = signals(mxGetPr(argin[1]), nry, ncy);
 
-
-
-/* SUBROUTINES */
-/// <summary>
-/// Computes the Pearson product-moment correlation coefficient between two signals.
-/// </summary>
-/// <param name="x">A signal vector.</param>
-/// <param name="y">A second signal vector of the same length as x.</param>
-/// <param name="nsamples">The number of sample points in x and y.</param>
-/// <returns>The correlation coefficient (r) between x and y.</returns>
-double corr(double x[], double y[], int nsamples)
-{
-	double sx, sy, sxy, ssx, ssy;
-	sx = sy = sxy = ssx = ssy = 0;
-	for (int a = 0; a < nsamples; a++)
-	{
-		sx += x[a];
-		sy += y[a];
-		sxy += x[a] * y[a];
-		ssx += x[a] * x[a];
-		ssy += y[a] * y[a];
+		argout[0] = mxCreateDoubleMatrix(ncx, ncy, mxREAL);
+		status = Correlate(mxGetPr(argout[0]), x, y);
 	}
 
-	double cov = (nsamples * sxy) - (sx * sy);
-	double scale = sqrt((nsamples * ssx) - (sx * sx)) * sqrt((nsamples * ssy) - (sy * sy));
-
-	return cov / scale;
-}
\ No newline at end of file
+	mexprofileend(profiled, nargout, argout, 1);
+	if (status != Success) { mexErrMsgTxt(errormsg(status)); }
+}
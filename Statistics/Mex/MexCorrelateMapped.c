@@ -0,0 +1,52 @@
+/* MEXCORRELATEMAPPED - Correlates signals stored in a mapped array file with one or more additional signals. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#include <mex.h>
+#include "../Native/Statistics.h"
+
+
+
+/* MEX FUNCTION */
+void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argin[])
+{
+	if (nargin != 3 && nargin != 4)
+		mexErrMsgTxt("Three or four input arguments must be provided to this function. See documentation for syntax details.");
+	if (!mxIsChar(argin[0]) || !mxIsChar(argin[2]))
+		mexErrMsgTxt("The input and output file paths must be strings.");
+
+	int nry = (int)mxGetM(argin[1]);
+	int ncy = (int)mxGetN(argin[1]);
+	int tilesize = (nargin == 4) ? (int)mxGetScalar(argin[3]) : 0;
+
+	if (nry == 0 || ncy == 0)	{ mexErrMsgTxt("Inputs cannot be empty arrays."); }
+	if (tilesize < 0)			{ mexErrMsgTxt("The tile size must be a non-negative integer."); }
+
+	char* xpath = mxArrayToString(argin[0]);
+	char* rpath = mxArrayToString(argin[2]);
+
+	MappedArray x, r;
+	ErrorCode status = OpenMappedArray(&x, xpath, 0);
+	if (status == Success)
+	{
+		if (x.NumRows != (size_t)nry)
+			status = SizeMismatch;
+		else
+		{
+			status = CreateMappedArray(&r, rpath, DoublePrecision, x.NumColumns, (size_t)ncy);
+			if (status == Success)
+			{
+				status = CorrelateMapped(&r, &x, signals(mxGetPr(argin[1]), nry, ncy), tilesize);
+				CloseMappedArray(&r);
+			}
+		}
+		CloseMappedArray(&x);
+	}
+
+	mxFree(xpath);
+	mxFree(rpath);
+
+	if (status != Success) { mexErrMsgTxt(errormsg(status)); }
+}
@@ -0,0 +1,34 @@
+% MEXCORRELATEMAPPED - Correlates signals stored in a mapped array file with one or more additional signals.
+%
+%	This function computes the same correlation coefficients as MEXCORRELATE, except that the signals in X are read
+%	directly from a mapped array file (see MAPWRITE) and the results are written directly to a new mapped array file. Only
+%	one tile of signals from X is resident in memory at any time, so arrays that are much larger than the available memory
+%	(e.g. whole-brain BOLD data sets) can be correlated without ever loading them into MATLAB.
+%
+%	SYNTAX:
+%		MexCorrelateMapped(xfile, y, rfile)
+%		MexCorrelateMapped(xfile, y, rfile, tilesize)
+%
+%	INPUT:
+%		xfile:			STRING
+%						The path to a mapped array file that holds an [M x NX] array of signals in either single or double
+%						precision. Each column of this array represents a single signal with M time points.
+%
+%		y:				[ M x NY DOUBLES ]
+%						An array of doubles containing the signal(s) to be correlated with each signal in X. The number of
+%						samples M must always equal M from X.
+%
+%		rfile:			STRING
+%						The path to the mapped array file that receives the [NX x NY] array of correlation coefficients in
+%						double precision. Any existing file at this location is overwritten. Use MEMMAPFILE to read it back.
+%
+%	OPTIONAL INPUT:
+%		tilesize:		INTEGER
+%						The number of signals from X that are correlated at once. Larger tiles use more memory. A value of
+%						zero sizes tiles automatically to fit within the native library's memory budget.
+%						DEFAULT: 0
+%
+%	See also: MAPWRITE, MEMMAPFILE, MEXCORRELATE
+
+%% CHANGELOG
+%	Written by Josh Grooms on 20261017
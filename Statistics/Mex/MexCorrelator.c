@@ -0,0 +1,186 @@
+/* MEXCORRELATOR - Ingests one array of signals once and correlates it against any number of other signals afterward. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Lags are now checked to be real, whole numbers of the right class before they are used.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <matrix.h>
+#include <mex.h>
+#include "../Native/Statistics.h"
+#include "MexEpilogue.h"
+#include "MexLags.h"
+
+
+
+/* DATA */
+static Correlator**	Live = NULL;		// Every correlator that MATLAB holds a handle to.
+static int			NumLive = 0;		// The number of correlators in Live.
+static int			Capacity = 0;		// The number of correlators that Live has room for.
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Finds the position of a correlator in the list of live correlators.
+/// </summary>
+/// <returns>The index of the correlator, or -1 if MATLAB doesn't hold a handle to it.</returns>
+static int find(const Correlator* c)
+{
+	for (int a = 0; a < NumLive; a++)
+	{
+		if (Live[a] == c)
+			return a;
+	}
+	return -1;
+}
+/// <summary>
+/// Releases one live correlator, unlocking this function once none are left.
+/// </summary>
+static void release(int idx)
+{
+	FreeCorrelator(Live[idx]);
+	free(Live[idx]);
+	Live[idx] = Live[--NumLive];
+	if (NumLive == 0 && mexIsLocked()) { mexUnlock(); }
+}
+/// <summary>
+/// Releases every live correlator along with the library's cached workspaces once MATLAB unloads this function.
+/// </summary>
+static void releaseall(void)
+{
+	while (NumLive > 0)
+		release(NumLive - 1);
+
+	free(Live);
+	Live = NULL;
+	Capacity = 0;
+	ReleaseWorkspace();
+}
+/// <summary>
+/// Gets the live correlator that a MATLAB handle refers to.
+/// </summary>
+static Correlator* handle(const mxArray* h)
+{
+	if (!mxIsUint64(h) || mxGetNumberOfElements(h) != 1) { mexErrMsgTxt("Correlator handles must be scalar UINT64 values."); }
+
+	Correlator* c = (Correlator*)(uintptr_t)(*(const uint64_t*)mxGetData(h));
+	if (find(c) < 0) { mexErrMsgTxt("The correlator handle is invalid or has already been freed."); }
+	return c;
+}
+/// <summary>
+/// Creates a correlator from an array of signals & an optional list of lags, returning its handle.
+/// </summary>
+static mxArray* create(const mxArray* x, const mxArray* lags)
+{
+	int nrx = (int)mxGetM(x);
+	int ncx = (int)mxGetN(x);
+	if (!mxIsDouble(x) || mxIsComplex(x))	{ mexErrMsgTxt("X must be an array of real doubles."); }
+	if (nrx == 0 || ncx == 0)				{ mexErrMsgTxt("X cannot be an empty array."); }
+
+	int nlags = lags ? (int)mxGetNumberOfElements(lags) : 0;
+	int* lagv = lags ? mexlags(lags, nrx) : NULL;
+
+	if (NumLive == Capacity)
+	{
+		int capacity = Capacity ? 2 * Capacity : 8;
+		Correlator** live = (Correlator**)realloc(Live, capacity * sizeof(Correlator*));
+		if (!live) { mexErrMsgTxt(errormsg(OutOfMemory)); }
+		Live = live;
+		Capacity = capacity;
+	}
+
+	Correlator* c = (Correlator*)malloc(sizeof(Correlator));
+	if (!c) { mexErrMsgTxt(errormsg(OutOfMemory)); }
+
+	ErrorCode status = CreateCorrelator(c, signals(mxGetPr(x), nrx, ncx), lagv, nlags);
+	mxFree(lagv);
+	if (status != Success)
+	{
+		free(c);
+		mexErrMsgTxt(errormsg(status));
+	}
+
+	// Correlators outlive this call, so the function has to stay loaded for as long as any of them exist
+	if (!mexIsLocked())
+	{
+		mexLock();
+		mexAtExit(releaseall);
+	}
+	Live[NumLive++] = c;
+
+	mxArray* h = mxCreateNumericMatrix(1, 1, mxUINT64_CLASS, mxREAL);
+	*(uint64_t*)mxGetData(h) = (uint64_t)(uintptr_t)c;
+	return h;
+}
+
+
+
+/* MEX FUNCTION */
+void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argin[])
+{
+	if (nargin < 1 || nargin > 3) { mexErrMsgTxt("One to three input arguments must be provided to this function. See documentation for syntax details."); }
+
+	if (mxIsChar(argin[0]))
+	{
+		char* command = mxArrayToString(argin[0]);
+		int freeing = command && (strcmp(command, "free") == 0) && (nargin == 2);
+		int flushing = command && (strcmp(command, "flush") == 0) && (nargin == 1);
+		mxFree(command);
+
+		if (freeing)
+			release(find(handle(argin[1])));
+		else if (flushing)
+			releaseall();
+		else
+			mexErrMsgTxt("Commands must be either MexCorrelator('free', h) or MexCorrelator('flush').");
+		return;
+	}
+
+	if (!mxIsUint64(argin[0]))
+	{
+		if (nargin > 2) { mexErrMsgTxt("Correlators are created from X and an optional list of lags only."); }
+		argout[0] = create(argin[0], (nargin == 2 && !mxIsEmpty(argin[1])) ? argin[1] : NULL);
+		return;
+	}
+
+	if (nargin < 2) { mexErrMsgTxt("Signals to correlate against the correlator must be provided."); }
+
+	const Correlator* c = handle(argin[0]);
+	const mxArray* y = argin[1];
+	int nry = (int)mxGetM(y);
+	int ncy = (int)mxGetN(y);
+	int ncx = c->NumSignals;
+	if (!mxIsDouble(y) || mxIsComplex(y))	{ mexErrMsgTxt("Y must be an array of real doubles."); }
+	if (nry != c->NumSamples)				{ mexErrMsgTxt("Y must contain signals of the same length as the ones in X."); }
+
+	ErrorCode status;
+	SignalArray ys = signals(mxGetPr(y), nry, ncy);
+	if (nargin == 3 && !mxIsEmpty(argin[2]))
+	{
+		Epilogue e;
+		mexepilogue(&e, argin[2], ncx);
+
+		// Plain correlations count as a single lag, which is dropped from the output's dimensions
+		int nlags = c->Lags ? c->NumLags : 1;
+		argout[0] = mexepilogueoutput(&e, nlags, ncx, ncy);
+		if (!c->Lags)
+		{
+			mwSize dims[2] = { e.Map ? e.NumRows : (mwSize)ncx, (mwSize)ncy };
+			mxSetDimensions(argout[0], dims, 2);
+		}
+
+		status = CorrelatorApply(mxGetPr(argout[0]), c, ys, &e);
+		mxFree((void*)e.Map);
+	}
+	else
+	{
+		argout[0] = c->Lags ? mxCreateDoubleMatrix(c->NumLags, (size_t)ncx * ncy, mxREAL) : mxCreateDoubleMatrix(ncx, ncy, mxREAL);
+		status = CorrelatorApply(mxGetPr(argout[0]), c, ys, NULL);
+	}
+
+	if (status != Success) { mexErrMsgTxt(errormsg(status)); }
+}
@@ -0,0 +1,59 @@
+% MEXCORRELATOR - Ingests one array of signals once and correlates it against any number of other signals afterward.
+%
+%	MEXCORRELATOR is meant for loops that correlate the same large array (e.g. every voxel of a BOLD scan) with one signal
+%	after another (e.g. every EEG channel). Creating a correlator does everything that only depends on X up front: plain
+%	correlators standardize every signal in X, while correlators with lags store the energy of every signal in X and
+%	either its spectra or, when only a few lags are needed, a copy of X. Each later call then only processes Y.
+%
+%	Correlators live in native memory until they are freed, and this function stays loaded while any of them exist.
+%
+%	SYNTAX:
+%		h = MexCorrelator(x)
+%		h = MexCorrelator(x, lags)
+%		r = MexCorrelator(h, y)
+%		r = MexCorrelator(h, y, epilogue)
+%		MexCorrelator('free', h)
+%		MexCorrelator('flush')
+%
+%	OUTPUTS:
+%		h:				UINT64
+%						A handle to the new correlator. Pass this into later calls along with the signals to correlate.
+%
+%		r:				[ NX x NY DOUBLES ] or [ L x (NX * NY) DOUBLES ]
+%						The Pearson correlation coefficients between every signal in X and every signal in Y. Correlators
+%						without lags produce the same output as MEXCORRELATE. Correlators with lags produce the same output
+%						as MEXCROSSCORRELATE does with the same lags.
+%
+%						When an EPILOGUE with a mask is provided, R is instead [NR x NY] (without lags) or [NR x L x NY]
+%						(with lags), where NR is the number of elements in the mask.
+%
+%	INPUTS:
+%		x:				[ M x NX DOUBLES ]
+%						The signals that the correlator holds. These are copied, so X may be cleared afterward.
+%
+%		h:				UINT64
+%						A handle returned by an earlier call to this function that hasn't been freed yet.
+%
+%		y:				[ M x NY DOUBLES ]
+%						The signals to correlate with every signal in X.
+%
+%		'free':			Releases the correlator that H refers to. H is invalid afterward.
+%
+%		'flush':		Releases every correlator along with the workspaces that the native library caches.
+%
+%	OPTIONAL INPUTS:
+%		lags:			[ L x 1 INTEGERS ]
+%						The sample shifts of X relative to Y at which cross-correlations are computed. Every lag must be an
+%						integer in the range [-(M - 1), M - 1]. Cross-correlations aren't centered on the mean, just like
+%						the ones that MEXCROSSCORRELATE computes.
+%						DEFAULT: [] (plain correlations that are centered on the mean)
+%
+%		epilogue:		STRUCT
+%						Processing that is applied to every coefficient as it is stored. This accepts the same fields as
+%						the epilogue of MEXCROSSCORRELATE (FisherN, Threshold, Cutoffs and Mask).
+%						DEFAULT: [] (store plain correlation coefficients)
+%
+%	See also: MEXCORRELATE, MEXCROSSCORRELATE, ONCLEANUP
+
+%% CHANGELOG
+%	Written by Josh Grooms on 20261017
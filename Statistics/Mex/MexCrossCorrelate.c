@@ -4,39 +4,36 @@
  * Written by Josh Grooms on 20141230
  *		20150210:	Updated to remove the restrictions on the number of columns in X and Y. These can now freely vary. 
  *					Updated the documentation of this function to reflect this change and to improve clarity.
+ *		20261017:	Moved the cross-correlation kernel into the native statistics library (Statistics/Native). This file is
+ *					now only responsible for translating between MATLAB arrays and the library's types.
+ *		20261017:	Added an optional third argument that selects which lags to compute. Only those lags are computed and
+ *					stored in the output.
+ *		20261017:	Added a single precision path. Single precision inputs are no longer converted in MATLAB, and they
+ *					produce single precision outputs.
+ *		20261017:	Added an optional fourth argument that describes an epilogue. Fisher transforms, thresholding and
+ *					unmasking are then applied by the kernel as it stores results, instead of in separate passes.
+ *		20261017:	Transform plans & workspaces are now kept between calls. Call with 'flush' to release them.
+ *		20261017:	Added an optional second output that profiles the native kernels (see MexProfile.h).
+ *		20261017:	Lags are now checked to be real, whole numbers of the right class before they are used.
  */
 
-#include <cilk/cilk.h>
-#include <math.h>
 #include <matrix.h>
 #include <mex.h>
-#include <mkl.h>
-
-
-
-/* MACROS */
-void	_check(int status, int line)
-{
-	if (status != 0) { printf("Something went wrong at line %d", line); }
-}
-
-#define check(status) _check(status, __LINE__)
-
-
-
-/* FUNCTION PROTOTYPES */
-void	xcorr(double cc[], double x[], double y[], int nsamples);
+#include "../Native/Statistics.h"
+#include "MexCache.h"
+#include "MexEpilogue.h"
+#include "MexLags.h"
+#include "MexProfile.h"
 
 
 
 /* MEX FUNCTION */
 void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argin[])
 {
-	if (nargin != 2)
-		mexErrMsgTxt("Two input arguments must be provided to this function. See documentation for syntax details.");
+	if (mexcache(nargin, argin)) { return; }
 
-	double* x = mxGetPr(argin[0]);
-	double* y = mxGetPr(argin[1]);
+	if (nargin < 2 || nargin > 4)
+		mexErrMsgTxt("Two to four input arguments must be provided to this function. See documentation for syntax details.");
 
 	int ncc, ncx, nrx, ncy, nry;
 	nrx = mxGetM(argin[0]);
@@ -48,74 +45,55 @@ void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argi
 	if (nrx == 0 || ncx == 0)		{ mexErrMsgTxt("Inputs cannot be empty arrays."); }
 	if (nrx != nry)					{ mexErrMsgTxt("X and Y must contain equivalent length signals."); }
 
-	argout[0] = mxCreateDoubleMatrix(ncc, ncx * ncy, mxREAL);
-	double* cc = mxGetPr(argout[0]);
+	mxClassID class = mxGetClassID(argin[0]);
+	if (class != mxGetClassID(argin[1]))						{ mexErrMsgTxt("X and Y must be of the same class."); }
+	if (class != mxDOUBLE_CLASS && class != mxSINGLE_CLASS)	{ mexErrMsgTxt("X and Y must be arrays of singles or doubles."); }
+
+	// Without a list of lags (or with an empty one), every lag gets computed
+	int haslags = (nargin >= 3 && !mxIsEmpty(argin[2]));
+	int nlags = haslags ? (int)mxGetNumberOfElements(argin[2]) : ncc;
 
-	if (ncx == 1) { xcorr(cc, x, y, nrx); }
-	else if (ncy == 1)
+	int* lags = haslags ? mexlags(argin[2], nrx) : (int*)mxMalloc(nlags * sizeof(int));
+	if (!haslags)
 	{
-		cilk_for (int a = 0; a < ncx; a++)
-		{
-			int idxCC = a * ncc;
-			int idxColX = a * nrx;
-			xcorr(cc + idxCC, x + idxColX, y, nrx);
-		}
+		for (int a = 0; a < nlags; a++)
+			lags[a] = a - (nrx - 1);
 	}
-	else
-	{
-		cilk_for (int a = 0; a < ncy; a++)
-		{
-			int idxColY = a * nry;
-			for (int b = 0; b < ncx; b++)
-			{
-				int idxCC = ncc * (a * ncx + b);
-				int idxColX = b * nrx;
-				xcorr(cc + idxCC, x + idxColX, y + idxColY, nrx);
-			}
-		}
-	}	
-}
 
+	int profiled = mexprofilebegin(nargout, 1);
 
+	ErrorCode status;
+	if (nargin == 4)
+	{
+		if (class != mxDOUBLE_CLASS) { mexErrMsgTxt("Epilogues can only be applied to arrays of doubles."); }
 
-/* SUBROUTINES */
-/// <summary>
-///	Calculates the cross-correlation function between two vectors X and Y.
-/// </summary>
-/// <param name="cc">The cross-correlation coefficient storage vector (LENGTH = 2*nxy - 1) that holds the output of this function.</param>
-/// <param name="x">A vector of data to be cross-correlated with the data in y.</param>
-/// <param name="y">A vector of data to be cross-correlated with the data in X.</param>
-/// <param name="nxy">The number of elements in x and y. Both vectors must be of equivalent length.</param>
-void	xcorr(double cc[], double x[], double y[], int nsamples)
-{
-	int status;
-	VSLCorrTaskPtr task;
-	int ncc = 2 * nsamples - 1;
-	int szdouble = sizeof(double);
-
-	status = vsldCorrNewTask1D(&task, VSL_CORR_MODE_FFT, nsamples, nsamples, ncc);
-	check(status);
-
-	// X & Y are swapped here because VSL outputs coefficients in a reversed order relative to MATLAB's convention. 
-	// Since we are requiring X and Y to have the same sizes, this swap conveniently makes everything consistent again. 
-	status = vsldCorrExec1D(task, y, 1, x, 1, cc, 1);
-	check(status);
-
-	status = vslCorrDeleteTask(&task);
-	check(status);
-
-	// Scale the results to Pearson product-moment correlation coefficients
-	double sumx, sumy;
-	double absx[nsamples], absy[nsamples], sqx[nsamples], sqy[nsamples];
+		Epilogue e;
+		mexepilogue(&e, argin[3], ncx);
+		SignalArray x = signals(mxGetPr(argin[0]), nrx, ncx);
+		SignalArray y = signals(mxGetPr(argin[1]), nry, ncy);
 
-	vdAbs(nsamples, x, absx);
-	vdAbs(nsamples, y, absy);
+		argout[0] = mexepilogueoutput(&e, nlags, ncx, ncy);
+		status = CrossCorrelateLagsEx(mxGetPr(argout[0]), x, y, lags, nlags, &e);
+		mxFree((void*)e.Map);
+	}
+	else if (class == mxSINGLE_CLASS)
+	{
+		SignalArrayF x = signalsf((const float*)mxGetData(argin[0]), nrx, ncx);
+		SignalArrayF y = signalsf((const float*)mxGetData(argin[1]), nry, ncy);
 
-	vdSqr(nsamples, absx, sqx);
-	vdSqr(nsamples, absy, sqy);
+		argout[0] = mxCreateNumericMatrix(nlags, ncx * ncy, mxSINGLE_CLASS, mxREAL);
+		status = CrossCorrelateLagsF((float*)mxGetData(argout[0]), x, y, lags, nlags);
+	}
+	else
+	{
+		SignalArray x = signals(mxGetPr(argin[0]), nrx, ncx);
+		SignalArray y = signals(mxGetPr(argin[1]), nry, ncy);
 
-	sumx = cblas_dasum(nsamples, sqx, 1);
-	sumy = cblas_dasum(nsamples, sqy, 1);
+		argout[0] = mxCreateDoubleMatrix(nlags, ncx * ncy, mxREAL);
+		status = CrossCorrelateLags(mxGetPr(argout[0]), x, y, lags, nlags);
+	}
 
-	cblas_dscal(ncc, 1.0 / sqrt(sumx * sumy), cc, 1);
-}
\ No newline at end of file
+	mxFree(lags);
+	mexprofileend(profiled, nargout, argout, 1);
+	if (status != Success) { mexErrMsgTxt(errormsg(status)); }
+}
@@ -2,12 +2,17 @@
 %
 %	SYNTAX:
 %		cc = MexCrossCorrelate(x, y)
+%		cc = MexCrossCorrelate(x, y, lags)
+%		cc = MexCrossCorrelate(x, y, lags, epilogue)
+%		[cc, profile] = MexCrossCorrelate(...)
+%		MexCrossCorrelate('flush')
 %
 %	OUTPUT:
-%		cc:				[ MC x NC DOUBLES ]
+%		cc:				[ MC x NC DOUBLES or SINGLES ]
 %                       An array of correlation values calculated between the data in X and Y. Each row of this array
 %                       contains Pearson correlation coefficients (i.e. r values) between X and Y at a specific sample
-%                       offset. The total number of offsets present will always follow MC = 2 * M - 1. 
+%                       offset. The total number of offsets present will always follow MC = 2 * M - 1, unless a list of
+%                       LAGS is provided, in which case MC = length(LAGS) and each row corresponds with one element of LAGS.
 %   
 %  						The number of correlation signals NC in this array wil always follow NC = NX * NY in order to hold 
 %  						all possible pairings of signals. Each successive column in CC then represents the correlation at all 
@@ -15,20 +20,61 @@
 %  						in this array therefore corresponds with the correlation between one signal in Y and all signals in 
 %  						X. Successive groupings corresponds with successive signals in Y.
 %
+%                       CC is a single precision array whenever X and Y are. Sums are still accumulated in double precision.
+%
+%                       When an EPILOGUE with a mask is provided, CC is instead an [NR x MC x NY] array, where NR is the
+%                       number of elements in the mask. Each signal in X is then stored in the row of its mask element.
+%
 %	INPUT:
-%		x:				[ M x NX DOUBLES ]
+%		x:				[ M x NX DOUBLES or SINGLES ]
 %                       An array of doubles containing the signal(s) to be cross-correlated with each signal in Y. Each
 %                       column of this array represents a single signal with M time points. The number of signals NX is free
 %                       to vary but must be a positive integer. The number of samples M must always equal M from Y.
 %
-%		y:				[ M x NY DOUBLES ]
+%		y:				[ M x NY DOUBLES or SINGLES ]
 %                       An array of doubles containing the signal(s) to be cross-correlated with each signal in X. Each
 %                       column of this array represents a single signal with M time points. The number of signals NY is free
-%                       to vary but must be a positive integer. The number of samples M must always equal M from X.
+%                       to vary but must be a positive integer. The number of samples M must always equal M from X. The
+%                       class of Y must always match the class of X.
+%
+%	OPTIONAL INPUT:
+%		lags:			[ MC x 1 INTEGERS ]
+%                       A vector of the sample shifts at which cross-correlation values should be computed. Only these lags
+%                       are computed and stored, which saves both time and memory when most lags aren't needed. Every lag
+%                       must be an integer in the range [-(M - 1), M - 1].
+%                       DEFAULT: -(M - 1) : (M - 1)
+%
+%		epilogue:		STRUCT
+%                       Processing that is applied to every correlation coefficient as it is stored, which replaces the
+%                       separate passes over CC that transforming, thresholding or unmasking it would otherwise take. This
+%                       is only available for arrays of doubles. Use [] for LAGS to compute every lag. Every field is
+%                       optional:
+%                           FisherN:	The number of samples N. Coefficients become atanh(r) * sqrt(N - 3).	DEFAULT: 0 (off)
+%                           Threshold:	0 keeps all values, 1 zeros insignificant values and 2 stores 1 for		DEFAULT: 0
+%                                       significant values and 0 for all others.
+%                           Cutoffs:	The finite [LOWER UPPER] cutoffs, in the same units as the stored		DEFAULT: []
+%                                       values. Values at or beyond either one are significant. These are
+%                                       required whenever Threshold isn't 0. Use -realmax or realmax to ignore
+%                                       a tail.
+%                           Mask:		A logical array with one false element for each signal in X. True		DEFAULT: []
+%                                       elements become rows of NaNs in CC.
+%
+%	OPTIONAL OUTPUT:
+%		profile:		STRUCT
+%                       Where the native kernels spent their time during this call: the wall time, the seconds spent in
+%                       each phase (Plan, Prepare, Forward, Spectrum, Inverse, Gather, Direct and Store), the busy time of
+%                       each thread, the bytes and signal pairs processed, and the processor cycles and cache misses where
+%                       hardware counters are available (NaN otherwise). Setting the STATISTICS_PROFILE environment variable
+%                       to a file path also appends every call's profile to that file as one line of JSON.
 %
 %   See also: CCORR, XCORR
 
 %% CHANGELOG
 %   Written by Josh Grooms on 20150131
 %		20150210:	Updated to remove the restrictions on the number of columns in X and Y. These can now freely vary.
-%					Updated the documentation of this function to reflect this chang and to improve clarity.
\ No newline at end of file
+%					Updated the documentation of this function to reflect this chang and to improve clarity.
+%		20261017:	Added an optional list of lags so that only the cross-correlation values that are needed get computed.
+%		20261017:	Added support for single precision inputs, which produce single precision outputs.
+%		20261017:	Added an optional epilogue that transforms, thresholds and unmasks coefficients as they are stored.
+%		20261017:	Added an optional second output that profiles the native kernels.
+%		20261017:	Thresholding epilogues now require finite cutoffs instead of quietly zeroing every coefficient.
\ No newline at end of file
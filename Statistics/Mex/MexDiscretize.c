@@ -0,0 +1,51 @@
+/* MEXDISCRETIZE - Partitions the amplitudes of many signals at once into discrete levels. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#include <math.h>
+#include <matrix.h>
+#include <mex.h>
+#include "../Native/Statistics.h"
+
+
+
+/* MEX FUNCTION */
+void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argin[])
+{
+	if (nargin != 3)
+		mexErrMsgTxt("Three input arguments must be provided to this function. See documentation for syntax details.");
+
+	int nrx = mxGetM(argin[0]);
+	int ncx = mxGetN(argin[0]);
+
+	if (nrx == 0 || ncx == 0)	{ mexErrMsgTxt("X cannot be an empty array."); }
+	if (!mxIsDouble(argin[0]))	{ mexErrMsgTxt("X must be an array of doubles."); }
+
+	int nbins = (int)mxGetScalar(argin[1]);
+	Partition method = (Partition)(int)mxGetScalar(argin[2]);
+	if (method != Distinct && nbins < 1)
+		mexErrMsgTxt("The number of bins must be a positive integer.");
+
+	int* codes = (int*)mxMalloc((size_t)nrx * ncx * sizeof(int));
+	int* levels = (int*)mxMalloc((size_t)ncx * sizeof(int));
+	ErrorCode status = Discretize(codes, levels, signals(mxGetPr(argin[0]), nrx, ncx), nbins, method);
+	if (status != Success) { mexErrMsgTxt(errormsg(status)); }
+
+	// Levels are handed back one-based, with NaNs in place of missing samples
+	argout[0] = mxCreateDoubleMatrix(nrx, ncx, mxREAL);
+	double* y = mxGetPr(argout[0]);
+	for (size_t a = 0; a < (size_t)nrx * ncx; a++)
+		y[a] = (codes[a] < 0) ? NAN : codes[a] + 1;
+
+	if (nargout > 1)
+	{
+		argout[1] = mxCreateDoubleMatrix(1, ncx, mxREAL);
+		for (int a = 0; a < ncx; a++)
+			mxGetPr(argout[1])[a] = levels[a];
+	}
+
+	mxFree(codes);
+	mxFree(levels);
+}
@@ -0,0 +1,37 @@
+% MEXDISCRETIZE - Partitions the amplitudes of many signals at once into discrete levels.
+%
+%	MEXDISCRETIZE bins every signal in its input independently, using a single pass over each signal for equidistant
+%	bins and a single sort of each signal for equiprobable bins or distinct values. Its outputs can be given straight to
+%	MEXENTROPY.
+%
+%	SYNTAX:
+%		y = MexDiscretize(x, nbins, partition)
+%		[y, levels] = MexDiscretize(...)
+%
+%	OUTPUTS:
+%		y:				[ M x NX DOUBLES ]
+%						The level of every sample, which is an integer in [1, LEVELS]. NaNs in X stay NaNs.
+%
+%		levels:			[ 1 x NX DOUBLES ]
+%						The number of levels in each signal. This is NBINS unless PARTITION is 2.
+%
+%	INPUTS:
+%		x:				[ M x NX DOUBLES ]
+%						An array of signals. Each column of this array represents a single signal with M time points.
+%
+%		nbins:			INTEGER
+%						The number of bins to partition each signal into. This is ignored when PARTITION is 2.
+%
+%		partition:		INTEGER
+%						How signals are partitioned.
+%						OPTIONS:
+%							0 - Equidistant bins, whose edges are LINSPACE(MIN(x), MAX(x), NBINS + 1). Each bin holds the
+%								values above its lower edge up to & including its upper one, and the first bin also holds
+%								the minimum.
+%							1 - Equiprobable bins, which each hold about M / NBINS samples. Tied values share the lower bin.
+%							2 - One level per distinct value, numbered in ascending order of value.
+%
+%	See also: DISCRETIZE, MEXENTROPY
+
+%% CHANGELOG
+%	Written by Josh Grooms on 20261017
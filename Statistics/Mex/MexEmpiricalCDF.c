@@ -1,31 +1,25 @@
 /* MEXEMPIRICALCDF - Generates p-values for data using an empirically derived null distribution.
  *
  *	SYNTAX:
- *		p = MexEmpiricalCDF(r, n)
+ *		p = MexEmpiricalCDF(r, n, t)
  *
  *	OUTPUT:
- *		p:		[ N x 1 DOUBLES ]
- *				An array of p-values corresponding with the data in r. This will always be a column vector of
- *				double-precision numbers that is the same length as r (length L). Each p-value in this vector is
- *				associated with the corresponding value in r.
+ *		p:		[ DOUBLES ]
+ *				An array of p-values corresponding with the data in r. This will always be an array of double-precision
+ *				numbers that is the same size as r. Each p-value in this array is associated with the corresponding
+ *				value in r, and NaNs or zeros in r get NaN p-values.
  *
  *	INPUTS:
- *		r:		[ N x 1 DOUBLES ] 
+ *		r:		[ DOUBLES ] 
  *				The real data distribution. This should be the data that will be tested for statistical significance
- *				after conversion to p-values. This must be a column vector of double-precision numbers of length L.
- *				
- *				WARNING:
- *					- NaNs or zeros in this vector must be removed prior to invoking this function.
+ *				after conversion to p-values. This can be an array of double-precision numbers of any size. NaNs and
+ *				zeros are treated as missing data.
  *
- *		n:		[ M x 1 DOUBLES ]
+ *		n:		[ DOUBLES ]
  *				The null data distribution. This should be an empirically derived null data distribution, which is an
  *				estimate of what the data in R would look like if the null hypothesis that is to be tested is in fact
- *				true. Like R, this must be a column vector of double-precision numbers, but the lengths of R and N do
- *				not necessarily have to agree.
- *	
- *				WARNINGS:
- *					- NaNs or zeros in this vector must be removed prior to invoking this function.
- *					- This vector MUST be sorted into ascending order before calling this function.
+ *				true. Like R, this can be an array of double-precision numbers of any size, and the sizes of R and N do
+ *				not have to agree. NaNs and zeros are ignored, and this array does not need to be sorted.
  *
  *		t:		INTEGER
  *				A number code corresponding with the tail of the CDF to be calculated.
@@ -41,20 +35,15 @@
  *		20150205:	Rewrote the p-value generation to rely on null distributions being sorted, which should be faster. 
  *					Updated the documentation accordingly. Also parallelized this function to improve performance.
  *		20150225:	Implemented CDF generation for one-tailed hypothesis testing.
+ *		20261017:	Moved the p-value generation kernel into the native statistics library (Statistics/Native). This file is
+ *					now only responsible for translating between MATLAB arrays and the library's types.
+ *		20261017:	Now takes the data distributions exactly as they are given to EMPIRICALCDF. Removing NaNs & zeros, sorting
+ *					the null distribution and scattering p-values back into the shape of r all happen natively.
  */
 
-#include <cilk\cilk.h>
 #include <matrix.h>
 #include <mex.h>
-
-
-/* DATA */
-typedef enum
-{
-	Both = 0,
-	Left,
-	Right,
-}Tails;
+#include "../Native/Statistics.h"
 
 
 
@@ -67,57 +56,16 @@ typedef enum
 /// <param name="pIn">A pointer to the array of input arguments.</param>
 void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argin[])
 {
-	double *r, *n, *p;
-	int lr, ln;
-	Tails t;
-
-	r = mxGetPr(argin[0]);
-	n = mxGetPr(argin[1]);
-	
-	t = (int)mxGetScalar(argin[2]);
-
-	lr = mxGetM(argin[0]);
-	ln = mxGetM(argin[1]);
-
-	argout[0] = mxCreateDoubleMatrix(lr, 1, mxREAL);
-	p = mxGetPr(argout[0]);
-
-	double sumNull, pval;
-	double invN = 1.0 / ((double)ln);
-
-	switch (t)
-	{
-		case Both:
-			cilk_for (int a = 0; a < lr; a++)
-			{
-				int b = 0;
-				while (n[b] < r[a] && b < ln) { b++; }
-				double pval = (double)b * invN;
-				p[a] = 2.0 * min(pval, 1.0 - pval);
-			}
-			break;
+	if (nargin != 3)									{ mexErrMsgTxt("Three input arguments must be provided to this function. See documentation for syntax details."); }
+	if (!mxIsDouble(argin[0]) || !mxIsDouble(argin[1]))	{ mexErrMsgTxt("R and N must be arrays of doubles."); }
 
-		case Left:
-			cilk_for (int a = 0; a < lr; a++)
-			{
-				int b = 0;
-				while (n[b] < r[a] && b < ln) { b++; }
-				p[a] = (double)b * invN;
-			}
-			break;
+	Tails t = (Tails)(int)mxGetScalar(argin[2]);
 
-		case Right:
-			cilk_for(int a = 0; a < lr; a++)
-			{
-				int b = 0;
-				while (n[b] < r[a] && b < ln) { b++; }
-				p[a] = 1.0 - ((double)b * invN);
-			}
-			break;
+	argout[0] = mxCreateNumericArray(mxGetNumberOfDimensions(argin[0]), mxGetDimensions(argin[0]), mxDOUBLE_CLASS, mxREAL);
 
-		default:
-			mexErrMsgTxt("Unrecognized distribution tail selection. See documentation for available options.");
-			break;
-	}
+	ErrorCode status = EmpiricalCDFRaw(mxGetPr(argout[0]), mxGetPr(argin[0]), mxGetNumberOfElements(argin[0]), mxGetPr(argin[1]), mxGetNumberOfElements(argin[1]), t);
+	if (status == InvalidArgument)
+		mexErrMsgTxt("Unrecognized distribution tail selection. See documentation for available options.");
+	else if (status != Success)
+		mexErrMsgTxt(errormsg(status));
 }
-	
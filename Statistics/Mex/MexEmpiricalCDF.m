@@ -1,31 +1,25 @@
 % MEXEMPIRICALCDF - Generates p-values for data using an empirically derived null distribution.
 %
 %	SYNTAX:
-%		p = MexEmpiricalCDF(r, n)
+%		p = MexEmpiricalCDF(r, n, t)
 %
 %	OUTPUT:
-%		p:		[ L x 1 DOUBLES ]
-%				An array of p-values corresponding with the data in R. This will always be a column vector of
-%				double-precision numbers that is the same length as R (length L). Each p-value in this vector is associated
-%				with the corresponding value in R.
+%		p:		[ DOUBLES ]
+%				An array of p-values corresponding with the data in R. This will always be an array of double-precision
+%				numbers that is the same size as R. Each p-value in this array is associated with the corresponding value
+%				in R, and NaNs or zeros in R get NaN p-values.
 %
 %	INPUTS:
-%		r:		[ L x 1 DOUBLES ] 
+%		r:		[ DOUBLES ] 
 %				The real data distribution. This should be the data that will be tested for statistical significance after
-%				conversion to p-values. This must be a column vector of double-precision numbers of length L. 
+%				conversion to p-values. This can be an array of double-precision numbers of any size. NaNs and zeros are
+%				treated as missing data.
 %
-%				WARNING:
-%					- NaNs or zeros in this vector must be removed prior to invoking this function.
-%
-%		n:		[ M x 1 DOUBLES ]
+%		n:		[ DOUBLES ]
 %				The null data distribution. This should be an empirically derived null data distribution, which is an
 %				estimate of what the data in R would look like if the null hypothesis that is to be tested is in fact true.
-%				Like R, this must be a column vector of double-precision numbers, but the lengths of R and N do not
-%				necessarily have to agree.
-%
-%				WARNINGS:
-%					- NaNs or zeros in this vector must be removed prior to invoking this function.
-%					- This vector MUST be sorted into ascending order before calling this function.
+%				Like R, this can be an array of double-precision numbers of any size, and the sizes of R and N do not have
+%				to agree. NaNs and zeros are ignored, and this array does not need to be sorted.
 %
 %		t:		INTEGER
 %				A number code corresponding with the tail of the CDF to be calculated.
@@ -38,4 +32,5 @@
 %% CHANGELOG
 %	Written by Josh Grooms on 20141121
 %		20150205:	Updated the documentation to reflect changes to the C code made today.
-%		20150225:	Implemented CDF generation for one-tailed hypothesis testing.
\ No newline at end of file
+%		20150225:	Implemented CDF generation for one-tailed hypothesis testing.
+%		20261017:	Updated the documentation to reflect that the data distributions no longer need any preparation.
\ No newline at end of file
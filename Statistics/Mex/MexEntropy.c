@@ -0,0 +1,102 @@
+/* MEXENTROPY - Measures the entropy of discrete signals or the information shared between many pairs of them. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#include <matrix.h>
+#include <mex.h>
+#include "../Native/Statistics.h"
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Numbers the distinct values of every already discretized signal in an array.
+/// </summary>
+/// <remarks>
+/// The codes & levels are allocated here and must be freed by the caller.
+/// </remarks>
+static LevelArray levelarray(const mxArray* x)
+{
+	int nrx = mxGetM(x);
+	int ncx = mxGetN(x);
+	int* codes = (int*)mxMalloc((size_t)nrx * ncx * sizeof(int));
+	int* levels = (int*)mxMalloc((size_t)ncx * sizeof(int));
+
+	ErrorCode status = Discretize(codes, levels, signals(mxGetPr(x), nrx, ncx), 0, Distinct);
+	if (status != Success) { mexErrMsgTxt(errormsg(status)); }
+
+	return discrete(codes, levels, nrx, ncx);
+}
+
+
+
+/* MEX FUNCTION */
+void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argin[])
+{
+	if (nargin != 1 && nargin != 3 && nargin != 4)
+		mexErrMsgTxt("One, three or four input arguments must be provided to this function. See documentation for syntax details.");
+
+	int nrx = mxGetM(argin[0]);
+	int ncx = mxGetN(argin[0]);
+	if (nrx == 0 || ncx == 0)	{ mexErrMsgTxt("X cannot be an empty array."); }
+	if (!mxIsDouble(argin[0]))	{ mexErrMsgTxt("X must be an array of doubles."); }
+
+	LevelArray x = levelarray(argin[0]);
+	ErrorCode status;
+
+	if (nargin == 1)
+	{
+		argout[0] = mxCreateDoubleMatrix(1, ncx, mxREAL);
+		status = Entropy(mxGetPr(argout[0]), x);
+	}
+	else
+	{
+		// An empty Y measures every signal in X against the others, which only takes half as many pairs for symmetric measures
+		LevelArray y = x;
+		if (!mxIsEmpty(argin[1]))
+		{
+			if (mxGetM(argin[1]) != (size_t)nrx)	{ mexErrMsgTxt("X and Y must contain equivalent length signals."); }
+			if (!mxIsDouble(argin[1]))				{ mexErrMsgTxt("Y must be an array of doubles."); }
+			y = levelarray(argin[1]);
+		}
+		int ncy = y.NumSignals;
+
+		Information measure = (Information)(int)mxGetScalar(argin[2]);
+
+		// Pairs arrive as one-based [NP x 2] arrays & are handed over as zero-based (X, Y) index pairs
+		int* pairs = NULL;
+		int npairs = 0;
+		if (nargin == 4 && !mxIsEmpty(argin[3]))
+		{
+			if (mxGetN(argin[3]) != 2 || !mxIsDouble(argin[3]))
+				mexErrMsgTxt("Pairs must be an [NP x 2] array of signal indices.");
+
+			npairs = (int)mxGetM(argin[3]);
+			pairs = (int*)mxMalloc(2 * (size_t)npairs * sizeof(int));
+			const double* p = mxGetPr(argin[3]);
+			for (int a = 0; a < npairs; a++)
+			{
+				pairs[2 * a] = (int)p[a] - 1;
+				pairs[2 * a + 1] = (int)p[a + npairs] - 1;
+				if (pairs[2 * a] < 0 || pairs[2 * a] >= ncx || pairs[2 * a + 1] < 0 || pairs[2 * a + 1] >= ncy)
+					mexErrMsgTxt("Pairs must contain indices of signals in X followed by indices of signals in Y.");
+			}
+		}
+
+		argout[0] = pairs ? mxCreateDoubleMatrix(npairs, 1, mxREAL) : mxCreateDoubleMatrix(ncx, ncy, mxREAL);
+		status = PairwiseInformation(mxGetPr(argout[0]), x, y, pairs, npairs, measure);
+
+		mxFree(pairs);
+		if (y.Codes != x.Codes)
+		{
+			mxFree((void*)y.Codes);
+			mxFree((void*)y.Levels);
+		}
+	}
+
+	mxFree((void*)x.Codes);
+	mxFree((void*)x.Levels);
+	if (status != Success) { mexErrMsgTxt(errormsg(status)); }
+}
@@ -0,0 +1,45 @@
+% MEXENTROPY - Measures the entropy of discrete signals or the information shared between many pairs of them.
+%
+%	MEXENTROPY estimates Shannon entropies in bits from histograms of the values in each signal. Every pair of signals
+%	costs a single pass over its samples, no matter how many distinct values the signals take on, and pairs are measured
+%	in parallel. Every distinct value is its own level, so continuous signals must be discretized first (e.g. with
+%	MEXDISCRETIZE). NaNs are treated as missing samples, and samples missing from either signal of a pair are left out of
+%	that pair.
+%
+%	SYNTAX:
+%		h = MexEntropy(x)
+%		h = MexEntropy(x, y, measure)
+%		h = MexEntropy(x, y, measure, pairs)
+%
+%	OUTPUT:
+%		h:				[ 1 x NX DOUBLES ] or [ NX x NY DOUBLES ] or [ NP x 1 DOUBLES ]
+%						The marginal entropy of every signal in X when only X is given. Otherwise, the requested measure
+%						between every signal in X (rows) & every signal in Y (columns), or between each listed pair.
+%
+%	INPUTS:
+%		x:				[ M x NX DOUBLES ]
+%						An array of discrete signals. Each column of this array represents a single signal with M time
+%						points.
+%
+%	OPTIONAL INPUTS:
+%		y:				[ M x NY DOUBLES ]
+%						A second array of discrete signals. The number of time points M must always equal M from X. Use []
+%						to measure every signal in X against every other one, which is twice as fast for symmetric
+%						measures.
+%
+%		measure:		INTEGER
+%						The quantity to measure.
+%						OPTIONS:
+%							0 - Joint entropy H(X,Y).
+%							1 - Conditional entropy H(X|Y).
+%							2 - Mutual information I(X;Y).
+%
+%		pairs:			[ NP x 2 INTEGERS ]
+%						The pairs of signals to measure. Each row holds the index of a signal in X followed by the index
+%						of a signal in Y.
+%						DEFAULT: [] (every signal in X with every signal in Y)
+%
+%	See also: ENTROPY, MEXDISCRETIZE
+
+%% CHANGELOG
+%	Written by Josh Grooms on 20261017
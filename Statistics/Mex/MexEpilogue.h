@@ -0,0 +1,97 @@
+/* MEXEPILOGUE - Translates MATLAB epilogue structures into the native library's Epilogue type.
+ *
+ *	An epilogue structure may contain any of the following fields. Missing fields keep their defaults.
+ *		FisherN:	The number of samples used to Fisher transform coefficients, or 0 to leave them alone.		DEFAULT: 0
+ *		Threshold:	0 to keep all values, 1 to zero insignificant ones or 2 to store significance as 1 or 0.	DEFAULT: 0
+ *		Cutoffs:	The finite [LOWER UPPER] significance cutoffs, in the same units as the stored values. These are
+ *					required whenever Threshold isn't 0. Use -realmax or realmax to ignore a tail.					DEFAULT: []
+ *		Mask:		A logical array with one element per output row, where true marks rows that have no signal.	DEFAULT: []
+ *					Signals in X are scattered into the false rows in order, and the true rows are filled with NaN.
+ */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Thresholding without finite, ordered cutoffs is now an error instead of silently zeroing every value.
+ */
+
+#pragma once
+#ifndef MEXEPILOGUE_H
+#define MEXEPILOGUE_H
+
+#include <math.h>
+#include <matrix.h>
+#include <mex.h>
+#include "../Native/Statistics.h"
+
+
+
+/* FUNCTIONS */
+/// <summary>
+/// Reads an epilogue structure from MATLAB.
+/// </summary>
+/// <param name="e">Receives the epilogue. Its map is allocated with mxMalloc and must be released with mxFree.</param>
+/// <param name="s">The MATLAB structure.</param>
+/// <param name="ncx">The number of signals in X, which must equal the number of false elements in the mask.</param>
+static void mexepilogue(Epilogue* e, const mxArray* s, int ncx)
+{
+	e->FisherN = 0;
+	e->Threshold = KeepAll;
+	e->Cutoffs[0] = e->Cutoffs[1] = NAN;
+	e->Map = NULL;
+	e->NumRows = 0;
+	e->Fill = NAN;
+
+	if (!mxIsStruct(s)) { mexErrMsgTxt("Epilogues must be structures."); }
+
+	const mxArray* field;
+	if ((field = mxGetField(s, 0, "FisherN")) != NULL)
+		e->FisherN = mxGetScalar(field);
+	if ((field = mxGetField(s, 0, "Threshold")) != NULL)
+		e->Threshold = (Thresholding)(int)mxGetScalar(field);
+	if ((field = mxGetField(s, 0, "Cutoffs")) != NULL)
+	{
+		if (!mxIsDouble(field) || mxGetNumberOfElements(field) != 2)
+			mexErrMsgTxt("Epilogue cutoffs must be a two-element vector of doubles.");
+		e->Cutoffs[0] = mxGetPr(field)[0];
+		e->Cutoffs[1] = mxGetPr(field)[1];
+	}
+	if (e->Threshold != KeepAll && !(isfinite(e->Cutoffs[0]) && isfinite(e->Cutoffs[1]) && e->Cutoffs[0] <= e->Cutoffs[1]))
+		mexErrMsgTxt("Thresholding epilogues need finite [LOWER UPPER] cutoffs with LOWER no greater than UPPER.");
+
+	if ((field = mxGetField(s, 0, "Mask")) != NULL && !mxIsEmpty(field))
+	{
+		if (!mxIsLogical(field)) { mexErrMsgTxt("Epilogue masks must be logical arrays."); }
+
+		size_t nrows = mxGetNumberOfElements(field);
+		const mxLogical* mask = mxGetLogicals(field);
+		size_t* map = (size_t*)mxMalloc(((size_t)ncx + 1) * sizeof(size_t));
+
+		size_t count = 0;
+		for (size_t a = 0; a < nrows; a++)
+		{
+			if (mask[a]) { continue; }
+			if (count == (size_t)ncx) { mexErrMsgTxt("Epilogue masks must contain exactly one false element for every signal in X."); }
+			map[count++] = a;
+		}
+		if (count != (size_t)ncx)
+			mexErrMsgTxt("Epilogue masks must contain exactly one false element for every signal in X.");
+
+		e->Map = map;
+		e->NumRows = nrows;
+	}
+}
+/// <summary>
+/// Creates the output array that a kernel running an epilogue writes into.
+/// </summary>
+static mxArray* mexepilogueoutput(const Epilogue* e, int nlags, int ncx, int ncy)
+{
+	if (!e->Map)
+		return mxCreateDoubleMatrix(nlags, (size_t)ncx * ncy, mxREAL);
+
+	mwSize dims[3] = { e->NumRows, (mwSize)nlags, (mwSize)ncy };
+	return mxCreateNumericArray(3, dims, mxDOUBLE_CLASS, mxREAL);
+}
+
+
+
+#endif
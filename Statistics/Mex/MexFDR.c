@@ -0,0 +1,23 @@
+/* MEXFDR - Calculates a FWER-corrected p-value cutoff using Benjamini-Hochberg control of the false discovery rate. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#include <mex.h>
+#include "../Native/Statistics.h"
+
+
+
+/* MEX FUNCTION */
+void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argin[])
+{
+	if (nargin != 2)				{ mexErrMsgTxt("Two input arguments must be provided to this function. See documentation for syntax details."); }
+	if (!mxIsDouble(argin[0]))		{ mexErrMsgTxt("P-values must be provided as an array of doubles."); }
+
+	double cutoff;
+	ErrorCode status = FDR(&cutoff, mxGetPr(argin[0]), mxGetNumberOfElements(argin[0]), mxGetScalar(argin[1]));
+	if (status != Success) { mexErrMsgTxt(errormsg(status)); }
+
+	argout[0] = mxCreateDoubleScalar(cutoff);
+}
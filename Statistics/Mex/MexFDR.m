@@ -0,0 +1,21 @@
+% MEXFDR - Calculates a FWER-corrected p-value cutoff using Benjamini-Hochberg control of the false discovery rate.
+%
+%	SYNTAX:
+%		cutoff = MexFDR(p, alpha)
+%
+%	OUTPUT:
+%		cutoff:		DOUBLE
+%					The p-value at or below which results are considered statistically significant, or NaN if no
+%					significance is found.
+%
+%	INPUTS:
+%		p:			[ DOUBLES ]
+%					An array of p-values of any size and shape. These do not need to be sorted.
+%
+%		alpha:		DOUBLE
+%					The false discovery rate to be controlled, which must be in (0, 1).
+%
+%	See also: FDR, MEXSGOF, MEXTHRESHOLD
+
+%% CHANGELOG
+%	Written by Josh Grooms on 20261017
@@ -0,0 +1,37 @@
+/* MEXFILTER - Filters many signals at once with an FIR filter, with or without phase distortion. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Transform plans & workspaces are now kept between calls. Call with 'flush' to release them.
+ */
+
+#include <matrix.h>
+#include <mex.h>
+#include "../Native/Statistics.h"
+#include "MexCache.h"
+
+
+
+/* MEX FUNCTION */
+void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argin[])
+{
+	if (mexcache(nargin, argin)) { return; }
+
+	if (nargin != 3)
+		mexErrMsgTxt("Three input arguments must be provided to this function. See documentation for syntax details.");
+
+	int nrx = mxGetM(argin[0]);
+	int ncx = mxGetN(argin[0]);
+	int ntaps = (int)mxGetNumberOfElements(argin[1]);
+
+	if (nrx == 0 || ncx == 0 || ntaps == 0)				{ mexErrMsgTxt("Inputs cannot be empty arrays."); }
+	if (!mxIsDouble(argin[0]) || !mxIsDouble(argin[1]))	{ mexErrMsgTxt("X and B must be arrays of doubles."); }
+
+	int zerophase = (mxGetScalar(argin[2]) != 0);
+	if (zerophase && nrx <= 3 * (ntaps - 1))
+		mexErrMsgTxt("Signals must be more than three times as long as the filter for zero-phase filtering.");
+
+	argout[0] = mxCreateDoubleMatrix(nrx, ncx, mxREAL);
+	ErrorCode status = FIRFilter(mxGetPr(argout[0]), signals(mxGetPr(argin[0]), nrx, ncx), mxGetPr(argin[1]), ntaps, zerophase);
+	if (status != Success) { mexErrMsgTxt(errormsg(status)); }
+}
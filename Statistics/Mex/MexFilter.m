@@ -0,0 +1,31 @@
+% MEXFILTER - Filters many signals at once with an FIR filter, with or without phase distortion.
+%
+%	MEXFILTER is a drop-in replacement for FILTER(B, 1, X) and FILTFILT(B, 1, X) when X is an array of signals in its
+%	columns. Filters with many taps are applied by FFT overlap-save convolution, and signals are filtered in parallel, so
+%	filters that are tens of thousands of taps long cost about as much as short ones.
+%
+%	SYNTAX:
+%		y = MexFilter(x, b, zerophase)
+%		MexFilter('flush')
+%
+%	OUTPUT:
+%		y:				[ M x NX DOUBLES ]
+%						The filtered signals. Without zero-phase filtering, these are delayed by (NB - 1) / 2 samples
+%						exactly as they would be by FILTER, and any cropping of that delay is still up to the caller.
+%
+%	INPUTS:
+%		x:				[ M x NX DOUBLES ]
+%						An array of signals. Each column of this array represents a single signal with M time points.
+%
+%		b:				[ NB x 1 DOUBLES ]
+%						The FIR filter coefficients (e.g. from FIR1).
+%
+%		zerophase:		BOOLEAN
+%						Whether to filter forward and backward like FILTFILT does, which cancels the phase delay of the
+%						filter. Signals are then extended at both ends by reflections of 3 * (NB - 1) samples, so M must be
+%						larger than that.
+%
+%	See also: FILTER, FILTFILT, FIR1
+
+%% CHANGELOG
+%	Written by Josh Grooms on 20261017
@@ -0,0 +1,37 @@
+/* MEXFRAMECORRELATE - Computes the spatial correlation between every pair of frames in one or two imaging data series. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#include <matrix.h>
+#include <mex.h>
+#include "../Native/Statistics.h"
+#include "MexFrames.h"
+
+
+
+/* MEX FUNCTION */
+void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argin[])
+{
+	if (nargin < 1 || nargin > 3)
+		mexErrMsgTxt("One to three input arguments must be provided to this function. See documentation for syntax details.");
+
+	FrameArray x = mexframes(argin[0]);
+	FrameArray y = (nargin > 1 && !mxIsEmpty(argin[1])) ? mexframes(argin[1]) : x;
+
+	if (x.NumVoxels == 0 || x.NumFrames == 0 || y.NumFrames == 0)	{ mexErrMsgTxt("Inputs cannot be empty arrays."); }
+	if (x.NumVoxels != y.NumVoxels)									{ mexErrMsgTxt("Volumes in X and Y must contain the same number of voxels."); }
+
+	const uint8_t* mask = NULL;
+	if (nargin == 3 && !mxIsEmpty(argin[2]))
+	{
+		if (!mxIsLogical(argin[2]) || mxGetNumberOfElements(argin[2]) != x.NumVoxels)
+			mexErrMsgTxt("The mask must be a logical array with one element per voxel.");
+		mask = (const uint8_t*)mxGetLogicals(argin[2]);
+	}
+
+	argout[0] = mxCreateDoubleMatrix(x.NumFrames, y.NumFrames, mxREAL);
+	ErrorCode status = FrameCorrelate(mxGetPr(argout[0]), x, y, mask);
+	if (status != Success) { mexErrMsgTxt(errormsg(status)); }
+}
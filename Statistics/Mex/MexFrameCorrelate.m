@@ -0,0 +1,34 @@
+% MEXFRAMECORRELATE - Computes the spatial correlation between every pair of frames in one or two imaging data series.
+%
+%	MEXFRAMECORRELATE treats the voxels of two volumes as paired samples, exactly as CORR3 does, but correlates every
+%	volume of a 4-D series with every volume of another (or the same) series in one call. Inputs of any real numeric class
+%	are read in place and are never converted to double precision in full, so whole BOLD runs stored as INT16 or SINGLE
+%	arrays can be compared without making copies of them.
+%
+%	SYNTAX:
+%		r = MexFrameCorrelate(x)
+%		r = MexFrameCorrelate(x, y)
+%		r = MexFrameCorrelate(x, y, mask)
+%
+%	OUTPUT:
+%		r:				[ TX x TY DOUBLES ]
+%						The spatial correlation coefficient between every frame of X (rows) and every frame of Y (columns).
+%
+%	INPUTS:
+%		x:				[ X x Y x Z x TX NUMERICS ]
+%						A series of volumes, indexed by the fourth dimension. A 3-D array is a series of one volume.
+%
+%	OPTIONAL INPUTS:
+%		y:				[ X x Y x Z x TY NUMERICS ]
+%						A second series of volumes with the same number of voxels as X, which may be of a different class.
+%						DEFAULT: [] (every frame of X with every other frame of X)
+%
+%		mask:			[ X x Y x Z LOGICALS ]
+%						The voxels to include in every coefficient, such as a brain mask. Voxels that are NaN or infinite in
+%						any frame of X or Y are always left out.
+%						DEFAULT: [] (every voxel)
+%
+%	See also: CORR3
+
+%% CHANGELOG
+%	Written by Josh Grooms on 20261017
@@ -0,0 +1,61 @@
+/* MEXFRAMES - Describes MATLAB arrays of any real numeric class to the native library without copying them. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#pragma once
+#ifndef MEXFRAMES_H
+#define MEXFRAMES_H
+
+#include <matrix.h>
+#include <mex.h>
+#include "../Native/Statistics.h"
+
+
+
+/* FUNCTIONS */
+/// <summary>
+/// Gets the native type of the elements of a real, floating point or 8, 16 or 32-bit integer MATLAB array.
+/// </summary>
+static Precision mexprecision(const mxArray* x)
+{
+	if (mxIsComplex(x))
+		mexErrMsgTxt("Arrays must be real arrays of a floating point or 8, 16 or 32-bit integer class.");
+
+	switch (mxGetClassID(x))
+	{
+		case mxDOUBLE_CLASS:	return DoublePrecision;
+		case mxSINGLE_CLASS:	return SinglePrecision;
+		case mxINT8_CLASS:		return Int8Precision;
+		case mxUINT8_CLASS:		return UInt8Precision;
+		case mxINT16_CLASS:		return Int16Precision;
+		case mxUINT16_CLASS:	return UInt16Precision;
+		case mxINT32_CLASS:		return Int32Precision;
+		case mxUINT32_CLASS:	return UInt32Precision;
+		default:
+			mexErrMsgTxt("Arrays must be real arrays of a floating point or 8, 16 or 32-bit integer class.");
+			return DoublePrecision;
+	}
+}
+/// <summary>
+/// Describes a 3-D volume or a 4-D series of volumes as a series of frames, which are indexed by the fourth dimension.
+/// </summary>
+static FrameArray mexframes(const mxArray* x)
+{
+	if (mxGetNumberOfDimensions(x) > 4)
+		mexErrMsgTxt("Volume arrays cannot have more than four dimensions.");
+
+	// A lone volume is a series of one frame
+	FrameArray f;
+	const mwSize* dims = mxGetDimensions(x);
+	f.Data = mxGetData(x);
+	f.Class = mexprecision(x);
+	f.NumFrames = (mxGetNumberOfDimensions(x) == 4) ? (int)dims[3] : 1;
+	f.NumVoxels = f.NumFrames ? mxGetNumberOfElements(x) / f.NumFrames : 0;
+	return f;
+}
+
+
+
+#endif
@@ -0,0 +1,45 @@
+/* MEXLAGS - Reads the lists of sample lags that MEX functions take from MATLAB. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#pragma once
+#ifndef MEXLAGS_H
+#define MEXLAGS_H
+
+#include <math.h>
+#include <matrix.h>
+#include <mex.h>
+
+
+
+/* FUNCTIONS */
+/// <summary>
+/// Converts a MATLAB array of lags into integers, raising an error unless every one of them is a valid lag.
+/// </summary>
+/// <param name="lags">A real array of doubles holding whole numbers in the range [-(M - 1), M - 1].</param>
+/// <param name="nsamples">The number of samples M in the signals being correlated.</param>
+/// <returns>The mxGetNumberOfElements(lags) lags, which must be freed using mxFree.</returns>
+static int* mexlags(const mxArray* lags, int nsamples)
+{
+	if (!mxIsDouble(lags) || mxIsComplex(lags))
+		mexErrMsgIdAndTxt("Statistics:InvalidLags", "Lags must be an array of real doubles.");
+
+	size_t nlags = mxGetNumberOfElements(lags);
+	const double* values = mxGetPr(lags);
+	int* out = (int*)mxMalloc((nlags ? nlags : 1) * sizeof(int));
+	for (size_t a = 0; a < nlags; a++)
+	{
+		// NaNs fail the first comparison & infinities fail the range check
+		double lag = values[a];
+		if (lag != floor(lag) || lag <= -nsamples || lag >= nsamples)
+			mexErrMsgIdAndTxt("Statistics:InvalidLags", "Lags must be integers in the range [-(M - 1), M - 1].");
+		out[a] = (int)lag;
+	}
+	return out;
+}
+
+
+
+#endif
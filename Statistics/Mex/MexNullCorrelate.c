@@ -0,0 +1,80 @@
+/* MEXNULLCORRELATE - Builds a sorted null distribution of correlation coefficients from surrogate signals. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Transform plans & workspaces are now kept between calls. Call with 'flush' to release them.
+ *		20261017:	Every argument is now checked before the output is allocated, so bad calls can't attempt huge allocations.
+ */
+
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <mex.h>
+#include "../Native/Statistics.h"
+#include "MexCache.h"
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Reads a whole number out of a real numeric scalar, raising an error unless it falls within a range.
+/// </summary>
+/// <param name="msg">The error message to raise if the argument isn't valid.</param>
+static double mexwhole(const mxArray* arg, double lo, double hi, const char* msg)
+{
+	if (!mxIsNumeric(arg) || mxIsComplex(arg) || mxGetNumberOfElements(arg) != 1) { mexErrMsgTxt(msg); }
+
+	// NaNs fail the first comparison & infinities fail the range check
+	double value = mxGetScalar(arg);
+	if (value != floor(value) || value < lo || value > hi) { mexErrMsgTxt(msg); }
+	return value;
+}
+
+
+
+/* MEX FUNCTION */
+void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argin[])
+{
+	if (mexcache(nargin, argin)) { return; }
+
+	if (nargin != 5 && nargin != 6)
+		mexErrMsgTxt("Five or six input arguments must be provided to this function. See documentation for syntax details.");
+
+	int ncx, ncy, nrx, nry;
+	nrx = mxGetM(argin[0]);
+	ncx = mxGetN(argin[0]);
+	nry = mxGetM(argin[1]);
+	ncy = mxGetN(argin[1]);
+
+	if (nrx == 0 || nry == 0 || ncx == 0 || ncy == 0)	{ mexErrMsgTxt("Inputs cannot be empty arrays."); }
+	if (nrx != nry)										{ mexErrMsgTxt("X and Y must contain equivalent length signals."); }
+	if (!mxIsDouble(argin[0]) || !mxIsDouble(argin[1]))	{ mexErrMsgTxt("X and Y must be arrays of doubles."); }
+
+	if (nrx < 2)										{ mexErrMsgTxt("Signals must have at least two samples."); }
+
+	Surrogate method = (Surrogate)(int)mexwhole(argin[2], CircularShift, BlockPermute, "The method must be 0, 1 or 2.");
+	int nsurrogates = (int)mexwhole(argin[3], 1, INT_MAX, "The number of surrogates must be a positive integer.");
+	uint64_t seed = (uint64_t)mexwhole(argin[4], 0, 18446744073709549568.0, "The seed must be a non-negative integer below 2^64.");
+	int blocksize = 0;
+	if (method == BlockPermute)
+	{
+		if (nargin != 6) { mexErrMsgTxt("Block permutation needs a block size."); }
+		blocksize = (int)mexwhole(argin[5], 1, nrx - 1, "The block size must be an integer in the range [1, M - 1].");
+	}
+
+	// The output holds every coefficient before NaNs and zeros are dropped, so it has to be addressable
+	size_t npairs = (size_t)ncx * (size_t)ncy;
+	if ((size_t)nsurrogates > SIZE_MAX / sizeof(double) / npairs)
+		mexErrMsgTxt("The null distribution would be too large to allocate. Use fewer surrogates or signals.");
+
+	SignalArray x = signals(mxGetPr(argin[0]), nrx, ncx);
+	SignalArray y = signals(mxGetPr(argin[1]), nry, ncy);
+
+	// The distribution shrinks by however many NaNs and zeros it contained
+	size_t nnull;
+	argout[0] = mxCreateDoubleMatrix((size_t)nsurrogates * npairs, 1, mxREAL);
+	ErrorCode status = NullCorrelate(mxGetPr(argout[0]), &nnull, x, y, method, nsurrogates, blocksize, seed);
+	if (status != Success) { mexErrMsgTxt(errormsg(status)); }
+
+	mxSetM(argout[0], nnull);
+}
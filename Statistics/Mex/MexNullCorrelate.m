@@ -0,0 +1,45 @@
+% MEXNULLCORRELATE - Builds a sorted null distribution of correlation coefficients from surrogate signals.
+%
+%	SYNTAX:
+%		n = MexNullCorrelate(x, y, method, nsurrogates, seed)
+%		n = MexNullCorrelate(x, y, method, nsurrogates, seed, blocksize)
+%		MexNullCorrelate('flush')
+%
+%	OUTPUT:
+%		n:				[ L x 1 DOUBLES ]
+%						The null distribution of correlation coefficients between surrogates of the signals in X and the
+%						signals in Y. This vector is sorted into ascending order and has had all NaNs and zeros removed, so
+%						it can be passed directly to MEXEMPIRICALCDF. Its length L is at most NSURROGATES * NX * NY.
+%
+%	INPUTS:
+%		x:				[ M x NX DOUBLES ]
+%						An array of signals from which surrogates are generated. Each surrogate data set applies the same
+%						random transformation to every signal in X, so relationships between signals in X are preserved.
+%
+%		y:				[ M x NY DOUBLES ]
+%						An array of signals that the surrogates are correlated with. The number of samples M must always
+%						equal M from X.
+%
+%		method:			INTEGER
+%						A number code corresponding with the method used to generate surrogate signals.
+%
+%						OPTIONS:
+%							0 - Circular time shifts by a random number of samples
+%							1 - Phase randomization, which preserves power spectra
+%							2 - Block permutation, which shuffles the order of BLOCKSIZE sample blocks
+%
+%		nsurrogates:	INTEGER
+%						The number of surrogate data sets to generate.
+%
+%		seed:			INTEGER
+%						The seed for the random number generators. The same seed always produces the same distribution,
+%						regardless of how many threads are used.
+%
+%	OPTIONAL INPUT:
+%		blocksize:		INTEGER
+%						The number of samples in each block when using block permutation. This must be in [1, M - 1].
+%
+%	See also: EMPIRICALCDF, MEXEMPIRICALCDF, NULLCORR
+
+%% CHANGELOG
+%	Written by Josh Grooms on 20261017
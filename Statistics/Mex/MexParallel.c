@@ -0,0 +1,45 @@
+/* MEXPARALLEL - Gets or sets the scheduler settings & memory budget that the native kernels run with. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Added the memory budget, which is shared by every MEX function just like the scheduler settings.
+ */
+
+#include <matrix.h>
+#include <mex.h>
+#include "../Native/Statistics.h"
+
+
+
+/* MEX FUNCTION */
+void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argin[])
+{
+	if (nargin > 4) { mexErrMsgTxt("Up to four input arguments may be provided to this function. See documentation for syntax details."); }
+
+	// Empty arguments leave their setting alone
+	ErrorCode status = Success;
+	if (nargin > 0 && !mxIsEmpty(argin[0]))
+		status = SetThreads((int)mxGetScalar(argin[0]));
+	if (status == Success && nargin > 1 && !mxIsEmpty(argin[1]))
+		status = SetAffinity((Affinity)(int)mxGetScalar(argin[1]));
+	if (status == Success && nargin > 2 && !mxIsEmpty(argin[2]))
+	{
+		double grain = mxGetScalar(argin[2]);
+		if (grain < 0) { mexErrMsgTxt("The grain size cannot be negative."); }
+		SetGrainSize((size_t)grain);
+	}
+	if (status == Success && nargin > 3 && !mxIsEmpty(argin[3]))
+	{
+		double budget = mxGetScalar(argin[3]);
+		if (!(budget >= 0)) { mexErrMsgTxt("The memory budget cannot be negative."); }
+		SetMemoryBudget((size_t)budget);
+	}
+	if (status != Success) { mexErrMsgTxt(errormsg(status)); }
+
+	const char* names[] = { "Threads", "Affinity", "GrainSize", "MemoryBudget" };
+	argout[0] = mxCreateStructMatrix(1, 1, 4, names);
+	mxSetField(argout[0], 0, names[0], mxCreateDoubleScalar((double)GetThreads()));
+	mxSetField(argout[0], 0, names[1], mxCreateDoubleScalar((double)GetAffinity()));
+	mxSetField(argout[0], 0, names[2], mxCreateDoubleScalar((double)GetGrainSize()));
+	mxSetField(argout[0], 0, names[3], mxCreateDoubleScalar((double)GetMemoryBudget()));
+}
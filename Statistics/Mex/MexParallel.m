@@ -0,0 +1,46 @@
+% MEXPARALLEL - Gets or sets the scheduler settings & memory budget that the native kernels run with.
+%
+%	MEXPARALLEL controls the scheduler that every MEX function in this folder shares. Settings persist for the rest of the
+%	MATLAB session and apply to every MEX function, since they all link the same shared copy of the native library.
+%
+%	SYNTAX:
+%		s = MexParallel()
+%		s = MexParallel(threads)
+%		s = MexParallel(threads, affinity)
+%		s = MexParallel(threads, affinity, grain)
+%		s = MexParallel(threads, affinity, grain, budget)
+%
+%	OUTPUT:
+%		s:				STRUCT
+%						The settings in effect after this call, in fields Threads, Affinity, GrainSize and MemoryBudget.
+%
+%	OPTIONAL INPUTS:
+%		threads:		INTEGER
+%						The number of threads that kernels run on, or 0 to use every processor.
+%						DEFAULT: [] (leave the thread count alone)
+%
+%		affinity:		INTEGER
+%						How worker threads are pinned to processors. MATLAB's own thread is never pinned. Pinning is only
+%						supported on Linux & Windows.
+%						OPTIONS:
+%							0 - Unpinned (the operating system moves threads between processors)
+%							1 - Compact (successive threads on successive processors)
+%							2 - Spread (threads as far apart as possible, across cores & NUMA nodes)
+%						DEFAULT: [] (leave the affinity alone)
+%
+%		grain:			INTEGER
+%						The number of iterations that a thread takes from its queue at once in kernels that split their work
+%						through the work-stealing scheduler (e.g. correlations between a few long signals), or 0 to size
+%						grains automatically. This can also be set through the STATISTICS_GRAIN environment variable.
+%						DEFAULT: [] (leave the grain size alone)
+%
+%		budget:			INTEGER
+%						The approximate number of bytes of scratch memory that a single kernel call may use. Kernels that
+%						cache intermediate results (e.g. the spectra used by cross-correlation) work in batches that fit
+%						within this budget. The budget starts out at 512 MB.
+%						DEFAULT: [] (leave the memory budget alone)
+%
+%	See also: MAXNUMCOMPTHREADS
+
+%% CHANGELOG
+%	Written by Josh Grooms on 20261017
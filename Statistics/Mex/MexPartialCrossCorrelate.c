@@ -0,0 +1,77 @@
+/* MEXPARTIALCROSSCORRELATE - Cross-correlates two sets of signals after regressing nuisance signals out of each. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Added an optional sixth argument that describes an epilogue (see MexEpilogue.h).
+ *		20261017:	Transform plans & workspaces are now kept between calls. Call with 'flush' to release them.
+ *		20261017:	Lags are now checked to be real, whole numbers of the right class before they are used.
+ */
+
+#include <matrix.h>
+#include <mex.h>
+#include "../Native/Statistics.h"
+#include "MexCache.h"
+#include "MexEpilogue.h"
+#include "MexLags.h"
+
+
+
+/* MEX FUNCTION */
+void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argin[])
+{
+	if (mexcache(nargin, argin)) { return; }
+
+	if (nargin != 5 && nargin != 6)
+		mexErrMsgTxt("Five or six input arguments must be provided to this function. See documentation for syntax details.");
+
+	for (int a = 0; a < 5; a++)
+	{
+		if (!mxIsDouble(argin[a]) && !mxIsEmpty(argin[a]))
+			mexErrMsgTxt("All inputs must be arrays of doubles.");
+	}
+
+	int ncx, nrx, ncy, nry;
+	nrx = mxGetM(argin[0]);
+	ncx = mxGetN(argin[0]);
+	nry = mxGetM(argin[2]);
+	ncy = mxGetN(argin[2]);
+
+	if (nrx == 0 || ncx == 0 || ncy == 0)	{ mexErrMsgTxt("X and Y cannot be empty arrays."); }
+	if (nrx != nry)							{ mexErrMsgTxt("X and Y must contain equivalent length signals."); }
+	if ((!mxIsEmpty(argin[1]) && (int)mxGetM(argin[1]) != nrx) || (!mxIsEmpty(argin[3]) && (int)mxGetM(argin[3]) != nry))
+		mexErrMsgTxt("Nuisance signals must contain the same number of samples as the signals they are regressed from.");
+
+	int nlags = (int)mxGetNumberOfElements(argin[4]);
+	if (nlags == 0) { mexErrMsgTxt("The list of lags cannot be empty."); }
+
+	int* lags = mexlags(argin[4], nrx);
+
+	Epilogue e;
+	if (nargin == 6) { mexepilogue(&e, argin[5], ncx); }
+
+	// Each set of nuisance signals is factorized exactly once, no matter how many signals it gets regressed from
+	Nuisance qx = { 0 }, qy = { 0 };
+	int hasqx = !mxIsEmpty(argin[1]);
+	int hasqy = !mxIsEmpty(argin[3]);
+
+	ErrorCode status = Success;
+	if (hasqx)
+		status = FactorNuisance(&qx, signals(mxGetPr(argin[1]), mxGetM(argin[1]), mxGetN(argin[1])));
+	if (hasqy && status == Success)
+		status = FactorNuisance(&qy, signals(mxGetPr(argin[3]), mxGetM(argin[3]), mxGetN(argin[3])));
+
+	if (status == Success)
+	{
+		SignalArray x = signals(mxGetPr(argin[0]), nrx, ncx);
+		SignalArray y = signals(mxGetPr(argin[2]), nry, ncy);
+
+		argout[0] = (nargin == 6) ? mexepilogueoutput(&e, nlags, ncx, ncy) : mxCreateDoubleMatrix(nlags, ncx * ncy, mxREAL);
+		status = PartialCrossCorrelateLags(mxGetPr(argout[0]), x, hasqx ? &qx : NULL, y, hasqy ? &qy : NULL, lags, nlags, (nargin == 6) ? &e : NULL);
+	}
+
+	if (nargin == 6) { mxFree((void*)e.Map); }
+	FreeNuisance(&qx);
+	FreeNuisance(&qy);
+	mxFree(lags);
+	if (status != Success) { mexErrMsgTxt(errormsg(status)); }
+}
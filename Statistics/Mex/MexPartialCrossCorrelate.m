@@ -0,0 +1,43 @@
+% MEXPARTIALCROSSCORRELATE - Cross-correlates two sets of signals after regressing nuisance signals out of each.
+%
+%	SYNTAX:
+%		cc = MexPartialCrossCorrelate(x, zx, y, zy, lags)
+%		cc = MexPartialCrossCorrelate(x, zx, y, zy, lags, epilogue)
+%		MexPartialCrossCorrelate('flush')
+%
+%	OUTPUT:
+%		cc:				[ MC x NC DOUBLES ]
+%						An array of partial correlation coefficients between the residuals of X and Y. Each row of this array
+%						corresponds with one element of LAGS. Columns are arranged exactly as they are in the output of
+%						MEXCROSSCORRELATE, so NC = NX * NY and each contiguous group of NX columns corresponds with one
+%						signal in Y. With an EPILOGUE that contains a mask, CC is an [NR x MC x NY] array instead.
+%
+%	INPUTS:
+%		x:				[ M x NX DOUBLES ]
+%						An array of signals. Each column of this array represents a single signal with M time points.
+%
+%		zx:				[ M x KX DOUBLES ]
+%						The nuisance signals to regress out of X, which should include a column of ones to control for
+%						signal means. These are factorized once, and the residuals of X are never returned to MATLAB. Use []
+%						to cross-correlate X as it is.
+%
+%		y:				[ M x NY DOUBLES ]
+%						A second array of signals. The number of samples M must always equal M from X.
+%
+%		zy:				[ M x KY DOUBLES ]
+%						The nuisance signals to regress out of Y, or [] to cross-correlate Y as it is.
+%
+%		lags:			[ MC x 1 INTEGERS ]
+%						A vector of the sample shifts at which partial correlation values should be computed. Every lag must
+%						be an integer in the range [-(M - 1), M - 1].
+%
+%	OPTIONAL INPUT:
+%		epilogue:		STRUCT
+%						Processing that is applied to every coefficient as it is stored. This takes the same fields as the
+%						epilogue of MEXCROSSCORRELATE.
+%
+%	See also: MEXCROSSCORRELATE, PARTIALCORR
+
+%% CHANGELOG
+%	Written by Josh Grooms on 20261017
+%		20261017:	Added an optional epilogue that transforms, thresholds and unmasks coefficients as they are stored.
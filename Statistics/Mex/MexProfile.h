@@ -0,0 +1,102 @@
+/* MEXPROFILE - Lets MEX functions hand the native library's kernel profile back to MATLAB.
+ *
+ *	Profiling is turned on for a single call when MATLAB asks for the profile output, or when the STATISTICS_PROFILE
+ *	environment variable holds the path of a file. Every profiled call then appends one line of JSON to that file.
+ *	The profile output is a structure with the following fields:
+ *		Kernel:			The name of the first native kernel that the call ran.
+ *		Calls:			The number of native kernel calls that were made.
+ *		WallTime:		The seconds spent inside those kernel calls.
+ *		Phases:			A structure with the seconds that all threads spent planning (Plan), converting or standardizing
+ *						inputs (Prepare), transforming signals (Forward), multiplying spectra (Spectrum), transforming
+ *						products back (Inverse), reading lags out of them (Gather), computing results directly (Direct)
+ *						and writing outputs (Store).
+ *		BusyTime:		[1 x T] seconds that each thread spent in any of the phases above.
+ *		Bytes:			The bytes that the kernels had to read & write.
+ *		Pairs:			The number of signal pairings that the kernels processed.
+ *		Cycles:			The processor cycles spent by the kernel threads, or NaN where hardware counters aren't available.
+ *		CacheMisses:	The last-level cache misses of the kernel threads, or NaN where hardware counters aren't available.
+ */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#pragma once
+#ifndef MEXPROFILE_H
+#define MEXPROFILE_H
+
+#include <math.h>
+#include <stdlib.h>
+#include <matrix.h>
+#include <mex.h>
+#include "../Native/Statistics.h"
+
+
+
+/* FUNCTIONS */
+/// <summary>
+/// Turns profiling on for the rest of the call if MATLAB asked for the profile output or a log file is configured.
+/// </summary>
+/// <param name="nargout">The number of outputs that MATLAB asked for.</param>
+/// <param name="idx">The index of the profile output.</param>
+/// <returns>Whether profiling was turned on, which must be handed to mexprofileend.</returns>
+static int mexprofilebegin(int nargout, int idx)
+{
+	// A profiled call that raised an error never got to turn profiling off, so that is done here instead
+	int enabled = (nargout > idx) || getenv("STATISTICS_PROFILE");
+	if (enabled || GetProfiling()) { SetProfiling(enabled); }
+	return enabled;
+}
+/// <summary>
+/// Turns profiling back off, logging the profile and handing it to MATLAB as requested.
+/// </summary>
+/// <remarks>
+/// Call this before raising any error from the kernel, since raising an error in MATLAB never returns and the profile
+/// would be lost.
+/// </remarks>
+/// <param name="enabled">The value that mexprofilebegin returned.</param>
+/// <param name="nargout">The number of outputs that MATLAB asked for.</param>
+/// <param name="argout">The outputs of the MEX function.</param>
+/// <param name="idx">The index of the profile output.</param>
+static void mexprofileend(int enabled, int nargout, mxArray* argout[], int idx)
+{
+	if (!enabled) { return; }
+
+	Profile p;
+	GetProfile(&p);
+	SetProfiling(0);
+
+	const char* path = getenv("STATISTICS_PROFILE");
+	if (path && path[0]) { WriteProfile(&p, path); }
+	if (nargout <= idx) { return; }
+
+	const char* fields[] = { "Kernel", "Calls", "WallTime", "Phases", "BusyTime", "Bytes", "Pairs", "Cycles", "CacheMisses" };
+	mxArray* s = mxCreateStructMatrix(1, 1, 9, fields);
+	mxSetField(s, 0, "Kernel", mxCreateString(p.Kernel ? p.Kernel : ""));
+	mxSetField(s, 0, "Calls", mxCreateDoubleScalar((double)p.Calls));
+	mxSetField(s, 0, "WallTime", mxCreateDoubleScalar(p.WallTime));
+
+	const char* names[NumPhases];
+	for (int a = 0; a < NumPhases; a++)
+		names[a] = phasename((Phase)a);
+
+	mxArray* phases = mxCreateStructMatrix(1, 1, NumPhases, names);
+	for (int a = 0; a < NumPhases; a++)
+		mxSetField(phases, 0, names[a], mxCreateDoubleScalar(p.PhaseTime[a]));
+	mxSetField(s, 0, "Phases", phases);
+
+	mxArray* busy = mxCreateDoubleMatrix(1, p.NumThreads, mxREAL);
+	for (int a = 0; a < p.NumThreads; a++)
+		mxGetPr(busy)[a] = p.BusyTime[a];
+	mxSetField(s, 0, "BusyTime", busy);
+
+	mxSetField(s, 0, "Bytes", mxCreateDoubleScalar((double)p.Bytes));
+	mxSetField(s, 0, "Pairs", mxCreateDoubleScalar((double)p.Pairs));
+	mxSetField(s, 0, "Cycles", mxCreateDoubleScalar((p.Cycles >= 0) ? (double)p.Cycles : NAN));
+	mxSetField(s, 0, "CacheMisses", mxCreateDoubleScalar((p.CacheMisses >= 0) ? (double)p.CacheMisses : NAN));
+	argout[idx] = s;
+}
+
+
+
+#endif
@@ -0,0 +1,23 @@
+/* MEXSGOF - Calculates a FWER-corrected p-value cutoff using sequential goodness of fit (SGoF). */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#include <mex.h>
+#include "../Native/Statistics.h"
+
+
+
+/* MEX FUNCTION */
+void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argin[])
+{
+	if (nargin != 2)				{ mexErrMsgTxt("Two input arguments must be provided to this function. See documentation for syntax details."); }
+	if (!mxIsDouble(argin[0]))		{ mexErrMsgTxt("P-values must be provided as an array of doubles."); }
+
+	double cutoff;
+	ErrorCode status = SGoF(&cutoff, mxGetPr(argin[0]), mxGetNumberOfElements(argin[0]), mxGetScalar(argin[1]));
+	if (status != Success) { mexErrMsgTxt(errormsg(status)); }
+
+	argout[0] = mxCreateDoubleScalar(cutoff);
+}
@@ -0,0 +1,21 @@
+% MEXSGOF - Calculates a FWER-corrected p-value cutoff using sequential goodness of fit (SGoF).
+%
+%	SYNTAX:
+%		cutoff = MexSGoF(p, alpha)
+%
+%	OUTPUT:
+%		cutoff:		DOUBLE
+%					The p-value at or below which results are considered statistically significant, or NaN if no
+%					significance is found.
+%
+%	INPUTS:
+%		p:			[ DOUBLES ]
+%					An array of p-values of any size and shape. These do not need to be sorted.
+%
+%		alpha:		DOUBLE
+%					The significance level, which must be in (0, 1).
+%
+%	See also: MEXFDR, MEXTHRESHOLD, SGOF
+
+%% CHANGELOG
+%	Written by Josh Grooms on 20261017
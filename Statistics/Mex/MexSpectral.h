@@ -0,0 +1,54 @@
+/* MEXSPECTRAL - Translates the segmentation arguments that pwelch & mscohere take into the native library's Welch type. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#pragma once
+#ifndef MEXSPECTRAL_H
+#define MEXSPECTRAL_H
+
+#include <matrix.h>
+#include <mex.h>
+#include "../Native/Statistics.h"
+
+
+
+/* FUNCTIONS */
+/// <summary>
+/// Reads a window, overlap, transform length & sampling rate from consecutive MEX arguments.
+/// </summary>
+/// <param name="w">Receives the segmentation. Its window points into the MATLAB array, so it must not outlive it.</param>
+/// <param name="argin">The four arguments WINDOW, NOVERLAP, NFFT and FS, in that order.</param>
+static void mexwelch(Welch* w, const mxArray* argin[], int nsamples)
+{
+	if (!mxIsDouble(argin[0]) || mxIsEmpty(argin[0]))
+		mexErrMsgTxt("The window must be a nonempty vector of doubles.");
+
+	w->Window = mxGetPr(argin[0]);
+	w->WindowLength = (int)mxGetNumberOfElements(argin[0]);
+	w->Overlap = (int)mxGetScalar(argin[1]);
+	w->NFFT = (int)mxGetScalar(argin[2]);
+	w->SamplingRate = mxGetScalar(argin[3]);
+	w->Scale = PowerSpectralDensity;
+
+	if (w->WindowLength > nsamples)						{ mexErrMsgTxt("The window cannot be longer than the signals."); }
+	if (w->Overlap < 0 || w->Overlap >= w->WindowLength)	{ mexErrMsgTxt("The overlap must be an integer in the range [0, length(WINDOW) - 1]."); }
+	if (w->NFFT < 2 || (w->NFFT & (w->NFFT - 1)) != 0)		{ mexErrMsgTxt("NFFT must be a power of two of at least 2."); }
+	if (!(w->SamplingRate > 0))							{ mexErrMsgTxt("The sampling rate must be positive."); }
+}
+/// <summary>
+/// Creates the column vector of the frequencies, in Hz, that the bins of a one-sided spectrum correspond with.
+/// </summary>
+static mxArray* mexfrequencies(const Welch* w)
+{
+	int nbins = w->NFFT / 2 + 1;
+	mxArray* f = mxCreateDoubleMatrix(nbins, 1, mxREAL);
+	for (int a = 0; a < nbins; a++)
+		mxGetPr(f)[a] = a * (w->SamplingRate / w->NFFT);
+	return f;
+}
+
+
+
+#endif
@@ -0,0 +1,74 @@
+/* MEXSUMMARIZE - Finds the extrema, NaN count, sum, mean, variance & histogram of an array in a single pass. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#include <matrix.h>
+#include <mex.h>
+#include "../Native/Statistics.h"
+#include "MexFrames.h"
+
+
+
+/* MEX FUNCTION */
+void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argin[])
+{
+	if (nargin < 1 || nargin > 4)
+		mexErrMsgTxt("One to four input arguments must be provided to this function. See documentation for syntax details.");
+	if (mxIsEmpty(argin[0]))
+		mexErrMsgTxt("X cannot be an empty array.");
+
+	// Columns run down the first dimension, and every other dimension is flattened into the number of columns
+	int columns = (nargin > 1) && (mxGetScalar(argin[1]) != 0);
+	FrameArray x;
+	x.Data = mxGetData(argin[0]);
+	x.Class = mexprecision(argin[0]);
+	x.NumVoxels = columns ? mxGetM(argin[0]) : mxGetNumberOfElements(argin[0]);
+	x.NumFrames = (int)(mxGetNumberOfElements(argin[0]) / x.NumVoxels);
+
+	int nbins = (nargin > 2) ? (int)mxGetScalar(argin[2]) : 0;
+	const double* limits = NULL;
+	if (nargin > 3 && !mxIsEmpty(argin[3]))
+	{
+		if (!mxIsDouble(argin[3]) || mxGetNumberOfElements(argin[3]) != 2)
+			mexErrMsgTxt("Histogram limits must be a two-element vector of doubles.");
+		limits = mxGetPr(argin[3]);
+	}
+	if (nbins < 0) { mexErrMsgTxt("The number of histogram bins cannot be negative."); }
+
+	Summary* s = (Summary*)mxMalloc((size_t)x.NumFrames * sizeof(Summary));
+	size_t* counts = nbins ? (size_t*)mxMalloc((size_t)nbins * x.NumFrames * sizeof(size_t)) : NULL;
+	ErrorCode status = Summarize(s, x, counts, nbins, limits);
+	if (status != Success) { mexErrMsgTxt(errormsg(status)); }
+
+	const char* names[] = { "Min", "Max", "NumNaNs", "Count", "Sum", "Mean", "Variance", "Histogram" };
+	argout[0] = mxCreateStructMatrix(1, 1, nbins ? 8 : 7, names);
+
+	mxArray* fields[7];
+	for (int a = 0; a < 7; a++)
+		fields[a] = mxCreateDoubleMatrix(1, x.NumFrames, mxREAL);
+	for (int a = 0; a < x.NumFrames; a++)
+	{
+		mxGetPr(fields[0])[a] = s[a].Min;
+		mxGetPr(fields[1])[a] = s[a].Max;
+		mxGetPr(fields[2])[a] = (double)s[a].NumNaNs;
+		mxGetPr(fields[3])[a] = (double)s[a].Count;
+		mxGetPr(fields[4])[a] = s[a].Sum;
+		mxGetPr(fields[5])[a] = s[a].Mean;
+		mxGetPr(fields[6])[a] = s[a].Variance;
+	}
+	for (int a = 0; a < 7; a++)
+		mxSetField(argout[0], 0, names[a], fields[a]);
+
+	if (nbins)
+	{
+		mxArray* h = mxCreateDoubleMatrix(nbins, x.NumFrames, mxREAL);
+		for (size_t a = 0; a < (size_t)nbins * x.NumFrames; a++)
+			mxGetPr(h)[a] = (double)counts[a];
+		mxSetField(argout[0], 0, names[7], h);
+	}
+
+	mxFree(s);
+	mxFree(counts);
+}
@@ -0,0 +1,43 @@
+% MEXSUMMARIZE - Finds the extrema, NaN count, sum, mean, variance & histogram of an array in a single pass.
+%
+%	MEXSUMMARIZE replaces separate calls to MIN, MAX, ISNAN, SUM, MEAN, VAR and HISTC, each of which reads the whole array,
+%	with a single multithreaded sweep. Arrays of any real numeric class are read in place without being converted to
+%	double precision first. NaNs are counted but are otherwise ignored by every statistic, just like NANMIN, NANMAX,
+%	NANMEAN & NANVAR ignore them.
+%
+%	SYNTAX:
+%		s = MexSummarize(x)
+%		s = MexSummarize(x, columns)
+%		s = MexSummarize(x, columns, nbins)
+%		s = MexSummarize(x, columns, nbins, limits)
+%
+%	OUTPUT:
+%		s:				STRUCT
+%						A structure with fields Min, Max, NumNaNs, Count (of values that aren't NaNs), Sum, Mean and
+%						Variance (normalized by Count - 1). Each field holds one value per summarized column. When NBINS
+%						is given, the structure also has a Histogram field that holds an [NBINS x NC] array of counts.
+%
+%	INPUTS:
+%		x:				[ NUMERICS ]
+%						An array of any real floating point or 8, 16 or 32-bit integer class.
+%
+%	OPTIONAL INPUTS:
+%		columns:		BOOLEAN
+%						Whether to summarize every column of X separately. Columns run down the first dimension of X, and
+%						any further dimensions are flattened, so NC = NUMEL(X) / SIZE(X, 1).
+%						DEFAULT: false (summarize the whole array at once)
+%
+%		nbins:			INTEGER
+%						The number of equal-width histogram bins to count values into.
+%						DEFAULT: 0 (no histogram)
+%
+%		limits:			[ DOUBLE, DOUBLE ]
+%						The lower & upper edges of the histogram. Values outside of these aren't counted, and the last bin
+%						includes its upper edge. Without limits, histograms span the range of each column, which takes a
+%						second pass over the data.
+%						DEFAULT: [] (the range of each column)
+%
+%	See also: HISTC, MAX, MEAN, MIN, VAR
+
+%% CHANGELOG
+%	Written by Josh Grooms on 20261017
@@ -0,0 +1,32 @@
+/* MEXTHRESHOLD - Thresholds a real data distribution for statistical significance using an empirical null distribution. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#include <mex.h>
+#include "../Native/Statistics.h"
+
+
+
+/* MEX FUNCTION */
+void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argin[])
+{
+	if (nargin != 5)									{ mexErrMsgTxt("Five input arguments must be provided to this function. See documentation for syntax details."); }
+	if (!mxIsDouble(argin[0]) || !mxIsDouble(argin[1]))	{ mexErrMsgTxt("R and N must be arrays of doubles."); }
+
+	Tails t = (Tails)(int)mxGetScalar(argin[2]);
+	double alpha = mxGetScalar(argin[3]);
+	Correction method = (Correction)(int)mxGetScalar(argin[4]);
+
+	argout[0] = mxCreateDoubleMatrix(1, 2, mxREAL);
+	double pcutoff;
+	ErrorCode status = Threshold(mxGetPr(argout[0]), &pcutoff,
+		mxGetPr(argin[0]), mxGetNumberOfElements(argin[0]),
+		mxGetPr(argin[1]), mxGetNumberOfElements(argin[1]),
+		t, alpha, method);
+	if (status != Success) { mexErrMsgTxt(errormsg(status)); }
+
+	if (nargout > 1)
+		argout[1] = mxCreateDoubleScalar(pcutoff);
+}
@@ -0,0 +1,46 @@
+% MEXTHRESHOLD - Thresholds a real data distribution for statistical significance using an empirical null distribution.
+%
+%	SYNTAX:
+%		c = MexThreshold(r, n, tail, alpha, correction)
+%		[c, p] = MexThreshold(r, n, tail, alpha, correction)
+%
+%	OUTPUTS:
+%		c:				[ DOUBLE, DOUBLE ]
+%						The lower and upper significance cutoffs in the same units as R. The cutoff of an untested tail is
+%						NaN.
+%
+%		p:				DOUBLE
+%						The p-value that corresponds with the cutoffs in C.
+%
+%	INPUTS:
+%		r:				[ DOUBLES ]
+%						The real data distribution. NaNs and zeros must be removed before calling this function.
+%
+%		n:				[ DOUBLES ]
+%						The null data distribution. NaNs and zeros must be removed before calling this function, but the
+%						distribution does not need to be sorted.
+%
+%		tail:			INTEGER
+%						A number code corresponding with the tail of the distribution to be tested.
+%
+%						OPTIONS:
+%							0 - Both tails (i.e. a two-tailed distribution)
+%							1 - Left tail
+%							2 - Right tail
+%
+%		alpha:			DOUBLE
+%						The significance level, which must be in (0, 1).
+%
+%		correction:		INTEGER
+%						A number code corresponding with the method used to control the family-wise error rate.
+%
+%						OPTIONS:
+%							0 - No correction
+%							1 - SGoF using a binomial test
+%							2 - Benjamini-Hochberg control of the false discovery rate
+%							3 - SGoF using a G-test
+%
+%	See also: MEXFDR, MEXSGOF, THRESHOLD
+
+%% CHANGELOG
+%	Written by Josh Grooms on 20261017
@@ -0,0 +1,38 @@
+/* MEXWELCH - Estimates the power spectra of many signals at once using Welch's method. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Transform plans & workspaces are now kept between calls. Call with 'flush' to release them.
+ */
+
+#include <matrix.h>
+#include <mex.h>
+#include "../Native/Statistics.h"
+#include "MexCache.h"
+#include "MexSpectral.h"
+
+
+
+/* MEX FUNCTION */
+void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argin[])
+{
+	if (mexcache(nargin, argin)) { return; }
+
+	if (nargin != 5 && nargin != 6)
+		mexErrMsgTxt("Five or six input arguments must be provided to this function. See documentation for syntax details.");
+
+	int nrx = mxGetM(argin[0]);
+	int ncx = mxGetN(argin[0]);
+	if (nrx == 0 || ncx == 0)	{ mexErrMsgTxt("X cannot be an empty array."); }
+	if (!mxIsDouble(argin[0]))	{ mexErrMsgTxt("X must be an array of doubles."); }
+
+	Welch w;
+	mexwelch(&w, argin + 1, nrx);
+	if (nargin == 6) { w.Scale = (Scaling)(int)mxGetScalar(argin[5]); }
+
+	argout[0] = mxCreateDoubleMatrix(w.NFFT / 2 + 1, ncx, mxREAL);
+	ErrorCode status = WelchSpectra(mxGetPr(argout[0]), signals(mxGetPr(argin[0]), nrx, ncx), &w);
+	if (status != Success) { mexErrMsgTxt(errormsg(status)); }
+
+	if (nargout > 1) { argout[1] = mexfrequencies(&w); }
+}
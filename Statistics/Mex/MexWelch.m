@@ -0,0 +1,49 @@
+% MEXWELCH - Estimates the power spectra of many signals at once using Welch's method.
+%
+%	MEXWELCH produces the same estimates as PWELCH does for real signals with a one-sided frequency range, but it handles
+%	every column of X in a single call. The window and transform plan are only built once, and signals are distributed
+%	across threads.
+%
+%	SYNTAX:
+%		psd = MexWelch(x, window, noverlap, nfft, fs)
+%		psd = MexWelch(x, window, noverlap, nfft, fs, scaling)
+%		[psd, f] = MexWelch(...)
+%		MexWelch('flush')
+%
+%	OUTPUTS:
+%		psd:			[ NF x NX DOUBLES ]
+%						The one-sided spectrum of every signal in X, where NF = NFFT / 2 + 1. Each column corresponds with
+%						one signal.
+%
+%		f:				[ NF x 1 DOUBLES ]
+%						The frequency in Hz of every row of PSD.
+%
+%	INPUTS:
+%		x:				[ M x NX DOUBLES ]
+%						An array of signals. Each column of this array represents a single signal with M time points.
+%
+%		window:			[ L x 1 DOUBLES ]
+%						The window applied to every segment. Its length L sets the length of the segments.
+%
+%		noverlap:		INTEGER
+%						The number of samples that successive segments share. This must be in [0, L - 1].
+%
+%		nfft:			INTEGER
+%						The transform length, which must be a power of two. Segments are zero-padded up to this length or
+%						wrapped around to it when L is longer.
+%
+%		fs:				DOUBLE
+%						The sampling rate of the signals in Hz.
+%
+%	OPTIONAL INPUT:
+%		scaling:		INTEGER
+%						How spectra are scaled.
+%						DEFAULT: 0
+%						OPTIONS:
+%							0 - Power spectral density (i.e. PWELCH's 'psd')
+%							1 - Power spectrum (i.e. PWELCH's 'power')
+%
+%	See also: MEXCOHERENCE, PWELCH
+
+%% CHANGELOG
+%	Written by Josh Grooms on 20261017
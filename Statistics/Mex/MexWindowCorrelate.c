@@ -7,9 +7,10 @@
  *
  *	SYNTAX:
  *		swc = MexWindowCorrelate(x, y, window, noverlap)
+ *		[swc, profile] = MexWindowCorrelate(...)
  *
  *	OUTPUT:
- *		swc:			[ MC x NC DOUBLES ]
+ *		swc:			[ MC x NC DOUBLES or SINGLES ]
  *						An array of sliding window correlation values calculated between the data in X and Y. Each row of
  *						this array contains Pearson correlation coefficients (i.e. r values) between a specific segment of
  *						the signals in X and Y. The number of correlation time points MC will always follow this formula:
@@ -22,16 +23,19 @@
  *						therefore corresponds with the correlation between one signal in Y and all signals in X. Successive
  *						groupings correspond with successive signals in Y.
  *
+ *						SWC is a single precision array whenever X and Y are. Sums are still accumulated in double precision.
+ *
  *	INPUTS:
- *		x:				[ M x NX DOUBLES ]
+ *		x:				[ M x NX DOUBLES or SINGLES ]
  *						An array of doubles containing the signal(s) to be correlated with each signal in Y. Each column of
  *						this array represents a single signal with M time points. The number of signals NX is free to vary
  *						but must be a positive integer. The number of time points M must always equal M from Y.
  *
- *		y:				[ M x NY DOUBLES ]
+ *		y:				[ M x NY DOUBLES or SINGLES ]
  *						An array of doubles containing the signal(s) to be correlated with each signal in X. Each column of
  *						this array represents a single signal with M time points. The number of signals NY is free to vary
- *						but must be a positive integer. The number of time points M must always equal M from X.
+ *						but must be a positive integer. The number of time points M must always equal M from X. The class of
+ *						Y must always match the class of X.
  *
  *		window:			INT
  *						The number of samples that constitute a single window. More specifically, this argument is the length
@@ -42,21 +46,25 @@
  *						points are "overlapped" from previous estimates as the window slides along a signal. This argument
  *						must be an integer between 0 and WINDOW - 1.
  *
+ *	OPTIONAL OUTPUT:
+ *		profile:		STRUCT
+ *						Where the native kernels spent their time during this call. See MexProfile.h for its fields.
+ *
  *	See also: CCORR, SWCORR
  */
 
 /* CHANGELOG
  * Written by Josh Grooms on 20150203
+ *		20261017:	Moved the sliding window correlation kernel into the native statistics library (Statistics/Native). This
+ *					file is now only responsible for translating between MATLAB arrays and the library's types.
+ *		20261017:	Added a single precision path. Single precision inputs are no longer converted in MATLAB, and they
+ *					produce single precision outputs.
+ *		20261017:	Added an optional second output that profiles the native kernels (see MexProfile.h).
  */
 
-#include <cilk/cilk.h>
-#include <mathimf.h>
 #include <mex.h>
-
-
-
-/* PROTOTYPES */
-double corr(double x[], double y[], int nsamples);
+#include "../Native/Statistics.h"
+#include "MexProfile.h"
 
 
 
@@ -66,12 +74,8 @@ void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argi
 	if (nargin != 4)
 		mexErrMsgTxt("Four input arguments must be provided to this function. See documentation for syntax details.");
 
-	double* x = mxGetPr(argin[0]);
-	double* y = mxGetPr(argin[1]);
-
 	int window = (int)mxGetScalar(argin[2]);
 	int noverlap = (int)mxGetScalar(argin[3]);
-	int increment = window - noverlap;
 
 	int ncx, ncy, nrx, nry;
 	nrx = mxGetM(argin[0]);
@@ -82,67 +86,32 @@ void mexFunction(int nargout, mxArray* argout[], int nargin, const mxArray* argi
 	if (nrx == 0 || nry == 0) { mexErrMsgTxt("Inputs cannot be empty arrays."); }
 	if (nrx != nry) { mexErrMsgTxt("X and Y must contain equivalent length signals."); }
 
-	// We need a higher precision calculation for the number of SWC points per signal. Otherwise, if this ends up being fractional,
-	// it could get rounded up and result in out-of-bounds indexing later on. We need to always force it downward.
-	float temp = (float)(nrx - window) / (float)increment;
-	int nswc = (int)floor(temp);
+	mxClassID class = mxGetClassID(argin[0]);
+	if (class != mxGetClassID(argin[1]))						{ mexErrMsgTxt("X and Y must be of the same class."); }
+	if (class != mxDOUBLE_CLASS && class != mxSINGLE_CLASS)	{ mexErrMsgTxt("X and Y must be arrays of singles or doubles."); }
+
+	int nswc = WindowCount(nrx, window, noverlap);
 
-	argout[0] = mxCreateDoubleMatrix(nswc, ncx * ncy, mxREAL);
-	double* swc = mxGetPr(argout[0]);
+	int profiled = mexprofilebegin(nargout, 1);
 
-	int nrxToUse = nswc * increment;
-	if (ncy == 1)
+	ErrorCode status;
+	if (class == mxSINGLE_CLASS)
 	{
-		cilk_for (int a = 0; a < ncx; a++)
-		{
-			int idxSWC = a * nswc;
-			int idxColX = a * nrx;
-			for (int b = 0; b < nrxToUse; b += increment)
-				swc[idxSWC++] = corr(x + idxColX + b, y + b, window);
-		}
+		SignalArrayF x = signalsf((const float*)mxGetData(argin[0]), nrx, ncx);
+		SignalArrayF y = signalsf((const float*)mxGetData(argin[1]), nry, ncy);
 
+		argout[0] = mxCreateNumericMatrix(nswc, ncx * ncy, mxSINGLE_CLASS, mxREAL);
+		status = WindowCorrelateF((float*)mxGetData(argout[0]), x, y, window, noverlap);
 	}
 	else
 	{
-		cilk_for (int a = 0; a < ncy; a++)
-		{
-			int idxColY = a * nry;
-			for (int b = 0; b < ncx; b++)
-			{
-				int idxSWC = nswc * (a * ncx + b);
-				int idxColX = b * nrx;
-				for (int c = 0; c < nrxToUse; c += increment)
-					swc[idxSWC++] = corr(x + idxColX + c, y + idxColY + c, window);
-			}
-		}
-	}
-}
-
-
+		SignalArray x = signals(mxGetPr(argin[0]), nrx, ncx);
+		SignalArray y = signals(mxGetPr(argin[1]), nry, ncy);
 
-/* SUBROUTINES */
-/// <summary>
-/// Computes the Pearson product-moment correlation coefficient between two signals.
-/// </summary>
-/// <param name="x">A signal vector.</param>
-/// <param name="y">A second signal vector of the same length as x.</param>
-/// <param name="nsamples">The number of sample points in x and y.</param>
-/// <returns>The correlation coefficient (r) between x and y.</returns>
-double corr(double x[], double y[], int nsamples)
-{
-	double sx, sy, sxy, ssx, ssy;
-	sx = sy = sxy = ssx = ssy = 0;
-	for (int a = 0; a < nsamples; a++)
-	{
-		sx += x[a];
-		sy += y[a];
-		sxy += x[a] * y[a];
-		ssx += x[a] * x[a];
-		ssy += y[a] * y[a];
+		argout[0] = mxCreateDoubleMatrix(nswc, ncx * ncy, mxREAL);
+		status = WindowCorrelate(mxGetPr(argout[0]), x, y, window, noverlap);
 	}
 
-	double cov = (nsamples * sxy) - (sx * sy);
-	double scale = sqrt((nsamples * ssx) - (sx * sx)) * sqrt((nsamples * ssy) - (sy * sy));
-
-	return cov / scale;
+	mexprofileend(profiled, nargout, argout, 1);
+	if (status != Success) { mexErrMsgTxt(errormsg(status)); }
 }
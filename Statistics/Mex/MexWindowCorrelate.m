@@ -7,9 +7,10 @@
 %
 %	SYNTAX:
 %		swc = MexWindowCorrelate(x, y, window, noverlap)
+%		[swc, profile] = MexWindowCorrelate(...)
 %
 %	OUTPUT:
-%		swc:			[ MC x NC DOUBLES ]
+%		swc:			[ MC x NC DOUBLES or SINGLES ]
 %						An array of sliding window correlation values calculated between the data in X and Y. Each row of 
 %						this array contains Pearson correlation coefficients (i.e. r values) between a specific segment of 
 %						the signals in X and Y. The number of correlation time points MC will always follow this formula:
@@ -22,16 +23,19 @@
 %						therefore corresponds with the correlation between one signal in Y and all signals in X. Successive 
 %						groupings correspond with successive signals in Y.
 %
+%						SWC is a single precision array whenever X and Y are. Sums are still accumulated in double precision.
+%
 %	INPUTS:
-%		x:				[ M x NX DOUBLES ]
+%		x:				[ M x NX DOUBLES or SINGLES ]
 %						An array of doubles containing the signal(s) to be correlated with each signal in Y. Each column of 
 %						this array represents a single signal with M time points. The number of signals NX is free to vary 
 %						but must be a positive integer. The number of time points M must always equal M from Y.
 %
-%		y:				[ M x NY DOUBLES ]
+%		y:				[ M x NY DOUBLES or SINGLES ]
 %						An array of doubles containing the signal(s) to be correlated with each signal in X. Each column of 
 %						this array represents a single signal with M time points. The number of signals NY is free to vary 
-%						but must be a positive integer. The number of time points M must always equal M from X.
+%						but must be a positive integer. The number of time points M must always equal M from X. The class of
+%						Y must always match the class of X.
 %
 %		window:			INT
 %						The number of samples that constitute a single window. More specifically, this argument is the length 
@@ -42,7 +46,14 @@
 %						points are "overlapped" from previous estimates as the window slides along a signal. This argument 
 %						must be an integer between 0 and WINDOW - 1.
 %
+%	OPTIONAL OUTPUT:
+%		profile:		STRUCT
+%						Where the native kernels spent their time during this call. This has the same fields as the profile
+%						output of MEXCROSSCORRELATE.
+%
 %	See also: CCORR, SWCORR
 
 %% CHANGELOG
-%	Written by Josh Grooms on 20150204
\ No newline at end of file
+%	Written by Josh Grooms on 20150204
+%		20261017:	Added support for single precision inputs, which produce single precision outputs.
+%		20261017:	Added an optional second output that profiles the native kernels.
\ No newline at end of file
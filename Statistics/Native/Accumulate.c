@@ -0,0 +1,77 @@
+/* ACCUMULATE - Streaming NaN-aware statistics across a series of equally sized arrays. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Replaces concatenating every subject & scan along a new dimension just to call NANMEAN across it.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "Statistics.h"
+
+
+
+/* CONSTANTS */
+#define CHUNK			(1 << 14)	// The number of elements that each task updates.
+
+
+
+/* FUNCTIONS */
+ErrorCode Accumulate(Accumulator* acc, const double x[])
+{
+	if (!acc || !x || !acc->Count || !acc->Mean || !acc->M2)	{ return InvalidArgument; }
+	if (acc->NumElements == 0)									{ return EmptyInput; }
+
+	size_t n = acc->NumElements;
+	size_t nchunks = (n + CHUNK - 1) / CHUNK;
+	double* count = acc->Count;
+	double* mean = acc->Mean;
+	double* m2 = acc->M2;
+
+	#pragma omp parallel for schedule(static)
+	for (ptrdiff_t a = 0; a < (ptrdiff_t)nchunks; a++)
+	{
+		size_t first = (size_t)a * CHUNK;
+		size_t last = (n - first < CHUNK) ? n : first + CHUNK;
+
+		// NaNs leave their element alone, which is written without branches so that the update vectorizes
+		#pragma omp simd
+		for (size_t b = first; b < last; b++)
+		{
+			double v = x[b];
+			int valid = (v == v);
+			double c = count[b] + valid;
+			double delta = valid ? v - mean[b] : 0.0;
+			double mu = mean[b] + (valid ? delta / c : 0.0);
+			m2[b] += delta * (valid ? v - mu : 0.0);
+			mean[b] = mu;
+			count[b] = c;
+		}
+	}
+
+	return Success;
+}
+
+ErrorCode AccumulatorMoments(double mean[], double variance[], double t[], const Accumulator* acc)
+{
+	if (!acc || !acc->Count || !acc->Mean || !acc->M2)			{ return InvalidArgument; }
+	if (acc->NumElements == 0)									{ return EmptyInput; }
+
+	size_t n = acc->NumElements;
+
+	// Outputs may alias the accumulator, so every field of an element is read before any of its outputs are written
+	#pragma omp parallel for schedule(static)
+	for (ptrdiff_t a = 0; a < (ptrdiff_t)n; a++)
+	{
+		double c = acc->Count[a];
+		double mu = (c > 0) ? acc->Mean[a] : NAN;
+		double var = (c > 1) ? acc->M2[a] / (c - 1) : (c == 1) ? 0.0 : NAN;
+		double ts = (c > 1) ? mu / sqrt(var / c) : NAN;
+
+		if (mean)		{ mean[a] = mu; }
+		if (variance)	{ variance[a] = var; }
+		if (t)			{ t[a] = ts; }
+	}
+
+	return Success;
+}
@@ -0,0 +1,135 @@
+/* ARENA - Reusable, aligned scratch memory for the native statistics kernels. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Releasing the workspace now flushes the transform plan cache as well.
+ */
+
+#include <stdlib.h>
+#include "Arena.h"
+#include "FFT.h"
+#include "Statistics.h"
+
+#if defined(_WIN32)
+	#include <malloc.h>
+	#define THREADLOCAL __declspec(thread)
+#else
+	#define THREADLOCAL __thread
+#endif
+
+
+
+/* DATA */
+static size_t				budget = (size_t)512 << 20;
+static THREADLOCAL Arena	cached = { NULL, 0, 0, 0, 1 };
+
+
+
+/* FUNCTIONS */
+void* alignedalloc(size_t bytes)
+{
+	if (bytes == 0) { bytes = ALIGNMENT; }
+#if defined(_WIN32)
+	return _aligned_malloc(bytes, ALIGNMENT);
+#else
+	void* ptr = NULL;
+	return (posix_memalign(&ptr, ALIGNMENT, bytes) == 0) ? ptr : NULL;
+#endif
+}
+
+void alignedfree(void* ptr)
+{
+#if defined(_WIN32)
+	_aligned_free(ptr);
+#else
+	free(ptr);
+#endif
+}
+
+Arena* arenaacquire(size_t bytes)
+{
+	bytes = aligned(bytes);
+
+	Arena* arena = &cached;
+	if (cached.InUse)
+	{
+		arena = (Arena*)calloc(1, sizeof(Arena));
+		if (!arena) { return NULL; }
+	}
+
+	if (arena->Capacity < bytes)
+	{
+		alignedfree(arena->Base);
+		arena->Base = (char*)alignedalloc(bytes);
+		arena->Capacity = arena->Base ? bytes : 0;
+		if (!arena->Base)
+		{
+			if (arena != &cached) { free(arena); }
+			return NULL;
+		}
+	}
+
+	arena->Used = 0;
+	arena->InUse = 1;
+	arena->Cached = (arena == &cached);
+	return arena;
+}
+
+void arenarelease(Arena* arena)
+{
+	if (!arena) { return; }
+	if (arena->Cached)
+	{
+		arena->Used = 0;
+		arena->InUse = 0;
+	}
+	else
+	{
+		alignedfree(arena->Base);
+		free(arena);
+	}
+}
+
+void* arenaalloc(Arena* arena, size_t bytes)
+{
+	bytes = aligned(bytes);
+	if (arena->Capacity - arena->Used < bytes) { return NULL; }
+
+	void* ptr = arena->Base + arena->Used;
+	arena->Used += bytes;
+	return ptr;
+}
+
+void arenaflush(void)
+{
+	if (cached.InUse) { return; }
+	alignedfree(cached.Base);
+	cached.Base = NULL;
+	cached.Capacity = 0;
+}
+
+
+
+/* MEMORY BUDGET */
+/// <summary>
+/// Sets the approximate maximum number of bytes of scratch memory that a single kernel call may use.
+/// </summary>
+void SetMemoryBudget(size_t bytes)
+{
+	budget = bytes;
+}
+/// <summary>
+/// Gets the approximate maximum number of bytes of scratch memory that a single kernel call may use.
+/// </summary>
+size_t GetMemoryBudget(void)
+{
+	return budget;
+}
+/// <summary>
+/// Releases the scratch memory that the calling thread keeps between kernel calls, along with unused transform plans.
+/// </summary>
+void ReleaseWorkspace(void)
+{
+	arenaflush();
+	fftflush();
+}
@@ -0,0 +1,90 @@
+/* ARENA - Reusable, aligned scratch memory for the native statistics kernels.
+ *
+ *	Kernels that need large temporary buffers (e.g. cached spectra in the cross-correlation) carve them out of an arena
+ *	instead of allocating them individually. Every allocation from an arena is aligned to a 64-byte boundary, which is the
+ *	size of a cache line and of an AVX-512 register. Each thread keeps one arena that persists between calls, so repeated
+ *	calls with similar sizes don't allocate any memory at all.
+ *
+ *	Kernels are also expected to size their batches so that the scratch memory they need stays within the memory budget
+ *	(see SetMemoryBudget in Statistics.h).
+ */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#pragma once
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+
+
+/* CONSTANTS */
+#define ALIGNMENT	64			// The alignment, in bytes, of every allocation made from an arena.
+
+
+
+/* DATA */
+/// <summary>
+/// A block of aligned memory that is handed out sequentially and released all at once.
+/// </summary>
+typedef struct
+{
+	char*		Base;			// The first byte of the block.
+	size_t		Capacity;		// The total size of the block in bytes.
+	size_t		Used;			// The number of bytes that have been handed out.
+	int			InUse;			// Whether the arena is currently held by a kernel.
+	int			Cached;			// Whether the arena is the calling thread's persistent arena.
+}Arena;
+
+
+
+/* FUNCTIONS */
+/// <summary>
+/// Rounds a number of bytes up to the next multiple of the arena alignment.
+/// </summary>
+static inline size_t aligned(size_t bytes)
+{
+	return (bytes + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+}
+
+/// <summary>
+/// Allocates a block of memory that is aligned to a 64-byte boundary.
+/// </summary>
+/// <returns>The new block, which must be released using alignedfree, or NULL if no memory is available.</returns>
+void*		alignedalloc(size_t bytes);
+/// <summary>
+/// Releases a block of memory that was allocated using alignedalloc.
+/// </summary>
+void		alignedfree(void* ptr);
+
+/// <summary>
+/// Acquires an empty arena with room for at least the requested number of bytes.
+/// </summary>
+/// <remarks>
+/// This normally returns the calling thread's persistent arena, growing it if necessary. If that arena is already held
+/// (e.g. by an outer kernel that calls this one), a temporary arena is created instead. Either way, the arena must be
+/// handed back with arenarelease when the kernel is finished with it.
+/// </remarks>
+/// <param name="bytes">The minimum capacity of the arena.</param>
+/// <returns>An empty arena, or NULL if the memory could not be allocated.</returns>
+Arena*		arenaacquire(size_t bytes);
+/// <summary>
+/// Hands back an arena that was acquired using arenaacquire. All memory that was allocated from it becomes invalid.
+/// </summary>
+void		arenarelease(Arena* arena);
+/// <summary>
+/// Allocates a 64-byte aligned block of memory from an arena.
+/// </summary>
+/// <returns>The new block, or NULL if the arena does not have enough room left.</returns>
+void*		arenaalloc(Arena* arena, size_t bytes);
+/// <summary>
+/// Releases the calling thread's persistent arena, if it is not currently held.
+/// </summary>
+void		arenaflush(void);
+
+
+
+#endif
@@ -0,0 +1,361 @@
+/* COMPARISONS - Significance thresholds that control error rates across multiple comparisons. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Moved the FWER corrections out of sgof.m, fdr.m and threshold.m. Quantiles are now found by selection, binomial
+ *					tails by a recurrence, and only the values that can possibly be significant ever get sorted.
+ *		20261017:	Benjamini-Hochberg p-values are generated without narrowing the number of data points to an int.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Sort.h"
+#include "Statistics.h"
+
+
+
+/* CONSTANTS */
+#define NEGLIGIBLE	1e-18		// Binomial probabilities this small relative to the running sum no longer affect it.
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Computes x * log(x / e), treating 0 * log(0) as 0.
+/// </summary>
+static double xlogx(double x, double e)
+{
+	return (x > 0) ? x * log(x / e) : 0.0;
+}
+/// <summary>
+/// Finds the critical value of the chi-squared distribution with one degree of freedom at an upper tail probability.
+/// </summary>
+/// <remarks>
+/// The upper tail of this distribution is erfc(sqrt(x / 2)), which is inverted here by bisection.
+/// </remarks>
+static double chi2crit(double alpha)
+{
+	double lo = 0, hi = 1e3;
+	for (int a = 0; a < 200 && hi - lo > 1e-14 * hi; a++)
+	{
+		double mid = 0.5 * (lo + hi);
+		if (erfc(sqrt(0.5 * mid)) > alpha)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	return 0.5 * (lo + hi);
+}
+/// <summary>
+/// Counts the elements of a vector that are strictly less than a value.
+/// </summary>
+static size_t countbelow(const double x[], size_t n, double value)
+{
+	size_t count = 0;
+	#pragma omp parallel for reduction(+:count) schedule(static)
+	for (size_t a = 0; a < n; a++)
+		count += (x[a] < value);
+	return count;
+}
+/// <summary>
+/// Computes the same p-value that EmpiricalCDF would for one value, without needing the null distribution to be sorted.
+/// </summary>
+static double pvalue(const double n[], size_t ln, double value, Tails t)
+{
+	double pval = (double)countbelow(n, ln, value) / (double)ln;
+	switch (t)
+	{
+		case Both:	return 2.0 * fmin(pval, 1.0 - pval);
+		case Left:	return pval;
+		default:	return 1.0 - pval;
+	}
+}
+/// <summary>
+/// Selects the value at a one-based index of the sorted order of a vector, clamping the index to the vector's bounds.
+/// </summary>
+static double orderstat(double x[], size_t n, double idx)
+{
+	size_t k = (idx < 1) ? 0 : (idx > (double)n) ? n - 1 : (size_t)idx - 1;
+	return nthelement(x, n, k);
+}
+/// <summary>
+/// Gets the number of significant results that SGoF removes as being expected by chance under a binomial test.
+/// </summary>
+/// <returns>The largest k in [1, nsig] for which P(X > k) > alpha, where X ~ B(ntrials, alpha), or zero if there is none.</returns>
+static size_t binomialexcess(size_t ntrials, size_t nsig, double alpha)
+{
+	// P(X > k) > alpha holds exactly when k is below the (1 - alpha) quantile
+	size_t kq = BinomialQuantile(ntrials, alpha, 1.0 - alpha);
+	size_t k = (kq > 0) ? kq - 1 : 0;
+	return (k < nsig) ? k : nsig;
+}
+/// <summary>
+/// Gets the number of significant results that SGoF removes as being expected by chance under a G-test.
+/// </summary>
+/// <param name="removed">Receives the largest k in [1, nsig] whose G statistic is below the critical value.</param>
+/// <returns>Whether any such k exists.</returns>
+static int gexcess(size_t* removed, size_t ntrials, size_t nsig, double alpha)
+{
+	double N = (double)ntrials;
+	double expBA = N * alpha;
+	double expAA = N * (1 - alpha);
+	double q = 1 + (1 / (2 * N));
+	double gcrit = chi2crit(alpha);
+
+	for (size_t k = nsig; k >= 1; k--)
+	{
+		double g = 2 * (xlogx(N - (double)k, expAA) + xlogx((double)k, expBA)) / q;
+		if (g < gcrit)
+		{
+			*removed = k;
+			return 1;
+		}
+	}
+	return 0;
+}
+/// <summary>
+/// Gets the number of results that remain significant under Benjamini-Hochberg control of the false discovery rate.
+/// </summary>
+/// <param name="n">The null distribution, which gets sorted.</param>
+static ErrorCode bhexcess(size_t* nsig, const double r[], size_t lr, double n[], size_t ln, Tails t, const double cutoffs[2], double alpha)
+{
+	double* rsig = (double*)malloc((*nsig + 1) * sizeof(double));
+	double* psig = (double*)malloc((*nsig + 1) * sizeof(double));
+	if (!rsig || !psig)
+	{
+		free(rsig);
+		free(psig);
+		return OutOfMemory;
+	}
+
+	size_t count = 0;
+	for (size_t a = 0; a < lr; a++)
+	{
+		if (r[a] <= cutoffs[0] || r[a] >= cutoffs[1])
+			rsig[count++] = r[a];
+	}
+
+	// P-values are needed for every uncorrected significant data point, so this is where a full sort pays off
+	sortdoubles(n, ln);
+	ErrorCode status = EmpiricalCDF(psig, rsig, count, n, ln, t);
+	if (status == Success)
+	{
+		sortdoubles(psig, count);
+
+		size_t last = 0;
+		for (size_t a = 0; a < count; a++)
+		{
+			if (psig[a] <= alpha * ((double)(a + 1) / (double)lr))
+				last = a + 1;
+		}
+		*nsig = last;
+	}
+
+	free(rsig);
+	free(psig);
+	return status;
+}
+
+
+
+/* FUNCTIONS */
+size_t BinomialQuantile(size_t n, double p, double q)
+{
+	if (n == 0 || p <= 0 || q <= 0)	{ return 0; }
+	if (p >= 1)						{ return n; }
+
+	double N = (double)n;
+	double odds = p / (1 - p);
+	size_t mode = (size_t)floor((N + 1) * p);
+	mode = (mode > n) ? n : mode;
+
+	// Probabilities relative to the mode, walking down until they become negligible
+	double t = 1, lower = 0;
+	size_t k = mode;
+	while (k > 0)
+	{
+		t *= (double)k / ((N - (double)k + 1) * odds);
+		k--;
+		lower += t;
+		if (t < NEGLIGIBLE * (lower + 1)) { break; }
+	}
+	size_t kfirst = k;
+	double tfirst = (mode == k) ? 1 : t;
+
+	// Then walking up from the mode
+	double upper = 0;
+	t = 1;
+	for (k = mode; k < n; )
+	{
+		t *= ((N - (double)k) / (double)(k + 1)) * odds;
+		k++;
+		upper += t;
+		if (t < NEGLIGIBLE * (upper + lower + 1)) { break; }
+	}
+
+	// Accumulate the CDF from the lowest non-negligible outcome until it reaches q
+	double target = q * (lower + 1 + upper);
+	double cdf = tfirst;
+	t = tfirst;
+	for (k = kfirst; cdf < target && k < n; )
+	{
+		t *= ((N - (double)k) / (double)(k + 1)) * odds;
+		k++;
+		cdf += t;
+		if (k > mode && t < NEGLIGIBLE * cdf) { break; }
+	}
+
+	return k;
+}
+
+ErrorCode SGoF(double* cutoff, const double p[], size_t np, double alpha)
+{
+	*cutoff = NAN;
+	if (np == 0)					{ return EmptyInput; }
+	if (alpha <= 0 || alpha >= 1)	{ return InvalidArgument; }
+
+	size_t count = 0;
+	for (size_t a = 0; a < np; a++)
+		count += (p[a] <= alpha);
+
+	size_t nsig = count - binomialexcess(np, count, alpha);
+	if (nsig == 0) { return Success; }
+
+	// The cutoff is the nsig-th smallest p-value, which must be among the ones at or below alpha
+	double* psig = (double*)malloc(count * sizeof(double));
+	if (!psig) { return OutOfMemory; }
+
+	for (size_t a = 0, b = 0; a < np; a++)
+	{
+		if (p[a] <= alpha)
+			psig[b++] = p[a];
+	}
+
+	*cutoff = nthelement(psig, count, nsig - 1);
+	free(psig);
+	return Success;
+}
+
+ErrorCode FDR(double* cutoff, const double p[], size_t np, double alpha)
+{
+	*cutoff = NAN;
+	if (np == 0)					{ return EmptyInput; }
+	if (alpha <= 0 || alpha >= 1)	{ return InvalidArgument; }
+
+	size_t count = 0;
+	for (size_t a = 0; a < np; a++)
+		count += (p[a] <= alpha);
+	if (count == 0) { return Success; }
+
+	double* psig = (double*)malloc(count * sizeof(double));
+	if (!psig) { return OutOfMemory; }
+
+	for (size_t a = 0, b = 0; a < np; a++)
+	{
+		if (p[a] <= alpha)
+			psig[b++] = p[a];
+	}
+
+	// These are the smallest p-values, so their ranks are the same as in a sort of the whole vector
+	sortdoubles(psig, count);
+	for (size_t a = count; a > 0; a--)
+	{
+		if (psig[a - 1] <= alpha * ((double)a / (double)np))
+		{
+			*cutoff = psig[a - 1];
+			break;
+		}
+	}
+
+	free(psig);
+	return Success;
+}
+
+ErrorCode Threshold(double cutoffs[2], double* pcutoff, const double r[], size_t lr, const double n[], size_t ln, Tails t, double alpha, Correction method)
+{
+	cutoffs[0] = cutoffs[1] = NAN;
+	*pcutoff = NAN;
+	if (lr == 0 || ln == 0)							{ return EmptyInput; }
+	if (alpha <= 0 || alpha >= 1)					{ return InvalidArgument; }
+	if (t < Both || t > Right)						{ return InvalidArgument; }
+	if (method < Uncorrected || method > GTest)		{ return InvalidArgument; }
+
+	// Selection reorders the null distribution, so it works on a copy
+	double* ns = (double*)malloc(ln * sizeof(double));
+	if (!ns) { return OutOfMemory; }
+	memcpy(ns, n, ln * sizeof(double));
+
+	double N = (double)ln;
+	switch (t)
+	{
+		case Both:
+			cutoffs[0] = orderstat(ns, ln, floor(0.5 * alpha * N));
+			cutoffs[1] = orderstat(ns, ln, ceil((1 - 0.5 * alpha) * N));
+			break;
+		case Left:
+			cutoffs[0] = orderstat(ns, ln, floor(alpha * N));
+			break;
+		case Right:
+			cutoffs[1] = orderstat(ns, ln, ceil((1 - alpha) * N));
+			break;
+	}
+
+	// If FWER is not being accounted for, the p-value cutoff for significance is just alpha
+	*pcutoff = alpha;
+	ErrorCode status = Success;
+
+	if (method != Uncorrected)
+	{
+		// This only works when p-values decrease outside of the cutoffs, which holds for correlations & similar measures
+		size_t nsig = 0;
+		for (size_t a = 0; a < lr; a++)
+			nsig += (r[a] <= cutoffs[0] || r[a] >= cutoffs[1]);
+
+		size_t removed = 0;
+		int adjusted = 1;
+		switch (method)
+		{
+			case Binomial:
+				removed = binomialexcess(lr, nsig, alpha);
+				adjusted = (removed > 0);
+				nsig -= removed;
+				break;
+			case FalseDiscovery:
+				status = bhexcess(&nsig, r, lr, ns, ln, t, cutoffs, alpha);
+				break;
+			case GTest:
+				adjusted = gexcess(&removed, lr, nsig, alpha);
+				nsig -= removed;
+				break;
+			default:
+				break;
+		}
+
+		// Calculate new data & p-value cutoffs based on the FWER-adjusted number of significant trials. SGoF leaves them alone
+		// when it finds no excess at all.
+		if (status == Success && adjusted && nsig != 0)
+		{
+			double S = (double)nsig;
+			switch (t)
+			{
+				case Both:
+					cutoffs[0] = orderstat(ns, ln, ceil(S / 2));
+					cutoffs[1] = orderstat(ns, ln, N - floor(S / 2) + 1);
+					*pcutoff = fmax(pvalue(ns, ln, cutoffs[0], Both), pvalue(ns, ln, cutoffs[1], Both));
+					break;
+				case Left:
+					cutoffs[0] = orderstat(ns, ln, S);
+					*pcutoff = pvalue(ns, ln, cutoffs[0], Left);
+					break;
+				case Right:
+					cutoffs[1] = orderstat(ns, ln, N - S + 1);
+					*pcutoff = pvalue(ns, ln, cutoffs[1], Right);
+					break;
+			}
+		}
+	}
+
+	free(ns);
+	return status;
+}
@@ -0,0 +1,459 @@
+/* CORRELATE - Computes the correlation between an array of signals and one or more additional signals. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Moved out of Statistics/Mex/MexCorrelate.c so that it can be used without MATLAB.
+ *		20261017:	Added an all-pairs engine that standardizes every signal once and then gets the whole correlation matrix from a
+ *					cache-blocked matrix product, instead of recomputing sums for every pairing.
+ *		20261017:	Added CorrelateMapped, which streams signals out of memory-mapped files one tile at a time.
+ *		20261017:	Added single precision versions of corr and Correlate that accumulate in double precision.
+ *		20261017:	Few long signal pairs are now split across threads by sample chunks through the work-stealing scheduler, and all-pairs
+ *					blocks shrink so that every thread gets at least one.
+ *		20261017:	Added phase timers & counters for profiling.
+ *		20261017:	CorrelateMapped now releases every finished band of its output as well as the signals of X, so its working set
+ *					really is independent of the number of signals in X.
+ */
+
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Arena.h"
+#include "Matrix.h"
+#include "Parallel.h"
+#include "Profile.h"
+#include "Simd.h"
+#include "Statistics.h"
+
+
+
+/* CONSTANTS */
+#define BLOCKBYTES	(2 << 20)		// The approximate size of the standardized block of X that each thread works on.
+#define MINTILE		64				// The smallest number of signals that automatically sized tiles may hold.
+#define SLICE		1024			// The number of signals from Y whose single precision products are narrowed at once.
+#define SPLIT		8192			// The number of samples in each chunk of a signal pair that is split across threads.
+#define MINPAIRS	4				// The number of pairs per thread below which pairs are split into chunks.
+
+
+
+/* DATA */
+/// <summary>
+/// Describes a set of signal pairs whose samples are split into chunks, so that each (pair, chunk) task can run on any thread.
+/// </summary>
+typedef struct
+{
+	double*			Sums;			// The five raw sums of every task, with the chunks of each pair stored together.
+	const void*		X;				// The first sample of the first signal in X.
+	const void*		Y;				// The first sample of the first signal in Y.
+	int				LDX;			// The distance between the first samples of successive signals in X.
+	int				LDY;			// The distance between the first samples of successive signals in Y.
+	int				NumX;			// The number of signals in X.
+	int				NumSamples;		// The number of samples in every signal.
+	int				NumChunks;		// The number of chunks that each pair is split into.
+	Precision		Class;			// The precision of X & Y.
+}Pairs;
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Sums the raw moments of one chunk from every (pair, chunk) task in a range.
+/// </summary>
+static void pairchunks(void* args, size_t first, size_t last, int worker)
+{
+	const Pairs* p = (const Pairs*)args;
+	double t = phasestart();
+	for (size_t a = first; a < last; a++)
+	{
+		int pair = (int)(a / p->NumChunks);
+		int offset = (int)(a % p->NumChunks) * SPLIT;
+		int count = (p->NumSamples - offset < SPLIT) ? p->NumSamples - offset : SPLIT;
+		size_t idxX = (size_t)(pair % p->NumX) * p->LDX + offset;
+		size_t idxY = (size_t)(pair / p->NumX) * p->LDY + offset;
+		double* s = p->Sums + a * 5;
+
+		if (p->Class == SinglePrecision)
+		{
+			moments(s, (const float*)p->X + idxX, (const float*)p->Y + idxY, count);
+			continue;
+		}
+
+		const double* x = (const double*)p->X + idxX;
+		const double* y = (const double*)p->Y + idxY;
+		double sx = 0, sy = 0, sxy = 0, ssx = 0, ssy = 0;
+		for (int b = 0; b < count; b++)
+		{
+			sx += x[b];
+			sy += y[b];
+			sxy += x[b] * y[b];
+			ssx += x[b] * x[b];
+			ssy += y[b] * y[b];
+		}
+		s[0] = sx; s[1] = sy; s[2] = sxy; s[3] = ssx; s[4] = ssy;
+	}
+	phaseend(DirectPhase, t);
+}
+/// <summary>
+/// Computes the correlations between a few long signal pairs by splitting each pair into chunks of samples.
+/// </summary>
+/// <remarks>
+/// Looping over pairs leaves most threads idle when there are fewer pairs than threads. Raw sums are additive, so the
+/// chunks of each pair are summed independently by the work-stealing scheduler and then combined with the same formula
+/// that corr and corrf use.
+/// </remarks>
+/// <param name="r">An [NX x NY] output array of the same precision as the inputs.</param>
+static ErrorCode splitcorr(void* r, Precision class, const void* x, int ldx, int ncx, const void* y, int ldy, int ncy, int nrx)
+{
+	int npairs = ncx * ncy;
+	int nchunks = (nrx + SPLIT - 1) / SPLIT;
+	double* sums = (double*)malloc((size_t)npairs * nchunks * 5 * sizeof(double));
+	if (!sums) { return OutOfMemory; }
+
+	Pairs p = { sums, x, y, ldx, ldy, ncx, nrx, nchunks, class };
+	parallelfor((size_t)npairs * nchunks, pairchunks, &p);
+
+	for (int a = 0; a < npairs; a++)
+	{
+		double s[5] = { 0, 0, 0, 0, 0 };
+		for (int b = 0; b < nchunks; b++)
+			for (int c = 0; c < 5; c++)
+				s[c] += sums[((size_t)a * nchunks + b) * 5 + c];
+
+		double cov = (nrx * s[2]) - (s[0] * s[1]);
+		double scale = sqrt((nrx * s[3]) - (s[0] * s[0])) * sqrt((nrx * s[4]) - (s[1] * s[1]));
+		if (class == SinglePrecision)
+			((float*)r)[a] = (float)(cov / scale);
+		else
+			((double*)r)[a] = cov / scale;
+	}
+
+	free(sums);
+	return Success;
+}
+/// <summary>
+/// Standardizes one signal from an array of either single or double precision signals.
+/// </summary>
+static void zcolumn(double z[], const void* data, Precision class, size_t offset, int nsamples)
+{
+	if (class == SinglePrecision)
+		standardizef(z, (const float*)data + offset, nsamples);
+	else
+		standardize(z, (const double*)data + offset, nsamples);
+}
+/// <summary>
+/// Computes all pairwise correlations between X and Y using products of standardized signals.
+/// </summary>
+/// <remarks>
+/// Every signal in Y is standardized once up front. Signals in X are then standardized in blocks of a few megabytes,
+/// and each block is multiplied against all of Y, so memory use stays bounded no matter how many signals X contains.
+/// Blocks are distributed across threads. Standardized signals and their products are always in double precision. For
+/// single precision inputs, each block of products is narrowed into R in slices of Y so that the buffer stays small.
+/// </remarks>
+/// <param name="r">An [NX x NY] output array of the same precision as the inputs.</param>
+/// <param name="class">The precision of X, Y and R.</param>
+static ErrorCode mcorr(void* r, Precision class, const void* x, int ldx, int ncx, const void* y, int ldy, int ncy, int nrx)
+{
+	double* zy = (double*)malloc((size_t)nrx * ncy * sizeof(double));
+	if (!zy) { return OutOfMemory; }
+
+	#pragma omp parallel for schedule(static)
+	for (int a = 0; a < ncy; a++)
+	{
+		double t = phasestart();
+		zcolumn(zy + (size_t)a * nrx, y, class, (size_t)a * ldy, nrx);
+		phaseend(PreparePhase, t);
+	}
+
+	int nb = (int)(BLOCKBYTES / ((size_t)nrx * sizeof(double)));
+	nb = (nb < 4) ? 4 : (nb > 256) ? 256 : nb;
+	nb = (nb > ncx) ? ncx : nb;
+
+	// Smaller blocks cost a little efficiency in each product, which is far less than what idle threads would cost
+	int nfair = (ncx + maxthreads() - 1) / maxthreads();
+	nfair = (nfair < 4) ? 4 : nfair;
+	nb = (nb > nfair) ? nfair : nb;
+	int nblocks = (ncx + nb - 1) / nb;
+
+	int single = (class == SinglePrecision);
+	int nby = single ? ((ncy < SLICE) ? ncy : SLICE) : 0;
+
+	ErrorCode status = Success;
+
+	#pragma omp parallel
+	{
+		double* zx = (double*)malloc((size_t)nrx * nb * sizeof(double));
+		double* rb = single ? (double*)malloc((size_t)nb * nby * sizeof(double)) : NULL;
+		if (!zx || (single && !rb))
+		{
+			#pragma omp atomic write
+			status = OutOfMemory;
+		}
+
+		// Every thread has to agree on whether to enter the work-sharing loop below
+		#pragma omp barrier
+		if (status == Success)
+		{
+			#pragma omp for schedule(dynamic, 1)
+			for (int a = 0; a < nblocks; a++)
+			{
+				int idxX = a * nb;
+				int nbx = (ncx - idxX < nb) ? ncx - idxX : nb;
+
+				double t = phasestart();
+				for (int b = 0; b < nbx; b++)
+					zcolumn(zx + (size_t)b * nrx, x, class, (size_t)(idxX + b) * ldx, nrx);
+				phaseend(PreparePhase, t);
+
+				ErrorCode bstatus = Success;
+				if (!single)
+				{
+					t = phasestart();
+					bstatus = gemmtn(nbx, ncy, nrx, zx, nrx, zy, nrx, (double*)r + idxX, ncx);
+					phaseend(DirectPhase, t);
+				}
+				else
+				{
+					for (int idxY = 0; idxY < ncy && bstatus == Success; idxY += nby)
+					{
+						int ny = (ncy - idxY < nby) ? ncy - idxY : nby;
+						t = phasestart();
+						bstatus = gemmtn(nbx, ny, nrx, zx, nrx, zy + (size_t)idxY * nrx, nrx, rb, nbx);
+						phaseend(DirectPhase, t);
+
+						t = phasestart();
+						for (int c = 0; c < ny; c++)
+							narrow((float*)r + (size_t)(idxY + c) * ncx + idxX, rb + (size_t)c * nbx, (size_t)nbx);
+						phaseend(StorePhase, t);
+					}
+				}
+
+				if (bstatus != Success)
+				{
+					#pragma omp atomic write
+					status = bstatus;
+				}
+			}
+		}
+
+		free(zx);
+		free(rb);
+	}
+
+	free(zy);
+	return status;
+}
+
+
+
+/* FUNCTIONS */
+
+/// <summary>
+/// Computes the Pearson product-moment correlation coefficient between two signals.
+/// </summary>
+/// <param name="x">A signal vector.</param>
+/// <param name="y">A second signal vector of the same length as x.</param>
+/// <param name="nsamples">The number of sample points in x and y.</param>
+/// <returns>The correlation coefficient (r) between x and y.</returns>
+double corr(const double x[], const double y[], int nsamples)
+{
+	double sx, sy, sxy, ssx, ssy;
+	sx = sy = sxy = ssx = ssy = 0;
+	for (int a = 0; a < nsamples; a++)
+	{
+		sx += x[a];
+		sy += y[a];
+		sxy += x[a] * y[a];
+		ssx += x[a] * x[a];
+		ssy += y[a] * y[a];
+	}
+
+	double cov = (nsamples * sxy) - (sx * sy);
+	double scale = sqrt((nsamples * ssx) - (sx * sx)) * sqrt((nsamples * ssy) - (sy * sy));
+
+	return cov / scale;
+}
+/// <summary>
+/// Computes the correlation between every signal in X and every signal in Y.
+/// </summary>
+/// <param name="r">An [NX x NY] output array that receives the correlation coefficients.</param>
+/// <param name="x">An [M x NX] array of signals.</param>
+/// <param name="y">An [M x NY] array of signals.</param>
+ErrorCode Correlate(double r[], SignalArray x, SignalArray y)
+{
+	if (x.NumSamples == 0 || y.NumSamples == 0)	{ return EmptyInput; }
+	if (x.NumSamples != y.NumSamples)			{ return SizeMismatch; }
+
+	int ncx = x.NumSignals;
+	int ncy = y.NumSignals;
+	int nrx = x.NumSamples;
+
+	kernelbegin("Correlate");
+	profilecount(((size_t)nrx * (ncx + ncy) + (size_t)ncx * ncy) * elementsize(DoublePrecision), (size_t)ncx * ncy);
+
+	// Standardizing signals only pays off when they get reused, so single signal inputs are handled pairwise
+	ErrorCode status = Success;
+	if (ncx > 1 && ncy > 1)
+		status = mcorr(r, DoublePrecision, x.Data, x.Stride, ncx, y.Data, y.Stride, ncy, nrx);
+	else if (ncx * ncy < MINPAIRS * maxthreads() && nrx >= 2 * SPLIT)
+		status = splitcorr(r, DoublePrecision, x.Data, x.Stride, ncx, y.Data, y.Stride, ncy, nrx);
+	else if (ncy == 1)
+	{
+		#pragma omp parallel for schedule(static)
+		for (int a = 0; a < ncx; a++)
+		{
+			double t = phasestart();
+			r[a] = corr(column(x, a), y.Data, nrx);
+			phaseend(DirectPhase, t);
+		}
+	}
+	else
+	{
+		#pragma omp parallel for schedule(static)
+		for (int a = 0; a < ncy; a++)
+		{
+			double t = phasestart();
+			size_t idxR = (size_t)a * ncx;
+			for (int b = 0; b < ncx; b++)
+				r[idxR + b] = corr(column(x, b), column(y, a), nrx);
+			phaseend(DirectPhase, t);
+		}
+	}
+
+	kernelend();
+	return status;
+}
+/// <summary>
+/// Computes the Pearson product-moment correlation coefficient between two single precision signals.
+/// </summary>
+/// <param name="x">A signal vector.</param>
+/// <param name="y">A second signal vector of the same length as x.</param>
+/// <param name="nsamples">The number of sample points in x and y.</param>
+/// <returns>The correlation coefficient (r) between x and y.</returns>
+double corrf(const float x[], const float y[], int nsamples)
+{
+	double s[5];
+	moments(s, x, y, nsamples);
+
+	double cov = (nsamples * s[2]) - (s[0] * s[1]);
+	double scale = sqrt((nsamples * s[3]) - (s[0] * s[0])) * sqrt((nsamples * s[4]) - (s[1] * s[1]));
+
+	return cov / scale;
+}
+/// <summary>
+/// Computes the correlation between every single precision signal in X and every single precision signal in Y.
+/// </summary>
+/// <param name="r">An [NX x NY] output array that receives the correlation coefficients.</param>
+/// <param name="x">An [M x NX] array of signals.</param>
+/// <param name="y">An [M x NY] array of signals.</param>
+ErrorCode CorrelateF(float r[], SignalArrayF x, SignalArrayF y)
+{
+	if (x.NumSamples == 0 || y.NumSamples == 0)	{ return EmptyInput; }
+	if (x.NumSamples != y.NumSamples)			{ return SizeMismatch; }
+
+	int ncx = x.NumSignals;
+	int ncy = y.NumSignals;
+	int nrx = x.NumSamples;
+
+	kernelbegin("CorrelateF");
+	profilecount(((size_t)nrx * (ncx + ncy) + (size_t)ncx * ncy) * elementsize(SinglePrecision), (size_t)ncx * ncy);
+
+	ErrorCode status = Success;
+	if (ncx > 1 && ncy > 1)
+		status = mcorr(r, SinglePrecision, x.Data, x.Stride, ncx, y.Data, y.Stride, ncy, nrx);
+	else if (ncx * ncy < MINPAIRS * maxthreads() && nrx >= 2 * SPLIT)
+		status = splitcorr(r, SinglePrecision, x.Data, x.Stride, ncx, y.Data, y.Stride, ncy, nrx);
+	else if (ncy == 1)
+	{
+		#pragma omp parallel for schedule(static)
+		for (int a = 0; a < ncx; a++)
+		{
+			double t = phasestart();
+			r[a] = (float)corrf(columnf(x, a), y.Data, nrx);
+			phaseend(DirectPhase, t);
+		}
+	}
+	else
+	{
+		#pragma omp parallel for schedule(static)
+		for (int a = 0; a < ncy; a++)
+		{
+			double t = phasestart();
+			size_t idxR = (size_t)a * ncx;
+			for (int b = 0; b < ncx; b++)
+				r[idxR + b] = (float)corrf(columnf(x, b), columnf(y, a), nrx);
+			phaseend(DirectPhase, t);
+		}
+	}
+
+	kernelend();
+	return status;
+}
+/// <summary>
+/// Computes the correlation between every signal stored in a mapped array file and every signal in Y, tile by tile.
+/// </summary>
+/// <param name="r">A writable, double precision [NX x NY] mapped array that receives the correlation coefficients.</param>
+/// <param name="x">An [M x NX] mapped array of signals in either single or double precision.</param>
+/// <param name="y">An [M x NY] array of signals.</param>
+/// <param name="tilesize">The number of signals from X to process at once, or zero to size tiles automatically.</param>
+ErrorCode CorrelateMapped(MappedArray* r, const MappedArray* x, SignalArray y, int tilesize)
+{
+	if (x->NumRows == 0 || y.NumSamples == 0)				{ return EmptyInput; }
+	if (x->NumColumns == 0 || y.NumSignals == 0)			{ return EmptyInput; }
+	if (x->NumRows != (size_t)y.NumSamples)					{ return SizeMismatch; }
+	if (r->Class != DoublePrecision)						{ return InvalidArgument; }
+	if (r->NumRows != x->NumColumns || r->NumColumns != (size_t)y.NumSignals)	{ return SizeMismatch; }
+	if (tilesize < 0)										{ return InvalidArgument; }
+
+	size_t nrx = x->NumRows;
+	size_t ncx = x->NumColumns;
+	size_t ncy = (size_t)y.NumSignals;
+	int single = (x->Class == SinglePrecision);
+
+	// Automatic tiles use half of the memory budget for converted signals and correlation coefficients
+	size_t tilebytes = (single ? nrx : 0) * sizeof(double) + ncy * sizeof(double);
+	size_t nt = (tilesize > 0) ? (size_t)tilesize : GetMemoryBudget() / 2 / tilebytes;
+	nt = (tilesize == 0 && nt < MINTILE) ? MINTILE : nt;
+	nt = (nt > ncx) ? ncx : nt;
+	nt = (nt > (size_t)(INT_MAX / 2)) ? (size_t)(INT_MAX / 2) : nt;
+
+	Arena* arena = arenaacquire(aligned(nt * ncy * sizeof(double)) + (single ? aligned(nt * nrx * sizeof(double)) : 0));
+	if (!arena) { return OutOfMemory; }
+	double* rt = (double*)arenaalloc(arena, nt * ncy * sizeof(double));
+	double* xt = single ? (double*)arenaalloc(arena, nt * nrx * sizeof(double)) : NULL;
+
+	double* rdata = (double*)r->Data;
+	ErrorCode status = Success;
+
+	for (size_t idxX = 0; idxX < ncx && status == Success; idxX += nt)
+	{
+		int nbx = (int)((ncx - idxX < nt) ? ncx - idxX : nt);
+
+		SignalArray xs;
+		if (single)
+		{
+			const float* src = (const float*)x->Data + idxX * nrx;
+			size_t count = (size_t)nbx * nrx;
+
+			#pragma omp parallel for schedule(static)
+			for (size_t a = 0; a < count; a++)
+				xt[a] = (double)src[a];
+
+			xs = signals(xt, (int)nrx, nbx);
+		}
+		else
+			xs = signals((const double*)x->Data + idxX * nrx, (int)nrx, nbx);
+
+		status = Correlate(rt, xs, y);
+
+		// Each tile fills a band of rows in the output, so it gets scattered across every output column
+		for (size_t a = 0; a < ncy && status == Success; a++)
+			memcpy(rdata + a * ncx + idxX, rt + a * (size_t)nbx, (size_t)nbx * sizeof(double));
+
+		// Neither the signals of a tile nor its band of the output are touched again once the tile is done
+		EvictMappedColumns((MappedArray*)x, idxX, (size_t)nbx);
+		EvictMappedRows(r, idxX, (size_t)nbx);
+	}
+
+	arenarelease(arena);
+	return status;
+}
@@ -0,0 +1,1087 @@
+/* CROSSCORRELATE - Cross-correlates two sets of equivalent length signals. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Moved out of Statistics/Mex/MexCrossCorrelate.c so that it can be used without MATLAB. The MKL VSL correlation
+ *					task was replaced with the portable transforms in FFT.c.
+ *		20261017:	Every signal is now transformed once and its spectrum and norm are cached, so NX + NY forward transforms are
+ *					computed instead of 2 * NX * NY.
+ *		20261017:	Added support for computing only a subset of lags. Small lag sets are computed directly in the time domain, and
+ *					large ones use transforms that are only as long as the requested lags require.
+ *		20261017:	Cached spectra are now computed in batches that fit within the memory budget, using buffers from a reusable,
+ *					64-byte aligned arena instead of individual allocations.
+ *		20261017:	Added single precision versions. Signals are widened into per-thread buffers as they are needed and results are
+ *					narrowed on the way out, so the engines below only ever work in double precision.
+ *		20261017:	Added epilogues. Coefficients that need processing are computed into the same per-thread buffers that single
+ *					precision results use, then transformed, thresholded and scattered straight into their final places.
+ *		20261017:	Transform plans now come from the plan cache, so repeated calls of the same length skip building them.
+ *		20261017:	Added correlators, which ingest X once and keep its standardized signals, energies and spectra, so that it can be
+ *					correlated against any number of later signals without being processed again.
+ *		20261017:	Added phase timers & counters for profiling.
+ *		20261017:	Moved the pair loops of both engines onto the work-stealing loop scheduler. The direct engine also splits a few
+ *					long signal pairs into chunks of samples, and the engine choice now accounts for how many threads each can use.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Arena.h"
+#include "Epilogue.h"
+#include "FFT.h"
+#include "Matrix.h"
+#include "Parallel.h"
+#include "Profile.h"
+#include "Simd.h"
+#include "Statistics.h"
+
+
+
+/* CONSTANTS */
+#define DIRECTCOST	1.0		// The relative cost of one multiply-add in a direct dot product versus one FFT "flop".
+#define BLOCK		256		// The most signals that one thread multiplies against Y at once in correlators without lags.
+#define SLICE		1024	// The number of signals from Y whose products are buffered at once for an epilogue.
+#define SPLIT		8192	// The number of samples in each chunk of a signal pair that the direct engine splits.
+#define MINPAIRS	4		// The number of pairs per thread below which the direct engine splits pairs into chunks.
+
+
+
+/* DATA */
+/// <summary>
+/// Describes an array of signals in either single or double precision.
+/// </summary>
+typedef struct
+{
+	const void*		Data;
+	Precision		Class;
+	int				NumSamples;
+	int				NumSignals;
+	int				Stride;
+}Input;
+
+/// <summary>
+/// Describes where & how the engines store cross-correlation coefficients.
+/// </summary>
+typedef struct
+{
+	void*				Data;
+	Precision			Class;
+	const Epilogue*		Epilogue;
+}Output;
+
+/// <summary>
+/// Describes the tasks of the direct engine, which are either whole signal pairs or (pair, chunk) pieces of them.
+/// </summary>
+typedef struct
+{
+	Output			CC;				// Where & how the coefficients are stored.
+	Input			X;				// The first array of signals.
+	Input			Y;				// The second array of signals.
+	const int*		Lags;			// The sample shifts of X relative to Y at which correlations are computed.
+	int				NumLags;		// The number of lags.
+	const double*	SSX;			// The sum of the squared samples of every signal in X.
+	const double*	SSY;			// The sum of the squared samples of every signal in Y.
+	int				NumChunks;		// The number of chunks that each pair is split into, or 1 to keep pairs whole.
+	double*			Sums;			// The raw lagged sums of every (pair, chunk) task.
+	char*			Buffers;		// Per-thread workspace for whole pairs.
+	size_t			SizeColumn;		// The bytes set aside in each workspace for one widened signal.
+	size_t			SizeBuffer;		// The bytes in each workspace.
+}Direct;
+
+/// <summary>
+/// Describes the signal pairings that the transform engine correlates from one batch of cached spectra.
+/// </summary>
+typedef struct
+{
+	Output			CC;				// Where & how the coefficients are stored.
+	const int*		Lags;			// The sample shifts of X relative to Y at which correlations are computed.
+	int				NumLags;		// The number of lags.
+	const double*	SSX;			// The sum of the squared samples of every signal in X.
+	const double*	SSY;			// The sum of the squared samples of every signal in Y.
+	int				NumX;			// The number of signals in all of X.
+	int				X0;				// The index of the first signal from X in the batch.
+	int				Y0;				// The index of the first signal from Y in the batch.
+	int				BatchX;			// The number of signals from X in the batch.
+	const Complex*	Fx;				// The spectra of the signals from X in the batch.
+	const Complex*	Fy;				// The spectra of the signals from Y in the batch.
+	size_t			LDF;			// The distance between successive spectra.
+	const FFTPlan*	Plan;			// The plan that the spectra were computed with.
+	Complex*		Cxy;			// Per-thread cross-spectral densities.
+	double*			CCP;			// Per-thread circular cross-correlations.
+	double*			WCC;			// Per-thread coefficient buffers, or NULL when coefficients are stored directly.
+	size_t			LDCCP;			// The distance between successive circular cross-correlation buffers.
+	size_t			LDWCC;			// The distance between successive coefficient buffers.
+}Spectra;
+
+/// <summary>
+/// Describes signals that the transform engine transforms into one batch of cached spectra.
+/// </summary>
+typedef struct
+{
+	Input			In;				// The array of signals.
+	int				First;			// The index of the first signal in the batch.
+	Complex*		F;				// The spectra of the batch.
+	size_t			LDF;			// The distance between successive spectra.
+	const FFTPlan*	Plan;			// The plan that computes the spectra.
+	double*			CCP;			// Per-thread buffers that single precision signals are widened into.
+	size_t			LDCCP;			// The distance between successive buffers.
+}Transforms;
+
+
+
+/* SUBROUTINES */
+static Input input(SignalArray x)
+{
+	Input in = { x.Data, DoublePrecision, x.NumSamples, x.NumSignals, x.Stride };
+	return in;
+}
+static Input inputf(SignalArrayF x)
+{
+	Input in = { x.Data, SinglePrecision, x.NumSamples, x.NumSignals, x.Stride };
+	return in;
+}
+static Output output(void* data, Precision class, const Epilogue* epilogue)
+{
+	Output out = { data, class, epilogue };
+	return out;
+}
+/// <summary>
+/// Determines whether coefficients have to be computed into a buffer before they can be stored in an output.
+/// </summary>
+static int buffered(Output out)
+{
+	return (out.Class == SinglePrecision || out.Epilogue != NULL);
+}
+/// <summary>
+/// Stores the buffered coefficients of one signal pairing in an output.
+/// </summary>
+static void store(Output out, const double cc[], int idxX, int idxY, int ncx, int nlags)
+{
+	if (out.Epilogue)
+		epiloguestore(out.Epilogue, (double*)out.Data, cc, idxX, idxY, ncx, nlags);
+	else
+		narrow((float*)out.Data + ((size_t)idxY * ncx + idxX) * nlags, cc, (size_t)nlags);
+}
+/// <summary>
+/// Gets a double precision copy of one signal, or the signal itself if it is already in double precision.
+/// </summary>
+/// <param name="buffer">Workspace that receives widened samples. This must hold at least NumSamples elements.</param>
+static const double* load(Input in, int idx, double buffer[])
+{
+	size_t offset = (size_t)idx * (size_t)in.Stride;
+	if (in.Class == DoublePrecision)
+		return (const double*)in.Data + offset;
+
+	widen(buffer, (const float*)in.Data + offset, (size_t)in.NumSamples);
+	return buffer;
+}
+/// <summary>
+/// Reads one sample from an array of signals in double precision.
+/// </summary>
+static inline double sample(Input in, size_t idx)
+{
+	return (in.Class == DoublePrecision) ? ((const double*)in.Data)[idx] : (double)((const float*)in.Data)[idx];
+}
+/// <summary>
+/// Computes the sum of the squared samples of one signal.
+/// </summary>
+static double sumsq(Input in, int idx)
+{
+	size_t offset = (size_t)idx * (size_t)in.Stride;
+	double sum = 0;
+	if (in.Class == DoublePrecision)
+	{
+		const double* x = (const double*)in.Data + offset;
+		for (int a = 0; a < in.NumSamples; a++)
+			sum += x[a] * x[a];
+	}
+	else
+	{
+		const float* x = (const float*)in.Data + offset;
+		for (int a = 0; a < in.NumSamples; a++)
+			sum += (double)x[a] * (double)x[a];
+	}
+	return sum;
+}
+/// <summary>
+///	Calculates the cross-correlation function between two signals at selected lags using dot products.
+/// </summary>
+/// <param name="cc">An output vector that receives one correlation coefficient per lag.</param>
+/// <param name="lags">The sample shifts of x relative to y at which correlations are computed.</param>
+/// <param name="nlags">The number of elements in lags and cc.</param>
+/// <param name="x">A vector of data to be cross-correlated with the data in y.</param>
+/// <param name="y">A vector of data to be cross-correlated with the data in x.</param>
+/// <param name="nsamples">The number of elements in x and y.</param>
+/// <param name="scale">The factor that converts cross-covariance into Pearson correlation coefficients.</param>
+static void dxcorr(double cc[], const int lags[], int nlags, const double x[], const double y[], int nsamples, double scale)
+{
+	for (int a = 0; a < nlags; a++)
+	{
+		int lag = lags[a];
+		int first = (lag < 0) ? -lag : 0;
+		int last = (lag > 0) ? nsamples - lag : nsamples;
+
+		double sum = 0;
+		const double* xs = x + lag;
+		#pragma omp simd reduction(+:sum)
+		for (int b = first; b < last; b++)
+			sum += xs[b] * y[b];
+
+		cc[a] = sum * scale;
+	}
+}
+/// <summary>
+/// Sums the lagged products of two signals over one chunk of samples from the second signal.
+/// </summary>
+/// <param name="sums">An output vector that receives one raw sum per lag.</param>
+/// <param name="start">The first sample of y in the chunk.</param>
+/// <param name="count">The number of samples of y in the chunk.</param>
+static void dxsums(double sums[], const int lags[], int nlags, Input x, int idxX, Input y, int idxY, int start, int count)
+{
+	int nsamples = x.NumSamples;
+	size_t ox = (size_t)idxX * (size_t)x.Stride;
+	size_t oy = (size_t)idxY * (size_t)y.Stride;
+
+	for (int a = 0; a < nlags; a++)
+	{
+		int lag = lags[a];
+		int first = (lag < 0) ? -lag : 0;
+		int last = (lag > 0) ? nsamples - lag : nsamples;
+		first = (first > start) ? first : start;
+		last = (last < start + count) ? last : start + count;
+
+		double sum = 0;
+		if (x.Class == DoublePrecision && y.Class == DoublePrecision)
+		{
+			const double* xs = (const double*)x.Data + ox + lag;
+			const double* ys = (const double*)y.Data + oy;
+			#pragma omp simd reduction(+:sum)
+			for (int b = first; b < last; b++)
+				sum += xs[b] * ys[b];
+		}
+		else if (x.Class == SinglePrecision && y.Class == SinglePrecision)
+		{
+			const float* xs = (const float*)x.Data + ox + lag;
+			const float* ys = (const float*)y.Data + oy;
+			#pragma omp simd reduction(+:sum)
+			for (int b = first; b < last; b++)
+				sum += (double)xs[b] * (double)ys[b];
+		}
+		else
+		{
+			for (int b = first; b < last; b++)
+				sum += sample(x, ox + lag + b) * sample(y, oy + b);
+		}
+		sums[a] = sum;
+	}
+}
+/// <summary>
+///	Calculates the cross-correlation function between two signals at selected lags from their precomputed spectra.
+/// </summary>
+/// <param name="cc">An output vector that receives one correlation coefficient per lag.</param>
+/// <param name="lags">The sample shifts of x relative to y at which correlations are computed.</param>
+/// <param name="nlags">The number of elements in lags and cc.</param>
+/// <param name="Fx">The spectrum of the first signal.</param>
+/// <param name="Fy">The spectrum of the second signal.</param>
+/// <param name="scale">The factor that converts cross-covariance into Pearson correlation coefficients.</param>
+/// <param name="plan">The transform plan that was used to compute Fx and Fy.</param>
+/// <param name="Cxy">Workspace for the cross-spectral density (nfft / 2 + 1 elements).</param>
+/// <param name="ccp">Workspace for the circular cross-correlation (nfft elements).</param>
+static void xcorr(double cc[], const int lags[], int nlags, const Complex Fx[], const Complex Fy[], double scale, const FFTPlan* plan, Complex Cxy[], double ccp[])
+{
+	int nfft = fftlength(plan);
+	int nbins = nfft / 2 + 1;
+
+	// The cross-spectral density is the transform of the cross-covariance function
+	double t = phasestart();
+	for (int a = 0; a < nbins; a++)
+	{
+		Cxy[a].re = Fx[a].re * Fy[a].re + Fx[a].im * Fy[a].im;
+		Cxy[a].im = Fx[a].im * Fy[a].re - Fx[a].re * Fy[a].im;
+	}
+	phaseend(SpectrumPhase, t);
+
+	t = phasestart();
+	irfft(plan, ccp, Cxy);
+	phaseend(InversePhase, t);
+
+	// Negative lags wrap around to the end of the circular cross-correlation. The transform length is a power of two, so
+	// masking is the same as taking the lag modulo nfft.
+	t = phasestart();
+	for (int a = 0; a < nlags; a++)
+		cc[a] = ccp[lags[a] & (nfft - 1)] * scale;
+	phaseend(GatherPhase, t);
+}
+/// <summary>
+/// Gets the number of chunks that the direct engine splits each signal pair into.
+/// </summary>
+/// <remarks>
+/// Looping over pairs leaves most threads idle when there are fewer pairs than threads, so a few long pairs are split into
+/// chunks of samples instead, as long as the raw sums of every chunk fit within the memory budget.
+/// </remarks>
+static int splitcount(int nsamples, int npairs, int nlags)
+{
+	int nchunks = (nsamples + SPLIT - 1) / SPLIT;
+	if (npairs >= MINPAIRS * maxthreads() || nsamples < 2 * SPLIT) { return 1; }
+	if ((size_t)npairs * nchunks * nlags * sizeof(double) > GetMemoryBudget()) { return 1; }
+	return nchunks;
+}
+/// <summary>
+/// Computes either the coefficients of every whole pair, or the raw sums of every (pair, chunk) task, in a range.
+/// </summary>
+static void directtasks(void* args, size_t first, size_t last, int worker)
+{
+	const Direct* d = (const Direct*)args;
+	int nlags = d->NumLags;
+	int ncx = d->X.NumSignals;
+
+	if (d->NumChunks > 1)
+	{
+		double t = phasestart();
+		for (size_t a = first; a < last; a++)
+		{
+			int pair = (int)(a / d->NumChunks);
+			int start = (int)(a % d->NumChunks) * SPLIT;
+			int count = (d->X.NumSamples - start < SPLIT) ? d->X.NumSamples - start : SPLIT;
+			dxsums(d->Sums + a * nlags, d->Lags, nlags, d->X, pair % ncx, d->Y, pair / ncx, start, count);
+		}
+		phaseend(DirectPhase, t);
+		return;
+	}
+
+	int single = (d->X.Class == SinglePrecision);
+	int buffer = buffered(d->CC);
+	char* workspace = d->Buffers ? d->Buffers + (size_t)worker * d->SizeBuffer : NULL;
+	double* wx = single ? (double*)workspace : NULL;
+	double* wy = single ? (double*)(workspace + d->SizeColumn) : NULL;
+	double* wcc = buffer ? (double*)(workspace + (single ? 2 * d->SizeColumn : 0)) : NULL;
+
+	for (size_t a = first; a < last; a++)
+	{
+		int idxY = (int)(a / ncx);
+		int idxX = (int)(a % ncx);
+		double scale = 1.0 / sqrt(d->SSX[idxX] * d->SSY[idxY]);
+
+		double* out = buffer ? wcc : (double*)d->CC.Data + a * nlags;
+		double t = phasestart();
+		const double* sx = load(d->X, idxX, wx);
+		const double* sy = load(d->Y, idxY, wy);
+		if (single) { phaseend(PreparePhase, t); }
+
+		t = phasestart();
+		dxcorr(out, d->Lags, nlags, sx, sy, d->X.NumSamples, scale);
+		phaseend(DirectPhase, t);
+
+		if (buffer)
+		{
+			t = phasestart();
+			store(d->CC, out, idxX, idxY, ncx, nlags);
+			phaseend(StorePhase, t);
+		}
+	}
+}
+/// <summary>
+/// Cross-correlates every signal pairing at selected lags using direct dot products.
+/// </summary>
+/// <remarks>
+/// Pairs are distributed across threads by the work-stealing scheduler. Single precision signals are widened into
+/// per-thread buffers, and results are computed into another per-thread buffer before being narrowed into CC. When there
+/// are too few pairs to keep every thread busy, pairs are split into chunks of samples instead (see splitcount). Lagged
+/// sums are additive, so the chunks are summed independently and then combined and stored one pair at a time.
+/// </remarks>
+static ErrorCode xcorrdirect(Output cc, Input x, Input y, const int lags[], int nlags, const double ssx[], const double ssy[])
+{
+	int nrx = x.NumSamples;
+	int ncx = x.NumSignals;
+	int npairs = ncx * y.NumSignals;
+	int nchunks = splitcount(nrx, npairs, nlags);
+	Direct d = { cc, x, y, lags, nlags, ssx, ssy, nchunks, NULL, NULL, 0, 0 };
+
+	if (nchunks > 1)
+	{
+		double* sums = (double*)malloc(((size_t)npairs * nchunks + 1) * nlags * sizeof(double));
+		if (!sums) { return OutOfMemory; }
+
+		d.Sums = sums;
+		parallelfor((size_t)npairs * nchunks, directtasks, &d);
+
+		double* pcc = sums + (size_t)npairs * nchunks * nlags;
+		for (int a = 0; a < npairs; a++)
+		{
+			double t = phasestart();
+			int idxY = a / ncx;
+			int idxX = a % ncx;
+			double scale = 1.0 / sqrt(ssx[idxX] * ssy[idxY]);
+			double* out = buffered(cc) ? pcc : (double*)cc.Data + (size_t)a * nlags;
+
+			for (int b = 0; b < nlags; b++)
+			{
+				double sum = 0;
+				for (int c = 0; c < nchunks; c++)
+					sum += sums[((size_t)a * nchunks + c) * nlags + b];
+				out[b] = sum * scale;
+			}
+			if (buffered(cc)) { store(cc, out, idxX, idxY, ncx, nlags); }
+			phaseend(StorePhase, t);
+		}
+
+		free(sums);
+		return Success;
+	}
+
+	int single = (x.Class == SinglePrecision);
+	d.SizeColumn = aligned((size_t)nrx * sizeof(double));
+	d.SizeBuffer = (single ? 2 * d.SizeColumn : 0) + (buffered(cc) ? aligned((size_t)nlags * sizeof(double)) : 0);
+
+	double t = phasestart();
+	Arena* arena = d.SizeBuffer ? arenaacquire(maxthreads() * d.SizeBuffer) : NULL;
+	phaseend(PlanPhase, t);
+	if (d.SizeBuffer && !arena) { return OutOfMemory; }
+	d.Buffers = d.SizeBuffer ? (char*)arenaalloc(arena, maxthreads() * d.SizeBuffer) : NULL;
+
+	parallelfor((size_t)npairs, directtasks, &d);
+
+	arenarelease(arena);
+	return Success;
+}
+/// <summary>
+/// Transforms every signal of a batch in a range into its cached spectrum.
+/// </summary>
+static void transformtasks(void* args, size_t first, size_t last, int worker)
+{
+	const Transforms* f = (const Transforms*)args;
+
+	// Single precision signals are widened into the worker's circular cross-correlation buffer first
+	double* buffer = f->CCP + (size_t)worker * f->LDCCP;
+	for (size_t a = first; a < last; a++)
+	{
+		double t = phasestart();
+		rfft(f->Plan, f->F + a * f->LDF, load(f->In, f->First + (int)a, buffer), f->In.NumSamples);
+		phaseend(ForwardPhase, t);
+	}
+}
+/// <summary>
+/// Cross-correlates every signal pairing in a range from one batch of cached spectra.
+/// </summary>
+static void spectratasks(void* args, size_t first, size_t last, int worker)
+{
+	const Spectra* p = (const Spectra*)args;
+	int nlags = p->NumLags;
+	Complex* Cxy = p->Cxy + (size_t)worker * p->LDF;
+	double* ccp = p->CCP + (size_t)worker * p->LDCCP;
+	double* wcc = p->WCC ? p->WCC + (size_t)worker * p->LDWCC : NULL;
+
+	for (size_t a = first; a < last; a++)
+	{
+		int bx = (int)(a % p->BatchX);
+		int by = (int)(a / p->BatchX);
+		int idxX = p->X0 + bx;
+		int idxY = p->Y0 + by;
+		double scale = 1.0 / sqrt(p->SSX[idxX] * p->SSY[idxY]);
+		double* out = wcc ? wcc : (double*)p->CC.Data + ((size_t)idxY * p->NumX + idxX) * nlags;
+
+		xcorr(out, p->Lags, nlags, p->Fx + bx * p->LDF, p->Fy + by * p->LDF, scale, p->Plan, Cxy, ccp);
+		if (wcc)
+		{
+			double t = phasestart();
+			store(p->CC, out, idxX, idxY, p->NumX, nlags);
+			phaseend(StorePhase, t);
+		}
+	}
+}
+/// <summary>
+/// Computes and caches the spectra of signals in batches, then cross-correlates every signal pairing at selected lags.
+/// </summary>
+/// <remarks>
+/// Every signal in a batch is transformed exactly once using a single shared plan. Each signal pairing then only costs one
+/// conjugate multiplication and one inverse transform. Batches are sized so that cached spectra and per-thread buffers fit
+/// within the memory budget, and all of that memory comes from one reusable arena. Ideally all of Y fits into one batch,
+/// in which case every signal is transformed exactly once. When X and Y describe the same array (i.e. autocorrelations)
+/// and X fits into one batch, the spectra are computed for X only and shared.
+/// </remarks>
+/// <param name="cached">The spectra of every signal in X, computed by a correlator, or NULL to compute them here.</param>
+static ErrorCode xcorrfft(Output cc, Input x, Input y, const int lags[], int nlags, const double ssx[], const double ssy[], int nfft, const Complex cached[])
+{
+	int ncx = x.NumSignals;
+	int ncy = y.NumSignals;
+	int nbins = nfft / 2 + 1;
+	int nthreads = maxthreads();
+	int buffer = buffered(cc);
+
+	// Spectra are stored at cache line aligned offsets, so their leading dimension is rounded up accordingly
+	size_t szspec = aligned(nbins * sizeof(Complex));
+	size_t ldF = szspec / sizeof(Complex);
+	size_t szthread = szspec + aligned(nfft * sizeof(double)) + (buffer ? aligned(nlags * sizeof(double)) : 0);
+
+	size_t budget = GetMemoryBudget();
+	size_t fixed = nthreads * szthread;
+	size_t nfit = (budget > fixed) ? (budget - fixed) / szspec : 0;
+
+	int bx, by;
+	int shared = (!cached && x.Data == y.Data && ncx == ncy && x.Stride == y.Stride && nfit >= (size_t)ncx);
+	if (shared)
+	{
+		bx = by = ncx;
+	}
+	else if (cached)
+	{
+		// Cached spectra all live outside of the arena, so Y can have whatever the budget allows
+		bx = ncx;
+		by = ((size_t)ncy <= nfit) ? ncy : (int)nfit;
+		by = (by < 1) ? 1 : by;
+	}
+	else
+	{
+		// Budgets too small for even one spectrum of each get exactly one of each, never all of X
+		by = ((size_t)ncy <= nfit / 2) ? ncy : (int)(nfit / 2);
+		by = (by < 1) ? 1 : by;
+		bx = (nfit <= (size_t)by) ? 1 : (nfit - by < (size_t)ncx) ? (int)(nfit - by) : ncx;
+	}
+
+	size_t total = fixed + (cached ? 0 : (size_t)bx * szspec) + (shared ? 0 : (size_t)by * szspec);
+	double t = phasestart();
+	Arena* arena = arenaacquire(total);
+	FFTPlan* plan = fftacquire(nfft);
+	phaseend(PlanPhase, t);
+	if (!arena || !plan)
+	{
+		arenarelease(arena);
+		fftrelease(plan);
+		return OutOfMemory;
+	}
+
+	Complex* Fx = cached ? (Complex*)cached : (Complex*)arenaalloc(arena, (size_t)bx * szspec);
+	Complex* Fy = shared ? Fx : (Complex*)arenaalloc(arena, (size_t)by * szspec);
+	Complex* Cxy = (Complex*)arenaalloc(arena, nthreads * szspec);
+	double* ccp = (double*)arenaalloc(arena, nthreads * aligned(nfft * sizeof(double)));
+	size_t ldccp = aligned(nfft * sizeof(double)) / sizeof(double);
+	size_t ldwcc = aligned(nlags * sizeof(double)) / sizeof(double);
+	double* wcc = buffer ? (double*)arenaalloc(arena, nthreads * ldwcc * sizeof(double)) : NULL;
+
+	Transforms f = { y, 0, Fy, ldF, plan, ccp, ldccp };
+	Spectra p = { cc, lags, nlags, ssx, ssy, ncx, 0, 0, 0, Fx, Fy, ldF, plan, Cxy, ccp, wcc, ldccp, ldwcc };
+
+	for (int y0 = 0; y0 < ncy; y0 += by)
+	{
+		int nby = (ncy - y0 < by) ? ncy - y0 : by;
+		if (!shared)
+		{
+			f.In = y;
+			f.First = y0;
+			f.F = Fy;
+			parallelfor((size_t)nby, transformtasks, &f);
+		}
+
+		for (int x0 = 0; x0 < ncx; x0 += bx)
+		{
+			int nbx = (ncx - x0 < bx) ? ncx - x0 : bx;
+			if (!cached)
+			{
+				f.In = x;
+				f.First = x0;
+				f.F = Fx;
+				parallelfor((size_t)nbx, transformtasks, &f);
+			}
+
+			p.X0 = x0;
+			p.Y0 = y0;
+			p.BatchX = nbx;
+			parallelfor((size_t)nbx * nby, spectratasks, &p);
+		}
+	}
+
+	fftrelease(plan);
+	arenarelease(arena);
+	return Success;
+}
+/// <summary>
+/// Estimates the relative cost of computing selected lags of one signal pairing using direct dot products.
+/// </summary>
+static double directcost(int nsamples, const int lags[], int nlags)
+{
+	double direct = 0;
+	for (int a = 0; a < nlags; a++)
+		direct += nsamples - abs(lags[a]);
+	return DIRECTCOST * direct;
+}
+/// <summary>
+/// Estimates the relative cost of one transform, along with the spectral product that accompanies it.
+/// </summary>
+static double fftcost(int nfft)
+{
+	return 2.5 * nfft * log2((double)nfft) + 4.0 * nfft;
+}
+/// <summary>
+/// Estimates how long a number of equally sized tasks take relative to just one of them when spread across threads.
+/// </summary>
+static double spread(double ntasks, int nthreads)
+{
+	return ceil(ntasks / nthreads);
+}
+/// <summary>
+/// Estimates whether cross-correlating in the frequency domain is faster than computing dot products directly.
+/// </summary>
+/// <remarks>
+/// The direct engine can split a few long pairs across every thread, whereas the transform engine can only spread whole
+/// transforms, so costs are compared per thread rather than in total.
+/// </remarks>
+static int usefft(int nsamples, int ncx, int ncy, const int lags[], int nlags, int nfft)
+{
+	int nthreads = maxthreads();
+	int nchunks = splitcount(nsamples, ncx * ncy, nlags);
+	double npairs = (double)ncx * (double)ncy;
+	double direct = directcost(nsamples, lags, nlags) / nchunks * spread(npairs * nchunks, nthreads);
+
+	// One inverse transform & spectral product per pairing, plus one forward transform per signal
+	double fft = fftcost(nfft) * (spread(npairs, nthreads) + spread(ncx, nthreads) + spread(ncy, nthreads));
+
+	return fft < direct;
+}
+
+
+
+/// <summary>
+/// Builds the list of every lag that the full cross-correlation of M sample signals contains.
+/// </summary>
+static int* alllags(int nsamples)
+{
+	int ncc = 2 * nsamples - 1;
+	int* lags = (int*)malloc(ncc * sizeof(int));
+	if (lags)
+	{
+		for (int a = 0; a < ncc; a++)
+			lags[a] = a - (nsamples - 1);
+	}
+	return lags;
+}
+/// <summary>
+/// Cross-correlates every signal pairing at selected lags, choosing whichever engine is expected to be faster.
+/// </summary>
+/// <remarks>
+/// Only the requested lags are computed and stored. When the lag set is small relative to the signal length, this
+/// computes dot products directly. Otherwise, it uses transforms that are just long enough to avoid wrapping any of the
+/// requested lags, which is shorter than what the full cross-correlation needs whenever the lags are limited.
+/// </remarks>
+static ErrorCode xcorrlags(Output cc, Input x, Input y, const int lags[], int nlags)
+{
+	if (x.NumSamples == 0 || x.NumSignals == 0)	{ return EmptyInput; }
+	if (x.NumSamples != y.NumSamples)			{ return SizeMismatch; }
+	if (nlags <= 0)								{ return InvalidArgument; }
+
+	ErrorCode status = epiloguecheck(cc.Epilogue, x.NumSignals);
+	if (status != Success) { return status; }
+
+	int nrx = x.NumSamples;
+	int ncx = x.NumSignals;
+	int ncy = y.NumSignals;
+
+	int maxlag = 0;
+	for (int a = 0; a < nlags; a++)
+	{
+		int lag = abs(lags[a]);
+		if (lag >= nrx) { return InvalidArgument; }
+		if (lag > maxlag) { maxlag = lag; }
+	}
+
+	double* ssx = (double*)malloc((ncx + ncy) * sizeof(double));
+	if (!ssx) { return OutOfMemory; }
+	double* ssy = ssx + ncx;
+
+	#pragma omp parallel for schedule(static)
+	for (int a = 0; a < ncx + ncy; a++)
+	{
+		double t = phasestart();
+		ssx[a] = (a < ncx) ? sumsq(x, a) : sumsq(y, a - ncx);
+		phaseend(PreparePhase, t);
+	}
+
+	// Every signal is read at least once & every coefficient is written once
+	size_t npairs = (size_t)ncx * ncy;
+	profilecount((size_t)nrx * (ncx + ncy) * elementsize(x.Class) + npairs * nlags * elementsize(cc.Class), npairs);
+
+	// Circular correlation at lag L picks up aliased terms from lag L -/+ nfft, which stay out of range when nfft >= M + L
+	int nfft = nextpow2(nrx + maxlag);
+
+	status = epiloguefill(cc.Epilogue, (double*)cc.Data, ncx, ncy, nlags);
+	if (status == Success)
+	{
+		if (usefft(nrx, ncx, ncy, lags, nlags, nfft))
+			status = xcorrfft(cc, x, y, lags, nlags, ssx, ssy, nfft, NULL);
+		else
+			status = xcorrdirect(cc, x, y, lags, nlags, ssx, ssy);
+	}
+
+	free(ssx);
+	return status;
+}
+
+
+
+/// <summary>
+/// Correlates every signal in Y with the standardized signals that a correlator without lags holds.
+/// </summary>
+/// <remarks>
+/// Y is standardized once, and then blocks of the correlator's signals are multiplied against all of it on different
+/// threads, just like the all-pairs engine of Correlate. With an epilogue, each block of products is computed into a
+/// per-thread buffer in slices of Y and then stored one coefficient at a time.
+/// </remarks>
+static ErrorCode zcorr(Output r, const Correlator* c, Input y)
+{
+	int nrx = c->NumSamples;
+	int ncx = c->NumSignals;
+	int ncy = y.NumSignals;
+
+	double* zy = (double*)malloc((size_t)nrx * ncy * sizeof(double));
+	if (!zy) { return OutOfMemory; }
+
+	#pragma omp parallel for schedule(static)
+	for (int a = 0; a < ncy; a++)
+	{
+		double t = phasestart();
+		standardize(zy + (size_t)a * nrx, load(y, a, NULL), nrx);
+		phaseend(PreparePhase, t);
+	}
+
+	int buffer = buffered(r);
+	if (ncy == 1)
+	{
+		// Matrix products don't pay off against a single signal, so each coefficient is one dot product at lag zero
+		int zero = 0;
+
+		#pragma omp parallel for schedule(static)
+		for (int a = 0; a < ncx; a++)
+		{
+			double v;
+			double t = phasestart();
+			dxcorr(buffer ? &v : (double*)r.Data + a, &zero, 1, c->Signals + (size_t)a * nrx, zy, nrx, 1.0);
+			if (buffer) { store(r, &v, a, 0, ncx, 1); }
+			phaseend(DirectPhase, t);
+		}
+
+		free(zy);
+		return Success;
+	}
+
+	int nb = (ncx + maxthreads() - 1) / maxthreads();
+	nb = (nb > BLOCK) ? BLOCK : nb;
+	int nblocks = (ncx + nb - 1) / nb;
+	int nby = buffer ? ((ncy < SLICE) ? ncy : SLICE) : 0;
+
+	ErrorCode status = Success;
+
+	#pragma omp parallel
+	{
+		double* rb = buffer ? (double*)malloc((size_t)nb * nby * sizeof(double)) : NULL;
+		if (buffer && !rb)
+		{
+			#pragma omp atomic write
+			status = OutOfMemory;
+		}
+
+		// Every thread has to agree on whether to enter the work-sharing loop below
+		#pragma omp barrier
+		if (status == Success)
+		{
+			#pragma omp for schedule(dynamic, 1)
+			for (int a = 0; a < nblocks; a++)
+			{
+				int idxX = a * nb;
+				int nbx = (ncx - idxX < nb) ? ncx - idxX : nb;
+				const double* zx = c->Signals + (size_t)idxX * nrx;
+
+				ErrorCode bstatus = Success;
+				if (!buffer)
+				{
+					double t = phasestart();
+					bstatus = gemmtn(nbx, ncy, nrx, zx, nrx, zy, nrx, (double*)r.Data + idxX, ncx);
+					phaseend(DirectPhase, t);
+				}
+				else
+				{
+					for (int idxY = 0; idxY < ncy && bstatus == Success; idxY += nby)
+					{
+						int ny = (ncy - idxY < nby) ? ncy - idxY : nby;
+						double t = phasestart();
+						bstatus = gemmtn(nbx, ny, nrx, zx, nrx, zy + (size_t)idxY * nrx, nrx, rb, nbx);
+						phaseend(DirectPhase, t);
+
+						t = phasestart();
+						for (int d = 0; d < ny * nbx; d++)
+							store(r, rb + d, idxX + d % nbx, idxY + d / nbx, ncx, 1);
+						phaseend(StorePhase, t);
+					}
+				}
+
+				if (bstatus != Success)
+				{
+					#pragma omp atomic write
+					status = bstatus;
+				}
+			}
+		}
+
+		free(rb);
+	}
+
+	free(zy);
+	return status;
+}
+/// <summary>
+/// Correlates every signal in Y with every signal that a correlator holds, using whichever engine it was created for.
+/// </summary>
+static ErrorCode apply(double out[], const Correlator* c, Input y, const Epilogue* epilogue)
+{
+	if (!c->Signals && !c->Spectra)				{ return InvalidArgument; }
+	if (y.NumSamples == 0 || y.NumSignals == 0)	{ return EmptyInput; }
+	if (y.NumSamples != c->NumSamples)			{ return SizeMismatch; }
+
+	ErrorCode status = epiloguecheck(epilogue, c->NumSignals);
+	if (status != Success) { return status; }
+
+	int ncx = c->NumSignals;
+	int ncy = y.NumSignals;
+	int nlags = c->Lags ? c->NumLags : 1;
+	Output cc = output(out, DoublePrecision, epilogue);
+
+	// Y & whatever the correlator holds are read at least once, and every coefficient is written once
+	size_t held = c->Spectra ? aligned((c->NFFT / 2 + 1) * sizeof(Complex)) : (size_t)c->NumSamples * sizeof(double);
+	size_t npairs = (size_t)ncx * ncy;
+	profilecount((size_t)y.NumSamples * ncy * sizeof(double) + held * ncx + npairs * nlags * sizeof(double), npairs);
+
+	if (!c->Lags)
+	{
+		status = epiloguefill(epilogue, out, ncx, ncy, nlags);
+		return (status == Success) ? zcorr(cc, c, y) : status;
+	}
+
+	double* ssy = (double*)malloc(ncy * sizeof(double));
+	if (!ssy) { return OutOfMemory; }
+
+	#pragma omp parallel for schedule(static)
+	for (int a = 0; a < ncy; a++)
+	{
+		double t = phasestart();
+		ssy[a] = sumsq(y, a);
+		phaseend(PreparePhase, t);
+	}
+
+	// The correlator stands in for X, whose samples are only read when it holds them instead of spectra
+	Input x = { c->Signals, DoublePrecision, c->NumSamples, ncx, c->NumSamples };
+
+	status = epiloguefill(epilogue, out, ncx, ncy, nlags);
+	if (status == Success)
+	{
+		if (c->Spectra)
+			status = xcorrfft(cc, x, y, c->Lags, c->NumLags, c->SumSquares, ssy, c->NFFT, (const Complex*)c->Spectra);
+		else
+			status = xcorrdirect(cc, x, y, c->Lags, c->NumLags, c->SumSquares, ssy);
+	}
+
+	free(ssy);
+	return status;
+}
+
+
+
+/* FUNCTIONS */
+/// <summary>
+/// Computes the cross-correlation function between every signal in X and every signal in Y.
+/// </summary>
+/// <param name="cc">A [(2M - 1) x (NX * NY)] output array that receives Pearson correlation coefficients at all lags.</param>
+/// <param name="x">An [M x NX] array of signals.</param>
+/// <param name="y">An [M x NY] array of signals.</param>
+ErrorCode CrossCorrelate(double cc[], SignalArray x, SignalArray y)
+{
+	if (x.NumSamples == 0 || x.NumSignals == 0)	{ return EmptyInput; }
+
+	int* lags = alllags(x.NumSamples);
+	if (!lags) { return OutOfMemory; }
+
+	ErrorCode status = CrossCorrelateLags(cc, x, y, lags, 2 * x.NumSamples - 1);
+	free(lags);
+	return status;
+}
+/// <summary>
+/// Computes the cross-correlation function between every single precision signal in X and every one in Y.
+/// </summary>
+/// <param name="cc">A [(2M - 1) x (NX * NY)] output array that receives Pearson correlation coefficients at all lags.</param>
+/// <param name="x">An [M x NX] array of signals.</param>
+/// <param name="y">An [M x NY] array of signals.</param>
+ErrorCode CrossCorrelateF(float cc[], SignalArrayF x, SignalArrayF y)
+{
+	if (x.NumSamples == 0 || x.NumSignals == 0)	{ return EmptyInput; }
+
+	int* lags = alllags(x.NumSamples);
+	if (!lags) { return OutOfMemory; }
+
+	ErrorCode status = CrossCorrelateLagsF(cc, x, y, lags, 2 * x.NumSamples - 1);
+	free(lags);
+	return status;
+}
+/// <summary>
+/// Computes the cross-correlation function between every signal in X and every signal in Y at selected lags.
+/// </summary>
+/// <param name="cc">An [L x (NX * NY)] output array that receives Pearson correlation coefficients.</param>
+/// <param name="x">An [M x NX] array of signals.</param>
+/// <param name="y">An [M x NY] array of signals.</param>
+/// <param name="lags">The L sample shifts of X relative to Y to compute. These must all be in [-(M - 1), M - 1].</param>
+/// <param name="nlags">The number of lags (L).</param>
+ErrorCode CrossCorrelateLags(double cc[], SignalArray x, SignalArray y, const int lags[], int nlags)
+{
+	kernelbegin("CrossCorrelateLags");
+	ErrorCode status = xcorrlags(output(cc, DoublePrecision, NULL), input(x), input(y), lags, nlags);
+	kernelend();
+	return status;
+}
+/// <summary>
+/// Computes the cross-correlation function between every single precision signal in X and every one in Y at selected lags.
+/// </summary>
+/// <param name="cc">An [L x (NX * NY)] output array that receives Pearson correlation coefficients.</param>
+/// <param name="x">An [M x NX] array of signals.</param>
+/// <param name="y">An [M x NY] array of signals.</param>
+/// <param name="lags">The L sample shifts of X relative to Y to compute. These must all be in [-(M - 1), M - 1].</param>
+/// <param name="nlags">The number of lags (L).</param>
+ErrorCode CrossCorrelateLagsF(float cc[], SignalArrayF x, SignalArrayF y, const int lags[], int nlags)
+{
+	kernelbegin("CrossCorrelateLagsF");
+	ErrorCode status = xcorrlags(output(cc, SinglePrecision, NULL), inputf(x), inputf(y), lags, nlags);
+	kernelend();
+	return status;
+}
+/// <summary>
+/// Computes the cross-correlation function between every signal in X and every signal in Y at selected lags, applying an
+/// epilogue to every coefficient as it is stored.
+/// </summary>
+/// <param name="out">An output array that receives the processed coefficients. This is [L x (NX * NY)] like the output of
+/// CrossCorrelateLags, unless the epilogue maps signals to rows, in which case it is [NumRows x L x NY].</param>
+/// <param name="x">An [M x NX] array of signals.</param>
+/// <param name="y">An [M x NY] array of signals.</param>
+/// <param name="lags">The L sample shifts of X relative to Y to compute. These must all be in [-(M - 1), M - 1].</param>
+/// <param name="nlags">The number of lags (L).</param>
+/// <param name="epilogue">The processing to apply, or NULL to store plain correlation coefficients.</param>
+ErrorCode CrossCorrelateLagsEx(double out[], SignalArray x, SignalArray y, const int lags[], int nlags, const Epilogue* epilogue)
+{
+	kernelbegin("CrossCorrelateLagsEx");
+	ErrorCode status = xcorrlags(output(out, DoublePrecision, epilogue), input(x), input(y), lags, nlags);
+	kernelend();
+	return status;
+}
+/// <summary>
+/// Ingests an array of signals once so that it can be correlated against any number of other signal arrays later.
+/// </summary>
+/// <remarks>
+/// Correlators with lags choose their engine once, assuming that each later call correlates X with a single signal. The
+/// spectra of X are computed here, so only the per-pairing costs of the engines are compared.
+/// </remarks>
+/// <param name="c">Receives the correlator. This must be released using FreeCorrelator.</param>
+/// <param name="x">An [M x NX] array of signals.</param>
+/// <param name="lags">The L sample shifts of X relative to Y to compute, or NULL to compute Pearson correlations.</param>
+/// <param name="nlags">The number of lags (L).</param>
+ErrorCode CreateCorrelator(Correlator* c, SignalArray x, const int lags[], int nlags)
+{
+	memset(c, 0, sizeof(Correlator));
+	if (x.NumSamples == 0 || x.NumSignals == 0)	{ return EmptyInput; }
+	if (lags && nlags <= 0)						{ return InvalidArgument; }
+
+	int nrx = x.NumSamples;
+	int ncx = x.NumSignals;
+	c->NumSamples = nrx;
+	c->NumSignals = ncx;
+	Input in = input(x);
+
+	if (!lags)
+	{
+		c->Signals = (double*)alignedalloc((size_t)nrx * ncx * sizeof(double));
+		if (!c->Signals) { return OutOfMemory; }
+
+		#pragma omp parallel for schedule(static)
+		for (int a = 0; a < ncx; a++)
+			standardize(c->Signals + (size_t)a * nrx, load(in, a, NULL), nrx);
+		return Success;
+	}
+
+	int maxlag = 0;
+	for (int a = 0; a < nlags; a++)
+	{
+		int lag = abs(lags[a]);
+		if (lag >= nrx) { return InvalidArgument; }
+		if (lag > maxlag) { maxlag = lag; }
+	}
+
+	c->Lags = (int*)malloc(nlags * sizeof(int));
+	c->SumSquares = (double*)malloc(ncx * sizeof(double));
+	if (!c->Lags || !c->SumSquares)
+	{
+		FreeCorrelator(c);
+		return OutOfMemory;
+	}
+	memcpy(c->Lags, lags, nlags * sizeof(int));
+	c->NumLags = nlags;
+
+	#pragma omp parallel for schedule(static)
+	for (int a = 0; a < ncx; a++)
+		c->SumSquares[a] = sumsq(in, a);
+
+	int nfft = nextpow2(nrx + maxlag);
+	if (fftcost(nfft) * (ncx + 1) >= directcost(nrx, lags, nlags) * ncx)
+	{
+		c->Signals = (double*)alignedalloc((size_t)nrx * ncx * sizeof(double));
+		if (!c->Signals)
+		{
+			FreeCorrelator(c);
+			return OutOfMemory;
+		}
+
+		#pragma omp parallel for schedule(static)
+		for (int a = 0; a < ncx; a++)
+			memcpy(c->Signals + (size_t)a * nrx, load(in, a, NULL), (size_t)nrx * sizeof(double));
+		return Success;
+	}
+
+	// Spectra are laid out exactly as xcorrfft lays out its own, one cache line aligned column per signal
+	size_t ldF = aligned((nfft / 2 + 1) * sizeof(Complex)) / sizeof(Complex);
+	Complex* Fx = (Complex*)alignedalloc((size_t)ncx * ldF * sizeof(Complex));
+	FFTPlan* plan = fftacquire(nfft);
+	if (!Fx || !plan)
+	{
+		alignedfree(Fx);
+		fftrelease(plan);
+		FreeCorrelator(c);
+		return OutOfMemory;
+	}
+
+	#pragma omp parallel for schedule(static)
+	for (int a = 0; a < ncx; a++)
+		rfft(plan, Fx + a * ldF, load(in, a, NULL), nrx);
+
+	fftrelease(plan);
+	c->Spectra = (double*)Fx;
+	c->NFFT = nfft;
+	return Success;
+}
+/// <summary>
+/// Correlates every signal in Y with every signal that a correlator holds.
+/// </summary>
+/// <param name="out">An [NX x NY] output array for correlators without lags, or an output laid out like the output of
+/// CrossCorrelateLagsEx for correlators with lags.</param>
+/// <param name="c">A correlator created by CreateCorrelator.</param>
+/// <param name="y">An [M x NY] array of signals.</param>
+/// <param name="epilogue">The processing to apply, or NULL to store plain correlation coefficients.</param>
+ErrorCode CorrelatorApply(double out[], const Correlator* c, SignalArray y, const Epilogue* epilogue)
+{
+	kernelbegin("CorrelatorApply");
+	ErrorCode status = apply(out, c, input(y), epilogue);
+	kernelend();
+	return status;
+}
+/// <summary>
+/// Releases the memory held by a correlator.
+/// </summary>
+void FreeCorrelator(Correlator* c)
+{
+	if (!c) { return; }
+	alignedfree(c->Signals);
+	alignedfree(c->Spectra);
+	free(c->SumSquares);
+	free(c->Lags);
+	memset(c, 0, sizeof(Correlator));
+}
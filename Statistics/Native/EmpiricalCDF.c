@@ -0,0 +1,205 @@
+/* EMPIRICALCDF - Generates p-values for data using an empirically derived null distribution. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Moved out of Statistics/Mex/MexEmpiricalCDF.c so that it can be used without MATLAB.
+ *		20261017:	Replaced the linear scan through the null distribution with a binary search, which takes advantage of the null
+ *					distribution being sorted. This also stops the scan from reading one element past the end of the null data.
+ *		20261017:	Added EmpiricalCDFRaw, which does all of the clean up & sorting that empiricalcdf.m used to do before calling
+ *					the MEX function, in far fewer passes over the data.
+ *		20261017:	Lengths are now sizes like every other length in the library, so callers no longer narrow them to ints.
+ *		20261017:	EmpiricalCDFRaw once again gives NaN p-values instead of an error when no valid null values remain.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "Parallel.h"
+#include "Sort.h"
+#include "Statistics.h"
+
+
+
+/* CONSTANTS */
+#define MAXCHUNKS		64				// The largest number of chunks that null distributions are compacted in.
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Counts the number of elements in a sorted vector that are strictly less than a value.
+/// </summary>
+/// <remarks>
+/// This is a branchless binary search. The halving step compiles to a conditional move, so the search doesn't suffer
+/// from branch mispredictions, which otherwise dominate its run time on large null distributions.
+/// </remarks>
+/// <param name="n">A vector sorted into ascending order.</param>
+/// <param name="ln">The number of elements in n. This must be at least one.</param>
+/// <param name="value">The value to be located.</param>
+/// <returns>The index of the first element in n that is not less than value, or ln if there is no such element.</returns>
+static size_t lowerbound(const double n[], size_t ln, double value)
+{
+	const double* base = n;
+	size_t len = ln;
+	while (len > 1)
+	{
+		size_t half = len / 2;
+		base = (base[half - 1] < value) ? base + half : base;
+		len -= half;
+	}
+	return (size_t)(base - n) + (*base < value);
+}
+/// <summary>
+/// Determines whether a value belongs in a data distribution. NaNs and zeros are treated as missing data.
+/// </summary>
+static inline int isvalid(double x)
+{
+	return (x == x) && (x != 0);
+}
+/// <summary>
+/// Copies the valid values of a null distribution into a new vector, using one chunk of the distribution per thread.
+/// </summary>
+/// <remarks>
+/// The new vector is twice as long as the number of values copied, so that it also holds the scratch space needed to
+/// radix sort them.
+/// </remarks>
+/// <param name="ncompact">Receives the number of values that were copied.</param>
+/// <returns>The new vector, which the caller must free, or NULL if it couldn't be allocated.</returns>
+static double* compact(size_t* ncompact, const double n[], size_t ln)
+{
+	int nchunks = maxthreads();
+	nchunks = (nchunks > MAXCHUNKS) ? MAXCHUNKS : nchunks;
+
+	size_t bounds[MAXCHUNKS + 1];
+	size_t offsets[MAXCHUNKS + 1];
+	for (int a = 0; a <= nchunks; a++)
+		bounds[a] = (ln * (size_t)a) / (size_t)nchunks;
+
+	#pragma omp parallel for schedule(static, 1)
+	for (int a = 0; a < nchunks; a++)
+	{
+		size_t count = 0;
+		for (size_t b = bounds[a]; b < bounds[a + 1]; b++)
+			count += isvalid(n[b]);
+		offsets[a + 1] = count;
+	}
+
+	offsets[0] = 0;
+	for (int a = 0; a < nchunks; a++)
+		offsets[a + 1] += offsets[a];
+
+	*ncompact = offsets[nchunks];
+	double* c = (double*)malloc((2 * offsets[nchunks] + 1) * sizeof(double));
+	if (!c) { return NULL; }
+
+	#pragma omp parallel for schedule(static, 1)
+	for (int a = 0; a < nchunks; a++)
+	{
+		double* ca = c + offsets[a];
+		for (size_t b = bounds[a]; b < bounds[a + 1]; b++)
+		{
+			if (isvalid(n[b]))
+				*ca++ = n[b];
+		}
+	}
+
+	return c;
+}
+
+
+
+/* FUNCTIONS */
+
+/// <summary>
+/// Generates p-values for data using an empirically derived null distribution.
+/// </summary>
+/// <param name="p">An output vector of length lr that receives one p-value per element of r.</param>
+/// <param name="r">The real data distribution. NaNs and zeros must be removed beforehand.</param>
+/// <param name="lr">The number of elements in r.</param>
+/// <param name="n">The null data distribution. This must be sorted into ascending order.</param>
+/// <param name="ln">The number of elements in n.</param>
+/// <param name="t">The tail of the distribution that p-values are generated for.</param>
+ErrorCode EmpiricalCDF(double p[], const double r[], size_t lr, const double n[], size_t ln, Tails t)
+{
+	if (ln == 0) { return EmptyInput; }
+
+	double invN = 1.0 / ((double)ln);
+
+	switch (t)
+	{
+		case Both:
+			#pragma omp parallel for schedule(static)
+			for (size_t a = 0; a < lr; a++)
+			{
+				size_t b = lowerbound(n, ln, r[a]);
+				double pval = (double)b * invN;
+				p[a] = 2.0 * fmin(pval, 1.0 - pval);
+			}
+			break;
+
+		case Left:
+			#pragma omp parallel for schedule(static)
+			for (size_t a = 0; a < lr; a++)
+			{
+				size_t b = lowerbound(n, ln, r[a]);
+				p[a] = (double)b * invN;
+			}
+			break;
+
+		case Right:
+			#pragma omp parallel for schedule(static)
+			for (size_t a = 0; a < lr; a++)
+			{
+				size_t b = lowerbound(n, ln, r[a]);
+				p[a] = 1.0 - ((double)b * invN);
+			}
+			break;
+
+		default:
+			return InvalidArgument;
+	}
+
+	return Success;
+}
+
+ErrorCode EmpiricalCDFRaw(double p[], const double r[], size_t lr, const double n[], size_t ln, Tails t)
+{
+	if (t < Both || t > Right) { return InvalidArgument; }
+
+	size_t nvalid;
+	double* buffer = compact(&nvalid, n, ln);
+	if (!buffer) { return OutOfMemory; }
+
+	// Without any valid null values every p-value is 0 / 0, just as it was in empiricalcdf.m
+	if (nvalid == 0)
+	{
+		for (size_t a = 0; a < lr; a++)
+			p[a] = NAN;
+		free(buffer);
+		return Success;
+	}
+
+	const double* ns = radixsort(buffer, buffer + nvalid, nvalid);
+	double invN = 1.0 / ((double)nvalid);
+
+	// P-values go straight to their places in the output, so the real data never has to be compacted
+	#pragma omp parallel for schedule(static)
+	for (size_t a = 0; a < lr; a++)
+	{
+		if (!isvalid(r[a]))
+		{
+			p[a] = NAN;
+			continue;
+		}
+
+		double pval = (double)lowerbound(ns, nvalid, r[a]) * invN;
+		switch (t)
+		{
+			case Both:	p[a] = 2.0 * fmin(pval, 1.0 - pval);	break;
+			case Left:	p[a] = pval;							break;
+			default:	p[a] = 1.0 - pval;						break;
+		}
+	}
+
+	free(buffer);
+	return Success;
+}
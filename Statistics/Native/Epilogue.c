@@ -0,0 +1,87 @@
+/* EPILOGUE - Applies output epilogues inside the correlation kernels. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Thresholding epilogues are now rejected unless their cutoffs are finite & in order. Their NaN defaults used
+ *					to zero every value without any warning.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "Epilogue.h"
+
+
+
+/* SUBROUTINES */
+static inline double process(const Epilogue* e, double r)
+{
+	double v = (e->FisherN != 0) ? atanh(r) * sqrt(e->FisherN - 3) : r;
+	if (e->Threshold == KeepAll || isnan(v)) { return v; }
+
+	int significant = (v <= e->Cutoffs[0] || v >= e->Cutoffs[1]);
+	if (e->Threshold == Significance)
+		return significant ? 1.0 : 0.0;
+	return significant ? v : 0.0;
+}
+
+
+
+/* FUNCTIONS */
+ErrorCode epiloguecheck(const Epilogue* e, int ncx)
+{
+	if (!e) { return Success; }
+	if (e->Threshold < KeepAll || e->Threshold > Significance)	{ return InvalidArgument; }
+	if (e->FisherN != 0 && !(e->FisherN > 3))					{ return InvalidArgument; }
+	if (e->Threshold != KeepAll && !(isfinite(e->Cutoffs[0]) && isfinite(e->Cutoffs[1]) && e->Cutoffs[0] <= e->Cutoffs[1]))
+		return InvalidArgument;
+	if (e->Map)
+	{
+		for (int a = 0; a < ncx; a++)
+		{
+			if (e->Map[a] >= e->NumRows) { return InvalidArgument; }
+		}
+	}
+	return Success;
+}
+
+ErrorCode epiloguefill(const Epilogue* e, double out[], int ncx, int ncy, int nlags)
+{
+	if (!e || !e->Map) { return Success; }
+
+	char* mapped = (char*)calloc(e->NumRows, 1);
+	if (!mapped) { return OutOfMemory; }
+	for (int a = 0; a < ncx; a++)
+		mapped[e->Map[a]] = 1;
+
+	// Rows that do get mapped are written by the kernel, so only the rest are touched here
+	size_t ncols = (size_t)nlags * ncy;
+	#pragma omp parallel for schedule(static)
+	for (size_t a = 0; a < ncols; a++)
+	{
+		double* col = out + (size_t)a * e->NumRows;
+		for (size_t b = 0; b < e->NumRows; b++)
+		{
+			if (!mapped[b])
+				col[b] = e->Fill;
+		}
+	}
+
+	free(mapped);
+	return Success;
+}
+
+void epiloguestore(const Epilogue* e, double out[], const double cc[], int idxX, int idxY, int ncx, int nlags)
+{
+	if (e->Map)
+	{
+		double* dst = out + (size_t)idxY * nlags * e->NumRows + e->Map[idxX];
+		for (int a = 0; a < nlags; a++)
+			dst[(size_t)a * e->NumRows] = process(e, cc[a]);
+	}
+	else
+	{
+		double* dst = out + ((size_t)idxY * ncx + idxX) * nlags;
+		for (int a = 0; a < nlags; a++)
+			dst[a] = process(e, cc[a]);
+	}
+}
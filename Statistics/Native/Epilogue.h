@@ -0,0 +1,40 @@
+/* EPILOGUE - Applies output epilogues (see the Epilogue type in Statistics.h) inside the correlation kernels.
+ *
+ *	Kernels compute the coefficients of one signal pairing into a small per-thread buffer and hand it to epiloguestore,
+ *	which transforms, thresholds and scatters each value straight into its final place while it is still in cache.
+ */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#pragma once
+#ifndef EPILOGUE_H
+#define EPILOGUE_H
+
+#include "Statistics.h"
+
+
+
+/* FUNCTIONS */
+/// <summary>
+/// Checks that an epilogue is valid for a kernel whose X input contains a given number of signals.
+/// </summary>
+ErrorCode	epiloguecheck(const Epilogue* e, int ncx);
+/// <summary>
+/// Fills the rows of a mapped output that no signal maps to. Outputs without a map are left alone.
+/// </summary>
+/// <returns>OutOfMemory if workspace could not be allocated, or Success otherwise.</returns>
+ErrorCode	epiloguefill(const Epilogue* e, double out[], int ncx, int ncy, int nlags);
+/// <summary>
+/// Processes the coefficients of one signal pairing & stores them in their final places in the output.
+/// </summary>
+/// <param name="e">The epilogue to apply.</param>
+/// <param name="out">The kernel's output array.</param>
+/// <param name="cc">The nlags coefficients between signal idxX of X and signal idxY of Y.</param>
+/// <param name="ncx">The number of signals in X, which determines where unmapped outputs go.</param>
+void		epiloguestore(const Epilogue* e, double out[], const double cc[], int idxX, int idxY, int ncx, int nlags);
+
+
+
+#endif
@@ -0,0 +1,29 @@
+/* ERRORS - Error reporting for the native statistics kernels. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#include "Statistics.h"
+
+
+
+/// <summary>
+/// Gets a description of an error code that is suitable for displaying to users.
+/// </summary>
+/// <param name="code">An error code returned by one of the native statistics functions.</param>
+/// <returns>A static string describing the error.</returns>
+const char* errormsg(ErrorCode code)
+{
+	switch (code)
+	{
+		case Success:			return "The operation completed successfully.";
+		case EmptyInput:		return "Inputs cannot be empty arrays.";
+		case SizeMismatch:		return "X and Y must contain equivalent length signals.";
+		case InvalidArgument:	return "An invalid argument was provided. See documentation for syntax details.";
+		case OutOfMemory:		return "Not enough memory is available to complete the operation.";
+		case FileError:			return "The file could not be opened, created or mapped into memory.";
+		case InvalidFile:		return "The file is not a valid mapped array file.";
+		default:				return "An unknown error occurred.";
+	}
+}
@@ -0,0 +1,451 @@
+/* FFT - A small self-contained radix-2 fast Fourier transform used by the native statistics kernels.
+ *
+ *	Real transforms of length N are computed by packing the even and odd samples of the signal into the real and imaginary
+ *	parts of a complex signal of length N / 2, transforming that with an iterative radix-2 FFT, and then separating the two
+ *	interleaved spectra. The inverse transform runs the same steps backward.
+ */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Added a cache of plans that persists between kernel calls.
+ *		20261017:	Added exact real transforms of arbitrary lengths using Bluestein's algorithm.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "FFT.h"
+
+
+
+/* CONSTANTS */
+#define CACHESIZE		8			// The number of plans that the cache holds.
+
+
+
+/* DATA */
+/// <summary>
+/// Holds one plan in the cache.
+/// </summary>
+typedef struct
+{
+	FFTPlan*		Plan;			// The cached plan, or NULL if the entry is empty.
+	int				Users;			// The number of callers that currently hold the plan.
+	unsigned long	LastUse;		// When the plan was last acquired, which decides what gets replaced first.
+}CacheEntry;
+
+static CacheEntry		cache[CACHESIZE];
+static unsigned long	ticks;
+
+struct FFTPlan
+{
+	int			n;				// The real transform length.
+	int			m;				// The length of the complex transform used internally (n / 2).
+	int*		bitrev;			// Bit reversal permutation indices for the complex transform.
+	Complex*	twiddle;		// Twiddle factors exp(-2*pi*i*k / m) for the complex transform (m / 2 elements).
+	Complex*	rtwiddle;		// Twiddle factors exp(-2*pi*i*k / n) for separating real spectra (m / 2 + 1 elements).
+};
+
+struct DFTPlan
+{
+	int			n;				// The real transform length.
+	int			l;				// The length of the circular convolution that evaluates it, or 0 if n is a power of two.
+	FFTPlan*	fft;			// A cached plan whose complex transforms have length l, or whose real ones have length n.
+	Complex*	chirp;			// Chirp factors exp(-pi*i*k^2 / n) (n elements).
+	Complex*	kernel;			// The transform of the conjugate chirp, already scaled by 1 / l (l elements).
+};
+
+
+
+/* SUBROUTINES */
+static inline Complex cadd(Complex a, Complex b)	{ Complex c = { a.re + b.re, a.im + b.im }; return c; }
+static inline Complex csub(Complex a, Complex b)	{ Complex c = { a.re - b.re, a.im - b.im }; return c; }
+static inline Complex cmul(Complex a, Complex b)	{ Complex c = { a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re }; return c; }
+static inline Complex cconj(Complex a)				{ Complex c = { a.re, -a.im }; return c; }
+/// <summary>
+/// Computes an unscaled in-place complex transform of length plan->m.
+/// </summary>
+/// <param name="plan">The plan holding bit reversal indices and twiddle factors.</param>
+/// <param name="a">The data to be transformed.</param>
+/// <param name="inverse">Nonzero to compute the backward transform instead of the forward one.</param>
+static void cfft(const FFTPlan* plan, Complex a[], int inverse)
+{
+	int m = plan->m;
+	for (int k = 0; k < m; k++)
+	{
+		int j = plan->bitrev[k];
+		if (j > k) { Complex t = a[k]; a[k] = a[j]; a[j] = t; }
+	}
+
+	double sign = inverse ? -1.0 : 1.0;
+	for (int len = 2; len <= m; len <<= 1)
+	{
+		int half = len >> 1;
+		int step = m / len;
+		for (int a0 = 0; a0 < m; a0 += len)
+		{
+			for (int b = 0; b < half; b++)
+			{
+				Complex w = plan->twiddle[b * step];
+				w.im *= sign;
+				Complex u = a[a0 + b];
+				Complex v = cmul(a[a0 + b + half], w);
+				a[a0 + b] = cadd(u, v);
+				a[a0 + b + half] = csub(u, v);
+			}
+		}
+	}
+}
+
+/// <summary>
+/// Evaluates the transform of a chirp-weighted signal as a circular convolution with the conjugate chirp.
+/// </summary>
+/// <param name="plan">The exact transform plan.</param>
+/// <param name="a">The signal multiplied by the chirp and zero-padded to plan->l elements, which is overwritten by its
+/// transform multiplied by the chirp (i.e. the exact length plan->n transform in its first plan->n elements).</param>
+static void bluestein(const DFTPlan* plan, Complex a[])
+{
+	cfft(plan->fft, a, 0);
+	for (int k = 0; k < plan->l; k++)
+		a[k] = cmul(a[k], plan->kernel[k]);
+	cfft(plan->fft, a, 1);
+
+	for (int k = 0; k < plan->n; k++)
+		a[k] = cmul(a[k], plan->chirp[k]);
+}
+
+
+
+/* FUNCTIONS */
+int nextpow2(int x)
+{
+	int p = 1;
+	while (p < x) { p <<= 1; }
+	return p;
+}
+
+FFTPlan* fftplan(int n)
+{
+	if (n <= 0 || (n & (n - 1)) != 0) { return NULL; }
+
+	FFTPlan* plan = (FFTPlan*)calloc(1, sizeof(FFTPlan));
+	if (!plan) { return NULL; }
+
+	plan->n = n;
+	plan->m = n / 2;
+	if (plan->m == 0) { return plan; }
+
+	int m = plan->m;
+	plan->bitrev = (int*)malloc(m * sizeof(int));
+	plan->twiddle = (Complex*)malloc((m / 2 + 1) * sizeof(Complex));
+	plan->rtwiddle = (Complex*)malloc((m / 2 + 1) * sizeof(Complex));
+	if (!plan->bitrev || !plan->twiddle || !plan->rtwiddle)
+	{
+		fftfree(plan);
+		return NULL;
+	}
+
+	int nbits = 0;
+	while ((1 << nbits) < m) { nbits++; }
+	for (int k = 0; k < m; k++)
+	{
+		int r = 0;
+		for (int b = 0; b < nbits; b++)
+			r |= ((k >> b) & 1) << (nbits - 1 - b);
+		plan->bitrev[k] = r;
+	}
+
+	const double pi = 3.14159265358979323846;
+	for (int k = 0; k <= m / 2; k++)
+	{
+		double theta = -2.0 * pi * (double)k / (double)m;
+		plan->twiddle[k].re = cos(theta);
+		plan->twiddle[k].im = sin(theta);
+
+		theta = -2.0 * pi * (double)k / (double)n;
+		plan->rtwiddle[k].re = cos(theta);
+		plan->rtwiddle[k].im = sin(theta);
+	}
+
+	return plan;
+}
+
+void fftfree(FFTPlan* plan)
+{
+	if (!plan) { return; }
+	free(plan->bitrev);
+	free(plan->twiddle);
+	free(plan->rtwiddle);
+	free(plan);
+}
+
+FFTPlan* fftacquire(int n)
+{
+	FFTPlan* plan = NULL;
+
+	// Kernels acquire plans outside of their parallel regions, but other callers may share the cache between threads
+	#pragma omp critical(fftcache)
+	{
+		CacheEntry* victim = NULL;
+		for (int a = 0; a < CACHESIZE && !plan; a++)
+		{
+			CacheEntry* e = cache + a;
+			if (e->Plan && e->Plan->n == n)
+			{
+				e->Users++;
+				e->LastUse = ++ticks;
+				plan = e->Plan;
+			}
+			else if (!e->Users && (!victim || !e->Plan || (victim->Plan && e->LastUse < victim->LastUse)))
+				victim = e;
+		}
+
+		if (!plan)
+		{
+			plan = fftplan(n);
+			if (plan && victim)
+			{
+				fftfree(victim->Plan);
+				victim->Plan = plan;
+				victim->Users = 1;
+				victim->LastUse = ++ticks;
+			}
+		}
+	}
+
+	return plan;
+}
+
+void fftrelease(FFTPlan* plan)
+{
+	if (!plan) { return; }
+
+	int cached = 0;
+	#pragma omp critical(fftcache)
+	{
+		for (int a = 0; a < CACHESIZE && !cached; a++)
+		{
+			if (cache[a].Plan == plan)
+			{
+				cache[a].Users--;
+				cached = 1;
+			}
+		}
+	}
+
+	if (!cached) { fftfree(plan); }
+}
+
+void fftflush(void)
+{
+	#pragma omp critical(fftcache)
+	{
+		for (int a = 0; a < CACHESIZE; a++)
+		{
+			if (cache[a].Plan && !cache[a].Users)
+			{
+				fftfree(cache[a].Plan);
+				cache[a].Plan = NULL;
+			}
+		}
+	}
+}
+
+int fftlength(const FFTPlan* plan)
+{
+	return plan->n;
+}
+
+void rfft(const FFTPlan* plan, Complex X[], const double x[], int nx)
+{
+	int m = plan->m;
+	if (m == 0)
+	{
+		X[0].re = (nx > 0) ? x[0] : 0.0;
+		X[0].im = 0.0;
+		return;
+	}
+
+	// Pack even samples into the real parts & odd samples into the imaginary parts of a half-length complex signal
+	for (int k = 0; k < m; k++)
+	{
+		int idx = 2 * k;
+		X[k].re = (idx < nx) ? x[idx] : 0.0;
+		X[k].im = (idx + 1 < nx) ? x[idx + 1] : 0.0;
+	}
+
+	cfft(plan, X, 0);
+
+	// Separate the spectra of the even & odd samples, then combine them into the spectrum of the whole signal. Bins k
+	// and m - k depend on each other, so they're computed together in order to allow this to happen in place.
+	Complex z0 = X[0];
+	X[0].re = z0.re + z0.im;	X[0].im = 0.0;
+	X[m].re = z0.re - z0.im;	X[m].im = 0.0;
+
+	for (int k = 1; k <= m / 2; k++)
+	{
+		int j = m - k;
+		Complex zk = X[k], zj = X[j];
+		Complex fe = { 0.5 * (zk.re + zj.re), 0.5 * (zk.im - zj.im) };
+		Complex fo = { 0.5 * (zk.im + zj.im), -0.5 * (zk.re - zj.re) };
+		Complex w = plan->rtwiddle[k];
+
+		X[k] = cadd(fe, cmul(w, fo));
+
+		// The twiddle factor for bin m - k is -conj(w)
+		Complex wj = { -w.re, w.im };
+		X[j] = cadd(cconj(fe), cmul(wj, cconj(fo)));
+	}
+}
+
+void irfft(const FFTPlan* plan, double x[], Complex X[])
+{
+	int m = plan->m;
+	if (m == 0)
+	{
+		x[0] = X[0].re;
+		return;
+	}
+
+	// Rebuild the spectrum of the packed half-length complex signal from the non-redundant half of the real spectrum
+	Complex x0 = X[0], xm = X[m];
+	X[0].re = 0.5 * (x0.re + xm.re) - 0.5 * (x0.im + xm.im);
+	X[0].im = 0.5 * (x0.im - xm.im) + 0.5 * (x0.re - xm.re);
+
+	for (int k = 1; k <= m / 2; k++)
+	{
+		int j = m - k;
+		Complex xk = X[k], xj = X[j];
+		Complex fe = { 0.5 * (xk.re + xj.re), 0.5 * (xk.im - xj.im) };
+		Complex d = { 0.5 * (xk.re - xj.re), 0.5 * (xk.im + xj.im) };
+		Complex fo = cmul(d, cconj(plan->rtwiddle[k]));
+
+		// Z[k] = fe + i * fo
+		X[k].re = fe.re - fo.im;
+		X[k].im = fe.im + fo.re;
+
+		// Z[m - k] = conj(fe) + i * conj(fo)
+		X[j].re = fe.re + fo.im;
+		X[j].im = -fe.im + fo.re;
+	}
+
+	cfft(plan, X, 1);
+
+	double scale = 1.0 / (double)m;
+	for (int k = 0; k < m; k++)
+	{
+		x[2 * k] = X[k].re * scale;
+		x[2 * k + 1] = X[k].im * scale;
+	}
+}
+
+DFTPlan* dftplan(int n)
+{
+	if (n <= 0) { return NULL; }
+
+	DFTPlan* plan = (DFTPlan*)calloc(1, sizeof(DFTPlan));
+	if (!plan) { return NULL; }
+	plan->n = n;
+
+	if ((n & (n - 1)) == 0)
+	{
+		plan->fft = fftacquire(n);
+		if (!plan->fft) { free(plan); return NULL; }
+		return plan;
+	}
+
+	// Complex transforms of length l come from real plans of length 2 * l
+	int l = nextpow2(2 * n - 1);
+	plan->l = l;
+	plan->fft = fftacquire(2 * l);
+	plan->chirp = (Complex*)malloc(n * sizeof(Complex));
+	plan->kernel = (Complex*)calloc(l, sizeof(Complex));
+	if (!plan->fft || !plan->chirp || !plan->kernel)
+	{
+		dftfree(plan);
+		return NULL;
+	}
+
+	// k^2 is reduced modulo 2n before scaling so that the chirp stays accurate for long signals
+	const double pi = 3.14159265358979323846;
+	for (int k = 0; k < n; k++)
+	{
+		long long k2 = ((long long)k * k) % (2LL * n);
+		double theta = -pi * (double)k2 / (double)n;
+		plan->chirp[k].re = cos(theta);
+		plan->chirp[k].im = sin(theta);
+	}
+
+	plan->kernel[0] = cconj(plan->chirp[0]);
+	for (int k = 1; k < n; k++)
+		plan->kernel[k] = plan->kernel[l - k] = cconj(plan->chirp[k]);
+
+	cfft(plan->fft, plan->kernel, 0);
+	double scale = 1.0 / (double)l;
+	for (int k = 0; k < l; k++)
+	{
+		plan->kernel[k].re *= scale;
+		plan->kernel[k].im *= scale;
+	}
+
+	return plan;
+}
+
+void dftfree(DFTPlan* plan)
+{
+	if (!plan) { return; }
+	fftrelease(plan->fft);
+	free(plan->chirp);
+	free(plan->kernel);
+	free(plan);
+}
+
+int dftworksize(const DFTPlan* plan)
+{
+	return plan->l;
+}
+
+void rdft(const DFTPlan* plan, Complex X[], const double x[], Complex work[])
+{
+	if (!plan->l)
+	{
+		rfft(plan->fft, X, x, plan->n);
+		return;
+	}
+
+	int n = plan->n;
+	for (int k = 0; k < n; k++)
+	{
+		work[k].re = x[k] * plan->chirp[k].re;
+		work[k].im = x[k] * plan->chirp[k].im;
+	}
+	for (int k = n; k < plan->l; k++)
+		work[k].re = work[k].im = 0.0;
+
+	bluestein(plan, work);
+	for (int k = 0; k <= n / 2; k++)
+		X[k] = work[k];
+}
+
+void irdft(const DFTPlan* plan, double x[], Complex X[], Complex work[])
+{
+	if (!plan->l)
+	{
+		irfft(plan->fft, x, X);
+		return;
+	}
+
+	// The inverse is the conjugate of the forward transform of the conjugated (full, Hermitian) spectrum
+	int n = plan->n;
+	for (int k = 0; k < n; k++)
+	{
+		Complex v = (k <= n / 2) ? cconj(X[k]) : X[n - k];
+		work[k] = cmul(v, plan->chirp[k]);
+	}
+	for (int k = n; k < plan->l; k++)
+		work[k].re = work[k].im = 0.0;
+
+	bluestein(plan, work);
+	double scale = 1.0 / (double)n;
+	for (int k = 0; k < n; k++)
+		x[k] = work[k].re * scale;
+}
@@ -0,0 +1,142 @@
+/* FFT - A small self-contained radix-2 fast Fourier transform used by the native statistics kernels.
+ *
+ *	The MEX functions originally relied on the MKL for all of their Fourier transforms, which ties them to the Intel
+ *	toolchain. This module provides the handful of transforms the kernels actually need (real forward and real inverse
+ *	transforms of power-of-two lengths) without any external dependencies. Exact transforms of any other length, which
+ *	phase randomization needs to leave power spectra untouched, are built on top of them using Bluestein's algorithm. Transform lengths are fixed when a plan is
+ *	created, and plans may be shared freely between threads because executing them never modifies the plan.
+ *
+ *	Kernels get their plans from a small cache of recently used lengths, so repeated calls with short signals (e.g. once
+ *	per scan & channel) don't rebuild the same twiddle factors every time.
+ */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Added a reference counted, least recently used cache of plans.
+ *		20261017:	Added exact real transforms of arbitrary lengths.
+ */
+
+#pragma once
+#ifndef FFT_H
+#define FFT_H
+
+
+
+/* DATA */
+/// <summary>
+/// A double-precision complex number with the same memory layout as MKL_Complex16 or C99 double complex.
+/// </summary>
+typedef struct
+{
+	double re;
+	double im;
+}Complex;
+
+/// <summary>
+/// A precomputed set of twiddle factors and bit reversal indices for real transforms of one particular length.
+/// </summary>
+typedef struct FFTPlan FFTPlan;
+
+/// <summary>
+/// A precomputed set of chirp factors and a cached transform plan for exact real transforms of any one length.
+/// </summary>
+typedef struct DFTPlan DFTPlan;
+
+
+
+/* FUNCTIONS */
+/// <summary>
+///	Calculates the next power of two that is greater than or equal to the inputted integer.
+/// </summary>
+/// <param name="x">Any positive integer.</param>
+/// <returns>The first integer power of two that is greater than or equal to x.</returns>
+int			nextpow2(int x);
+
+/// <summary>
+/// Creates a plan for real transforms of length n.
+/// </summary>
+/// <param name="n">The transform length. This must be a positive integer power of two.</param>
+/// <returns>A new plan that must be freed using fftfree, or NULL if n is invalid or memory could not be allocated.</returns>
+FFTPlan*	fftplan(int n);
+/// <summary>
+/// Releases all resources associated with a transform plan.
+/// </summary>
+void		fftfree(FFTPlan* plan);
+/// <summary>
+/// Gets a plan for real transforms of length n from the plan cache, creating it if the cache doesn't hold one.
+/// </summary>
+/// <remarks>
+/// Cached plans are shared by every caller and must be returned using fftrelease instead of fftfree. When the cache is
+/// full, the least recently used plan that nobody holds is replaced. If every cached plan is held, the new plan is simply
+/// not cached.
+/// </remarks>
+/// <param name="n">The transform length. This must be a positive integer power of two.</param>
+/// <returns>A plan that must be returned using fftrelease, or NULL if n is invalid or memory could not be allocated.</returns>
+FFTPlan*	fftacquire(int n);
+/// <summary>
+/// Returns a plan that was acquired from the plan cache.
+/// </summary>
+void		fftrelease(FFTPlan* plan);
+/// <summary>
+/// Frees every cached plan that nobody holds.
+/// </summary>
+void		fftflush(void);
+/// <summary>
+/// Gets the transform length that a plan was created for.
+/// </summary>
+int			fftlength(const FFTPlan* plan);
+
+/// <summary>
+/// Computes the forward transform of a real signal that is implicitly zero-padded to the plan length.
+/// </summary>
+/// <param name="plan">A transform plan of length N.</param>
+/// <param name="X">An output array of (N / 2 + 1) elements that receives the non-redundant half of the spectrum.</param>
+/// <param name="x">The real input signal.</param>
+/// <param name="nx">The number of samples in x. This must not exceed N; any remaining samples are treated as zeros.</param>
+void		rfft(const FFTPlan* plan, Complex X[], const double x[], int nx);
+/// <summary>
+/// Computes the scaled inverse transform of a conjugate-symmetric spectrum, producing a real signal.
+/// </summary>
+/// <param name="plan">A transform plan of length N.</param>
+/// <param name="x">An output array of N elements that receives the real signal.</param>
+/// <param name="X">The (N / 2 + 1) non-redundant elements of the spectrum. This array is overwritten.</param>
+void		irfft(const FFTPlan* plan, double x[], Complex X[]);
+
+/// <summary>
+/// Creates a plan for exact real transforms of length n, which unlike rfft never pad signals to a power of two.
+/// </summary>
+/// <remarks>
+/// Power of two lengths are handed straight to rfft & irfft. Any other length is evaluated as a circular convolution
+/// with a chirp (Bluestein's algorithm), which takes three radix-2 transforms of at least twice the length.
+/// </remarks>
+/// <param name="n">The transform length. This can be any positive integer.</param>
+/// <returns>A new plan that must be freed using dftfree, or NULL if n is invalid or memory could not be allocated.</returns>
+DFTPlan*	dftplan(int n);
+/// <summary>
+/// Releases all resources associated with an exact transform plan.
+/// </summary>
+void		dftfree(DFTPlan* plan);
+/// <summary>
+/// Gets the number of complex elements of workspace that exact transforms of a plan's length need.
+/// </summary>
+int			dftworksize(const DFTPlan* plan);
+/// <summary>
+/// Computes the exact forward transform of a real signal.
+/// </summary>
+/// <param name="plan">An exact transform plan of length N.</param>
+/// <param name="X">An output array of (N / 2 + 1) elements that receives the non-redundant half of the spectrum.</param>
+/// <param name="x">The real input signal of N samples.</param>
+/// <param name="work">Workspace of at least dftworksize elements.</param>
+void		rdft(const DFTPlan* plan, Complex X[], const double x[], Complex work[]);
+/// <summary>
+/// Computes the exact, scaled inverse transform of a conjugate-symmetric spectrum, producing a real signal.
+/// </summary>
+/// <param name="plan">An exact transform plan of length N.</param>
+/// <param name="x">An output array of N elements that receives the real signal.</param>
+/// <param name="X">The (N / 2 + 1) non-redundant elements of the spectrum. This array may be overwritten.</param>
+/// <param name="work">Workspace of at least dftworksize elements.</param>
+void		irdft(const DFTPlan* plan, double x[], Complex X[], Complex work[]);
+
+
+
+#endif
@@ -0,0 +1,205 @@
+/* FILTER - FIR filtering of many signals at once, with or without phase distortion. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Replaces the filter and filtfilt calls that boldObj and eegObj made with filters tens of thousands of taps long.
+ *		20261017:	Long filters are applied by overlap-save convolution, so filtering costs O(log(NB)) per sample instead of O(NB).
+ *		20261017:	Transform plans now come from the plan cache, so repeated calls of the same length skip building them.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Arena.h"
+#include "FFT.h"
+#include "Parallel.h"
+#include "Statistics.h"
+
+
+
+/* CONSTANTS */
+#define DIRECTTAPS		64			// Filters with fewer taps than this are applied by direct convolution.
+#define MAXFFT			(1 << 20)	// The longest transform that overlap-save blocks may use.
+
+
+
+/* DATA */
+/// <summary>
+/// Holds everything that applying one filter needs, which is shared by every thread.
+/// </summary>
+typedef struct
+{
+	const double*	Taps;			// The filter coefficients (NB elements).
+	int				NumTaps;		// The number of filter coefficients (NB).
+	FFTPlan*		Plan;			// The plan for overlap-save blocks, or NULL to convolve directly.
+	Complex*		Response;		// The spectrum of the taps zero-padded to the block length.
+}FIR;
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Chooses the overlap-save block length that minimizes the cost of filtering one sample.
+/// </summary>
+/// <remarks>
+/// Every block costs about one forward & one inverse transform of length N and yields (N - NB + 1) samples. Blocks that
+/// are much longer than the signal being filtered only waste work, so those are never considered.
+/// </remarks>
+static int blocklength(int ntaps, int nsamples)
+{
+	int shortest = nextpow2(2 * ntaps);
+	int longest = nextpow2(nsamples + ntaps);
+	longest = (longest > MAXFFT) ? MAXFFT : longest;
+
+	int best = shortest;
+	double cost = INFINITY;
+	for (int n = shortest; n <= longest; n *= 2)
+	{
+		double c = n * log2((double)n) / (n - ntaps + 1);
+		if (c < cost)
+		{
+			cost = c;
+			best = n;
+		}
+	}
+	return best;
+}
+/// <summary>
+/// Convolves a signal with a filter, treating every sample before the start of the signal as a constant value.
+/// </summary>
+/// <remarks>
+/// This computes y[n] = sum(b[k] * s[n - k]) for n in [0, N), where s[j] = pre for every j < 0. That is what filter does
+/// with initial conditions that hold the filter at a steady state for a constant input, which is how filtfilt starts
+/// both of its passes (pre is zero for filter's usual initial rest). Each overlap-save block gathers the last (NB - 1)
+/// samples of the previous block along with its own, so the aliased part of every circular convolution is discarded.
+/// </remarks>
+/// <param name="block">A buffer of NFFT elements.</param>
+/// <param name="spectrum">A buffer of (NFFT / 2 + 1) elements.</param>
+static void convolve(double y[], const double s[], int n, double pre, const FIR* f, double block[], Complex spectrum[])
+{
+	int nb = f->NumTaps;
+	if (!f->Plan)
+	{
+		for (int a = 0; a < n; a++)
+		{
+			double sum = 0;
+			for (int b = 0; b < nb; b++)
+				sum += f->Taps[b] * ((a - b >= 0) ? s[a - b] : pre);
+			y[a] = sum;
+		}
+		return;
+	}
+
+	int nfft = fftlength(f->Plan);
+	int nbins = nfft / 2 + 1;
+	int step = nfft - (nb - 1);
+	for (int i0 = 0; i0 < n; i0 += step)
+	{
+		// Gather the samples from i0 - (NB - 1) up to the end of the block, padding the ends of the signal
+		int j0 = i0 - (nb - 1);
+		for (int a = 0; a < nfft; a++)
+		{
+			int j = j0 + a;
+			block[a] = (j < 0) ? pre : (j < n) ? s[j] : 0.0;
+		}
+
+		rfft(f->Plan, spectrum, block, nfft);
+		for (int a = 0; a < nbins; a++)
+		{
+			Complex p = spectrum[a], q = f->Response[a];
+			spectrum[a].re = p.re * q.re - p.im * q.im;
+			spectrum[a].im = p.re * q.im + p.im * q.re;
+		}
+		irfft(f->Plan, block, spectrum);
+
+		int ncopy = (n - i0 < step) ? n - i0 : step;
+		memcpy(y + i0, block + (nb - 1), (size_t)ncopy * sizeof(double));
+	}
+}
+/// <summary>
+/// Reverses the order of the elements in a vector.
+/// </summary>
+static void reverse(double x[], int n)
+{
+	for (int a = 0, b = n - 1; a < b; a++, b--)
+	{
+		double t = x[a];
+		x[a] = x[b];
+		x[b] = t;
+	}
+}
+
+
+
+/* FUNCTIONS */
+ErrorCode FIRFilter(double y[], SignalArray x, const double b[], int ntaps, int zerophase)
+{
+	if (x.NumSamples == 0 || x.NumSignals == 0)	{ return EmptyInput; }
+	if (ntaps <= 0)								{ return InvalidArgument; }
+
+	int nrx = x.NumSamples;
+	int nfact = zerophase ? 3 * (ntaps - 1) : 0;
+	if (zerophase && nrx <= nfact) { return SizeMismatch; }
+
+	int next = nrx + 2 * nfact;
+	int nfft = (ntaps >= DIRECTTAPS) ? blocklength(ntaps, next) : 0;
+	int nbins = nfft / 2 + 1;
+
+	FIR f = { b, ntaps, NULL, NULL };
+	size_t szsignal = zerophase ? 2 * aligned((size_t)next * sizeof(double)) : 0;
+	size_t szblock = nfft ? aligned((size_t)nfft * sizeof(double)) + aligned((size_t)nbins * sizeof(Complex)) : 0;
+	size_t szthread = szsignal + szblock;
+	size_t szresponse = nfft ? aligned((size_t)nbins * sizeof(Complex)) : 0;
+
+	Arena* arena = (szthread + szresponse) ? arenaacquire(maxthreads() * szthread + szresponse) : NULL;
+	f.Plan = nfft ? fftacquire(nfft) : NULL;
+	if ((szthread + szresponse && !arena) || (nfft && !f.Plan))
+	{
+		arenarelease(arena);
+		fftrelease(f.Plan);
+		return OutOfMemory;
+	}
+
+	char* buffers = arena ? (char*)arenaalloc(arena, maxthreads() * szthread) : NULL;
+	if (nfft)
+	{
+		f.Response = (Complex*)arenaalloc(arena, szresponse);
+		rfft(f.Plan, f.Response, b, ntaps);
+	}
+
+	#pragma omp parallel for schedule(dynamic, 1)
+	for (int a = 0; a < x.NumSignals; a++)
+	{
+		char* workspace = buffers ? buffers + threadid() * szthread : NULL;
+		double* block = nfft ? (double*)(workspace + szsignal) : NULL;
+		Complex* spectrum = nfft ? (Complex*)(workspace + szsignal + aligned((size_t)nfft * sizeof(double))) : NULL;
+		const double* xa = column(x, a);
+		double* ya = y + (size_t)a * nrx;
+
+		if (!zerophase)
+		{
+			convolve(ya, xa, nrx, 0.0, &f, block, spectrum);
+			continue;
+		}
+
+		// Odd reflections about the end points keep the extended signal & its slope continuous
+		double* ext = (double*)workspace;
+		double* tmp = (double*)(workspace + szsignal / 2);
+		for (int c = 0; c < nfact; c++)
+		{
+			ext[c] = 2 * xa[0] - xa[nfact - c];
+			ext[nfact + nrx + c] = 2 * xa[nrx - 1] - xa[nrx - 2 - c];
+		}
+		memcpy(ext + nfact, xa, (size_t)nrx * sizeof(double));
+
+		convolve(tmp, ext, next, ext[0], &f, block, spectrum);
+		reverse(tmp, next);
+		convolve(ext, tmp, next, tmp[0], &f, block, spectrum);
+		for (int c = 0; c < nrx; c++)
+			ya[c] = ext[next - 1 - nfact - c];
+	}
+
+	fftrelease(f.Plan);
+	arenarelease(arena);
+	return Success;
+}
@@ -0,0 +1,449 @@
+/* INFORMATION - Discretization of signals & histogram-based information theoretic measures between them. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Replaces the entropy calculations of the Signal class, which compared every pair of distinct values across entire
+ *					data sets, with a single histogram pass per pair of signals.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Arena.h"
+#include "Parallel.h"
+#include "Sort.h"
+#include "Statistics.h"
+
+
+
+/* CONSTANTS */
+#define DENSECELLS		(1 << 16)	// The largest joint histogram that is counted densely.
+
+
+
+/* DATA */
+/// <summary>
+/// Per-thread workspace for building the histograms of one pair of discrete signals.
+/// </summary>
+typedef struct
+{
+	int*		Joint;			// A dense [LX x LY] joint histogram, or the counts of Y within one level of X.
+	int*		CountX;			// The marginal histogram of X, with room for one extra element (LX + 1 elements).
+	int*		CountY;			// The marginal histogram of Y (LY elements).
+	int*		Order;			// The indices of the samples of a pair, grouped by their level in X (M elements).
+}Histogram;
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Bins a signal into equidistant partitions that span its range.
+/// </summary>
+/// <param name="edges">A buffer of (NB + 1) elements.</param>
+static void equidistant(int codes[], const double x[], int n, int nbins, double edges[])
+{
+	double lo = INFINITY, hi = -INFINITY;
+	for (int a = 0; a < n; a++)
+	{
+		if (isnan(x[a])) { continue; }
+		lo = (x[a] < lo) ? x[a] : lo;
+		hi = (x[a] > hi) ? x[a] : hi;
+	}
+
+	// Edges are placed the same way that linspace places them, so values that sit on an edge land in the same bin
+	double width = (hi - lo) / nbins;
+	for (int a = 0; a <= nbins; a++)
+		edges[a] = lo + a * width;
+	edges[nbins] = hi;
+
+	for (int a = 0; a < n; a++)
+	{
+		if (isnan(x[a]))
+		{
+			codes[a] = -1;
+			continue;
+		}
+
+		int k = (width > 0) ? (int)ceil((x[a] - lo) / width) - 1 : 0;
+		k = (k < 0) ? 0 : (k >= nbins) ? nbins - 1 : k;
+		while (k > 0 && x[a] <= edges[k])
+			k--;
+		while (k < nbins - 1 && x[a] > edges[k + 1])
+			k++;
+		codes[a] = k;
+	}
+}
+/// <summary>
+/// Copies the values of a signal that aren't NaNs into a buffer & sorts them into ascending order.
+/// </summary>
+/// <param name="sorted">A buffer of 2N elements, the first half of which receives the sorted values.</param>
+/// <returns>The number of sorted values.</returns>
+static int sortvalid(double sorted[], const double x[], int n)
+{
+	int count = 0;
+	for (int a = 0; a < n; a++)
+	{
+		if (!isnan(x[a]))
+			sorted[count++] = x[a];
+	}
+
+	double* result = radixsort(sorted, sorted + n, (size_t)count);
+	if (result != sorted)
+		memcpy(sorted, result, (size_t)count * sizeof(double));
+	return count;
+}
+/// <summary>
+/// Bins a signal into partitions that each hold about the same number of samples.
+/// </summary>
+/// <param name="sorted">A buffer of 2N elements.</param>
+static void equiprobable(int codes[], const double x[], int n, int nbins, double sorted[])
+{
+	int count = sortvalid(sorted, x, n);
+	for (int a = 0; a < n; a++)
+	{
+		if (isnan(x[a]))
+		{
+			codes[a] = -1;
+			continue;
+		}
+
+		// Find the first bin whose upper edge is at least this value. Bins with no ranks at all are always skipped.
+		int lo = 0, hi = nbins - 1;
+		while (lo < hi)
+		{
+			int mid = (lo + hi) / 2;
+			long long rank = (long long)(mid + 1) * count / nbins;
+			if (rank > 0 && x[a] <= sorted[rank - 1])
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+		codes[a] = lo;
+	}
+}
+/// <summary>
+/// Numbers the distinct values of a signal in ascending order.
+/// </summary>
+/// <param name="sorted">A buffer of 2N elements.</param>
+/// <returns>The number of distinct values.</returns>
+static int distinct(int codes[], const double x[], int n, double sorted[])
+{
+	int count = sortvalid(sorted, x, n);
+	int nunique = 0;
+	for (int a = 0; a < count; a++)
+	{
+		if (nunique == 0 || sorted[a] != sorted[nunique - 1])
+			sorted[nunique++] = sorted[a];
+	}
+
+	for (int a = 0; a < n; a++)
+	{
+		if (isnan(x[a]))
+		{
+			codes[a] = -1;
+			continue;
+		}
+
+		int lo = 0, hi = nunique - 1;
+		while (lo < hi)
+		{
+			int mid = (lo + hi) / 2;
+			if (sorted[mid] < x[a])
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		codes[a] = lo;
+	}
+	return nunique;
+}
+/// <summary>
+/// Gets the index of the signal in X that a pair uses.
+/// </summary>
+static inline int pairx(const int pairs[], int idx, int ncx)
+{
+	return pairs ? pairs[2 * idx] : idx % ncx;
+}
+/// <summary>
+/// Gets the index of the signal in Y that a pair uses.
+/// </summary>
+static inline int pairy(const int pairs[], int idx, int ncx)
+{
+	return pairs ? pairs[2 * idx + 1] : idx / ncx;
+}
+/// <summary>
+/// Converts the sum of c * log2(c) over the bins of a histogram into its entropy in bits.
+/// </summary>
+static inline double bits(double sum, int total)
+{
+	return (total > 0) ? log2((double)total) - sum / total : NAN;
+}
+/// <summary>
+/// Measures the information shared between two discrete signals.
+/// </summary>
+/// <remarks>
+/// Entropies are found from histogram counts as H = log2(T) - sum(c * log2(c)) / T, where T is the number of samples
+/// that both signals have, so the only logarithms taken are the ones tabulated in xlogx. Dense joint histograms are
+/// scanned in full to find both marginal histograms. Otherwise, samples are grouped by their level in X with a counting
+/// sort, and the levels of Y within each group are counted & cleared again before the next group, which only ever
+/// touches as many bins as there are samples.
+/// </remarks>
+/// <param name="xlogx">A table of c * log2(c) for every count c in [0, M].</param>
+static double measurepair(const int cx[], int lx, const int cy[], int ly, int n, Information measure, const double xlogx[], Histogram* h)
+{
+	int total = 0;
+	double sxy = 0, sx = 0, sy = 0;
+	memset(h->CountY, 0, (size_t)ly * sizeof(int));
+
+	if ((size_t)lx * ly <= DENSECELLS)
+	{
+		memset(h->Joint, 0, (size_t)lx * ly * sizeof(int));
+		memset(h->CountX, 0, (size_t)lx * sizeof(int));
+		for (int a = 0; a < n; a++)
+		{
+			if ((unsigned)cx[a] >= (unsigned)lx || (unsigned)cy[a] >= (unsigned)ly) { continue; }
+			h->Joint[cx[a] * ly + cy[a]]++;
+			total++;
+		}
+
+		for (int a = 0; a < lx; a++)
+		{
+			const int* row = h->Joint + (size_t)a * ly;
+			for (int b = 0; b < ly; b++)
+			{
+				sxy += xlogx[row[b]];
+				h->CountX[a] += row[b];
+				h->CountY[b] += row[b];
+			}
+			sx += xlogx[h->CountX[a]];
+		}
+	}
+	else
+	{
+		memset(h->Joint, 0, (size_t)ly * sizeof(int));
+		memset(h->CountX, 0, (size_t)(lx + 1) * sizeof(int));
+		for (int a = 0; a < n; a++)
+		{
+			if ((unsigned)cx[a] >= (unsigned)lx || (unsigned)cy[a] >= (unsigned)ly) { continue; }
+			h->CountX[cx[a] + 1]++;
+			h->CountY[cy[a]]++;
+			total++;
+		}
+
+		for (int a = 0; a < lx; a++)
+		{
+			sx += xlogx[h->CountX[a + 1]];
+			h->CountX[a + 1] += h->CountX[a];
+		}
+		for (int a = 0; a < n; a++)
+		{
+			if ((unsigned)cx[a] >= (unsigned)lx || (unsigned)cy[a] >= (unsigned)ly) { continue; }
+			h->Order[h->CountX[cx[a]]++] = a;
+		}
+
+		// Scattering leaves each element of CountX at the end of its group, which is where the next group starts
+		for (int a = 0, first = 0; a < lx; first = h->CountX[a++])
+		{
+			for (int b = first; b < h->CountX[a]; b++)
+				h->Joint[cy[h->Order[b]]]++;
+			for (int b = first; b < h->CountX[a]; b++)
+			{
+				int* count = h->Joint + cy[h->Order[b]];
+				sxy += xlogx[*count];
+				*count = 0;
+			}
+		}
+	}
+
+	for (int a = 0; a < ly; a++)
+		sy += xlogx[h->CountY[a]];
+
+	switch (measure)
+	{
+		case ConditionalEntropy:	return bits(sxy, total) - bits(sy, total);
+		case MutualInformation:		return bits(sx, total) + bits(sy, total) - bits(sxy, total);
+		default:					return bits(sxy, total);
+	}
+}
+/// <summary>
+/// Tabulates c * log2(c) for every count in [0, N].
+/// </summary>
+static void tabulate(double xlogx[], int n)
+{
+	xlogx[0] = 0;
+	#pragma omp parallel for schedule(static)
+	for (int a = 1; a <= n; a++)
+		xlogx[a] = a * log2((double)a);
+}
+/// <summary>
+/// Gets the largest number of levels that any signal in an array has, or -1 if any of them has a negative number.
+/// </summary>
+static int maxlevels(LevelArray x)
+{
+	int lmax = 0;
+	for (int a = 0; a < x.NumSignals; a++)
+	{
+		if (x.Levels[a] < 0) { return -1; }
+		lmax = (x.Levels[a] > lmax) ? x.Levels[a] : lmax;
+	}
+	return lmax;
+}
+
+
+
+/* FUNCTIONS */
+ErrorCode Discretize(int codes[], int levels[], SignalArray x, int nbins, Partition method)
+{
+	if (x.NumSamples == 0 || x.NumSignals == 0)		{ return EmptyInput; }
+	if (method < Equidistant || method > Distinct)	{ return InvalidArgument; }
+	if (method != Distinct && nbins < 1)			{ return InvalidArgument; }
+
+	int nrx = x.NumSamples;
+	size_t szthread = (method == Equidistant) ?
+		aligned((size_t)(nbins + 1) * sizeof(double)) :
+		aligned(2 * (size_t)nrx * sizeof(double));
+
+	Arena* arena = arenaacquire(maxthreads() * szthread);
+	if (!arena) { return OutOfMemory; }
+	char* buffers = (char*)arenaalloc(arena, maxthreads() * szthread);
+
+	#pragma omp parallel for schedule(dynamic, 1)
+	for (int a = 0; a < x.NumSignals; a++)
+	{
+		double* workspace = (double*)(buffers + threadid() * szthread);
+		int* ca = codes + (size_t)a * nrx;
+		switch (method)
+		{
+			case Equidistant:
+				equidistant(ca, column(x, a), nrx, nbins, workspace);
+				levels[a] = nbins;
+				break;
+
+			case Equiprobable:
+				equiprobable(ca, column(x, a), nrx, nbins, workspace);
+				levels[a] = nbins;
+				break;
+
+			case Distinct:
+				levels[a] = distinct(ca, column(x, a), nrx, workspace);
+				break;
+		}
+	}
+
+	arenarelease(arena);
+	return Success;
+}
+
+ErrorCode Entropy(double h[], LevelArray x)
+{
+	if (x.NumSamples == 0 || x.NumSignals == 0)	{ return EmptyInput; }
+
+	int lmax = maxlevels(x);
+	if (lmax < 0) { return InvalidArgument; }
+
+	int nrx = x.NumSamples;
+	size_t sztable = aligned((size_t)(nrx + 1) * sizeof(double));
+	size_t szthread = aligned((size_t)lmax * sizeof(int));
+	Arena* arena = arenaacquire(sztable + maxthreads() * szthread);
+	if (!arena) { return OutOfMemory; }
+
+	double* xlogx = (double*)arenaalloc(arena, sztable);
+	char* buffers = (char*)arenaalloc(arena, maxthreads() * szthread);
+	tabulate(xlogx, nrx);
+
+	#pragma omp parallel for schedule(dynamic, 1)
+	for (int a = 0; a < x.NumSignals; a++)
+	{
+		int* counts = (int*)(buffers + threadid() * szthread);
+		const int* ca = x.Codes + (size_t)a * nrx;
+		int lx = x.Levels[a];
+		memset(counts, 0, (size_t)lx * sizeof(int));
+
+		int total = 0;
+		for (int b = 0; b < nrx; b++)
+		{
+			if ((unsigned)ca[b] >= (unsigned)lx) { continue; }
+			counts[ca[b]]++;
+			total++;
+		}
+
+		double sum = 0;
+		for (int b = 0; b < lx; b++)
+			sum += xlogx[counts[b]];
+		h[a] = bits(sum, total);
+	}
+
+	arenarelease(arena);
+	return Success;
+}
+
+ErrorCode PairwiseInformation(double out[], LevelArray x, LevelArray y, const int pairs[], int npairs, Information measure)
+{
+	if (x.NumSamples == 0 || x.NumSignals == 0 || y.NumSignals == 0)	{ return EmptyInput; }
+	if (x.NumSamples != y.NumSamples)									{ return SizeMismatch; }
+	if (measure < JointEntropy || measure > MutualInformation)			{ return InvalidArgument; }
+	if (pairs && npairs <= 0)											{ return InvalidArgument; }
+
+	int nrx = x.NumSamples;
+	int ncx = x.NumSignals;
+	int ncy = y.NumSignals;
+	int lxmax = maxlevels(x);
+	int lymax = maxlevels(y);
+	if (lxmax < 0 || lymax < 0) { return InvalidArgument; }
+
+	npairs = pairs ? npairs : ncx * ncy;
+	for (int a = 0; pairs && a < npairs; a++)
+	{
+		if (pairs[2 * a] < 0 || pairs[2 * a] >= ncx || pairs[2 * a + 1] < 0 || pairs[2 * a + 1] >= ncy)
+			return InvalidArgument;
+	}
+
+	// Joint entropy & mutual information don't depend on the order of the signals in a pair
+	int symmetric = !pairs && x.Codes == y.Codes && x.Levels == y.Levels && ncx == ncy && measure != ConditionalEntropy;
+
+	size_t cells = (size_t)lxmax * lymax;
+	size_t sztable = aligned((size_t)(nrx + 1) * sizeof(double));
+	size_t szjoint = aligned(((cells < DENSECELLS) ? cells : (lymax > DENSECELLS) ? lymax : DENSECELLS) * sizeof(int));
+	size_t szorder = (cells > DENSECELLS) ? aligned((size_t)nrx * sizeof(int)) : 0;
+	size_t szthread = szjoint + aligned((size_t)(lxmax + 1) * sizeof(int)) + aligned((size_t)lymax * sizeof(int)) + szorder;
+
+	Arena* arena = arenaacquire(sztable + maxthreads() * szthread);
+	if (!arena) { return OutOfMemory; }
+
+	double* xlogx = (double*)arenaalloc(arena, sztable);
+	char* buffers = (char*)arenaalloc(arena, maxthreads() * szthread);
+	tabulate(xlogx, nrx);
+
+	#pragma omp parallel
+	{
+		char* workspace = buffers + threadid() * szthread;
+		Histogram h;
+		h.Joint = (int*)workspace;
+		h.CountX = (int*)(workspace + szjoint);
+		h.CountY = (int*)(workspace + szjoint + aligned((size_t)(lxmax + 1) * sizeof(int)));
+		h.Order = szorder ? (int*)(workspace + szthread - szorder) : NULL;
+
+		#pragma omp for schedule(dynamic, 1)
+		for (int a = 0; a < npairs; a++)
+		{
+			int idxX = pairx(pairs, a, ncx);
+			int idxY = pairy(pairs, a, ncx);
+			if (symmetric && idxX > idxY) { continue; }
+
+			out[a] = measurepair(
+				x.Codes + (size_t)idxX * nrx, x.Levels[idxX],
+				y.Codes + (size_t)idxY * nrx, y.Levels[idxY],
+				nrx, measure, xlogx, &h);
+		}
+	}
+
+	if (symmetric)
+	{
+		for (int a = 0; a < ncx; a++)
+			for (int b = 0; b < a; b++)
+				out[a + (size_t)b * ncx] = out[b + (size_t)a * ncx];
+	}
+
+	arenarelease(arena);
+	return Success;
+}
@@ -0,0 +1,286 @@
+/* MAPPEDARRAY - Memory-mapped array files that let kernels work on data sets larger than the available memory. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Element sizes now come from the elementsize function that every kernel shares.
+ *		20261017:	Array sizes are now checked for overflow, so corrupt headers can't make a small file look big enough.
+ *		20261017:	Added EvictMappedRows, which releases bands of rows from every column of an array (e.g. finished tiles of an
+ *					output whose rows are signals).
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Statistics.h"
+
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+
+
+/* CONSTANTS */
+#define MAGIC		"STATMAT"
+#define VERSION		1
+#define HEADERSIZE	64
+
+
+
+/* DATA */
+/// <summary>
+/// The fixed-size header that begins every mapped array file.
+/// </summary>
+typedef struct
+{
+	char		Magic[8];
+	uint32_t	Version;
+	uint32_t	Class;
+	uint64_t	NumRows;
+	uint64_t	NumColumns;
+	char		Reserved[HEADERSIZE - 32];
+}Header;
+
+/// <summary>
+/// Platform-specific details about a mapping.
+/// </summary>
+typedef struct
+{
+	void*		Base;			// The first byte of the mapped view (i.e. the header).
+	size_t		Size;			// The size of the mapped view in bytes.
+	int			Writable;
+#if defined(_WIN32)
+	HANDLE		File;
+	HANDLE		Map;
+#else
+	int			File;
+#endif
+}Mapping;
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Calculates the number of bytes that a mapped array file holds.
+/// </summary>
+/// <returns>The size of the header & every element, or zero if that can't be represented in a size_t.</returns>
+static size_t filesize(uint64_t nrows, uint64_t ncols, size_t szelement)
+{
+	if (nrows > SIZE_MAX || ncols > SIZE_MAX) { return 0; }
+	if (ncols != 0 && nrows > (SIZE_MAX - HEADERSIZE) / ncols / szelement) { return 0; }
+	return HEADERSIZE + (size_t)nrows * (size_t)ncols * szelement;
+}
+/// <summary>
+/// Maps an open file into memory and fills in an array description from its header.
+/// </summary>
+static ErrorCode mapfile(MappedArray* array, Mapping* m, size_t size)
+{
+#if defined(_WIN32)
+	m->Map = CreateFileMappingA(m->File, NULL, m->Writable ? PAGE_READWRITE : PAGE_READONLY, (DWORD)((uint64_t)size >> 32), (DWORD)size, NULL);
+	if (!m->Map) { return FileError; }
+	m->Base = MapViewOfFile(m->Map, m->Writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size);
+	if (!m->Base) { return FileError; }
+#else
+	m->Base = mmap(NULL, size, m->Writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, m->File, 0);
+	if (m->Base == MAP_FAILED)
+	{
+		m->Base = NULL;
+		return FileError;
+	}
+	madvise(m->Base, size, MADV_SEQUENTIAL);
+#endif
+	m->Size = size;
+
+	const Header* h = (const Header*)m->Base;
+	if (memcmp(h->Magic, MAGIC, sizeof(h->Magic)) != 0 || h->Version != VERSION || h->Class > SinglePrecision)
+		return InvalidFile;
+	size_t needed = filesize(h->NumRows, h->NumColumns, elementsize((Precision)h->Class));
+	if (needed == 0 || size < needed)
+		return InvalidFile;
+
+	array->Data = (char*)m->Base + HEADERSIZE;
+	array->Class = (Precision)h->Class;
+	array->NumRows = (size_t)h->NumRows;
+	array->NumColumns = (size_t)h->NumColumns;
+	array->Mapping = m;
+	return Success;
+}
+/// <summary>
+/// Releases all resources held by a mapping, whether or not it was completely set up.
+/// </summary>
+static void unmap(Mapping* m)
+{
+#if defined(_WIN32)
+	if (m->Base) { UnmapViewOfFile(m->Base); }
+	if (m->Map) { CloseHandle(m->Map); }
+	if (m->File != INVALID_HANDLE_VALUE) { CloseHandle(m->File); }
+#else
+	if (m->Base) { munmap(m->Base, m->Size); }
+	if (m->File >= 0) { close(m->File); }
+#endif
+	free(m);
+}
+/// <summary>
+/// Releases the physical memory that backs a range of a mapping, after writing any changes back to the file.
+/// </summary>
+/// <remarks>
+/// Only whole pages can be released. Pages that hold bytes after the range are always kept. Pages that hold bytes before
+/// it are only released when the caller allows it, in which case those bytes are simply read back from the file if they
+/// are needed again.
+/// </remarks>
+/// <param name="before">Whether the page that the range starts in may be released even if it begins before the range.</param>
+static void evict(const Mapping* m, char* start, char* end, int before)
+{
+#if defined(_WIN32)
+	// Unlocking pages that aren't locked removes them from the working set without discarding their contents
+	(void)before;
+	if (m->Writable) { FlushViewOfFile(start, (SIZE_T)(end - start)); }
+	VirtualUnlock(start, (SIZE_T)(end - start));
+#else
+	size_t pagesize = (size_t)sysconf(_SC_PAGESIZE);
+	uintptr_t a = (before ? (uintptr_t)start : (uintptr_t)start + pagesize - 1) & ~(uintptr_t)(pagesize - 1);
+	uintptr_t b = (uintptr_t)end & ~(uintptr_t)(pagesize - 1);
+	if (b <= a) { return; }
+
+	if (m->Writable) { msync((void*)a, b - a, MS_ASYNC); }
+	madvise((void*)a, b - a, MADV_DONTNEED);
+#endif
+}
+
+
+
+/* FUNCTIONS */
+ErrorCode OpenMappedArray(MappedArray* array, const char* path, int writable)
+{
+	memset(array, 0, sizeof(MappedArray));
+	Mapping* m = (Mapping*)calloc(1, sizeof(Mapping));
+	if (!m) { return OutOfMemory; }
+	m->Writable = writable;
+
+	size_t size;
+#if defined(_WIN32)
+	m->File = CreateFileA(path, writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	LARGE_INTEGER fsize;
+	if (m->File == INVALID_HANDLE_VALUE || !GetFileSizeEx(m->File, &fsize))
+	{
+		unmap(m);
+		return FileError;
+	}
+	size = (size_t)fsize.QuadPart;
+#else
+	m->File = open(path, writable ? O_RDWR : O_RDONLY);
+	struct stat st;
+	if (m->File < 0 || fstat(m->File, &st) != 0)
+	{
+		unmap(m);
+		return FileError;
+	}
+	size = (size_t)st.st_size;
+#endif
+
+	if (size < HEADERSIZE)
+	{
+		unmap(m);
+		return InvalidFile;
+	}
+
+	ErrorCode status = mapfile(array, m, size);
+	if (status != Success)
+	{
+		unmap(m);
+		memset(array, 0, sizeof(MappedArray));
+	}
+	return status;
+}
+
+ErrorCode CreateMappedArray(MappedArray* array, const char* path, Precision precision, size_t nrows, size_t ncols)
+{
+	memset(array, 0, sizeof(MappedArray));
+	if (precision != DoublePrecision && precision != SinglePrecision) { return InvalidArgument; }
+
+	size_t size = filesize(nrows, ncols, elementsize(precision));
+	if (size == 0) { return InvalidArgument; }
+
+	Mapping* m = (Mapping*)calloc(1, sizeof(Mapping));
+	if (!m) { return OutOfMemory; }
+	m->Writable = 1;
+
+	Header h;
+	memset(&h, 0, sizeof(Header));
+	memcpy(h.Magic, MAGIC, sizeof(MAGIC));
+	h.Version = VERSION;
+	h.Class = (uint32_t)precision;
+	h.NumRows = nrows;
+	h.NumColumns = ncols;
+
+#if defined(_WIN32)
+	m->File = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	DWORD nwritten = 0;
+	LARGE_INTEGER fsize;
+	fsize.QuadPart = (LONGLONG)size;
+	if (m->File == INVALID_HANDLE_VALUE || !WriteFile(m->File, &h, HEADERSIZE, &nwritten, NULL) ||
+		!SetFilePointerEx(m->File, fsize, NULL, FILE_BEGIN) || !SetEndOfFile(m->File))
+	{
+		unmap(m);
+		return FileError;
+	}
+#else
+	m->File = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (m->File < 0 || write(m->File, &h, HEADERSIZE) != HEADERSIZE || ftruncate(m->File, (off_t)size) != 0)
+	{
+		unmap(m);
+		return FileError;
+	}
+#endif
+
+	ErrorCode status = mapfile(array, m, size);
+	if (status != Success)
+	{
+		unmap(m);
+		memset(array, 0, sizeof(MappedArray));
+	}
+	return status;
+}
+
+void EvictMappedColumns(MappedArray* array, size_t first, size_t count)
+{
+	Mapping* m = (Mapping*)array->Mapping;
+	if (!m || count == 0) { return; }
+
+	size_t colbytes = array->NumRows * elementsize(array->Class);
+	char* start = (char*)array->Data + first * colbytes;
+	evict(m, start, start + count * colbytes, 0);
+}
+
+void EvictMappedRows(MappedArray* array, size_t first, size_t count)
+{
+	Mapping* m = (Mapping*)array->Mapping;
+	if (!m || count == 0) { return; }
+
+	size_t szelement = elementsize(array->Class);
+	size_t colbytes = array->NumRows * szelement;
+	for (size_t a = 0; a < array->NumColumns; a++)
+	{
+		char* start = (char*)array->Data + a * colbytes + first * szelement;
+		evict(m, start, start + count * szelement, 1);
+	}
+}
+
+void CloseMappedArray(MappedArray* array)
+{
+	Mapping* m = (Mapping*)array->Mapping;
+	if (!m) { return; }
+
+#if defined(_WIN32)
+	if (m->Writable && m->Base) { FlushViewOfFile(m->Base, 0); }
+#else
+	if (m->Writable && m->Base) { msync(m->Base, m->Size, MS_SYNC); }
+#endif
+
+	unmap(m);
+	memset(array, 0, sizeof(MappedArray));
+}
@@ -0,0 +1,174 @@
+/* MATRIX - Dense linear algebra helpers used by the native statistics kernels. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Added gemmtnadd, which accumulates products into C instead of overwriting it.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Matrix.h"
+#include "Simd.h"
+
+#ifdef STATISTICS_CBLAS
+	#include <cblas.h>
+#endif
+
+
+
+/* CONSTANTS */
+#define MR	4			// Rows of C computed by one call to the micro-kernel.
+#define NR	4			// Columns of C computed by one call to the micro-kernel.
+#define KC	256			// The depth of each rank-KC update, chosen so that packed panels stay resident in L1/L2.
+#define MC	128			// Rows of A' packed at once.
+
+
+
+/* SUBROUTINES */
+#ifndef STATISTICS_CBLAS
+/// <summary>
+/// Copies a [kc x mc] block of a column-major matrix into row panels of MR columns each, padding with zeros.
+/// </summary>
+/// <remarks>
+/// After packing, the MR elements that the micro-kernel needs at each depth index are contiguous, which lets the inner loop
+/// of the micro-kernel vectorize across rows of C without reassociating any sums.
+/// </remarks>
+static void pack(double P[], const double A[], int lda, int kc, int mc, int R)
+{
+	for (int i0 = 0; i0 < mc; i0 += R)
+	{
+		int mr = (mc - i0 < R) ? mc - i0 : R;
+		for (int p = 0; p < kc; p++)
+		{
+			for (int i = 0; i < mr; i++)
+				P[i] = A[p + (size_t)(i0 + i) * lda];
+			for (int i = mr; i < R; i++)
+				P[i] = 0.0;
+			P += R;
+		}
+	}
+}
+/// <summary>
+/// Accumulates an [MR x NR] tile of C from packed panels of A' and B.
+/// </summary>
+static void micro(int kc, const double Ap[], const double Bp[], double C[], int ldc, int mr, int nr, int first)
+{
+	double c[NR][MR] = { { 0 } };
+	for (int p = 0; p < kc; p++)
+	{
+		for (int j = 0; j < NR; j++)
+		{
+			double b = Bp[j];
+			for (int i = 0; i < MR; i++)
+				c[j][i] += Ap[i] * b;
+		}
+		Ap += MR;
+		Bp += NR;
+	}
+
+	for (int j = 0; j < nr; j++)
+	{
+		double* Cj = C + (size_t)j * ldc;
+		if (first)
+			for (int i = 0; i < mr; i++) { Cj[i] = c[j][i]; }
+		else
+			for (int i = 0; i < mr; i++) { Cj[i] += c[j][i]; }
+	}
+}
+#endif
+/// <summary>
+/// Computes C = A' * B, or C += A' * B when accumulating.
+/// </summary>
+static ErrorCode product(int m, int n, int k, const double A[], int lda, const double B[], int ldb, double C[], int ldc, int accumulate)
+{
+	if (m <= 0 || n <= 0) { return Success; }
+
+#ifdef STATISTICS_CBLAS
+	cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, m, n, k, 1.0, A, lda, B, ldb, accumulate ? 1.0 : 0.0, C, ldc);
+#else
+	if (k <= 0)
+	{
+		for (int j = 0; j < n && !accumulate; j++)
+			memset(C + (size_t)j * ldc, 0, m * sizeof(double));
+		return Success;
+	}
+
+	int npanels = (n + NR - 1) / NR;
+	double* Ap = (double*)malloc((size_t)KC * ((MC + MR - 1) / MR) * MR * sizeof(double));
+	double* Bp = (double*)malloc((size_t)KC * npanels * NR * sizeof(double));
+	if (!Ap || !Bp)
+	{
+		free(Ap);
+		free(Bp);
+		return OutOfMemory;
+	}
+
+	for (int p0 = 0; p0 < k; p0 += KC)
+	{
+		int kc = (k - p0 < KC) ? k - p0 : KC;
+		pack(Bp, B + p0, ldb, kc, n, NR);
+
+		for (int i0 = 0; i0 < m; i0 += MC)
+		{
+			int mc = (m - i0 < MC) ? m - i0 : MC;
+			pack(Ap, A + p0 + (size_t)i0 * lda, lda, kc, mc, MR);
+
+			for (int j = 0; j < n; j += NR)
+			{
+				int nr = (n - j < NR) ? n - j : NR;
+				const double* Bj = Bp + (size_t)(j / NR) * kc * NR;
+				for (int i = 0; i < mc; i += MR)
+				{
+					int mr = (mc - i < MR) ? mc - i : MR;
+					const double* Ai = Ap + (size_t)(i / MR) * kc * MR;
+					micro(kc, Ai, Bj, C + (i0 + i) + (size_t)j * ldc, ldc, mr, nr, p0 == 0 && !accumulate);
+				}
+			}
+		}
+	}
+
+	free(Ap);
+	free(Bp);
+#endif
+
+	return Success;
+}
+
+
+
+/* FUNCTIONS */
+ErrorCode gemmtn(int m, int n, int k, const double A[], int lda, const double B[], int ldb, double C[], int ldc)
+{
+	return product(m, n, k, A, lda, B, ldb, C, ldc, 0);
+}
+
+ErrorCode gemmtnadd(int m, int n, int k, const double A[], int lda, const double B[], int ldb, double C[], int ldc)
+{
+	return product(m, n, k, A, lda, B, ldb, C, ldc, 1);
+}
+
+void standardize(double z[], const double x[], int nsamples)
+{
+	double mean = 0;
+	for (int a = 0; a < nsamples; a++)
+		mean += x[a];
+	mean /= (double)nsamples;
+
+	double ss = 0;
+	for (int a = 0; a < nsamples; a++)
+	{
+		z[a] = x[a] - mean;
+		ss += z[a] * z[a];
+	}
+
+	double scale = (ss > 0) ? 1.0 / sqrt(ss) : NAN;
+	for (int a = 0; a < nsamples; a++)
+		z[a] *= scale;
+}
+
+void standardizef(double z[], const float x[], int nsamples)
+{
+	widen(z, x, (size_t)nsamples);
+	standardize(z, z, nsamples);
+}
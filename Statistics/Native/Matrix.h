@@ -0,0 +1,59 @@
+/* MATRIX - Dense linear algebra helpers used by the native statistics kernels.
+ *
+ *	All matrices here are column-major with an explicit leading dimension, which is the same layout that MATLAB, BLAS and
+ *	the SignalArray type use. When the library is built with STATISTICS_CBLAS defined, products are delegated to the
+ *	system BLAS. Otherwise a cache-blocked kernel in Matrix.c is used so that the library keeps working without one.
+ */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Added gemmtnadd.
+ */
+
+#pragma once
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include "Statistics.h"
+
+
+
+/* FUNCTIONS */
+/// <summary>
+/// Computes the matrix product C = A' * B.
+/// </summary>
+/// <param name="m">The number of rows of C and columns of A.</param>
+/// <param name="n">The number of columns of C and B.</param>
+/// <param name="k">The number of rows of A and B (i.e. the length of each dot product).</param>
+/// <param name="A">A [k x m] matrix with leading dimension lda.</param>
+/// <param name="B">A [k x n] matrix with leading dimension ldb.</param>
+/// <param name="C">An [m x n] output matrix with leading dimension ldc. Any existing contents are overwritten.</param>
+/// <returns>OutOfMemory if packing buffers could not be allocated, or Success otherwise.</returns>
+ErrorCode	gemmtn(int m, int n, int k, const double A[], int lda, const double B[], int ldb, double C[], int ldc);
+/// <summary>
+/// Accumulates the matrix product C += A' * B.
+/// </summary>
+/// <remarks>
+/// This takes the same arguments as gemmtn, except that the existing contents of C are added to instead of overwritten.
+/// </remarks>
+ErrorCode	gemmtnadd(int m, int n, int k, const double A[], int lda, const double B[], int ldb, double C[], int ldc);
+
+/// <summary>
+/// Centers a signal on its mean and scales it to unit Euclidean norm.
+/// </summary>
+/// <remarks>
+/// The dot product of two standardized signals is their Pearson correlation coefficient. Signals with no variance are
+/// filled with NaNs so that their correlations come out as NaN, just like the raw-sum formula in corr does.
+/// </remarks>
+/// <param name="z">An output vector of length nsamples that receives the standardized signal.</param>
+/// <param name="x">The signal to be standardized.</param>
+/// <param name="nsamples">The number of samples in x and z.</param>
+void		standardize(double z[], const double x[], int nsamples);
+/// <summary>
+/// Centers a single precision signal on its mean and scales it to unit Euclidean norm in double precision.
+/// </summary>
+void		standardizef(double z[], const float x[], int nsamples);
+
+
+
+#endif
@@ -0,0 +1,269 @@
+/* PARALLEL - Scheduler settings & the work-stealing loop scheduler shared by the native statistics kernels. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Replaces thread counts & grain sizes that used to be hard-coded into individual kernels.
+ *		20261017:	Settings are now kept in static state instead of the environment, which isn't safe to change while other threads
+ *					may be reading it. The MEX functions share one copy of the library, so they still see each other's settings.
+ */
+
+#if defined(__linux__)
+	#define _GNU_SOURCE
+#endif
+
+#include <stdlib.h>
+#include "Parallel.h"
+#include "Statistics.h"
+
+#if defined(_WIN32)
+	#include <windows.h>
+#elif defined(__linux__)
+	#include <sched.h>
+#endif
+
+
+
+/* CONSTANTS */
+#define GRAIN			"STATISTICS_GRAIN"
+#define LINE			64			// The size of a cache line, which keeps the queues of different threads apart.
+#define TAKES			16			// The number of grains that automatic grain sizes split each thread's share into.
+
+
+
+/* DATA */
+static Affinity		affinity = Unpinned;	// How worker threads are pinned to processors.
+static long			grain = -1;				// The grain size, or -1 until its initial value has been read.
+
+#ifdef _OPENMP
+/// <summary>
+/// Holds the iterations [Next, End) that one thread has yet to run.
+/// </summary>
+typedef struct
+{
+	size_t			Next;			// The first iteration that hasn't been taken.
+	size_t			End;			// One past the last iteration in the queue.
+	omp_lock_t		Lock;			// Guards both bounds against the owner & thieves.
+}Queue;
+#endif
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Pins every worker thread of a parallel region to processors. The calling thread (thread zero) is left alone.
+/// </summary>
+/// <returns>Whether the platform supports pinning threads.</returns>
+static int pin(Affinity pinning)
+{
+#if defined(__linux__)
+	// The calling thread is never pinned, so it still holds every processor that the process may run on
+	cpu_set_t all;
+	if (sched_getaffinity(0, sizeof(all), &all) != 0) { return 0; }
+	int cpus[CPU_SETSIZE];
+	int ncpus = 0;
+	for (int a = 0; a < CPU_SETSIZE; a++)
+	{
+		if (CPU_ISSET(a, &all))
+			cpus[ncpus++] = a;
+	}
+
+	#pragma omp parallel
+	{
+		int id = threadid();
+		int n = teamsize();
+		if (id > 0)
+		{
+			cpu_set_t set = all;
+			if (pinning != Unpinned)
+			{
+				int idx = (pinning == Compact) ? id % ncpus : (int)(((long)id * ncpus / n) % ncpus);
+				CPU_ZERO(&set);
+				CPU_SET(cpus[idx], &set);
+			}
+			sched_setaffinity(0, sizeof(set), &set);
+		}
+	}
+	return 1;
+#elif defined(_WIN32)
+	DWORD_PTR process, system;
+	if (!GetProcessAffinityMask(GetCurrentProcess(), &process, &system)) { return 0; }
+	int cpus[8 * sizeof(DWORD_PTR)];
+	int ncpus = 0;
+	for (int a = 0; a < (int)(8 * sizeof(DWORD_PTR)); a++)
+	{
+		if (process & ((DWORD_PTR)1 << a))
+			cpus[ncpus++] = a;
+	}
+
+	#pragma omp parallel
+	{
+		int id = threadid();
+		int n = teamsize();
+		if (id > 0)
+		{
+			DWORD_PTR mask = process;
+			if (pinning != Unpinned)
+			{
+				int idx = (pinning == Compact) ? id % ncpus : (int)(((long)id * ncpus / n) % ncpus);
+				mask = (DWORD_PTR)1 << cpus[idx];
+			}
+			SetThreadAffinityMask(GetCurrentThread(), mask);
+		}
+	}
+	return 1;
+#else
+	return pinning == Unpinned;
+#endif
+}
+
+#ifdef _OPENMP
+/// <summary>
+/// Gets the queue of one thread from an array of queues that are each padded out to a whole number of cache lines.
+/// </summary>
+static inline Queue* queue(char* queues, size_t stride, int idx)
+{
+	return (Queue*)(queues + (size_t)idx * stride);
+}
+/// <summary>
+/// Takes the next grain of iterations from a thread's own queue.
+/// </summary>
+/// <returns>Whether any iterations were left.</returns>
+static int take(Queue* q, size_t grain, size_t* first, size_t* last)
+{
+	omp_set_lock(&q->Lock);
+	int found = (q->Next < q->End);
+	if (found)
+	{
+		*first = q->Next;
+		*last = (q->End - q->Next < grain) ? q->End : q->Next + grain;
+		q->Next = *last;
+	}
+	omp_unset_lock(&q->Lock);
+	return found;
+}
+/// <summary>
+/// Moves the upper half of the first non-empty queue belonging to another thread into a thread's own queue.
+/// </summary>
+/// <remarks>
+/// Work is only ever moved, never created, so a thread that finds every other queue empty can stop. Anything that
+/// another thief is holding at that moment will be run by that thief.
+/// </remarks>
+/// <returns>Whether anything was stolen.</returns>
+static int steal(char* queues, size_t stride, int id, int nthreads)
+{
+	for (int a = 1; a < nthreads; a++)
+	{
+		Queue* victim = queue(queues, stride, (id + a) % nthreads);
+		omp_set_lock(&victim->Lock);
+		size_t remaining = victim->End - victim->Next;
+		size_t first = victim->End - (remaining + 1) / 2;
+		size_t last = victim->End;
+		victim->End = first;
+		omp_unset_lock(&victim->Lock);
+
+		if (remaining)
+		{
+			Queue* own = queue(queues, stride, id);
+			omp_set_lock(&own->Lock);
+			own->Next = first;
+			own->End = last;
+			omp_unset_lock(&own->Lock);
+			return 1;
+		}
+	}
+	return 0;
+}
+#endif
+
+
+
+/* FUNCTIONS */
+ErrorCode SetThreads(int nthreads)
+{
+	if (nthreads < 0) { return InvalidArgument; }
+#ifdef _OPENMP
+	omp_set_num_threads(nthreads ? nthreads : omp_get_num_procs());
+#endif
+	// Pools can gain new threads, which start out unpinned
+	if (affinity != Unpinned) { pin(affinity); }
+	return Success;
+}
+int GetThreads(void)
+{
+	return maxthreads();
+}
+ErrorCode SetAffinity(Affinity pinning)
+{
+	if (pinning < Unpinned || pinning > Spread)	{ return InvalidArgument; }
+	if (!pin(pinning))							{ return InvalidArgument; }
+	affinity = pinning;
+	return Success;
+}
+Affinity GetAffinity(void)
+{
+	return affinity;
+}
+void SetGrainSize(size_t size)
+{
+	grain = (long)size;
+}
+size_t GetGrainSize(void)
+{
+	// The environment is only ever read, and only until a grain size is set
+	if (grain < 0)
+	{
+		const char* value = getenv(GRAIN);
+		long size = value ? strtol(value, NULL, 10) : 0;
+		grain = (size > 0) ? size : 0;
+	}
+	return (size_t)grain;
+}
+
+void parallelfor(size_t count, LoopBody body, void* args)
+{
+	if (count == 0) { return; }
+
+#ifdef _OPENMP
+	int nthreads = maxthreads();
+	size_t stride = ((sizeof(Queue) + LINE - 1) / LINE) * LINE;
+	char* queues = (nthreads > 1 && count > 1 && !omp_in_parallel()) ? (char*)malloc((size_t)nthreads * stride) : NULL;
+	if (queues)
+	{
+		size_t size = GetGrainSize();
+
+		#pragma omp parallel num_threads(nthreads)
+		{
+			// The runtime may start fewer threads than requested, so shares are split among the threads that exist
+			int id = threadid();
+			int n = teamsize();
+			size_t share = count / n, extra = count % n;
+			size_t chunk = size ? size : share / TAKES;
+			chunk = chunk ? chunk : 1;
+
+			Queue* own = queue(queues, stride, id);
+			own->Next = id * share + ((size_t)id < extra ? (size_t)id : extra);
+			own->End = own->Next + share + ((size_t)id < extra);
+			omp_init_lock(&own->Lock);
+
+			#pragma omp barrier
+			size_t first, last;
+			for (;;)
+			{
+				if (take(own, chunk, &first, &last))
+					body(args, first, last, id);
+				else if (!steal(queues, stride, id, n))
+					break;
+			}
+
+			// Thieves may still be looking at this queue until every thread has finished
+			#pragma omp barrier
+			omp_destroy_lock(&own->Lock);
+		}
+
+		free(queues);
+		return;
+	}
+#endif
+
+	body(args, 0, count, 0);
+}
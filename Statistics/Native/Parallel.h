@@ -0,0 +1,89 @@
+/* PARALLEL - Portable access to the threading runtime used by the native statistics kernels.
+ *
+ *	The kernels are parallelized with OpenMP pragmas, which compilers without OpenMP support simply ignore. The functions
+ *	here cover the few places where a kernel needs to ask the runtime about threads directly, and they fall back to
+ *	single-threaded answers when OpenMP isn't available.
+ *
+ *	Loops whose iterations vary in cost, or that have too few outer iterations to occupy every thread (e.g. a single pair
+ *	of long signals), can instead be run through parallelfor, which splits a flattened iteration space across threads and
+ *	lets idle threads steal work from busy ones.
+ */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Added a work-stealing loop scheduler whose grain size is configured through SetGrainSize.
+ *		20261017:	Loop bodies now receive the index of the worker that runs them, which stays valid for indexing per-thread
+ *					workspace even when the loop runs serially inside another parallel region.
+ */
+
+#pragma once
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stddef.h>
+
+#ifdef _OPENMP
+	#include <omp.h>
+#endif
+
+
+
+/* DATA */
+/// <summary>
+/// Processes the iterations [first, last) of a loop that parallelfor splits across threads.
+/// </summary>
+/// <remarks>
+/// Workers are numbered from zero up to (but not including) the value that maxthreads returned when parallelfor was
+/// called, so worker indices can select per-thread workspace.
+/// </remarks>
+typedef void (*LoopBody)(void* args, size_t first, size_t last, int worker);
+
+
+
+/* FUNCTIONS */
+/// <summary>
+/// Gets the maximum number of threads that a parallel region started from the calling thread may use.
+/// </summary>
+static inline int maxthreads(void)
+{
+#ifdef _OPENMP
+	return omp_get_max_threads();
+#else
+	return 1;
+#endif
+}
+/// <summary>
+/// Gets the index of the calling thread within the current parallel region.
+/// </summary>
+static inline int threadid(void)
+{
+#ifdef _OPENMP
+	return omp_get_thread_num();
+#else
+	return 0;
+#endif
+}
+/// <summary>
+/// Gets the number of threads in the current parallel region.
+/// </summary>
+static inline int teamsize(void)
+{
+#ifdef _OPENMP
+	return omp_get_num_threads();
+#else
+	return 1;
+#endif
+}
+/// <summary>
+/// Runs count iterations of a loop across threads using a work-stealing scheduler.
+/// </summary>
+/// <remarks>
+/// Each thread starts with an equal contiguous share of the iterations, which it takes a grain at a time. Threads that
+/// run out steal the upper half of what is left to another thread. Loops run serially when called from inside a parallel
+/// region or when OpenMP isn't available.
+/// </remarks>
+void parallelfor(size_t count, LoopBody body, void* args);
+
+
+
+#endif
@@ -0,0 +1,207 @@
+/* PARTIAL - Partial correlations, which control for nuisance signals by regressing them out of the signals first. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Added epilogues. Tiles are processed by the cross-correlation kernel as they are computed, and mapped outputs are
+ *					scattered from the tile buffer once every signal pairing in a tile is done.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Arena.h"
+#include "Epilogue.h"
+#include "Statistics.h"
+
+
+
+/* CONSTANTS */
+#define RANKTOL		1e-10			// Nuisance signals with less than this fraction of their norm left after projection are dependent.
+#define MINTILE		64				// The smallest number of signals that residual tiles may hold.
+
+
+
+/* SUBROUTINES */
+static double dot(const double x[], const double y[], int n)
+{
+	double sum = 0;
+	#pragma omp simd reduction(+:sum)
+	for (int a = 0; a < n; a++)
+		sum += x[a] * y[a];
+	return sum;
+}
+/// <summary>
+/// Removes the components of a signal that lie in the span of a set of orthonormal basis vectors.
+/// </summary>
+/// <remarks>
+/// Components are removed one basis vector at a time (i.e. modified Gram-Schmidt), which keeps the residuals orthogonal
+/// to the basis even when the signal lies almost entirely within its span. The signal is small enough to stay in cache
+/// across all of the basis vectors, so it is only ever read from memory once.
+/// </remarks>
+static void project(double r[], const double x[], const double Q[], int nsamples, int rank)
+{
+	if (r != x)
+		memcpy(r, x, (size_t)nsamples * sizeof(double));
+
+	for (int a = 0; a < rank; a++)
+	{
+		const double* qa = Q + (size_t)a * nsamples;
+		double c = dot(qa, r, nsamples);
+		#pragma omp simd
+		for (int b = 0; b < nsamples; b++)
+			r[b] -= c * qa[b];
+	}
+}
+/// <summary>
+/// Moves the [L x NBX x NY] cross-correlations of a tile of X into the mapped rows of an [NumRows x L x NY] output.
+/// </summary>
+static void scatter(double out[], const double tile[], const Epilogue* e, int x0, int nbx, int ncy, int nlags)
+{
+	#pragma omp parallel for schedule(static)
+	for (int a = 0; a < ncy; a++)
+	{
+		for (int b = 0; b < nbx; b++)
+		{
+			const double* src = tile + ((size_t)a * nbx + b) * nlags;
+			double* dst = out + (size_t)a * nlags * e->NumRows + e->Map[x0 + b];
+			for (int c = 0; c < nlags; c++)
+				dst[(size_t)c * e->NumRows] = src[c];
+		}
+	}
+}
+
+
+
+/* FUNCTIONS */
+ErrorCode FactorNuisance(Nuisance* q, SignalArray z)
+{
+	q->Basis = NULL;
+	q->NumSamples = z.NumSamples;
+	q->Rank = 0;
+	if (z.NumSamples == 0 || z.NumSignals == 0)	{ return EmptyInput; }
+
+	int m = z.NumSamples;
+	q->Basis = (double*)malloc((size_t)m * z.NumSignals * sizeof(double));
+	if (!q->Basis) { return OutOfMemory; }
+
+	for (int a = 0; a < z.NumSignals; a++)
+	{
+		const double* za = column(z, a);
+		double* qa = q->Basis + (size_t)q->Rank * m;
+
+		// Projecting twice restores the orthogonality that a single pass loses when columns are nearly dependent
+		double norm = sqrt(dot(za, za, m));
+		project(qa, za, q->Basis, m, q->Rank);
+		project(qa, qa, q->Basis, m, q->Rank);
+
+		double rnorm = sqrt(dot(qa, qa, m));
+		if (rnorm <= RANKTOL * norm || rnorm == 0) { continue; }
+
+		for (int b = 0; b < m; b++)
+			qa[b] /= rnorm;
+		q->Rank++;
+	}
+
+	return Success;
+}
+
+void FreeNuisance(Nuisance* q)
+{
+	if (!q) { return; }
+	free(q->Basis);
+	q->Basis = NULL;
+	q->Rank = 0;
+}
+
+ErrorCode Residualize(double r[], SignalArray x, const Nuisance* q)
+{
+	if (x.NumSamples == 0 || x.NumSignals == 0)	{ return EmptyInput; }
+	if (x.NumSamples != q->NumSamples)			{ return SizeMismatch; }
+
+	#pragma omp parallel for schedule(static)
+	for (int a = 0; a < x.NumSignals; a++)
+		project(r + (size_t)a * x.NumSamples, column(x, a), q->Basis, x.NumSamples, q->Rank);
+
+	return Success;
+}
+
+ErrorCode PartialCrossCorrelateLags(double cc[], SignalArray x, const Nuisance* qx, SignalArray y, const Nuisance* qy, const int lags[], int nlags, const Epilogue* epilogue)
+{
+	if (x.NumSamples == 0 || x.NumSignals == 0 || y.NumSignals == 0)	{ return EmptyInput; }
+	if (x.NumSamples != y.NumSamples)								{ return SizeMismatch; }
+	if ((qx && qx->NumSamples != x.NumSamples) || (qy && qy->NumSamples != y.NumSamples))	{ return SizeMismatch; }
+	if (nlags <= 0)													{ return InvalidArgument; }
+
+	ErrorCode status = epiloguecheck(epilogue, x.NumSignals);
+	if (status != Success) { return status; }
+
+	int nrx = x.NumSamples;
+	int ncx = x.NumSignals;
+	int ncy = y.NumSignals;
+	int mapped = (epilogue && epilogue->Map);
+
+	// Tiles are processed elementwise by the kernel. Mapped outputs always go through the tile buffer to get scattered.
+	Epilogue local;
+	if (epilogue)
+	{
+		local = *epilogue;
+		local.Map = NULL;
+	}
+
+	// Tiles of X use half of the memory budget for residuals & the cross-correlations of a tile when they need gathering
+	size_t szry = qy ? aligned((size_t)nrx * ncy * sizeof(double)) : 0;
+	size_t tilebytes = (size_t)nrx * sizeof(double) + ((ncy > 1 || mapped) ? (size_t)nlags * ncy * sizeof(double) : 0);
+	size_t nt = GetMemoryBudget() / 2 / tilebytes;
+	nt = (nt < MINTILE) ? MINTILE : nt;
+	nt = (nt > (size_t)ncx) ? (size_t)ncx : nt;
+	int bx = (int)nt;
+
+	size_t szrx = qx ? aligned((size_t)nrx * bx * sizeof(double)) : 0;
+	size_t sztile = ((ncy > 1 && bx < ncx) || mapped) ? aligned((size_t)nlags * bx * ncy * sizeof(double)) : 0;
+	Arena* arena = arenaacquire(szry + szrx + sztile);
+	if (!arena) { return OutOfMemory; }
+
+	double* ry = qy ? (double*)arenaalloc(arena, szry) : NULL;
+	double* rx = qx ? (double*)arenaalloc(arena, szrx) : NULL;
+	double* tile = sztile ? (double*)arenaalloc(arena, sztile) : NULL;
+
+	status = epiloguefill(epilogue, cc, ncx, ncy, nlags);
+	if (status == Success && qy)
+	{
+		status = Residualize(ry, y, qy);
+		y = signals(ry, nrx, ncy);
+	}
+
+	for (int x0 = 0; x0 < ncx && status == Success; x0 += bx)
+	{
+		int nbx = (ncx - x0 < bx) ? ncx - x0 : bx;
+		SignalArray xt = { column(x, x0), nrx, nbx, x.Stride };
+		if (qx)
+		{
+			status = Residualize(rx, xt, qx);
+			if (status != Success) { break; }
+			xt = signals(rx, nrx, nbx);
+		}
+
+		// With a single signal in Y (or a single tile), the tile's cross-correlations are already where they belong
+		if (!tile)
+		{
+			status = CrossCorrelateLagsEx(cc + (size_t)x0 * nlags, xt, y, lags, nlags, epilogue ? &local : NULL);
+			continue;
+		}
+
+		status = CrossCorrelateLagsEx(tile, xt, y, lags, nlags, epilogue ? &local : NULL);
+		if (status != Success) { break; }
+
+		if (mapped)
+		{
+			scatter(cc, tile, epilogue, x0, nbx, ncy, nlags);
+			continue;
+		}
+		for (int a = 0; a < ncy; a++)
+			memcpy(cc + ((size_t)a * ncx + x0) * nlags, tile + (size_t)a * nbx * nlags, (size_t)nbx * nlags * sizeof(double));
+	}
+
+	arenarelease(arena);
+	return status;
+}
@@ -0,0 +1,302 @@
+/* PROFILE - Phase timers & counters that instrument the native statistics kernels. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Hardware counters now only count while a kernel call is underway, instead of from when they were opened until
+ *					the profile was read.
+ */
+
+#if defined(__linux__)
+	#define _GNU_SOURCE
+#elif !defined(_WIN32)
+	#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include "Parallel.h"
+#include "Profile.h"
+#include "Statistics.h"
+
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <time.h>
+	#include <unistd.h>
+#endif
+#if defined(__linux__)
+	#include <linux/perf_event.h>
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+#endif
+
+
+
+/* CONSTANTS */
+#define UNOPENED	-2				// Marks hardware counters that a thread hasn't tried to open yet.
+#define NUMCOUNTERS	2				// Processor cycles & last-level cache misses.
+
+
+
+/* DATA */
+#ifdef STATISTICS_PROFILING
+int					profiling = 0;
+
+static const char*	kernel = NULL;								// The first kernel that ran while profiling.
+static uint64_t		calls = 0;									// The number of profiled kernel calls.
+static double		wall = 0;									// The seconds spent inside profiled kernel calls.
+static double		entered = 0;								// The time at which the current kernel call started.
+static int			depth = 0;									// The number of kernel calls that are underway.
+static uint64_t		bytes = 0;									// The bytes that kernels read & wrote.
+static uint64_t		pairs = 0;									// The signal pairings that kernels processed.
+static double		times[PROFILETHREADS][NumPhases];			// The seconds that each thread spent in each phase.
+static int			counters[PROFILETHREADS][NUMCOUNTERS];		// The hardware counters of each thread.
+static int			reset = 0;									// Whether the counters have been initialized.
+#endif
+
+static const char*	names[NumPhases] = { "Plan", "Prepare", "Forward", "Spectrum", "Inverse", "Gather", "Direct", "Store" };
+
+
+
+/* SUBROUTINES */
+#ifdef STATISTICS_PROFILING
+/// <summary>
+/// Gets the time in seconds since an arbitrary fixed point.
+/// </summary>
+static double profileclock(void)
+{
+#if defined(_OPENMP)
+	return omp_get_wtime();
+#elif defined(_WIN32)
+	LARGE_INTEGER ticks, frequency;
+	QueryPerformanceCounter(&ticks);
+	QueryPerformanceFrequency(&frequency);
+	return (double)ticks.QuadPart / (double)frequency.QuadPart;
+#else
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + 1e-9 * (double)t.tv_nsec;
+#endif
+}
+/// <summary>
+/// Gets the profile slot of the calling thread.
+/// </summary>
+static int slot(void)
+{
+	int id = threadid();
+	return (id < PROFILETHREADS) ? id : PROFILETHREADS - 1;
+}
+/// <summary>
+/// Opens one hardware counter for the calling thread, which doesn't count anything until it is enabled.
+/// </summary>
+/// <returns>The counter's file descriptor, or -1 if the platform or its permissions don't allow counting.</returns>
+static int counteropen(int idx)
+{
+#if defined(__linux__)
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.config = (idx == 0) ? PERF_COUNT_HW_CPU_CYCLES : PERF_COUNT_HW_CACHE_MISSES;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+	return -1;
+#endif
+}
+/// <summary>
+/// Starts or stops the hardware counters of one thread.
+/// </summary>
+static void counterswitch(int id, int enable)
+{
+#if defined(__linux__)
+	for (int a = 0; a < NUMCOUNTERS; a++)
+	{
+		if (counters[id][a] >= 0)
+			ioctl(counters[id][a], enable ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE, 0);
+	}
+#endif
+}
+/// <summary>
+/// Sums one hardware counter over every thread that opened it.
+/// </summary>
+/// <returns>The total count, or -1 if any thread failed to open the counter or none opened it.</returns>
+static int64_t counterread(int idx)
+{
+	int64_t total = 0;
+	int found = 0;
+	for (int a = 0; a < PROFILETHREADS; a++)
+	{
+		int fd = counters[a][idx];
+		if (fd == UNOPENED) { continue; }
+		if (fd < 0) { return -1; }
+
+#if defined(__linux__)
+		uint64_t value;
+		if (read(fd, &value, sizeof(value)) != (ssize_t)sizeof(value)) { return -1; }
+		total += (int64_t)value;
+		found = 1;
+#endif
+	}
+	return found ? total : -1;
+}
+/// <summary>
+/// Closes every hardware counter & forgets everything that has been recorded.
+/// </summary>
+static void clear(void)
+{
+	// Counters start out zeroed rather than unopened, so nothing is closed before the first reset
+	for (int a = 0; a < PROFILETHREADS; a++)
+	{
+		for (int b = 0; b < NUMCOUNTERS; b++)
+		{
+#if defined(__linux__)
+			if (reset && counters[a][b] >= 0) { close(counters[a][b]); }
+#endif
+			counters[a][b] = UNOPENED;
+		}
+	}
+	memset(times, 0, sizeof(times));
+	kernel = NULL;
+	calls = bytes = pairs = 0;
+	wall = entered = 0;
+	depth = 0;
+	reset = 1;
+}
+#endif
+
+
+
+/* FUNCTIONS */
+#ifdef STATISTICS_PROFILING
+double profilestart(void)
+{
+	// Threads past the last slot share it, so only the thread whose index matches the slot opens its counters
+	int id = threadid();
+	if (id < PROFILETHREADS && counters[id][0] == UNOPENED)
+	{
+		for (int a = 0; a < NUMCOUNTERS; a++)
+			counters[id][a] = counteropen(a);
+
+		// Counters that open partway through a kernel call have missed their chance to be started with the others
+		if (depth > 0) { counterswitch(id, 1); }
+	}
+	return profileclock();
+}
+void profilephase(Phase phase, double start)
+{
+	double elapsed = profileclock() - start;
+	int idx = slot();
+
+	#pragma omp atomic
+	times[idx][phase] += elapsed;
+}
+void profileadd(size_t nbytes, size_t npairs)
+{
+	#pragma omp atomic
+	bytes += (uint64_t)nbytes;
+	#pragma omp atomic
+	pairs += (uint64_t)npairs;
+}
+void profileenter(const char* name)
+{
+	if (teamsize() > 1) { return; }
+	if (depth++ == 0)
+	{
+		entered = profileclock();
+		calls++;
+		if (!kernel) { kernel = name; }
+
+		// Counters only run inside kernel calls, so time spent in MATLAB or the caller between calls isn't counted
+		for (int a = 0; a < PROFILETHREADS; a++)
+			counterswitch(a, 1);
+	}
+}
+void profileleave(void)
+{
+	if (teamsize() > 1) { return; }
+	if (depth > 0 && --depth == 0)
+	{
+		wall += profileclock() - entered;
+		for (int a = 0; a < PROFILETHREADS; a++)
+			counterswitch(a, 0);
+	}
+}
+#endif
+
+void SetProfiling(int enabled)
+{
+#ifdef STATISTICS_PROFILING
+	clear();
+	profiling = (enabled != 0);
+#endif
+}
+int GetProfiling(void)
+{
+#ifdef STATISTICS_PROFILING
+	return profiling;
+#else
+	return 0;
+#endif
+}
+void GetProfile(Profile* p)
+{
+	memset(p, 0, sizeof(Profile));
+	p->Cycles = p->CacheMisses = -1;
+
+#ifdef STATISTICS_PROFILING
+	p->Kernel = kernel;
+	p->Calls = calls;
+	p->WallTime = wall;
+	p->Bytes = bytes;
+	p->Pairs = pairs;
+
+	for (int a = 0; a < PROFILETHREADS; a++)
+	{
+		for (int b = 0; b < NumPhases; b++)
+		{
+			p->PhaseTime[b] += times[a][b];
+			p->BusyTime[a] += times[a][b];
+		}
+		if (p->BusyTime[a] > 0) { p->NumThreads = a + 1; }
+	}
+
+	if (reset)
+	{
+		p->Cycles = counterread(0);
+		p->CacheMisses = counterread(1);
+	}
+#endif
+}
+const char* phasename(Phase phase)
+{
+	return (phase >= PlanPhase && phase < NumPhases) ? names[phase] : "Unknown";
+}
+ErrorCode WriteProfile(const Profile* p, const char* path)
+{
+	FILE* file = path ? fopen(path, "a") : stdout;
+	if (!file) { return FileError; }
+
+	if (p->Kernel)	{ fprintf(file, "{\"Kernel\":\"%s\"", p->Kernel); }
+	else			{ fprintf(file, "{\"Kernel\":null"); }
+	fprintf(file, ",\"Calls\":%llu,\"WallTime\":%.9g,\"Phases\":{", (unsigned long long)p->Calls, p->WallTime);
+	for (int a = 0; a < NumPhases; a++)
+		fprintf(file, "%s\"%s\":%.9g", a ? "," : "", names[a], p->PhaseTime[a]);
+
+	fprintf(file, "},\"BusyTime\":[");
+	for (int a = 0; a < p->NumThreads; a++)
+		fprintf(file, "%s%.9g", a ? "," : "", p->BusyTime[a]);
+
+	fprintf(file, "],\"Bytes\":%llu,\"Pairs\":%llu", (unsigned long long)p->Bytes, (unsigned long long)p->Pairs);
+	if (p->Cycles >= 0)			{ fprintf(file, ",\"Cycles\":%lld", (long long)p->Cycles); }
+	else						{ fprintf(file, ",\"Cycles\":null"); }
+	if (p->CacheMisses >= 0)	{ fprintf(file, ",\"CacheMisses\":%lld}\n", (long long)p->CacheMisses); }
+	else						{ fprintf(file, ",\"CacheMisses\":null}\n"); }
+
+	int failed = ferror(file);
+	if (path) { failed |= (fclose(file) != 0); }
+	else { fflush(file); }
+	return failed ? FileError : Success;
+}
@@ -0,0 +1,95 @@
+/* PROFILE - Phase timers & counters that instrument the native statistics kernels (see SetProfiling in Statistics.h).
+ *
+ *	Kernels bracket each phase of their work with phasestart & phaseend, and report what they processed through
+ *	profilecount. Public entry points bracket the whole call with kernelbegin & kernelend. While profiling is off, each of
+ *	these only tests one flag. When the library is built without STATISTICS_PROFILING, they are all empty and compile away.
+ */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#pragma once
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "Statistics.h"
+
+
+
+/* FUNCTIONS */
+#ifdef STATISTICS_PROFILING
+/// <summary>
+/// Whether profiling is turned on. Only SetProfiling writes this.
+/// </summary>
+extern int profiling;
+
+/// <summary>
+/// Gets the time in seconds since an arbitrary fixed point, starting the calling thread's hardware counters if they
+/// haven't been started yet.
+/// </summary>
+double		profilestart(void);
+/// <summary>
+/// Adds the time since a phase started to the calling thread's total for that phase.
+/// </summary>
+void		profilephase(Phase phase, double start);
+/// <summary>
+/// Adds bytes moved & signal pairings processed to the profile.
+/// </summary>
+void		profileadd(size_t bytes, size_t pairs);
+/// <summary>
+/// Starts timing a kernel call. Calls made from inside other kernels or from inside parallel regions are not counted.
+/// </summary>
+void		profileenter(const char* kernel);
+/// <summary>
+/// Stops timing the kernel call that the matching profileenter started.
+/// </summary>
+void		profileleave(void);
+
+/// <summary>
+/// Marks the start of a phase on the calling thread.
+/// </summary>
+/// <returns>The time at which the phase started, which must be handed to phaseend.</returns>
+static inline double phasestart(void)
+{
+	return profiling ? profilestart() : 0;
+}
+/// <summary>
+/// Marks the end of a phase on the calling thread.
+/// </summary>
+static inline void phaseend(Phase phase, double start)
+{
+	if (profiling) { profilephase(phase, start); }
+}
+/// <summary>
+/// Records the bytes that a kernel has to read & write, along with the number of signal pairings it processes.
+/// </summary>
+static inline void profilecount(size_t bytes, size_t pairs)
+{
+	if (profiling) { profileadd(bytes, pairs); }
+}
+/// <summary>
+/// Marks the start of a call to a public kernel.
+/// </summary>
+static inline void kernelbegin(const char* kernel)
+{
+	if (profiling) { profileenter(kernel); }
+}
+/// <summary>
+/// Marks the end of a call to a public kernel.
+/// </summary>
+static inline void kernelend(void)
+{
+	if (profiling) { profileleave(); }
+}
+#else
+static inline double phasestart(void)							{ return 0; }
+static inline void phaseend(Phase phase, double start)			{ }
+static inline void profilecount(size_t bytes, size_t pairs)		{ }
+static inline void kernelbegin(const char* kernel)				{ }
+static inline void kernelend(void)								{ }
+#endif
+
+
+
+#endif
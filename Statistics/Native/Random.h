@@ -0,0 +1,97 @@
+/* RANDOM - Reproducible, independent pseudorandom number streams for the native statistics kernels.
+ *
+ *	Kernels that need random numbers (e.g. to generate surrogate data) give every unit of work its own stream instead of
+ *	sharing one generator between threads. A stream is fully determined by a seed and a stream index, so results are the
+ *	same no matter how many threads are used or how the work happens to be scheduled. Streams use the xoshiro256**
+ *	generator, whose state is initialized from the seed and index by the SplitMix64 generator as its authors recommend.
+ */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#pragma once
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <stdint.h>
+
+
+
+/* DATA */
+/// <summary>
+/// The state of one pseudorandom number stream.
+/// </summary>
+typedef struct
+{
+	uint64_t	State[4];
+}Random;
+
+
+
+/* FUNCTIONS */
+/// <summary>
+/// Advances a SplitMix64 generator and returns its next output.
+/// </summary>
+static inline uint64_t splitmix64(uint64_t* x)
+{
+	uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+/// <summary>
+/// Initializes a pseudorandom number stream.
+/// </summary>
+/// <param name="rng">The stream to initialize.</param>
+/// <param name="seed">The seed shared by every stream of a single computation.</param>
+/// <param name="stream">The index of the stream (e.g. the index of a surrogate data set).</param>
+static inline void rngseed(Random* rng, uint64_t seed, uint64_t stream)
+{
+	uint64_t x = seed ^ splitmix64(&stream);
+	for (int a = 0; a < 4; a++)
+		rng->State[a] = splitmix64(&x);
+}
+/// <summary>
+/// Gets the next 64 random bits from a stream.
+/// </summary>
+static inline uint64_t rngnext(Random* rng)
+{
+	uint64_t* s = rng->State;
+	uint64_t x = s[1] * 5;
+	uint64_t result = ((x << 7) | (x >> 57)) * 9;
+	uint64_t t = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = (s[3] << 45) | (s[3] >> 19);
+
+	return result;
+}
+/// <summary>
+/// Gets a uniformly distributed random number in the range [0, 1).
+/// </summary>
+static inline double rnguniform(Random* rng)
+{
+	return (double)(rngnext(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+/// <summary>
+/// Gets a uniformly distributed random integer in the range [0, n).
+/// </summary>
+/// <remarks>
+/// Values that would make some results more likely than others are rejected, so the result is exactly uniform.
+/// </remarks>
+static inline uint64_t rngbelow(Random* rng, uint64_t n)
+{
+	uint64_t limit = UINT64_MAX - (UINT64_MAX % n);
+	uint64_t x;
+	do { x = rngnext(rng); } while (x >= limit);
+	return x % n;
+}
+
+
+
+#endif
@@ -0,0 +1,187 @@
+/* SIMD - Explicitly vectorized kernels for single precision signals. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#include "Simd.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+	#define SIMD_X86
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+		#define TARGET(isa)
+	#else
+		#define TARGET(isa)	__attribute__((target(isa)))
+	#endif
+#endif
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Accumulates the correlation sums for samples [first, nsamples) one at a time.
+/// </summary>
+static void momentstail(double s[5], const float x[], const float y[], int first, int nsamples)
+{
+	for (int a = first; a < nsamples; a++)
+	{
+		double u = x[a];
+		double v = y[a];
+		s[0] += u;
+		s[1] += v;
+		s[2] += u * v;
+		s[3] += u * u;
+		s[4] += v * v;
+	}
+}
+
+#ifdef SIMD_X86
+/// <summary>
+/// Sums the four lanes of an AVX register.
+/// </summary>
+TARGET("avx2,fma") static double hsum256(__m256d v)
+{
+	__m128d lo = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+	return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+/// <summary>
+/// Computes the correlation sums eight samples at a time using AVX2 and FMA instructions.
+/// </summary>
+TARGET("avx2,fma") static void moments256(double s[5], const float x[], const float y[], int nsamples)
+{
+	__m256d sx0 = _mm256_setzero_pd(), sy0 = _mm256_setzero_pd(), sxy0 = _mm256_setzero_pd();
+	__m256d ssx0 = _mm256_setzero_pd(), ssy0 = _mm256_setzero_pd();
+	__m256d sx1 = sx0, sy1 = sx0, sxy1 = sx0, ssx1 = sx0, ssy1 = sx0;
+
+	int a = 0;
+	for (; a + 8 <= nsamples; a += 8)
+	{
+		__m256 xf = _mm256_loadu_ps(x + a);
+		__m256 yf = _mm256_loadu_ps(y + a);
+		__m256d x0 = _mm256_cvtps_pd(_mm256_castps256_ps128(xf));
+		__m256d x1 = _mm256_cvtps_pd(_mm256_extractf128_ps(xf, 1));
+		__m256d y0 = _mm256_cvtps_pd(_mm256_castps256_ps128(yf));
+		__m256d y1 = _mm256_cvtps_pd(_mm256_extractf128_ps(yf, 1));
+
+		sx0 = _mm256_add_pd(sx0, x0);			sx1 = _mm256_add_pd(sx1, x1);
+		sy0 = _mm256_add_pd(sy0, y0);			sy1 = _mm256_add_pd(sy1, y1);
+		sxy0 = _mm256_fmadd_pd(x0, y0, sxy0);	sxy1 = _mm256_fmadd_pd(x1, y1, sxy1);
+		ssx0 = _mm256_fmadd_pd(x0, x0, ssx0);	ssx1 = _mm256_fmadd_pd(x1, x1, ssx1);
+		ssy0 = _mm256_fmadd_pd(y0, y0, ssy0);	ssy1 = _mm256_fmadd_pd(y1, y1, ssy1);
+	}
+
+	s[0] = hsum256(_mm256_add_pd(sx0, sx1));
+	s[1] = hsum256(_mm256_add_pd(sy0, sy1));
+	s[2] = hsum256(_mm256_add_pd(sxy0, sxy1));
+	s[3] = hsum256(_mm256_add_pd(ssx0, ssx1));
+	s[4] = hsum256(_mm256_add_pd(ssy0, ssy1));
+	momentstail(s, x, y, a, nsamples);
+}
+/// <summary>
+/// Computes the correlation sums sixteen samples at a time using AVX-512 instructions.
+/// </summary>
+TARGET("avx512f") static void moments512(double s[5], const float x[], const float y[], int nsamples)
+{
+	__m512d sx0 = _mm512_setzero_pd(), sy0 = _mm512_setzero_pd(), sxy0 = _mm512_setzero_pd();
+	__m512d ssx0 = _mm512_setzero_pd(), ssy0 = _mm512_setzero_pd();
+	__m512d sx1 = sx0, sy1 = sx0, sxy1 = sx0, ssx1 = sx0, ssy1 = sx0;
+
+	int a = 0;
+	for (; a + 16 <= nsamples; a += 16)
+	{
+		__m512d x0 = _mm512_cvtps_pd(_mm256_loadu_ps(x + a));
+		__m512d x1 = _mm512_cvtps_pd(_mm256_loadu_ps(x + a + 8));
+		__m512d y0 = _mm512_cvtps_pd(_mm256_loadu_ps(y + a));
+		__m512d y1 = _mm512_cvtps_pd(_mm256_loadu_ps(y + a + 8));
+
+		sx0 = _mm512_add_pd(sx0, x0);			sx1 = _mm512_add_pd(sx1, x1);
+		sy0 = _mm512_add_pd(sy0, y0);			sy1 = _mm512_add_pd(sy1, y1);
+		sxy0 = _mm512_fmadd_pd(x0, y0, sxy0);	sxy1 = _mm512_fmadd_pd(x1, y1, sxy1);
+		ssx0 = _mm512_fmadd_pd(x0, x0, ssx0);	ssx1 = _mm512_fmadd_pd(x1, x1, ssx1);
+		ssy0 = _mm512_fmadd_pd(y0, y0, ssy0);	ssy1 = _mm512_fmadd_pd(y1, y1, ssy1);
+	}
+
+	s[0] = _mm512_reduce_add_pd(_mm512_add_pd(sx0, sx1));
+	s[1] = _mm512_reduce_add_pd(_mm512_add_pd(sy0, sy1));
+	s[2] = _mm512_reduce_add_pd(_mm512_add_pd(sxy0, sxy1));
+	s[3] = _mm512_reduce_add_pd(_mm512_add_pd(ssx0, ssx1));
+	s[4] = _mm512_reduce_add_pd(_mm512_add_pd(ssy0, ssy1));
+	momentstail(s, x, y, a, nsamples);
+}
+/// <summary>
+/// Queries the processor for the instruction sets that it and the operating system support.
+/// </summary>
+static SimdLevel detect(void)
+{
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) { return Portable; }
+
+	// AVX registers are only usable if the operating system saves them on context switches
+	__cpuid(info, 1);
+	int fma = (info[2] >> 12) & 1;
+	int osxsave = (info[2] >> 27) & 1;
+	if (!osxsave) { return Portable; }
+	unsigned long long xcr0 = _xgetbv(0);
+
+	__cpuidex(info, 7, 0);
+	int avx2 = (info[1] >> 5) & 1;
+	int avx512 = (info[1] >> 16) & 1;
+
+	if (avx512 && (xcr0 & 0xE6) == 0xE6) { return AVX512; }
+	if (avx2 && fma && (xcr0 & 0x6) == 0x6) { return AVX2; }
+	return Portable;
+#else
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f")) { return AVX512; }
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) { return AVX2; }
+	return Portable;
+#endif
+}
+#endif
+
+
+
+/* FUNCTIONS */
+SimdLevel simdlevel(void)
+{
+#ifdef SIMD_X86
+	// Every thread computes the same answer, so racing to store it is harmless
+	static volatile int level = -1;
+	if (level < 0) { level = (int)detect(); }
+	return (SimdLevel)level;
+#else
+	return Portable;
+#endif
+}
+
+void moments(double s[5], const float x[], const float y[], int nsamples)
+{
+#ifdef SIMD_X86
+	switch (simdlevel())
+	{
+		case AVX512:	moments512(s, x, y, nsamples); return;
+		case AVX2:		moments256(s, x, y, nsamples); return;
+		default:		break;
+	}
+#endif
+	s[0] = s[1] = s[2] = s[3] = s[4] = 0;
+	momentstail(s, x, y, 0, nsamples);
+}
+
+void widen(double z[], const float x[], size_t n)
+{
+	#pragma omp simd
+	for (size_t a = 0; a < n; a++)
+		z[a] = (double)x[a];
+}
+
+void narrow(float z[], const double x[], size_t n)
+{
+	#pragma omp simd
+	for (size_t a = 0; a < n; a++)
+		z[a] = (float)x[a];
+}
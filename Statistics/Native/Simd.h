@@ -0,0 +1,61 @@
+/* SIMD - Explicitly vectorized kernels for single precision signals.
+ *
+ *	Single precision data halves the memory traffic of the bandwidth-bound loops in the correlation kernels, but summing
+ *	thousands of products in single precision loses too much accuracy. The kernels here load single precision samples and
+ *	widen them to double precision before accumulating anything. On x86 processors, AVX2 and AVX-512 versions are compiled
+ *	alongside a portable version and the best one that the processor supports is chosen at run time, so the library does
+ *	not have to be built for a particular instruction set.
+ */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#pragma once
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <stddef.h>
+
+
+
+/* DATA */
+/// <summary>
+/// The instruction sets that the vectorized kernels can use.
+/// </summary>
+typedef enum
+{
+	Portable = 0,
+	AVX2,
+	AVX512,
+}SimdLevel;
+
+
+
+/* FUNCTIONS */
+/// <summary>
+/// Gets the widest instruction set that both the library and the processor support.
+/// </summary>
+SimdLevel	simdlevel(void);
+
+/// <summary>
+/// Computes the sums that the raw-sum correlation formula needs for two single precision signals.
+/// </summary>
+/// <param name="s">An output vector that receives sum(x), sum(y), sum(x .* y), sum(x .^ 2) and sum(y .^ 2).</param>
+/// <param name="x">A signal vector.</param>
+/// <param name="y">A second signal vector of the same length as x.</param>
+/// <param name="nsamples">The number of sample points in x and y.</param>
+void		moments(double s[5], const float x[], const float y[], int nsamples);
+
+/// <summary>
+/// Converts single precision samples to double precision.
+/// </summary>
+void		widen(double z[], const float x[], size_t n);
+/// <summary>
+/// Converts double precision values to single precision.
+/// </summary>
+void		narrow(float z[], const double x[], size_t n);
+
+
+
+#endif
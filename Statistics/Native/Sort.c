@@ -0,0 +1,205 @@
+/* SORT - Sorting and selection of double precision values for the native statistics kernels. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Replaced the chunked merge sort with a parallel LSD radix sort.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Parallel.h"
+#include "Sort.h"
+
+
+
+/* CONSTANTS */
+#define RADIXSORT		(1 << 12)		// The smallest vector that gets radix sorted. Anything shorter is quicker to qsort.
+#define RADIXBITS		11				// The number of key bits that each radix sorting pass orders by.
+#define RADIXBINS		(1 << RADIXBITS)
+#define NUMDIGITS		((64 + RADIXBITS - 1) / RADIXBITS)
+#define MAXCHUNKS		64				// The largest number of chunks that radix sorting passes are split into.
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Orders doubles ascending for qsort.
+/// </summary>
+static int ascending(const void* a, const void* b)
+{
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+/// <summary>
+/// Maps a double onto an unsigned integer whose ordering is the same as the ordering of the double.
+/// </summary>
+/// <remarks>
+/// Positive values only need their sign bit set. Negative values have all of their bits flipped, which reverses their
+/// order and puts them below every positive value.
+/// </remarks>
+static inline uint64_t sortkey(double x)
+{
+	uint64_t u;
+	memcpy(&u, &x, sizeof(u));
+	return (u >> 63) ? ~u : u | ((uint64_t)1 << 63);
+}
+static inline int digit(double x, int d)
+{
+	return (int)((sortkey(x) >> (d * RADIXBITS)) & (RADIXBINS - 1));
+}
+static void swap(double x[], size_t a, size_t b)
+{
+	double t = x[a];
+	x[a] = x[b];
+	x[b] = t;
+}
+
+
+
+/* FUNCTIONS */
+double* radixsort(double x[], double tmp[], size_t n)
+{
+	int nchunks = maxthreads();
+	nchunks = (nchunks > MAXCHUNKS) ? MAXCHUNKS : nchunks;
+
+	size_t bounds[MAXCHUNKS + 1];
+	for (int a = 0; a <= nchunks; a++)
+		bounds[a] = (n * (size_t)a) / (size_t)nchunks;
+
+	// Counts of each digit in each chunk, which turn into the position that each chunk writes its next value with a digit to
+	size_t* counts = (size_t*)calloc((size_t)nchunks * NUMDIGITS * RADIXBINS, sizeof(size_t));
+	if (!counts)
+	{
+		qsort(x, n, sizeof(double), ascending);
+		return x;
+	}
+
+	// Every digit is counted up front so that passes over digits that all values share can be skipped entirely
+	#pragma omp parallel for schedule(static, 1)
+	for (int a = 0; a < nchunks; a++)
+	{
+		size_t* ca = counts + (size_t)a * NUMDIGITS * RADIXBINS;
+		for (size_t b = bounds[a]; b < bounds[a + 1]; b++)
+		{
+			uint64_t key = sortkey(x[b]);
+			for (int d = 0; d < NUMDIGITS; d++)
+				ca[d * RADIXBINS + ((key >> (d * RADIXBITS)) & (RADIXBINS - 1))]++;
+		}
+	}
+
+	double* src = x;
+	double* dst = tmp;
+	int moved = 0;
+	for (int d = 0; d < NUMDIGITS; d++)
+	{
+		int trivial = 0;
+		for (int b = 0; b < RADIXBINS && !trivial; b++)
+		{
+			size_t total = 0;
+			for (int a = 0; a < nchunks; a++)
+				total += counts[((size_t)a * NUMDIGITS + d) * RADIXBINS + b];
+			trivial = (total == n);
+		}
+		if (trivial) { continue; }
+
+		// Once values have moved between chunks, each chunk has to count this digit again
+		if (moved && nchunks > 1)
+		{
+			#pragma omp parallel for schedule(static, 1)
+			for (int a = 0; a < nchunks; a++)
+			{
+				size_t* ca = counts + ((size_t)a * NUMDIGITS + d) * RADIXBINS;
+				memset(ca, 0, RADIXBINS * sizeof(size_t));
+				for (size_t b = bounds[a]; b < bounds[a + 1]; b++)
+					ca[digit(src[b], d)]++;
+			}
+		}
+
+		// Chunks write each digit in order, so the sort stays stable & every pass builds on the ones before it
+		size_t offset = 0;
+		for (int b = 0; b < RADIXBINS; b++)
+		{
+			for (int a = 0; a < nchunks; a++)
+			{
+				size_t* cab = counts + ((size_t)a * NUMDIGITS + d) * RADIXBINS + b;
+				size_t c = *cab;
+				*cab = offset;
+				offset += c;
+			}
+		}
+
+		#pragma omp parallel for schedule(static, 1)
+		for (int a = 0; a < nchunks; a++)
+		{
+			size_t* ca = counts + ((size_t)a * NUMDIGITS + d) * RADIXBINS;
+			for (size_t b = bounds[a]; b < bounds[a + 1]; b++)
+				dst[ca[digit(src[b], d)]++] = src[b];
+		}
+
+		double* t = src;
+		src = dst;
+		dst = t;
+		moved = 1;
+	}
+
+	free(counts);
+	return src;
+}
+
+void sortdoubles(double x[], size_t n)
+{
+	double* tmp = (n >= RADIXSORT) ? (double*)malloc(n * sizeof(double)) : NULL;
+	if (!tmp)
+	{
+		qsort(x, n, sizeof(double), ascending);
+		return;
+	}
+
+	double* sorted = radixsort(x, tmp, n);
+	if (sorted != x)
+		memcpy(x, sorted, n * sizeof(double));
+	free(tmp);
+}
+
+double nthelement(double x[], size_t n, size_t k)
+{
+	size_t lo = 0;
+	size_t hi = n - 1;
+
+	// Quickselect degrades on adversarial inputs, so give up & sort the remaining range after too many rounds
+	int budget = 64;
+	while (hi > lo)
+	{
+		if (budget-- == 0)
+		{
+			qsort(x + lo, hi - lo + 1, sizeof(double), ascending);
+			break;
+		}
+
+		// Median-of-three pivot, which also leaves sentinels at both ends of the range
+		size_t mid = lo + (hi - lo) / 2;
+		if (x[mid] < x[lo]) { swap(x, mid, lo); }
+		if (x[hi] < x[lo]) { swap(x, hi, lo); }
+		if (x[hi] < x[mid]) { swap(x, hi, mid); }
+		double pivot = x[mid];
+
+		size_t a = lo, b = hi;
+		for (;;)
+		{
+			do { a++; } while (x[a] < pivot);
+			do { b--; } while (pivot < x[b]);
+			if (a >= b) { break; }
+			swap(x, a, b);
+		}
+
+		// Every element in [lo, b] is now no greater than the pivot & every element in [b + 1, hi] is no smaller
+		if (k <= b)
+			hi = b;
+		else
+			lo = b + 1;
+	}
+
+	return x[k];
+}
@@ -0,0 +1,56 @@
+/* SORT - Sorting and selection of double precision values for the native statistics kernels.
+ *
+ *	Many significance tests only need a handful of order statistics (e.g. the values at two quantiles of a null
+ *	distribution), which selection finds in linear time. Sorting is reserved for the places that genuinely need every
+ *	value in order, and is parallelized there.
+ */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Added radix sorting, which sortdoubles now uses for all but short vectors.
+ */
+
+#pragma once
+#ifndef SORT_H
+#define SORT_H
+
+#include <stddef.h>
+
+
+
+/* FUNCTIONS */
+/// <summary>
+/// Sorts a vector of values into ascending order using a parallel least significant digit radix sort.
+/// </summary>
+/// <remarks>
+/// Each pass orders values by 11 bits of their bit patterns, and passes over bits that every value shares are skipped.
+/// Values ping-pong between x and tmp, so the sorted result can end up in either one. Vectors must not contain NaNs.
+/// </remarks>
+/// <param name="x">A vector of n values.</param>
+/// <param name="tmp">A scratch vector of n elements.</param>
+/// <param name="n">The number of elements in x.</param>
+/// <returns>Whichever of x or tmp holds the sorted values.</returns>
+double*		radixsort(double x[], double tmp[], size_t n);
+/// <summary>
+/// Sorts a vector of values into ascending order, using multiple threads for large vectors.
+/// </summary>
+/// <remarks>
+/// Vectors must not contain NaNs.
+/// </remarks>
+void		sortdoubles(double x[], size_t n);
+/// <summary>
+/// Finds the value that would be at a given index if a vector were sorted into ascending order.
+/// </summary>
+/// <remarks>
+/// This partially reorders x in place, so that x[k] holds the selected value, every element before it is no greater and
+/// every element after it is no smaller. The expected run time is linear in n. Vectors must not contain NaNs.
+/// </remarks>
+/// <param name="x">A vector of n values.</param>
+/// <param name="n">The number of elements in x. This must be at least one.</param>
+/// <param name="k">The zero-based index of the order statistic to select. This must be less than n.</param>
+/// <returns>The k-th smallest value in x.</returns>
+double		nthelement(double x[], size_t n, size_t k);
+
+
+
+#endif
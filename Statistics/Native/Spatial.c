@@ -0,0 +1,208 @@
+/* SPATIAL - Spatial correlation between the frames of imaging data series. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Replaces calling corr3 once for every pair of frames, which converted & centered both volumes every time.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Arena.h"
+#include "Matrix.h"
+#include "Parallel.h"
+#include "Statistics.h"
+
+
+
+/* CONSTANTS */
+#define CHUNK			4096		// The number of voxels whose validity is checked at once.
+#define STRIP			32			// The number of columns of the Gram matrix that make up one task.
+#define MINBLOCK		256			// The fewest voxels that are widened into a block at once.
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Gets a pointer to the first voxel of one frame in a series.
+/// </summary>
+static inline const void* frame(FrameArray x, int idx)
+{
+	return (const char*)x.Data + (size_t)idx * x.NumVoxels * elementsize(x.Class);
+}
+/// <summary>
+/// Reads one voxel of a frame as a double.
+/// </summary>
+static inline double voxel(const void* data, Precision class, size_t idx)
+{
+	switch (class)
+	{
+		case DoublePrecision:	return ((const double*)data)[idx];
+		case SinglePrecision:	return ((const float*)data)[idx];
+		case Int8Precision:		return ((const int8_t*)data)[idx];
+		case UInt8Precision:	return ((const uint8_t*)data)[idx];
+		case Int16Precision:	return ((const int16_t*)data)[idx];
+		case UInt16Precision:	return ((const uint16_t*)data)[idx];
+		case Int32Precision:	return ((const int32_t*)data)[idx];
+		default:				return ((const uint32_t*)data)[idx];
+	}
+}
+/// <summary>
+/// Excludes the voxels in a range that are not finite in some frame of a floating point series.
+/// </summary>
+static void invalidate(uint8_t valid[], FrameArray x, size_t first, size_t count)
+{
+	if (x.Class != DoublePrecision && x.Class != SinglePrecision) { return; }
+	for (int a = 0; a < x.NumFrames; a++)
+	{
+		const void* data = frame(x, a);
+		for (size_t b = first; b < first + count; b++)
+		{
+			if (!isfinite(voxel(data, x.Class, b)))
+				valid[b] = 0;
+		}
+	}
+}
+/// <summary>
+/// Sums the included voxels of one frame.
+/// </summary>
+static double framesum(const void* data, Precision class, const size_t idx[], size_t count)
+{
+	double sum = 0;
+	for (size_t a = 0; a < count; a++)
+		sum += voxel(data, class, idx[a]);
+	return sum;
+}
+/// <summary>
+/// Widens & centers a block of included voxels from one frame into double precision.
+/// </summary>
+/// <returns>The sum of the squares of the centered values.</returns>
+static double gather(double z[], const void* data, Precision class, const size_t idx[], int count, double mean)
+{
+	double ss = 0;
+	for (int a = 0; a < count; a++)
+	{
+		z[a] = voxel(data, class, idx[a]) - mean;
+		ss += z[a] * z[a];
+	}
+	return ss;
+}
+
+
+
+/* FUNCTIONS */
+ErrorCode FrameCorrelate(double r[], FrameArray x, FrameArray y, const uint8_t mask[])
+{
+	if (x.NumVoxels == 0 || x.NumFrames == 0 || y.NumFrames == 0)	{ return EmptyInput; }
+	if (x.NumVoxels != y.NumVoxels)									{ return SizeMismatch; }
+	if (x.Class < DoublePrecision || x.Class > UInt32Precision)		{ return InvalidArgument; }
+	if (y.Class < DoublePrecision || y.Class > UInt32Precision)		{ return InvalidArgument; }
+
+	size_t nvox = x.NumVoxels;
+	int ntx = x.NumFrames;
+	int nty = y.NumFrames;
+	int same = (x.Data == y.Data && x.Class == y.Class && ntx == nty);
+	int nframes = same ? ntx : ntx + nty;
+
+	// Blocks hold every frame, so they get shorter as series get longer
+	size_t nb = GetMemoryBudget() / 2 / ((size_t)nframes * sizeof(double));
+	nb = (nb / MINBLOCK) * MINBLOCK;
+	nb = (nb < MINBLOCK) ? MINBLOCK : nb;
+	nb = (nb > nvox) ? nvox : nb;
+
+	size_t szidx = aligned(nvox * sizeof(size_t));
+	size_t szvalid = aligned(nvox * sizeof(uint8_t));
+	size_t szstats = 2 * aligned((size_t)(ntx + nty) * sizeof(double));
+	size_t szblock = aligned(nb * nframes * sizeof(double));
+	Arena* arena = arenaacquire(szidx + szvalid + szstats + szblock);
+	if (!arena) { return OutOfMemory; }
+
+	size_t* idx = (size_t*)arenaalloc(arena, szidx);
+	uint8_t* valid = (uint8_t*)arenaalloc(arena, szvalid);
+	double* means = (double*)arenaalloc(arena, szstats / 2);
+	double* ss = (double*)arenaalloc(arena, szstats / 2);
+	double* block = (double*)arenaalloc(arena, szblock);
+
+	// Find the voxels that every coefficient includes
+	size_t nchunks = (nvox + CHUNK - 1) / CHUNK;
+	#pragma omp parallel for schedule(static)
+	for (ptrdiff_t a = 0; a < (ptrdiff_t)nchunks; a++)
+	{
+		size_t first = (size_t)a * CHUNK;
+		size_t count = (nvox - first < CHUNK) ? nvox - first : CHUNK;
+		for (size_t b = first; b < first + count; b++)
+			valid[b] = mask ? (mask[b] != 0) : 1;
+
+		invalidate(valid, x, first, count);
+		if (!same) { invalidate(valid, y, first, count); }
+	}
+
+	size_t nv = 0;
+	for (size_t a = 0; a < nvox; a++)
+	{
+		if (valid[a])
+			idx[nv++] = a;
+	}
+
+	// Frames of Y are numbered after the frames of X in the statistics & in each block
+	#pragma omp parallel for schedule(dynamic, 1)
+	for (int a = 0; a < nframes; a++)
+	{
+		FrameArray s = (a < ntx) ? x : y;
+		int t = (a < ntx) ? a : a - ntx;
+		means[a] = nv ? framesum(frame(s, t), s.Class, idx, nv) / nv : 0;
+		ss[a] = 0;
+	}
+
+	memset(r, 0, (size_t)ntx * nty * sizeof(double));
+	int nstrips = (nty + STRIP - 1) / STRIP;
+	const double* by = same ? block : block + (size_t)ntx * nb;
+	const double* ssy = same ? ss : ss + ntx;
+	ErrorCode status = Success;
+
+	for (size_t b0 = 0; b0 < nv && status == Success; b0 += nb)
+	{
+		int count = (int)((nv - b0 < nb) ? nv - b0 : nb);
+
+		#pragma omp parallel for schedule(dynamic, 1)
+		for (int a = 0; a < nframes; a++)
+		{
+			FrameArray s = (a < ntx) ? x : y;
+			int t = (a < ntx) ? a : a - ntx;
+			ss[a] += gather(block + (size_t)a * nb, frame(s, t), s.Class, idx + b0, count, means[a]);
+		}
+
+		// Each strip of columns is written by a single thread. Only the upper triangle is needed for a symmetric result.
+		#pragma omp parallel for schedule(dynamic, 1)
+		for (int a = 0; a < nstrips; a++)
+		{
+			int j0 = a * STRIP;
+			int ncols = (nty - j0 < STRIP) ? nty - j0 : STRIP;
+			int nrows = same ? j0 + ncols : ntx;
+			ErrorCode bstatus = gemmtnadd(nrows, ncols, count, block, (int)nb, by + (size_t)j0 * nb, (int)nb, r + (size_t)j0 * ntx, ntx);
+			if (bstatus != Success)
+			{
+				#pragma omp atomic write
+				status = bstatus;
+			}
+		}
+	}
+
+	if (status == Success)
+	{
+		#pragma omp parallel for schedule(static)
+		for (int a = 0; a < nty; a++)
+		{
+			int nrows = same ? a + 1 : ntx;
+			for (int b = 0; b < nrows; b++)
+				r[b + (size_t)a * ntx] /= sqrt(ss[b] * ssy[a]);
+		}
+
+		for (int a = 0; same && a < ntx; a++)
+			for (int b = 0; b < a; b++)
+				r[a + (size_t)b * ntx] = r[b + (size_t)a * ntx];
+	}
+
+	arenarelease(arena);
+	return status;
+}
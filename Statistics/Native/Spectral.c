@@ -0,0 +1,319 @@
+/* SPECTRAL - Welch power spectra and magnitude-squared coherence for many signals at once. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Replaces the per-channel pwelch and mscohere calls made by spectralObj and cohObj. Windows and transform plans
+ *					are built once per call, and the segment spectra of signals that take part in many pairs are only computed once.
+ *		20261017:	Transform plans now come from the plan cache, so repeated calls of the same length skip building them.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Arena.h"
+#include "FFT.h"
+#include "Parallel.h"
+#include "Statistics.h"
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Checks that a Welch description is usable with signals of a given length.
+/// </summary>
+static ErrorCode welchcheck(const Welch* w, int nsamples)
+{
+	if (!w || !w->Window || w->WindowLength <= 0)				{ return InvalidArgument; }
+	if (w->Overlap < 0 || w->Overlap >= w->WindowLength)		{ return InvalidArgument; }
+	if (w->NFFT < 2 || nextpow2(w->NFFT) != w->NFFT)			{ return InvalidArgument; }
+	if (!(w->SamplingRate > 0))									{ return InvalidArgument; }
+	if (w->Scale < PowerSpectralDensity || w->Scale > PowerSpectrum)	{ return InvalidArgument; }
+	if (WelchSegments(w, nsamples) == 0)						{ return SizeMismatch; }
+	return Success;
+}
+/// <summary>
+/// Gets the index of the signal in X that a pair uses. Without a list of pairs, every signal in X pairs with every one in Y.
+/// </summary>
+static inline int pairx(const int pairs[], int idx, int ncx)
+{
+	return pairs ? pairs[2 * idx] : idx % ncx;
+}
+/// <summary>
+/// Gets the index of the signal in Y that a pair uses.
+/// </summary>
+static inline int pairy(const int pairs[], int idx, int ncx)
+{
+	return pairs ? pairs[2 * idx + 1] : idx / ncx;
+}
+/// <summary>
+/// Windows one segment of a signal into a transform buffer.
+/// </summary>
+/// <remarks>
+/// Windows longer than the transform are wrapped around (i.e. summed modulo NFFT), which is what pwelch & mscohere do.
+/// </remarks>
+/// <returns>The number of samples in the buffer, beyond which the transform treats the segment as zero-padded.</returns>
+static int segment(double buffer[], const double x[], const Welch* w, int idx)
+{
+	const double* xs = x + (size_t)idx * (w->WindowLength - w->Overlap);
+	if (w->WindowLength <= w->NFFT)
+	{
+		for (int a = 0; a < w->WindowLength; a++)
+			buffer[a] = xs[a] * w->Window[a];
+		return w->WindowLength;
+	}
+
+	memset(buffer, 0, (size_t)w->NFFT * sizeof(double));
+	for (int a = 0; a < w->WindowLength; a++)
+		buffer[a % w->NFFT] += xs[a] * w->Window[a];
+	return w->NFFT;
+}
+/// <summary>
+/// Accumulates the squared magnitudes of the segment spectra of a signal.
+/// </summary>
+/// <param name="P">An output vector of NF elements that receives the sum of the periodograms of every segment.</param>
+/// <param name="S">A buffer of NF elements that receives segment spectra.</param>
+/// <param name="buffer">A buffer of NFFT elements that receives windowed segments.</param>
+static void autospectrum(double P[], const double x[], const Welch* w, int nsegments, const FFTPlan* plan, Complex S[], double buffer[])
+{
+	int nbins = w->NFFT / 2 + 1;
+	memset(P, 0, (size_t)nbins * sizeof(double));
+	for (int a = 0; a < nsegments; a++)
+	{
+		rfft(plan, S, buffer, segment(buffer, x, w, a));
+		for (int b = 0; b < nbins; b++)
+			P[b] += S[b].re * S[b].re + S[b].im * S[b].im;
+	}
+}
+
+
+
+/* FUNCTIONS */
+int WelchSegments(const Welch* w, int nsamples)
+{
+	if (nsamples < w->WindowLength || w->WindowLength <= w->Overlap) { return 0; }
+	return (nsamples - w->Overlap) / (w->WindowLength - w->Overlap);
+}
+
+ErrorCode WelchSpectra(double psd[], SignalArray x, const Welch* w)
+{
+	if (x.NumSamples == 0 || x.NumSignals == 0) { return EmptyInput; }
+	ErrorCode status = welchcheck(w, x.NumSamples);
+	if (status != Success) { return status; }
+
+	int nfft = w->NFFT;
+	int nbins = nfft / 2 + 1;
+	int nsegments = WelchSegments(w, x.NumSamples);
+
+	// Density scaling divides by the window's energy & the sampling rate, and power scaling by the window's squared sum
+	double sum = 0, energy = 0;
+	for (int a = 0; a < w->WindowLength; a++)
+	{
+		sum += w->Window[a];
+		energy += w->Window[a] * w->Window[a];
+	}
+	double scale = (w->Scale == PowerSpectralDensity) ? 1.0 / (energy * w->SamplingRate) : 1.0 / (sum * sum);
+	scale /= nsegments;
+
+	size_t szspec = aligned((size_t)nbins * sizeof(Complex));
+	size_t szthread = szspec + aligned((size_t)nfft * sizeof(double));
+	Arena* arena = arenaacquire(maxthreads() * szthread);
+	FFTPlan* plan = fftacquire(nfft);
+	if (!arena || !plan)
+	{
+		arenarelease(arena);
+		fftrelease(plan);
+		return OutOfMemory;
+	}
+	char* buffers = (char*)arenaalloc(arena, maxthreads() * szthread);
+
+	#pragma omp parallel for schedule(dynamic, 1)
+	for (int a = 0; a < x.NumSignals; a++)
+	{
+		char* workspace = buffers + threadid() * szthread;
+		double* P = psd + (size_t)a * nbins;
+		autospectrum(P, column(x, a), w, nsegments, plan, (Complex*)workspace, (double*)(workspace + szspec));
+
+		// Power at every frequency except DC & Nyquist is folded in from the negative half of the spectrum
+		for (int b = 0; b < nbins; b++)
+			P[b] *= (b == 0 || b == nbins - 1) ? scale : 2.0 * scale;
+	}
+
+	fftrelease(plan);
+	arenarelease(arena);
+	return Success;
+}
+
+ErrorCode Coherence(double coh[], SignalArray x, SignalArray y, const int pairs[], int npairs, const Welch* w)
+{
+	if (x.NumSamples == 0 || x.NumSignals == 0 || y.NumSignals == 0)	{ return EmptyInput; }
+	if (x.NumSamples != y.NumSamples)								{ return SizeMismatch; }
+	if (pairs && npairs <= 0)										{ return EmptyInput; }
+	ErrorCode status = welchcheck(w, x.NumSamples);
+	if (status != Success) { return status; }
+
+	int ncx = x.NumSignals;
+	int ncy = y.NumSignals;
+	int nthreads = maxthreads();
+	int nfft = w->NFFT;
+	int nbins = nfft / 2 + 1;
+	int nsegments = WelchSegments(w, x.NumSamples);
+	npairs = pairs ? npairs : ncx * ncy;
+
+	for (int a = 0; pairs && a < npairs; a++)
+	{
+		if (pairs[2 * a] < 0 || pairs[2 * a] >= ncx || pairs[2 * a + 1] < 0 || pairs[2 * a + 1] >= ncy)
+			return InvalidArgument;
+	}
+
+	// Group pairs by their signal in X, so that each one is transformed once & then used for all of its pairs
+	int* first = (int*)calloc((size_t)ncx + 1, sizeof(int));
+	int* order = (int*)malloc((size_t)npairs * sizeof(int));
+	int* cursor = (int*)malloc((size_t)ncx * sizeof(int));
+	if (!first || !order || !cursor)
+	{
+		free(first);
+		free(order);
+		free(cursor);
+		return OutOfMemory;
+	}
+	for (int a = 0; a < npairs; a++)
+		first[pairx(pairs, a, ncx) + 1]++;
+	for (int a = 0; a < ncx; a++)
+		first[a + 1] += first[a];
+	memcpy(cursor, first, (size_t)ncx * sizeof(int));
+	for (int a = 0; a < npairs; a++)
+		order[cursor[pairx(pairs, a, ncx)]++] = a;
+	free(cursor);
+
+	// Segment spectra of Y are cached in batches, along with their accumulated auto-spectra
+	size_t szspec = aligned((size_t)nbins * sizeof(Complex));
+	size_t ldF = szspec / sizeof(Complex);
+	size_t szauto = aligned((size_t)nbins * sizeof(double));
+	size_t ldP = szauto / sizeof(double);
+	size_t szsignal = (size_t)nsegments * szspec + szauto;
+	size_t szthread = szspec + aligned((size_t)nfft * sizeof(double));
+	size_t szpaired = szspec + 2 * sizeof(int);
+	size_t fixed = (size_t)nthreads * szthread + (size_t)ncx * szauto;
+
+	size_t budget = GetMemoryBudget();
+	size_t nfit = (budget > fixed) ? (budget - fixed) / (szsignal + nthreads * szpaired) : 1;
+	int by = (nfit < (size_t)ncy) ? (int)nfit : ncy;
+	by = (by < 1) ? 1 : by;
+
+	size_t ldpaired = aligned(2 * (size_t)by * sizeof(int)) / sizeof(int);
+	size_t total = fixed + (size_t)by * (szsignal + nthreads * szspec) + nthreads * ldpaired * sizeof(int);
+	Arena* arena = arenaacquire(total);
+	FFTPlan* plan = fftacquire(nfft);
+	if (!arena || !plan)
+	{
+		arenarelease(arena);
+		fftrelease(plan);
+		free(first);
+		free(order);
+		return OutOfMemory;
+	}
+
+	Complex* Fy = (Complex*)arenaalloc(arena, (size_t)by * nsegments * szspec);
+	double* Pyy = (double*)arenaalloc(arena, (size_t)by * szauto);
+	double* Pxx = (double*)arenaalloc(arena, (size_t)ncx * szauto);
+	char* buffers = (char*)arenaalloc(arena, (size_t)nthreads * szthread);
+	Complex* Pxy = (Complex*)arenaalloc(arena, (size_t)nthreads * by * szspec);
+	int* paired = (int*)arenaalloc(arena, nthreads * ldpaired * sizeof(int));
+
+	for (int y0 = 0; y0 < ncy; y0 += by)
+	{
+		int nby = (ncy - y0 < by) ? ncy - y0 : by;
+
+		#pragma omp parallel for schedule(dynamic, 1)
+		for (int a = 0; a < nby; a++)
+		{
+			double* buffer = (double*)(buffers + threadid() * szthread + szspec);
+			Complex* Fa = Fy + (size_t)a * nsegments * ldF;
+			double* Pa = Pyy + (size_t)a * ldP;
+			memset(Pa, 0, (size_t)nbins * sizeof(double));
+			for (int b = 0; b < nsegments; b++)
+			{
+				Complex* S = Fa + (size_t)b * ldF;
+				rfft(plan, S, buffer, segment(buffer, column(y, y0 + a), w, b));
+				for (int c = 0; c < nbins; c++)
+					Pa[c] += S[c].re * S[c].re + S[c].im * S[c].im;
+			}
+		}
+
+		#pragma omp parallel for schedule(dynamic, 1)
+		for (int a = 0; a < ncx; a++)
+		{
+			int tid = threadid();
+			int* ys = paired + tid * ldpaired;
+			int* slot = ys + by;
+
+			// Find the distinct signals in this batch of Y that this signal is paired with
+			int nys = 0;
+			for (int b = 0; b < nby; b++)
+				slot[b] = -1;
+			for (int b = first[a]; b < first[a + 1]; b++)
+			{
+				int idxY = pairy(pairs, order[b], ncx) - y0;
+				if (idxY < 0 || idxY >= nby || slot[idxY] >= 0) { continue; }
+				slot[idxY] = nys;
+				ys[nys++] = idxY;
+			}
+			if (nys == 0) { continue; }
+
+			char* workspace = buffers + tid * szthread;
+			Complex* S = (Complex*)workspace;
+			double* buffer = (double*)(workspace + szspec);
+			Complex* C = Pxy + (size_t)tid * by * ldF;
+			memset(C, 0, (size_t)nys * ldF * sizeof(Complex));
+
+			// Auto-spectra of X are accumulated during the first batch that needs them & kept for the rest
+			double* P = Pxx + (size_t)a * ldP;
+			int accumulate = 1;
+			for (int b = first[a]; b < first[a + 1] && accumulate; b++)
+			{
+				int idxY = pairy(pairs, order[b], ncx);
+				accumulate = (idxY >= y0);
+			}
+			if (accumulate) { memset(P, 0, (size_t)nbins * sizeof(double)); }
+
+			for (int b = 0; b < nsegments; b++)
+			{
+				rfft(plan, S, buffer, segment(buffer, column(x, a), w, b));
+				if (accumulate)
+				{
+					for (int c = 0; c < nbins; c++)
+						P[c] += S[c].re * S[c].re + S[c].im * S[c].im;
+				}
+
+				for (int d = 0; d < nys; d++)
+				{
+					const Complex* T = Fy + ((size_t)ys[d] * nsegments + b) * ldF;
+					Complex* Cd = C + (size_t)d * ldF;
+					for (int c = 0; c < nbins; c++)
+					{
+						Cd[c].re += S[c].re * T[c].re + S[c].im * T[c].im;
+						Cd[c].im += S[c].im * T[c].re - S[c].re * T[c].im;
+					}
+				}
+			}
+
+			for (int b = first[a]; b < first[a + 1]; b++)
+			{
+				int idxY = pairy(pairs, order[b], ncx) - y0;
+				if (idxY < 0 || idxY >= nby) { continue; }
+
+				const Complex* Cd = C + (size_t)slot[idxY] * ldF;
+				const double* Py = Pyy + (size_t)idxY * ldP;
+				double* out = coh + (size_t)order[b] * nbins;
+				for (int c = 0; c < nbins; c++)
+					out[c] = (Cd[c].re * Cd[c].re + Cd[c].im * Cd[c].im) / (P[c] * Py[c]);
+			}
+		}
+	}
+
+	fftrelease(plan);
+	arenarelease(arena);
+	free(first);
+	free(order);
+	return Success;
+}
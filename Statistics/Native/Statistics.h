@@ -0,0 +1,988 @@
+/* STATISTICS - Native statistics kernels that back the MEX functions in Statistics/Mex.
+ *
+ *	This header declares a plain C interface to the correlation, sliding window correlation, cross-correlation and empirical
+ *	CDF kernels that used to live directly inside their MEX entry points. None of the functions declared here depend on
+ *	MATLAB, so they can be compiled into an ordinary static library on any platform (see Statistics/CMakeLists.txt),
+ *	exercised from plain C programs and profiled outside of a MATLAB session. The MEX files are now thin wrappers that
+ *	translate mxArrays into the types below and translate error codes back into MATLAB errors.
+ *
+ *	CONVENTIONS:
+ *		- Signals are stored in column-major arrays with one signal per column and one sample per row, exactly as MATLAB
+ *		  stores them. Every array input is described by a SignalArray structure (pointer, dimensions and column stride).
+ *		- Output arrays are always allocated by the caller and are written densely (i.e. without any stride).
+ *		- Functions that can fail return an ErrorCode. Use errormsg to get a human-readable description of a failure.
+ *		- Functions whose names end in F take single precision signals (described by SignalArrayF) and write single
+ *		  precision outputs. They accumulate in double precision internally, so they are about as accurate as their double
+ *		  precision counterparts while reading half as much memory.
+ */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#pragma once
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+/* CONSTANTS */
+#define PROFILETHREADS	64			// The number of threads whose busy time a profile keeps apart. Others share the last slot.
+
+
+
+/* DATA */
+/// <summary>
+/// Error codes that are returned by the native statistics functions.
+/// </summary>
+typedef enum
+{
+	Success = 0,
+	EmptyInput,
+	SizeMismatch,
+	InvalidArgument,
+	OutOfMemory,
+	FileError,
+	InvalidFile,
+}ErrorCode;
+
+/// <summary>
+/// The numeric types that array elements may be stored as.
+/// </summary>
+/// <remarks>
+/// Mapped arrays & the correlation kernels only store floating point elements. Integer types are only read by kernels
+/// that take raw imaging data (e.g. FrameCorrelate), which widen them to double precision a block at a time.
+/// </remarks>
+typedef enum
+{
+	DoublePrecision = 0,
+	SinglePrecision,
+	Int8Precision,
+	UInt8Precision,
+	Int16Precision,
+	UInt16Precision,
+	Int32Precision,
+	UInt32Precision,
+}Precision;
+
+/// <summary>
+/// Tails of an empirical cumulative distribution function.
+/// </summary>
+typedef enum
+{
+	Both = 0,
+	Left,
+	Right,
+}Tails;
+
+/// <summary>
+/// Methods of controlling the family-wise error rate (FWER) when many hypotheses are tested at once.
+/// </summary>
+typedef enum
+{
+	Uncorrected = 0,			// Don't control FWER.
+	Binomial,					// Sequential goodness of fit (SGoF) using an exact binomial test.
+	FalseDiscovery,				// Benjamini-Hochberg control of the false discovery rate.
+	GTest,						// Sequential goodness of fit (SGoF) using a G-test.
+}Correction;
+
+/// <summary>
+/// Methods of generating surrogate signals that keep some properties of the originals while destroying their relationships
+/// with other signals.
+/// </summary>
+typedef enum
+{
+	CircularShift = 0,			// Rotates signals by a random number of samples. This keeps all of their autocorrelation.
+	PhaseRandomize,				// Randomizes the phase of every frequency component. This keeps their power spectra.
+	BlockPermute,				// Shuffles the order of fixed-length blocks. This keeps autocorrelation within blocks.
+}Surrogate;
+
+/// <summary>
+/// Enumerates the ways that correlation kernels can threshold their outputs before storing them.
+/// </summary>
+typedef enum
+{
+	KeepAll = 0,				// Store every value.
+	ZeroInsignificant,			// Store zeros in place of values that fall between the lower & upper cutoffs.
+	Significance,				// Store ones for values at or beyond either cutoff and zeros for all others.
+}Thresholding;
+
+/// <summary>
+/// Enumerates the ways that averaged periodograms can be scaled.
+/// </summary>
+typedef enum
+{
+	PowerSpectralDensity = 0,	// Power per unit frequency, which normalizes by the sampling rate & the window's energy.
+	PowerSpectrum,				// Power per frequency bin, which normalizes by the squared sum of the window.
+}Scaling;
+
+/// <summary>
+/// Enumerates the ways that signals can be partitioned into discrete levels.
+/// </summary>
+typedef enum
+{
+	Equidistant = 0,			// Evenly spaced bins that span the range of each signal.
+	Equiprobable,				// Bins that each hold about the same number of samples. Tied values share the lower bin.
+	Distinct,					// One level per distinct value, for signals that have already been discretized.
+}Partition;
+
+/// <summary>
+/// Enumerates the information theoretic quantities that can be measured between pairs of discrete signals, in bits.
+/// </summary>
+typedef enum
+{
+	JointEntropy = 0,			// H(X,Y), which uses the joint distribution of both signals.
+	ConditionalEntropy,			// H(X|Y) = H(X,Y) - H(Y), which is what is left of H(X) once Y is known.
+	MutualInformation,			// I(X;Y) = H(X) + H(Y) - H(X,Y), which is what X & Y share.
+}Information;
+
+/// <summary>
+/// Enumerates the ways that worker threads can be pinned to processors.
+/// </summary>
+typedef enum
+{
+	Unpinned = 0,				// Let the operating system move threads between processors.
+	Compact,					// Pin successive threads to successive processors, which keeps them close in the cache hierarchy.
+	Spread,						// Pin threads as far apart as possible, which spreads them across cores & NUMA nodes.
+}Affinity;
+
+/// <summary>
+/// Enumerates the phases that profiled kernels split their time into.
+/// </summary>
+typedef enum
+{
+	PlanPhase = 0,				// Acquiring transform plans & scratch memory.
+	PreparePhase,				// Computing norms, standardizing signals & widening single precision inputs.
+	ForwardPhase,				// Forward transforms of signals into spectra.
+	SpectrumPhase,				// Cross-spectral products (i.e. multiplying one spectrum by the conjugate of another).
+	InversePhase,				// Inverse transforms of cross-spectra into circular correlations.
+	GatherPhase,				// Picking requested lags out of circular correlations & scaling them into coefficients.
+	DirectPhase,				// Dot products, matrix products & running sums computed in the time domain.
+	StorePhase,					// Epilogues & narrowing coefficients into single precision outputs.
+	NumPhases,					// The number of phases, which isn't a phase itself.
+}Phase;
+
+/// <summary>
+/// Describes a column-major array of signals where each column is one signal and each row is one sample.
+/// </summary>
+typedef struct
+{
+	const double*	Data;			// A pointer to the first sample of the first signal.
+	int				NumSamples;		// The number of samples (rows) in each signal.
+	int				NumSignals;		// The number of signals (columns) in the array.
+	int				Stride;			// The distance in elements between the first samples of successive signals.
+}SignalArray;
+
+/// <summary>
+/// Describes a column-major array of single precision signals where each column is one signal and each row is one sample.
+/// </summary>
+typedef struct
+{
+	const float*	Data;			// A pointer to the first sample of the first signal.
+	int				NumSamples;		// The number of samples (rows) in each signal.
+	int				NumSignals;		// The number of signals (columns) in the array.
+	int				Stride;			// The distance in elements between the first samples of successive signals.
+}SignalArrayF;
+
+/// <summary>
+/// Describes a series of image frames (e.g. the volumes of a 4-D BOLD run) stored one after another in memory.
+/// </summary>
+/// <remarks>
+/// This is the column-major layout that MATLAB uses for an [X x Y x Z x T] array, which is a [V x T] array where each
+/// column holds the V = X * Y * Z voxels of one frame.
+/// </remarks>
+typedef struct
+{
+	const void*		Data;			// A pointer to the first voxel of the first frame.
+	Precision		Class;			// The type of every voxel.
+	size_t			NumVoxels;		// The number of voxels (V) in each frame.
+	int				NumFrames;		// The number of frames (T).
+}FrameArray;
+
+/// <summary>
+/// Holds summary statistics of a collection of values. NaNs are counted but are otherwise left out of every statistic.
+/// </summary>
+typedef struct
+{
+	double			Min;			// The smallest value, or NaN if there are none.
+	double			Max;			// The largest value, or NaN if there are none.
+	size_t			NumNaNs;		// The number of NaNs.
+	size_t			Count;			// The number of values that aren't NaNs.
+	double			Sum;			// The sum of the values.
+	double			Mean;			// The mean of the values, or NaN if there are none.
+	double			Variance;		// The unbiased sample variance of the values (normalized by Count - 1).
+}Summary;
+
+/// <summary>
+/// Holds the running statistics of every element of a series of equally sized arrays (e.g. one correlation map for each
+/// subject & scan) without keeping the arrays themselves.
+/// </summary>
+/// <remarks>
+/// Every field points to caller-owned storage of NumElements values, which must be zeroed before the first array is
+/// ingested. Counts are kept in double precision so that MATLAB can hold them directly.
+/// </remarks>
+typedef struct
+{
+	double*			Count;			// The number of arrays in which each element wasn't a NaN.
+	double*			Mean;			// The running mean of each element.
+	double*			M2;				// The running sum of squared deviations of each element from its mean.
+	size_t			NumElements;	// The number of elements in each array.
+}Accumulator;
+
+/// <summary>
+/// Holds the timings & counters that instrumented kernels record while profiling is enabled (see SetProfiling).
+/// </summary>
+/// <remarks>
+/// Phase times are summed over every thread, so in parallel kernels they can add up to more than the wall time. Byte
+/// counts are the traffic that kernels cannot avoid, i.e. reading every input once and writing every output once, which
+/// gives a lower bound on memory traffic to compare against wall time. Hardware counters are only available on Linux, where
+/// they are read through perf_event_open for every thread that ran a profiled phase, from its first such phase onward.
+/// </remarks>
+typedef struct
+{
+	const char*		Kernel;							// The name of the first kernel that ran while profiling, or NULL.
+	uint64_t		Calls;							// The number of kernel calls that were profiled.
+	double			WallTime;						// The seconds spent inside those calls.
+	double			PhaseTime[NumPhases];			// The seconds spent in each phase, summed over every thread.
+	double			BusyTime[PROFILETHREADS];		// The seconds that each thread spent in any phase.
+	int				NumThreads;						// One more than the index of the last thread that spent time in a phase.
+	uint64_t		Bytes;							// The number of bytes that kernels read from inputs & wrote to outputs.
+	uint64_t		Pairs;							// The number of signal pairings that kernels processed.
+	int64_t			Cycles;							// The number of processor cycles, or -1 if they couldn't be counted.
+	int64_t			CacheMisses;					// The number of last-level cache misses, or -1 if they couldn't be counted.
+}Profile;
+
+/// <summary>
+/// Describes a column-major array of discrete signals, whose samples are the zero-based levels they fall into.
+/// </summary>
+typedef struct
+{
+	const int*		Codes;			// The level of every sample, or a negative value for missing samples.
+	const int*		Levels;			// The number of levels that each signal can take on.
+	int				NumSamples;		// The number of samples (rows) in each signal.
+	int				NumSignals;		// The number of signals (columns) in the array.
+}LevelArray;
+
+/// <summary>
+/// Describes a two-dimensional column-major array that is stored in a memory-mapped file.
+/// </summary>
+/// <remarks>
+/// Mapped array files consist of a 64-byte header followed immediately by the array elements in column-major order. The
+/// header holds the 8 characters "STATMAT" (including the terminating null), a 32-bit format version (currently 1), a
+/// 32-bit Precision code, and the 64-bit number of rows and columns, all in native byte order. The rest of the header is
+/// reserved and should be zeroed. MATLAB can create these files with MAPWRITE and read them with MEMMAPFILE.
+/// </remarks>
+typedef struct
+{
+	void*			Data;			// A pointer to the first element of the array (i.e. just past the header).
+	Precision		Class;			// The type of every element in the array.
+	size_t			NumRows;		// The number of rows in the array.
+	size_t			NumColumns;		// The number of columns in the array.
+	void*			Mapping;		// Platform-specific details about the mapping. This must not be modified.
+}MappedArray;
+
+/// <summary>
+/// Holds an orthonormal basis for the signals that partial correlations control for (i.e. nuisance signals).
+/// </summary>
+/// <remarks>
+/// A basis is a thin QR factorization of the nuisance signals, of which only Q is kept. Factorizing once lets the same
+/// nuisance signals be projected out of any number of signal arrays without solving a least squares problem each time.
+/// </remarks>
+typedef struct
+{
+	double*			Basis;			// An [M x K] array whose columns are orthonormal & span the nuisance signals.
+	int				NumSamples;		// The number of samples (M) in each basis vector.
+	int				Rank;			// The number of basis vectors (K). Linearly dependent nuisance signals add none.
+}Nuisance;
+
+/// <summary>
+/// Holds what correlating an array of signals (X) needs to know about it, so that X is only ingested once no matter how
+/// many other signals it is correlated with afterward.
+/// </summary>
+/// <remarks>
+/// Correlators without lags keep standardized copies of X. Correlators with lags keep the energy of every signal in X,
+/// along with either its spectra or, when the lags are few enough that dot products are cheaper than transforms, a copy
+/// of X itself. Only the signals that are correlated against X are then processed by each call to CorrelatorApply.
+/// </remarks>
+typedef struct
+{
+	double*			Signals;		// An [M x NX] array of standardized or copied signals, or NULL when spectra are kept.
+	double*			Spectra;		// The one-sided spectra of X as interleaved real & imaginary parts, or NULL.
+	double*			SumSquares;		// The sum of the squared samples of every signal in X, or NULL without lags.
+	int*			Lags;			// The sample shifts of X relative to Y that are computed, or NULL without lags.
+	int				NumLags;		// The number of lags (L), which is zero without lags.
+	int				NumSamples;		// The number of samples (M) in every signal.
+	int				NumSignals;		// The number of signals (NX) in X.
+	int				NFFT;			// The length of the transforms behind the spectra, or zero when none are kept.
+}Correlator;
+
+/// <summary>
+/// Describes the final processing that correlation kernels apply to each coefficient as they store it.
+/// </summary>
+/// <remarks>
+/// Each coefficient is Fisher transformed first (if requested) and thresholded second, so cutoffs are in the same units
+/// as the stored values. Thresholding epilogues must have finite cutoffs with the lower one no greater than the upper one,
+/// so a one-tailed threshold puts the cutoff of the ignored tail at -DBL_MAX or DBL_MAX. NaNs are stored unchanged.
+/// Without a map, outputs keep the layout that the kernel normally uses. With one, signal idx of X is scattered to row
+/// Map[idx] of an [NumRows x L x NY] output (e.g. voxels x lags x channels), and rows that no signal maps to are filled
+/// with the Fill value. This replaces the separate passes that transforming, thresholding and unmasking would otherwise
+/// take over the output.
+/// </remarks>
+typedef struct
+{
+	double			FisherN;		// When nonzero, stores atanh(r) * sqrt(FisherN - 3). Use 4 for the plain Fisher transform.
+	Thresholding	Threshold;		// How values are thresholded.
+	double			Cutoffs[2];		// The finite lower & upper cutoffs. Values at or beyond either one are significant.
+	const size_t*	Map;			// The output row of each signal in X, or NULL to leave the output layout alone.
+	size_t			NumRows;		// The number of rows in a mapped output.
+	double			Fill;			// The value stored in rows of a mapped output that no signal maps to (e.g. NaN).
+}Epilogue;
+
+/// <summary>
+/// Describes how Welch's method segments, windows and transforms signals.
+/// </summary>
+/// <remarks>
+/// Signals are split into as many windowed segments as fit, with successive segments sharing Overlap samples. Samples
+/// left over at the end of a signal are ignored. Segments are zero-padded to NFFT samples, or wrapped around to NFFT
+/// samples when the window is longer than that. Only the one-sided spectrum is computed, so there are (NFFT / 2 + 1)
+/// frequency bins at multiples of (SamplingRate / NFFT).
+/// </remarks>
+typedef struct
+{
+	const double*	Window;			// The window applied to every segment.
+	int				WindowLength;	// The number of samples in the window & in each segment.
+	int				Overlap;		// The number of samples that successive segments share. This must be in [0, WindowLength - 1].
+	int				NFFT;			// The transform length, which must be a power of two no smaller than 2.
+	double			SamplingRate;	// The sampling rate of the signals, in Hz.
+	Scaling			Scale;			// How power spectra are scaled. Coherence does not depend on this.
+}Welch;
+
+
+
+/* FUNCTIONS */
+/// <summary>
+/// Creates a description of a densely packed column-major array of signals.
+/// </summary>
+/// <param name="data">A pointer to the first element of the array.</param>
+/// <param name="nsamples">The number of rows (samples) in the array.</param>
+/// <param name="nsignals">The number of columns (signals) in the array.</param>
+/// <returns>A SignalArray whose stride is equal to the number of samples.</returns>
+static inline SignalArray signals(const double* data, int nsamples, int nsignals)
+{
+	SignalArray s = { data, nsamples, nsignals, nsamples };
+	return s;
+}
+/// <summary>
+/// Gets a pointer to the first sample of one signal in a signal array.
+/// </summary>
+static inline const double* column(SignalArray s, int idx)
+{
+	return s.Data + (size_t)idx * (size_t)s.Stride;
+}
+/// <summary>
+/// Creates a description of a densely packed column-major array of single precision signals.
+/// </summary>
+static inline SignalArrayF signalsf(const float* data, int nsamples, int nsignals)
+{
+	SignalArrayF s = { data, nsamples, nsignals, nsamples };
+	return s;
+}
+/// <summary>
+/// Gets a pointer to the first sample of one signal in a single precision signal array.
+/// </summary>
+static inline const float* columnf(SignalArrayF s, int idx)
+{
+	return s.Data + (size_t)idx * (size_t)s.Stride;
+}
+/// <summary>
+/// Gets the number of bytes that one array element of a given type occupies.
+/// </summary>
+static inline size_t elementsize(Precision class)
+{
+	switch (class)
+	{
+		case DoublePrecision:	return sizeof(double);
+		case SinglePrecision:	return sizeof(float);
+		case Int8Precision:
+		case UInt8Precision:	return sizeof(int8_t);
+		case Int16Precision:
+		case UInt16Precision:	return sizeof(int16_t);
+		default:				return sizeof(int32_t);
+	}
+}
+/// <summary>
+/// Creates a description of a densely packed column-major array of discrete signals.
+/// </summary>
+static inline LevelArray discrete(const int* codes, const int* levels, int nsamples, int nsignals)
+{
+	LevelArray s = { codes, levels, nsamples, nsignals };
+	return s;
+}
+
+/// <summary>
+/// Gets a description of an error code that is suitable for displaying to users.
+/// </summary>
+const char*	errormsg(ErrorCode code);
+
+/// <summary>
+/// Sets the approximate maximum number of bytes of scratch memory that a single kernel call may use.
+/// </summary>
+/// <remarks>
+/// Kernels that cache intermediate results (e.g. the spectra used by cross-correlation) process signals in batches that
+/// are sized to fit within this budget, so peak memory use stays bounded regardless of how many signals are analyzed. The
+/// default budget is 512 MB. Budgets that are too small to hold even a single batch are exceeded by the smallest amount
+/// that still allows the kernel to run.
+/// </remarks>
+void		SetMemoryBudget(size_t bytes);
+/// <summary>
+/// Gets the approximate maximum number of bytes of scratch memory that a single kernel call may use.
+/// </summary>
+size_t		GetMemoryBudget(void);
+
+/// <summary>
+/// Sets the number of threads that the kernels run on.
+/// </summary>
+/// <remarks>
+/// Every MEX file links the same shared copy of this library, so scheduler settings made through one of them apply to all
+/// of them. Thread counts are held by the OpenMP runtime and apply to kernels called from the thread that sets them. The
+/// grain size starts out from the STATISTICS_GRAIN environment variable when it is set before the library is loaded.
+/// </remarks>
+/// <param name="nthreads">The number of threads, or zero to use every processor.</param>
+ErrorCode	SetThreads(int nthreads);
+/// <summary>
+/// Gets the number of threads that the kernels run on.
+/// </summary>
+int			GetThreads(void);
+/// <summary>
+/// Pins the worker threads that the kernels run on to processors.
+/// </summary>
+/// <remarks>
+/// Threads are pinned within the set of processors that the process was started with, and pinning is applied again
+/// whenever the thread count changes. The calling thread (e.g. MATLAB's own) is never pinned. Pinning is supported on
+/// Linux & Windows. Elsewhere, only Unpinned is accepted.
+/// </remarks>
+ErrorCode	SetAffinity(Affinity pinning);
+/// <summary>
+/// Gets how the worker threads that the kernels run on are pinned to processors.
+/// </summary>
+Affinity	GetAffinity(void);
+/// <summary>
+/// Sets the number of iterations that a worker takes from its queue at once in kernels that split their work through the
+/// work-stealing scheduler.
+/// </summary>
+/// <remarks>
+/// Small grains balance load better while large grains lower scheduling overhead. The automatic grain gives every thread
+/// about 16 takes of its initial share.
+/// </remarks>
+/// <param name="grain">The number of iterations, or zero to size grains automatically.</param>
+void		SetGrainSize(size_t grain);
+/// <summary>
+/// Gets the number of iterations that a worker takes from its queue at once, or zero if grains are sized automatically.
+/// </summary>
+size_t		GetGrainSize(void);
+/// <summary>
+/// Releases the scratch memory that the calling thread keeps between kernel calls, along with every cached transform plan
+/// that no kernel is using.
+/// </summary>
+/// <remarks>
+/// Kernels keep their largest scratch buffer and the transform plans of the last few lengths they used, so that repeated
+/// calls skip allocation & setup entirely. Call this to return that memory once a batch of analyses is finished.
+/// </remarks>
+void		ReleaseWorkspace(void);
+
+/// <summary>
+/// Turns kernel profiling on or off. Turning profiling on discards everything that has been recorded so far.
+/// </summary>
+/// <remarks>
+/// Profiling is off by default, in which case instrumented kernels only test one flag per phase. Building the library
+/// without STATISTICS_PROFILING removes the instrumentation entirely, in which case profiles stay empty. Every MEX file links
+/// the same shared copy of this library, so they also share one profile.
+/// </remarks>
+void		SetProfiling(int enabled);
+/// <summary>
+/// Gets whether kernel profiling is turned on.
+/// </summary>
+int			GetProfiling(void);
+/// <summary>
+/// Gets everything that profiled kernels have recorded since profiling was last turned on.
+/// </summary>
+void		GetProfile(Profile* p);
+/// <summary>
+/// Gets the name of a phase, which is also its key in JSON profiles.
+/// </summary>
+const char*	phasename(Phase phase);
+/// <summary>
+/// Appends a profile to a file as one line of JSON, so that the profiles of successive calls form a JSON Lines log.
+/// </summary>
+/// <param name="p">The profile to write.</param>
+/// <param name="path">The path of the file to append to, or NULL to write to the standard output.</param>
+ErrorCode	WriteProfile(const Profile* p, const char* path);
+
+/// <summary>
+/// Maps an existing array file into memory.
+/// </summary>
+/// <param name="array">Receives a description of the mapped array. This must be closed using CloseMappedArray.</param>
+/// <param name="path">The path to an existing mapped array file.</param>
+/// <param name="writable">Nonzero to allow the array to be modified. Changes are written back to the file.</param>
+ErrorCode	OpenMappedArray(MappedArray* array, const char* path, int writable);
+/// <summary>
+/// Creates a new zero-filled array file of a given size and maps it into memory with write access.
+/// </summary>
+/// <param name="array">Receives a description of the mapped array. This must be closed using CloseMappedArray.</param>
+/// <param name="path">The path to the new file. Any existing file at this location is overwritten.</param>
+/// <param name="precision">The type of the array elements.</param>
+/// <param name="nrows">The number of rows in the array.</param>
+/// <param name="ncols">The number of columns in the array.</param>
+ErrorCode	CreateMappedArray(MappedArray* array, const char* path, Precision precision, size_t nrows, size_t ncols);
+/// <summary>
+/// Advises the operating system that a range of columns in a mapped array won't be needed again soon.
+/// </summary>
+/// <remarks>
+/// This releases the physical memory that backs the columns (after writing any changes back to the file), which keeps
+/// the working set of the process small when arrays much larger than the available memory are streamed through.
+/// </remarks>
+void		EvictMappedColumns(MappedArray* array, size_t first, size_t count);
+/// <summary>
+/// Advises the operating system that a band of rows in every column of a mapped array won't be needed again soon.
+/// </summary>
+/// <remarks>
+/// This is the counterpart of EvictMappedColumns for arrays that are filled a band of rows at a time. Every page that ends
+/// within the band is released, including pages that begin in rows before it, so that bands released in ascending order
+/// leave none of their pages resident behind them. Released rows are read back from the file if they are needed again.
+/// </remarks>
+void		EvictMappedRows(MappedArray* array, size_t first, size_t count);
+/// <summary>
+/// Unmaps an array from memory and closes its file. Any changes are written back to the file first.
+/// </summary>
+void		CloseMappedArray(MappedArray* array);
+
+/// <summary>
+/// Computes the Pearson product-moment correlation coefficient between two signals.
+/// </summary>
+/// <param name="x">A signal vector.</param>
+/// <param name="y">A second signal vector of the same length as x.</param>
+/// <param name="nsamples">The number of sample points in x and y.</param>
+/// <returns>The correlation coefficient (r) between x and y.</returns>
+double		corr(const double x[], const double y[], int nsamples);
+/// <summary>
+/// Computes the Pearson product-moment correlation coefficient between two single precision signals.
+/// </summary>
+/// <remarks>
+/// Sums are accumulated in double precision using the widest vector instructions that the processor supports.
+/// </remarks>
+double		corrf(const float x[], const float y[], int nsamples);
+
+/// <summary>
+/// Computes the correlation between every signal in X and every signal in Y.
+/// </summary>
+/// <param name="r">An [NX x NY] output array that receives the correlation coefficients.</param>
+/// <param name="x">An [M x NX] array of signals.</param>
+/// <param name="y">An [M x NY] array of signals.</param>
+ErrorCode	Correlate(double r[], SignalArray x, SignalArray y);
+/// <summary>
+/// Computes the correlation between every single precision signal in X and every single precision signal in Y.
+/// </summary>
+ErrorCode	CorrelateF(float r[], SignalArrayF x, SignalArrayF y);
+
+/// <summary>
+/// Computes the correlation between every signal stored in a mapped array file and every signal in Y, tile by tile.
+/// </summary>
+/// <remarks>
+/// Only one tile of signals from X (and the corresponding part of R) needs to be resident in memory at any time, so the
+/// working set of this function is independent of the number of signals in X. Single precision data in X is converted
+/// to double precision one tile at a time.
+/// </remarks>
+/// <param name="r">A writable, double precision [NX x NY] mapped array that receives the correlation coefficients.</param>
+/// <param name="x">An [M x NX] mapped array of signals in either single or double precision.</param>
+/// <param name="y">An [M x NY] array of signals.</param>
+/// <param name="tilesize">The number of signals from X to process at once, or zero to size tiles automatically.</param>
+ErrorCode	CorrelateMapped(MappedArray* r, const MappedArray* x, SignalArray y, int tilesize);
+
+/// <summary>
+/// Calculates the number of correlation estimates that a sliding window correlation produces for each signal pairing.
+/// </summary>
+/// <param name="nsamples">The number of samples in the signals being correlated.</param>
+/// <param name="window">The number of samples in a single window.</param>
+/// <param name="noverlap">The number of samples that successive windows share.</param>
+/// <returns>The number of windows, i.e. floor((nsamples - window) / (window - noverlap)), or zero if there are none.</returns>
+int			WindowCount(int nsamples, int window, int noverlap);
+
+/// <summary>
+/// Computes the sliding window correlation between every signal in X and every signal in Y.
+/// </summary>
+/// <param name="swc">An [MC x (NX * NY)] output array that receives the correlation time series (see WindowCount).</param>
+/// <param name="x">An [M x NX] array of signals.</param>
+/// <param name="y">An [M x NY] array of signals.</param>
+/// <param name="window">The number of samples in a single window.</param>
+/// <param name="noverlap">The number of samples that successive windows share. This must be in [0, window - 1].</param>
+ErrorCode	WindowCorrelate(double swc[], SignalArray x, SignalArray y, int window, int noverlap);
+/// <summary>
+/// Computes the sliding window correlation between every single precision signal in X and every one in Y.
+/// </summary>
+ErrorCode	WindowCorrelateF(float swc[], SignalArrayF x, SignalArrayF y, int window, int noverlap);
+
+/// <summary>
+/// Computes the cross-correlation function between every signal in X and every signal in Y.
+/// </summary>
+/// <param name="cc">A [(2M - 1) x (NX * NY)] output array that receives Pearson correlation coefficients at all lags.</param>
+/// <param name="x">An [M x NX] array of signals.</param>
+/// <param name="y">An [M x NY] array of signals.</param>
+ErrorCode	CrossCorrelate(double cc[], SignalArray x, SignalArray y);
+/// <summary>
+/// Computes the cross-correlation function between every single precision signal in X and every one in Y.
+/// </summary>
+ErrorCode	CrossCorrelateF(float cc[], SignalArrayF x, SignalArrayF y);
+
+/// <summary>
+/// Computes the cross-correlation function between every signal in X and every signal in Y at selected lags only.
+/// </summary>
+/// <param name="cc">An [L x (NX * NY)] output array that receives Pearson correlation coefficients.</param>
+/// <param name="x">An [M x NX] array of signals.</param>
+/// <param name="y">An [M x NY] array of signals.</param>
+/// <param name="lags">The L sample shifts of X relative to Y to compute. These must all be in [-(M - 1), M - 1].</param>
+/// <param name="nlags">The number of lags (L).</param>
+ErrorCode	CrossCorrelateLags(double cc[], SignalArray x, SignalArray y, const int lags[], int nlags);
+/// <summary>
+/// Computes the cross-correlation function between every single precision signal in X and every one in Y at selected lags.
+/// </summary>
+ErrorCode	CrossCorrelateLagsF(float cc[], SignalArrayF x, SignalArrayF y, const int lags[], int nlags);
+/// <summary>
+/// Computes the cross-correlation function between every signal in X and every signal in Y at selected lags, applying an
+/// epilogue to every coefficient as it is stored.
+/// </summary>
+/// <param name="out">An output array that receives the processed coefficients. This is [L x (NX * NY)] like the output of
+/// CrossCorrelateLags, unless the epilogue maps signals to rows, in which case it is [NumRows x L x NY].</param>
+/// <param name="epilogue">The processing to apply, or NULL to store plain correlation coefficients.</param>
+ErrorCode	CrossCorrelateLagsEx(double out[], SignalArray x, SignalArray y, const int lags[], int nlags, const Epilogue* epilogue);
+
+/// <summary>
+/// Ingests an array of signals once so that it can be correlated against any number of other signal arrays later.
+/// </summary>
+/// <param name="c">Receives the correlator. This must be released using FreeCorrelator.</param>
+/// <param name="x">An [M x NX] array of signals. This is copied, so it may be released once the correlator exists.</param>
+/// <param name="lags">The L sample shifts of X relative to Y to compute, which must all be in [-(M - 1), M - 1], or NULL to
+/// compute plain Pearson correlations like Correlate does.</param>
+/// <param name="nlags">The number of lags (L), which is ignored when lags is NULL.</param>
+ErrorCode	CreateCorrelator(Correlator* c, SignalArray x, const int lags[], int nlags);
+/// <summary>
+/// Correlates every signal in Y with every signal that a correlator holds.
+/// </summary>
+/// <param name="out">An output array laid out like the output of Correlate ([NX x NY]) for correlators without lags, or
+/// like the output of CrossCorrelateLagsEx for correlators with lags. Correlators without lags count as having the single
+/// lag zero when an epilogue maps signals to rows, so those outputs are [NumRows x 1 x NY].</param>
+/// <param name="c">A correlator created by CreateCorrelator.</param>
+/// <param name="y">An [M x NY] array of signals.</param>
+/// <param name="epilogue">The processing to apply to every coefficient as it is stored, or NULL to store them as they are.</param>
+ErrorCode	CorrelatorApply(double out[], const Correlator* c, SignalArray y, const Epilogue* epilogue);
+/// <summary>
+/// Releases the memory held by a correlator.
+/// </summary>
+void		FreeCorrelator(Correlator* c);
+
+/// <summary>
+/// Finds an orthonormal basis for a set of nuisance signals.
+/// </summary>
+/// <remarks>
+/// Nuisance signals that are linearly dependent on the ones before them (to within a relative tolerance of 1e-10) are
+/// skipped, so rank deficient sets of nuisance signals are handled the same way that MATLAB's backslash operator would.
+/// </remarks>
+/// <param name="q">Receives the basis. This must be released using FreeNuisance.</param>
+/// <param name="z">An [M x K] array of nuisance signals. A column of ones should be included to control for means.</param>
+ErrorCode	FactorNuisance(Nuisance* q, SignalArray z);
+/// <summary>
+/// Releases the memory held by a nuisance signal basis.
+/// </summary>
+void		FreeNuisance(Nuisance* q);
+/// <summary>
+/// Computes the residuals of every signal in X after regressing out a set of nuisance signals.
+/// </summary>
+/// <param name="r">An [M x NX] output array that receives the residual signals.</param>
+/// <param name="x">An [M x NX] array of signals.</param>
+/// <param name="q">The basis of the nuisance signals, as produced by FactorNuisance.</param>
+ErrorCode	Residualize(double r[], SignalArray x, const Nuisance* q);
+/// <summary>
+/// Computes the partial cross-correlation function between every signal in X and every signal in Y at selected lags.
+/// </summary>
+/// <remarks>
+/// Nuisance signals are projected out of X in tiles of signals that fit within the memory budget, and each tile of
+/// residuals is cross-correlated with Y as soon as it is ready, so the residuals of X never exist all at once. Y is
+/// residualized once up front.
+/// </remarks>
+/// <param name="cc">An [L x (NX * NY)] output array that receives partial correlation coefficients, or an [NumRows x L x NY]
+/// one if the epilogue maps signals to rows.</param>
+/// <param name="x">An [M x NX] array of signals.</param>
+/// <param name="qx">The basis of the nuisance signals to regress out of X, or NULL to use X as it is.</param>
+/// <param name="y">An [M x NY] array of signals.</param>
+/// <param name="qy">The basis of the nuisance signals to regress out of Y, or NULL to use Y as it is.</param>
+/// <param name="lags">The L sample shifts of X relative to Y to compute. These must all be in [-(M - 1), M - 1].</param>
+/// <param name="nlags">The number of lags (L).</param>
+/// <param name="epilogue">The processing to apply to every coefficient as it is stored, or NULL to store them as they are.</param>
+ErrorCode	PartialCrossCorrelateLags(double cc[], SignalArray x, const Nuisance* qx, SignalArray y, const Nuisance* qy, const int lags[], int nlags, const Epilogue* epilogue);
+
+/// <summary>
+/// Calculates the number of segments that Welch's method averages over for signals of a given length.
+/// </summary>
+/// <returns>The number of segments, i.e. floor((nsamples - Overlap) / (WindowLength - Overlap)), or zero if there are none.</returns>
+int			WelchSegments(const Welch* w, int nsamples);
+/// <summary>
+/// Estimates the one-sided power spectrum of every signal in X using Welch's averaged, modified periodogram method.
+/// </summary>
+/// <remarks>
+/// This produces the same estimates as pwelch does for real signals with a one-sided frequency range. Signals are
+/// distributed across threads, and every thread reuses a single transform plan and segment buffer.
+/// </remarks>
+/// <param name="psd">An [NF x NX] output array that receives the spectra, where NF = NFFT / 2 + 1.</param>
+/// <param name="x">An [M x NX] array of signals.</param>
+/// <param name="w">The segmentation & scaling to use.</param>
+ErrorCode	WelchSpectra(double psd[], SignalArray x, const Welch* w);
+/// <summary>
+/// Estimates the magnitude-squared coherence between pairs of signals in X and Y using Welch's method.
+/// </summary>
+/// <remarks>
+/// This produces the same estimates as mscohere does for real signals. The segment spectra of Y are transformed once and
+/// cached in batches that fit within the memory budget. Every signal in X is then transformed once per batch, and its
+/// spectra are multiplied against every cached signal it is paired with as they are produced, so auto-spectra & all
+/// cross-spectra are accumulated in a single sweep over its segments.
+/// </remarks>
+/// <param name="coh">An [NF x NP] output array that receives coherence estimates, where NF = NFFT / 2 + 1.</param>
+/// <param name="x">An [M x NX] array of signals.</param>
+/// <param name="y">An [M x NY] array of signals.</param>
+/// <param name="pairs">A list of NP pairs of zero-based signal indices, each of which is an index into X followed by one
+/// into Y. Use NULL to pair every signal in X with every one in Y, in which case NP = NX * NY and pairs are ordered as
+/// they are in the output of CrossCorrelate.</param>
+/// <param name="npairs">The number of pairs (NP). This is ignored when pairs is NULL.</param>
+/// <param name="w">The segmentation to use.</param>
+ErrorCode	Coherence(double coh[], SignalArray x, SignalArray y, const int pairs[], int npairs, const Welch* w);
+
+/// <summary>
+/// Filters every signal in X with an FIR filter, optionally without any phase distortion.
+/// </summary>
+/// <remarks>
+/// Without zero-phase filtering, this is equivalent to filter(b, 1, x), so outputs are delayed by (NB - 1) / 2 samples.
+/// With it, this is equivalent to filtfilt(b, 1, x), including filtfilt's reflection of 3 * (NB - 1) samples at both
+/// ends of each signal and its steady-state initial conditions. Filters with many taps are applied by FFT overlap-save
+/// convolution, so their cost grows with the logarithm of their length instead of linearly.
+/// </remarks>
+/// <param name="y">An [M x NX] output array that receives the filtered signals.</param>
+/// <param name="x">An [M x NX] array of signals. With zero-phase filtering, M must be larger than 3 * (NB - 1).</param>
+/// <param name="b">The NB filter coefficients.</param>
+/// <param name="ntaps">The number of filter coefficients (NB).</param>
+/// <param name="zerophase">Whether to filter forward & backward, which cancels out the phase delay of the filter.</param>
+ErrorCode	FIRFilter(double y[], SignalArray x, const double b[], int ntaps, int zerophase);
+
+/// <summary>
+/// Computes the spatial correlation between every frame in X and every frame in Y.
+/// </summary>
+/// <remarks>
+/// Each coefficient treats the voxels of two frames as paired samples, which is what corr3 computes for two volumes.
+/// Voxels outside of the mask, and voxels that are NaN or infinite in any frame of X or Y, are left out of every
+/// coefficient. Frame means are found in one pass over the data. A second pass then widens & centers blocks of voxels
+/// from every frame into double precision and accumulates them into a Gram matrix, with columns of the Gram matrix
+/// distributed across threads, so inputs of any class are read in place & are never copied in full. When X & Y are the
+/// same array, each block is only widened once and only half of the Gram matrix is computed.
+/// </remarks>
+/// <param name="r">An [TX x TY] output array that receives the correlation coefficients.</param>
+/// <param name="x">A series of TX frames.</param>
+/// <param name="y">A series of TY frames with the same number of voxels as X. This may be the same array as X.</param>
+/// <param name="mask">A vector of V elements that is nonzero for voxels to include, or NULL to include every voxel.</param>
+ErrorCode	FrameCorrelate(double r[], FrameArray x, FrameArray y, const uint8_t mask[]);
+
+/// <summary>
+/// Summarizes every column of an array of any numeric class, optionally counting a histogram of each column as well.
+/// </summary>
+/// <remarks>
+/// Columns are split into chunks that are summarized in parallel, and each chunk is widened into double precision a
+/// cache-sized block at a time. Extrema, NaN counts, sums & squared deviations are all found in a single sweep over the
+/// data, and the statistics of chunks are merged with Chan's pairwise update, so variances are as accurate as those of a
+/// two-pass algorithm. Histograms with fixed limits are counted in the same sweep. Without limits, histograms span the
+/// range of each column, which takes a second sweep once the extrema are known.
+/// </remarks>
+/// <param name="s">An output vector of T elements that receives the statistics of each column.</param>
+/// <param name="x">A [V x T] array. Summarize a whole array at once by describing it as a single column.</param>
+/// <param name="counts">An [NB x T] output array that receives the histogram of each column, or NULL to skip them.</param>
+/// <param name="nbins">The number of equal-width bins (NB) in each histogram. This is ignored when counts is NULL.</param>
+/// <param name="limits">The lower & upper edges of every histogram, or NULL to span the range of each column. Values
+/// outside of the limits aren't counted, and the last bin includes its upper edge.</param>
+ErrorCode	Summarize(Summary s[], FrameArray x, size_t counts[], int nbins, const double limits[2]);
+
+/// <summary>
+/// Adds the elements of one array to the running statistics of an accumulator.
+/// </summary>
+/// <remarks>
+/// Each element is updated with Welford's algorithm, so the arrays that have been ingested never need to be stored or
+/// read again. NaNs are skipped element by element, which matches what NANMEAN & NANVAR do across a concatenated array.
+/// </remarks>
+/// <param name="acc">The accumulator to update.</param>
+/// <param name="x">An array of acc->NumElements values.</param>
+ErrorCode	Accumulate(Accumulator* acc, const double x[]);
+/// <summary>
+/// Gets the mean, the sample variance & the one-sample t statistic of every element of an accumulator.
+/// </summary>
+/// <remarks>
+/// Means are NaN where no values were ingested. Variances are normalized by Count - 1, so they are zero where only one
+/// value was ingested. The t statistic is Mean / sqrt(Variance / Count), which is NaN where fewer than two values were
+/// ingested. Any output may alias any field of the accumulator.
+/// </remarks>
+/// <param name="mean">An output array that receives the mean of each element, or NULL to skip it.</param>
+/// <param name="variance">An output array that receives the variance of each element, or NULL to skip it.</param>
+/// <param name="t">An output array that receives the t statistic of each element, or NULL to skip it.</param>
+/// <param name="acc">The accumulator to read.</param>
+ErrorCode	AccumulatorMoments(double mean[], double variance[], double t[], const Accumulator* acc);
+
+/// <summary>
+/// Partitions the amplitudes of every signal in X into discrete levels.
+/// </summary>
+/// <remarks>
+/// Equidistant bins split the range of each signal at the same edges that linspace(min, max, NB + 1) would, and each
+/// bin holds the values above its lower edge up to & including its upper one (the first bin also holds the minimum).
+/// Equiprobable bins are found with one sort of each signal, after which the upper edge of bin k is the value of rank
+/// floor((k + 1) * M / NB). Distinct levels are numbered in ascending order of value. NaNs are treated as missing.
+/// </remarks>
+/// <param name="codes">An [M x NX] output array that receives the zero-based level of each sample, or -1 for NaNs.</param>
+/// <param name="levels">An output vector of NX elements that receives the number of levels in each signal.</param>
+/// <param name="x">An [M x NX] array of signals.</param>
+/// <param name="nbins">The number of bins (NB) for equidistant & equiprobable partitions. This is ignored for Distinct.</param>
+/// <param name="method">How signals are partitioned.</param>
+ErrorCode	Discretize(int codes[], int levels[], SignalArray x, int nbins, Partition method);
+/// <summary>
+/// Computes the marginal Shannon entropy of every discrete signal in X, in bits.
+/// </summary>
+/// <param name="h">An output vector of NX elements that receives the entropies. Signals without any samples get NaN.</param>
+/// <param name="x">An [M x NX] array of discrete signals. Missing samples are ignored.</param>
+ErrorCode	Entropy(double h[], LevelArray x);
+/// <summary>
+/// Measures joint entropy, conditional entropy or mutual information between pairs of discrete signals in X and Y.
+/// </summary>
+/// <remarks>
+/// Every pair costs one pass over its samples to build a joint histogram, from which both marginal histograms are also
+/// found, and pairs are distributed across threads. Joint histograms that would be too large to keep dense are counted
+/// one level of X at a time instead, so the cost of a pair never depends on the product of the number of levels. Samples
+/// that are missing from either signal are left out of the pair. When X & Y are the same array & the measure is
+/// symmetric, only half of the pairs are measured.
+/// </remarks>
+/// <param name="out">An [NX x NY] output array, or a vector of NP elements when pairs are listed.</param>
+/// <param name="x">An [M x NX] array of discrete signals.</param>
+/// <param name="y">An [M x NY] array of discrete signals.</param>
+/// <param name="pairs">A list of NP pairs of zero-based signal indices, each of which is an index into X followed by one
+/// into Y. Use NULL to pair every signal in X with every one in Y.</param>
+/// <param name="npairs">The number of pairs (NP). This is ignored when pairs is NULL.</param>
+/// <param name="measure">The quantity to measure. Conditional entropy is H(X|Y).</param>
+ErrorCode	PairwiseInformation(double out[], LevelArray x, LevelArray y, const int pairs[], int npairs, Information measure);
+
+/// <summary>
+/// Builds a null distribution of correlation coefficients by correlating surrogates of the signals in X with Y.
+/// </summary>
+/// <remarks>
+/// Each surrogate data set applies the same random transformation (i.e. the same shift, phases or block order) to every
+/// signal in X, so relationships between signals in X are preserved while their relationships with Y are destroyed.
+/// Every surrogate data set draws its random numbers from its own stream, so the results only depend on the seed and never
+/// on the number of threads used. Phase randomized surrogates are generated from exact length-M transforms of the signals,
+/// so every surrogate has exactly the same power spectrum as the signal it came from.
+/// </remarks>
+/// <param name="null">An output vector of (NS * NX * NY) elements. On return, the first nnull elements hold the null
+/// distribution sorted into ascending order, with any NaNs and zeros removed so that it can be passed directly to
+/// EmpiricalCDF.</param>
+/// <param name="nnull">Receives the number of elements in the null distribution.</param>
+/// <param name="x">An [M x NX] array of signals from which surrogates are generated.</param>
+/// <param name="y">An [M x NY] array of signals that the surrogates are correlated with.</param>
+/// <param name="method">The method used to generate surrogate signals.</param>
+/// <param name="nsurrogates">The number of surrogate data sets (NS) to generate.</param>
+/// <param name="blocksize">The number of samples per block for BlockPermute. This must be in [1, M - 1].</param>
+/// <param name="seed">The seed for the random number generators. Equal seeds always produce equal distributions.</param>
+ErrorCode	NullCorrelate(double null[], size_t* nnull, SignalArray x, SignalArray y, Surrogate method, int nsurrogates, int blocksize, uint64_t seed);
+
+/// <summary>
+/// Finds the smallest number of successes k for which the binomial cumulative distribution function P(X <= k) is at least q.
+/// </summary>
+/// <remarks>
+/// Binomial probabilities are generated by a ratio recurrence outward from the mode of the distribution and normalized by
+/// their sum, so nothing underflows even when the number of trials runs into the millions. Only the range of outcomes
+/// holding non-negligible probability is ever visited.
+/// </remarks>
+/// <param name="n">The number of trials.</param>
+/// <param name="p">The probability of success in each trial.</param>
+/// <param name="q">The cumulative probability to be reached.</param>
+size_t		BinomialQuantile(size_t n, double p, double q);
+/// <summary>
+/// Calculates a FWER-corrected p-value cutoff using sequential goodness of fit (SGoF).
+/// </summary>
+/// <remarks>
+/// The number of p-values at or below alpha is compared with the binomial distribution of how many would be expected to be
+/// there by chance. The cutoff is the largest of the p-values that are significant in excess of that expectation. Only the
+/// p-values at or below alpha are copied, and the cutoff among them is found by selection rather than sorting.
+/// </remarks>
+/// <param name="cutoff">Receives the p-value cutoff, or NaN if nothing is significant.</param>
+/// <param name="p">A vector of np p-values.</param>
+/// <param name="np">The number of elements in p.</param>
+/// <param name="alpha">The significance level.</param>
+ErrorCode	SGoF(double* cutoff, const double p[], size_t np, double alpha);
+/// <summary>
+/// Calculates a p-value cutoff using Benjamini-Hochberg control of the false discovery rate.
+/// </summary>
+/// <remarks>
+/// Only p-values at or below alpha can ever pass the test, so only those are copied and sorted.
+/// </remarks>
+/// <param name="cutoff">Receives the p-value cutoff, or NaN if nothing is significant.</param>
+/// <param name="p">A vector of np p-values.</param>
+/// <param name="np">The number of elements in p.</param>
+/// <param name="alpha">The false discovery rate to be controlled.</param>
+ErrorCode	FDR(double* cutoff, const double p[], size_t np, double alpha);
+/// <summary>
+/// Thresholds a real data distribution for statistical significance using an empirical null distribution.
+/// </summary>
+/// <remarks>
+/// Cutoffs are order statistics of the null distribution, which are found by selection instead of by sorting it. The null
+/// distribution is only sorted in full when Benjamini-Hochberg control needs p-values for many data points.
+/// </remarks>
+/// <param name="cutoffs">Receives the lower and upper data cutoffs. Cutoffs for tails that aren't tested are NaN.</param>
+/// <param name="pcutoff">Receives the p-value that corresponds with the data cutoffs.</param>
+/// <param name="r">The real data distribution. NaNs and zeros must be removed beforehand.</param>
+/// <param name="lr">The number of elements in r.</param>
+/// <param name="n">The null data distribution. NaNs and zeros must be removed beforehand, but it need not be sorted.</param>
+/// <param name="ln">The number of elements in n.</param>
+/// <param name="t">The tails of the distribution that are tested.</param>
+/// <param name="alpha">The significance level.</param>
+/// <param name="method">The method used to control the family-wise error rate.</param>
+ErrorCode	Threshold(double cutoffs[2], double* pcutoff, const double r[], size_t lr, const double n[], size_t ln, Tails t, double alpha, Correction method);
+
+/// <summary>
+/// Generates p-values for data using an empirically derived null distribution.
+/// </summary>
+/// <param name="p">An output vector of length lr that receives one p-value per element of r.</param>
+/// <param name="r">The real data distribution. NaNs and zeros must be removed beforehand.</param>
+/// <param name="lr">The number of elements in r.</param>
+/// <param name="n">The null data distribution. This must be sorted into ascending order.</param>
+/// <param name="ln">The number of elements in n.</param>
+/// <param name="t">The tail of the distribution that p-values are generated for.</param>
+ErrorCode	EmpiricalCDF(double p[], const double r[], size_t lr, const double n[], size_t ln, Tails t);
+/// <summary>
+/// Generates p-values for data using an empirically derived null distribution that hasn't been cleaned up or sorted.
+/// </summary>
+/// <remarks>
+/// NaNs and zeros are treated as missing data in both distributions. The valid null values are compacted into a new
+/// buffer and radix sorted there, which takes about twice as much memory as the valid null values themselves. Real data
+/// are never copied. P-values are written straight to the elements of the output that correspond with them, and missing
+/// real data get NaN p-values. If the null distribution holds no valid values at all, every p-value is NaN.
+/// </remarks>
+/// <param name="p">An output vector of length lr that receives one p-value per element of r.</param>
+/// <param name="r">The real data distribution, which may contain NaNs and zeros.</param>
+/// <param name="lr">The number of elements in r.</param>
+/// <param name="n">The null data distribution, which may contain NaNs and zeros and does not need to be sorted.</param>
+/// <param name="ln">The number of elements in n.</param>
+/// <param name="t">The tail of the distribution that p-values are generated for.</param>
+ErrorCode	EmpiricalCDFRaw(double p[], const double r[], size_t lr, const double n[], size_t ln, Tails t);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
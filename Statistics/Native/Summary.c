@@ -0,0 +1,258 @@
+/* SUMMARY - Single pass summary statistics over arrays of any numeric class. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Replaces the separate passes that min, max, isnan, mean, var & histc each took over volumes & signals.
+ *		20261017:	Histogram limits are only read in the pass that counts them, after the chunk statistics have been set up.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Arena.h"
+#include "Parallel.h"
+#include "Statistics.h"
+
+
+
+/* CONSTANTS */
+#define BLOCK			1024		// The number of values widened into double precision at once, which stays resident in L1.
+#define CHUNK			(1 << 16)	// The number of values that each task summarizes.
+
+
+
+/* DATA */
+/// <summary>
+/// Holds the running statistics of part of a column, which can be merged with those of any other part.
+/// </summary>
+typedef struct
+{
+	size_t		Count;			// The number of values that aren't NaNs.
+	size_t		NumNaNs;		// The number of NaNs.
+	double		Min;			// The smallest value, or +Inf if there are none.
+	double		Max;			// The largest value, or -Inf if there are none.
+	double		Sum;			// The sum of the values.
+	double		Mean;			// The mean of the values.
+	double		M2;				// The sum of squared deviations from the mean.
+}Partial;
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Widens a contiguous run of single precision or integer elements into double precision.
+/// </summary>
+/// <remarks>
+/// Every type gets its own loop so that each one vectorizes.
+/// </remarks>
+static void widenany(double z[], const void* data, Precision class, size_t first, int count)
+{
+	switch (class)
+	{
+		case SinglePrecision:	{ const float* x = (const float*)data + first;		for (int a = 0; a < count; a++) { z[a] = x[a]; } break; }
+		case Int8Precision:		{ const int8_t* x = (const int8_t*)data + first;	for (int a = 0; a < count; a++) { z[a] = x[a]; } break; }
+		case UInt8Precision:	{ const uint8_t* x = (const uint8_t*)data + first;	for (int a = 0; a < count; a++) { z[a] = x[a]; } break; }
+		case Int16Precision:	{ const int16_t* x = (const int16_t*)data + first;	for (int a = 0; a < count; a++) { z[a] = x[a]; } break; }
+		case UInt16Precision:	{ const uint16_t* x = (const uint16_t*)data + first;	for (int a = 0; a < count; a++) { z[a] = x[a]; } break; }
+		case Int32Precision:	{ const int32_t* x = (const int32_t*)data + first;	for (int a = 0; a < count; a++) { z[a] = x[a]; } break; }
+		default:				{ const uint32_t* x = (const uint32_t*)data + first;	for (int a = 0; a < count; a++) { z[a] = x[a]; } break; }
+	}
+}
+/// <summary>
+/// Merges the statistics of one part of a column into those of another, using Chan's pairwise update for the moments.
+/// </summary>
+static void merge(Partial* p, const Partial* q)
+{
+	if (q->Count)
+	{
+		size_t n = p->Count + q->Count;
+		double delta = q->Mean - p->Mean;
+		p->Mean += delta * ((double)q->Count / n);
+		p->M2 += q->M2 + delta * delta * ((double)p->Count * q->Count / n);
+		p->Count = n;
+		p->Sum += q->Sum;
+		p->Min = (q->Min < p->Min) ? q->Min : p->Min;
+		p->Max = (q->Max > p->Max) ? q->Max : p->Max;
+	}
+	p->NumNaNs += q->NumNaNs;
+}
+/// <summary>
+/// Counts the values of a block that fall into each of NB equal-width bins spanning [lo, hi].
+/// </summary>
+/// <remarks>
+/// The last bin includes its upper edge. NaNs & values outside of the limits aren't counted.
+/// </remarks>
+static void histogram(size_t counts[], const double z[], int count, int nbins, double lo, double hi)
+{
+	double scale = (hi > lo) ? nbins / (hi - lo) : 0;
+	for (int a = 0; a < count; a++)
+	{
+		if (!(z[a] >= lo && z[a] <= hi)) { continue; }
+		int bin = (int)((z[a] - lo) * scale);
+		counts[(bin >= nbins) ? nbins - 1 : bin]++;
+	}
+}
+/// <summary>
+/// Summarizes a block of values that has been widened into double precision.
+/// </summary>
+/// <remarks>
+/// Extrema, counts & the sum are found in one vectorized sweep. The squared deviations are then summed around the mean
+/// of the block while it is still in L1, which is as accurate as a two-pass algorithm but only reads memory once.
+/// </remarks>
+static void summarizeblock(Partial* p, const double z[], int count)
+{
+	Partial b = { 0, 0, INFINITY, -INFINITY, 0, 0, 0 };
+	double lo = INFINITY, hi = -INFINITY, sum = 0, nans = 0;
+
+	// Comparisons with NaN are false, so NaNs never become extrema
+	#pragma omp simd reduction(+:sum, nans) reduction(min:lo) reduction(max:hi)
+	for (int a = 0; a < count; a++)
+	{
+		double v = z[a];
+		int nan = (v != v);
+		nans += nan;
+		sum += nan ? 0.0 : v;
+		lo = (v < lo) ? v : lo;
+		hi = (v > hi) ? v : hi;
+	}
+
+	b.NumNaNs = (size_t)nans;
+	b.Count = (size_t)count - b.NumNaNs;
+	b.Min = lo;
+	b.Max = hi;
+	b.Sum = sum;
+	b.Mean = b.Count ? sum / b.Count : 0;
+
+	// Blocks without NaNs are by far the most common, and don't need to check for them
+	double m2 = 0, mean = b.Mean;
+	if (b.NumNaNs == 0)
+	{
+		#pragma omp simd reduction(+:m2)
+		for (int a = 0; a < count; a++)
+			m2 += (z[a] - mean) * (z[a] - mean);
+	}
+	else
+	{
+		for (int a = 0; a < count; a++)
+		{
+			if (z[a] == z[a])
+				m2 += (z[a] - mean) * (z[a] - mean);
+		}
+	}
+	b.M2 = m2;
+
+	merge(p, &b);
+}
+
+
+
+/* FUNCTIONS */
+ErrorCode Summarize(Summary s[], FrameArray x, size_t counts[], int nbins, const double limits[2])
+{
+	if (x.NumVoxels == 0 || x.NumFrames == 0)						{ return EmptyInput; }
+	if (x.Class < DoublePrecision || x.Class > UInt32Precision)		{ return InvalidArgument; }
+	if (counts && nbins < 1)										{ return InvalidArgument; }
+
+	size_t nrx = x.NumVoxels;
+	int ncx = x.NumFrames;
+	size_t nchunks = (nrx + CHUNK - 1) / CHUNK;
+	size_t ntasks = nchunks * ncx;
+	size_t stride = nrx * elementsize(x.Class);
+	int bins = counts ? nbins : 0;
+
+	size_t szpartials = aligned(ntasks * sizeof(Partial));
+	size_t szcounts = aligned(ntasks * bins * sizeof(size_t));
+	size_t szthread = aligned(BLOCK * sizeof(double));
+	Arena* arena = arenaacquire(szpartials + szcounts + maxthreads() * szthread);
+	if (!arena) { return OutOfMemory; }
+
+	Partial* partials = (Partial*)arenaalloc(arena, szpartials);
+	size_t* pcounts = bins ? (size_t*)arenaalloc(arena, szcounts) : NULL;
+	char* buffers = (char*)arenaalloc(arena, maxthreads() * szthread);
+
+	// Histograms with fixed limits are counted in the same sweep. Otherwise they need the extrema of each column first.
+	for (int pass = 0; pass < ((bins && !limits) ? 2 : 1); pass++)
+	{
+		int moments = (pass == 0);
+
+		#pragma omp parallel for schedule(dynamic, 1)
+		for (ptrdiff_t a = 0; a < (ptrdiff_t)ntasks; a++)
+		{
+			double* z = (double*)(buffers + threadid() * szthread);
+			int column = (int)(a / nchunks);
+			size_t first = (a % nchunks) * CHUNK;
+			size_t last = (nrx - first < CHUNK) ? nrx : first + CHUNK;
+			const void* data = (const char*)x.Data + column * stride;
+
+			Partial* p = partials + a;
+			size_t* pc = (bins && (limits || !moments)) ? pcounts + a * bins : NULL;
+			if (moments)
+			{
+				Partial empty = { 0, 0, INFINITY, -INFINITY, 0, 0, 0 };
+				*p = empty;
+			}
+
+			// Without limits, histograms span the extrema that the first pass merged into every chunk of the column
+			double lo = 0, hi = 0;
+			if (pc)
+			{
+				lo = limits ? limits[0] : p->Min;
+				hi = limits ? limits[1] : p->Max;
+				memset(pc, 0, bins * sizeof(size_t));
+			}
+
+			for (size_t b = first; b < last; b += BLOCK)
+			{
+				// Double precision values are already in the right form & can be summarized in place
+				int count = (last - b < BLOCK) ? (int)(last - b) : BLOCK;
+				const double* zb = (x.Class == DoublePrecision) ? (const double*)data + b : z;
+				if (x.Class != DoublePrecision)
+					widenany(z, data, x.Class, b, count);
+
+				if (moments)
+					summarizeblock(p, zb, count);
+				if (pc)
+					histogram(pc, zb, count, bins, lo, hi);
+			}
+		}
+
+		if (!moments) { continue; }
+
+		// Merge the chunks of each column, so that every chunk of the second pass sees the extrema of its whole column
+		#pragma omp parallel for schedule(static)
+		for (int a = 0; a < ncx; a++)
+		{
+			Partial* p = partials + (size_t)a * nchunks;
+			for (size_t b = 1; b < nchunks; b++)
+				merge(p, p + b);
+			for (size_t b = 1; b < nchunks; b++)
+				p[b] = p[0];
+		}
+	}
+
+	#pragma omp parallel for schedule(static)
+	for (int a = 0; a < ncx; a++)
+	{
+		const Partial* p = partials + (size_t)a * nchunks;
+		s[a].Count = p->Count;
+		s[a].NumNaNs = p->NumNaNs;
+		s[a].Min = p->Count ? p->Min : NAN;
+		s[a].Max = p->Count ? p->Max : NAN;
+		s[a].Sum = p->Sum;
+		s[a].Mean = p->Count ? p->Mean : NAN;
+		s[a].Variance = (p->Count > 1) ? p->M2 / (p->Count - 1) : (p->Count == 1) ? 0 : NAN;
+
+		if (!bins) { continue; }
+		size_t* ca = counts + (size_t)a * bins;
+		memset(ca, 0, bins * sizeof(size_t));
+		for (size_t b = 0; b < nchunks; b++)
+		{
+			const size_t* pc = pcounts + ((size_t)a * nchunks + b) * bins;
+			for (int c = 0; c < bins; c++)
+				ca[c] += pc[c];
+		}
+	}
+
+	arenarelease(arena);
+	return Success;
+}
@@ -0,0 +1,267 @@
+/* SURROGATE - Builds null distributions of correlation coefficients from surrogate signals. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Null distributions are now sorted in parallel by sortdoubles.
+ *		20261017:	Transform plans now come from the plan cache, so repeated calls of the same length skip building them.
+ *		20261017:	Phase randomization now uses exact length-M transforms instead of zero-padding signals to a power of two, which
+ *					smeared their spectra & kept surrogates from having exactly the same power spectrum as the original signals.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Arena.h"
+#include "FFT.h"
+#include "Matrix.h"
+#include "Parallel.h"
+#include "Random.h"
+#include "Sort.h"
+#include "Statistics.h"
+
+
+
+/* CONSTANTS */
+#define TWOPI		6.283185307179586476925286766559
+
+
+
+/* DATA */
+/// <summary>
+/// Per-thread workspace for generating surrogate signals.
+/// </summary>
+typedef struct
+{
+	double*		Signal;			// The surrogate signal being built (M elements).
+	Complex*	Spectrum;		// A phase randomized spectrum (M / 2 + 1 elements).
+	Complex*	Phases;			// Unit phasors that rotate each frequency bin (M / 2 + 1 elements).
+	Complex*	Work;			// Workspace for exact length-M transforms (see dftworksize).
+	int*		Blocks;			// The order in which blocks are concatenated.
+}Workspace;
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Draws the random transformation that one surrogate data set applies to every signal.
+/// </summary>
+/// <returns>The number of samples to rotate signals by for CircularShift, or zero otherwise.</returns>
+static int drawsurrogate(Workspace* w, Random* rng, Surrogate method, int nsamples, int nbins, int nblocks)
+{
+	switch (method)
+	{
+		case CircularShift:
+			return 1 + (int)rngbelow(rng, (uint64_t)(nsamples - 1));
+
+		case PhaseRandomize:
+		{
+			// The DC bin, and the Nyquist bin of even length signals, must stay real for the randomized signal to be real
+			int nrandom = (nsamples % 2 == 0) ? nbins - 1 : nbins;
+			w->Phases[0].re = 1.0;
+			w->Phases[0].im = 0.0;
+			for (int a = 1; a < nrandom; a++)
+			{
+				double phi = TWOPI * rnguniform(rng);
+				w->Phases[a].re = cos(phi);
+				w->Phases[a].im = sin(phi);
+			}
+			for (int a = nrandom; a < nbins; a++)
+			{
+				w->Phases[a].re = 1.0;
+				w->Phases[a].im = 0.0;
+			}
+			return 0;
+		}
+
+		case BlockPermute:
+			// Fisher-Yates shuffle
+			for (int a = 0; a < nblocks; a++)
+				w->Blocks[a] = a;
+			for (int a = nblocks - 1; a > 0; a--)
+			{
+				int b = (int)rngbelow(rng, (uint64_t)(a + 1));
+				int t = w->Blocks[a];
+				w->Blocks[a] = w->Blocks[b];
+				w->Blocks[b] = t;
+			}
+			return 0;
+
+		default:
+			return 0;
+	}
+}
+/// <summary>
+/// Builds the standardized surrogate of one signal in the workspace's signal buffer.
+/// </summary>
+/// <param name="x">The original signal.</param>
+/// <param name="F">The exact spectrum of the signal, which is only needed for PhaseRandomize.</param>
+static void buildsurrogate(Workspace* w, const double x[], const Complex F[], Surrogate method, int nsamples, int shift, const DFTPlan* plan, int blocksize, int nblocks)
+{
+	double* z = w->Signal;
+	switch (method)
+	{
+		case CircularShift:
+			memcpy(z, x + shift, (size_t)(nsamples - shift) * sizeof(double));
+			memcpy(z + nsamples - shift, x, (size_t)shift * sizeof(double));
+			break;
+
+		case PhaseRandomize:
+		{
+			int nbins = nsamples / 2 + 1;
+			for (int a = 0; a < nbins; a++)
+			{
+				w->Spectrum[a].re = F[a].re * w->Phases[a].re - F[a].im * w->Phases[a].im;
+				w->Spectrum[a].im = F[a].re * w->Phases[a].im + F[a].im * w->Phases[a].re;
+			}
+			irdft(plan, z, w->Spectrum, w->Work);
+			break;
+		}
+
+		case BlockPermute:
+			for (int a = 0, idxZ = 0; a < nblocks; a++)
+			{
+				int first = w->Blocks[a] * blocksize;
+				int len = (nsamples - first < blocksize) ? nsamples - first : blocksize;
+				memcpy(z + idxZ, x + first, (size_t)len * sizeof(double));
+				idxZ += len;
+			}
+			break;
+	}
+
+	standardize(z, z, nsamples);
+}
+
+
+
+/* FUNCTIONS */
+/// <summary>
+/// Builds a null distribution of correlation coefficients by correlating surrogates of the signals in X with Y.
+/// </summary>
+/// <remarks>
+/// Signals in Y are standardized once, and each surrogate signal is standardized as it is built, so every correlation
+/// coefficient is a single dot product. Surrogate data sets are distributed across threads. For PhaseRandomize, the exact
+/// length-M spectra of the signals in X are cached in batches that fit within the memory budget, so each signal is
+/// transformed forward only once per batch and each surrogate only costs one inverse transform.
+/// </remarks>
+ErrorCode NullCorrelate(double null[], size_t* nnull, SignalArray x, SignalArray y, Surrogate method, int nsurrogates, int blocksize, uint64_t seed)
+{
+	*nnull = 0;
+	if (x.NumSamples == 0 || x.NumSignals == 0 || y.NumSignals == 0)	{ return EmptyInput; }
+	if (x.NumSamples != y.NumSamples)								{ return SizeMismatch; }
+	if (nsurrogates <= 0 || x.NumSamples < 2)						{ return InvalidArgument; }
+	if (method < CircularShift || method > BlockPermute)			{ return InvalidArgument; }
+	if (method == BlockPermute && (blocksize < 1 || blocksize >= x.NumSamples))	{ return InvalidArgument; }
+
+	int nrx = x.NumSamples;
+	int ncx = x.NumSignals;
+	int ncy = y.NumSignals;
+	int nthreads = maxthreads();
+	int phase = (method == PhaseRandomize);
+
+	DFTPlan* plan = phase ? dftplan(nrx) : NULL;
+	if (phase && !plan) { return OutOfMemory; }
+
+	int nbins = phase ? nrx / 2 + 1 : 0;
+	int nblocks = (method == BlockPermute) ? (nrx + blocksize - 1) / blocksize : 0;
+
+	size_t szsignal = aligned((size_t)nrx * sizeof(double));
+	size_t szspec = aligned((size_t)nbins * sizeof(Complex));
+	size_t szwork = aligned((size_t)(phase ? dftworksize(plan) : 0) * sizeof(Complex));
+	size_t szthread = szsignal + 2 * szspec + szwork + aligned((size_t)nblocks * sizeof(int));
+	size_t fixed = (size_t)ncy * szsignal + nthreads * szthread;
+
+	// Only phase randomization caches anything per signal in X, so its batches are the only ones limited by the budget
+	int bx = ncx;
+	if (phase)
+	{
+		size_t budget = GetMemoryBudget();
+		size_t nfit = (budget > fixed) ? (budget - fixed) / szspec : 1;
+		bx = (nfit < (size_t)ncx) ? (int)nfit : ncx;
+		bx = (bx < 1) ? 1 : bx;
+	}
+
+	Arena* arena = arenaacquire(fixed + (phase ? (size_t)bx * szspec : 0));
+	if (!arena)
+	{
+		dftfree(plan);
+		return OutOfMemory;
+	}
+
+	size_t ldZ = szsignal / sizeof(double);
+	size_t ldF = szspec / sizeof(Complex);
+	double* zy = (double*)arenaalloc(arena, (size_t)ncy * szsignal);
+	char* buffers = (char*)arenaalloc(arena, nthreads * szthread);
+	Complex* Fx = phase ? (Complex*)arenaalloc(arena, (size_t)bx * szspec) : NULL;
+
+	#pragma omp parallel for schedule(static)
+	for (int a = 0; a < ncy; a++)
+		standardize(zy + a * ldZ, column(y, a), nrx);
+
+	for (int x0 = 0; x0 < ncx; x0 += bx)
+	{
+		int nbx = (ncx - x0 < bx) ? ncx - x0 : bx;
+
+		if (phase)
+		{
+			#pragma omp parallel for schedule(static)
+			for (int a = 0; a < nbx; a++)
+			{
+				Complex* work = (Complex*)(buffers + threadid() * szthread + szsignal + 2 * szspec);
+				rdft(plan, Fx + a * ldF, column(x, x0 + a), work);
+			}
+		}
+
+		#pragma omp parallel
+		{
+			char* buffer = buffers + threadid() * szthread;
+			Workspace w;
+			w.Signal = (double*)buffer;
+			w.Spectrum = (Complex*)(buffer + szsignal);
+			w.Phases = w.Spectrum + ldF;
+			w.Work = (Complex*)(buffer + szsignal + 2 * szspec);
+			w.Blocks = (int*)(buffer + szsignal + 2 * szspec + szwork);
+
+			#pragma omp for schedule(dynamic, 1)
+			for (int s = 0; s < nsurrogates; s++)
+			{
+				// Reseeding every batch reproduces exactly the same transformation for every signal in the data set
+				Random rng;
+				rngseed(&rng, seed, (uint64_t)s);
+				int shift = drawsurrogate(&w, &rng, method, nrx, nbins, nblocks);
+
+				for (int a = 0; a < nbx; a++)
+				{
+					int idxX = x0 + a;
+					buildsurrogate(&w, column(x, idxX), phase ? Fx + a * ldF : NULL, method, nrx, shift, plan, blocksize, nblocks);
+
+					for (int b = 0; b < ncy; b++)
+					{
+						const double* zb = zy + b * ldZ;
+						double r = 0;
+						#pragma omp simd reduction(+:r)
+						for (int c = 0; c < nrx; c++)
+							r += w.Signal[c] * zb[c];
+
+						null[((size_t)s * ncy + b) * ncx + idxX] = r;
+					}
+				}
+			}
+		}
+	}
+
+	dftfree(plan);
+	arenarelease(arena);
+
+	// Drop the values that EmpiricalCDF can't use, then put the rest in order
+	size_t nnc = (size_t)nsurrogates * ncx * ncy;
+	size_t count = 0;
+	for (size_t a = 0; a < nnc; a++)
+	{
+		if (null[a] != 0 && !isnan(null[a]))
+			null[count++] = null[a];
+	}
+
+	sortdoubles(null, count);
+	*nnull = count;
+	return Success;
+}
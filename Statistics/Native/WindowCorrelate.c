@@ -0,0 +1,326 @@
+/* WINDOWCORRELATE - Computes the sliding window correlation between an array of signals and one or more other signals. */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ *		20261017:	Moved out of Statistics/Mex/MexWindowCorrelate.c so that it can be used without MATLAB.
+ *		20261017:	Replaced the per-window correlation with an incremental engine that slides running sums forward by the window
+ *					increment, so heavily overlapping windows cost O(increment) per step instead of O(window).
+ *		20261017:	Added a single precision version that widens signals into per-thread buffers and reuses the same engine.
+ *		20261017:	Added phase timers & counters for profiling.
+ *		20261017:	Moved scheduling onto the work-stealing loop scheduler, which splits every pair into chunks of windows so that a
+ *					few long signal pairs still keep every thread busy.
+ */
+
+#include <math.h>
+#include "Arena.h"
+#include "Parallel.h"
+#include "Profile.h"
+#include "Simd.h"
+#include "Statistics.h"
+
+
+
+/* CONSTANTS */
+#define REFRESH		4		// Running sums are recomputed exactly after sliding this many window lengths.
+#define SPLIT		8192	// The number of samples that a chunk of windows slides across, before rounding.
+
+
+
+/* DATA */
+/// <summary>
+/// Describes the (pair, chunk) tasks of a sliding window correlation.
+/// </summary>
+/// <remarks>
+/// Tasks are numbered chunk by chunk, so that a thread working through a contiguous range of them mostly keeps to the
+/// same signal from Y.
+/// </remarks>
+typedef struct
+{
+	void*			SWC;			// The output array, of the same precision as X & Y.
+	const void*		X;				// The first sample of the first signal in X.
+	const void*		Y;				// The first sample of the first signal in Y.
+	int				LDX;			// The distance between the first samples of successive signals in X.
+	int				LDY;			// The distance between the first samples of successive signals in Y.
+	int				NumX;			// The number of signals in X.
+	int				NumPairs;		// The number of signal pairs.
+	int				NumWindows;		// The number of windows in every pair.
+	int				ChunkSize;		// The number of windows in every chunk but the last.
+	int				Window;			// The number of samples in a single window.
+	int				Increment;		// The number of samples that the window moves between estimates.
+	Precision		Class;			// The precision of X, Y & the output.
+	char*			Buffers;		// Per-thread workspace for widening single precision chunks.
+	size_t			SizeColumn;		// The bytes set aside in each workspace for one widened chunk of samples.
+	size_t			SizeBuffer;		// The bytes in each workspace.
+}Windows;
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Gets the number of windows after which swcorr recomputes its running sums exactly.
+/// </summary>
+/// <remarks>
+/// Running sums depend on every window since the last refresh, so chunks of windows that start on a multiple of this
+/// period produce exactly the same coefficients as one long run.
+/// </remarks>
+static int refreshperiod(int window, int increment)
+{
+	return (2 * increment >= window) ? 1 : (REFRESH * window) / increment;
+}
+/// <summary>
+/// Gets the number of windows in each chunk that a pair of signals is split into.
+/// </summary>
+static int chunksize(int window, int increment)
+{
+	int period = refreshperiod(window, increment);
+	int chunk = ((SPLIT / increment + period - 1) / period) * period;
+	return (chunk > 0) ? chunk : period;
+}
+/// <summary>
+/// Computes the sliding window correlation time series between two signals using running sums.
+/// </summary>
+/// <remarks>
+/// Samples are shifted by the mean of the window in which the sums were last computed exactly. Centering keeps the
+/// running sums small so that adding and removing samples does not lose precision to cancellation, and recomputing the
+/// sums (and their centers) every few window lengths keeps rounding errors from drifting over long recordings.
+/// </remarks>
+/// <param name="swc">An output vector that receives nswc correlation coefficients.</param>
+/// <param name="x">A signal vector.</param>
+/// <param name="y">A second signal vector of the same length as x.</param>
+/// <param name="window">The number of samples in a single window.</param>
+/// <param name="increment">The number of samples that the window moves between estimates.</param>
+/// <param name="nswc">The number of windows to compute.</param>
+static void swcorr(double swc[], const double x[], const double y[], int window, int increment, int nswc)
+{
+	// Without enough overlap between windows, sliding is no cheaper than starting over
+	if (2 * increment >= window)
+	{
+		for (int a = 0; a < nswc; a++)
+			swc[a] = corr(x + (size_t)a * increment, y + (size_t)a * increment, window);
+		return;
+	}
+
+	int refresh = refreshperiod(window, increment);
+	double n = (double)window;
+	double cx = 0, cy = 0, sx = 0, sy = 0, sxy = 0, ssx = 0, ssy = 0;
+
+	for (int a = 0; a < nswc; a++)
+	{
+		const double* wx = x + (size_t)a * increment;
+		const double* wy = y + (size_t)a * increment;
+
+		if (a % refresh == 0)
+		{
+			cx = cy = 0;
+			for (int b = 0; b < window; b++)
+			{
+				cx += wx[b];
+				cy += wy[b];
+			}
+			cx /= n;
+			cy /= n;
+
+			sx = sy = sxy = ssx = ssy = 0;
+			for (int b = 0; b < window; b++)
+			{
+				double u = wx[b] - cx;
+				double v = wy[b] - cy;
+				sx += u;
+				sy += v;
+				sxy += u * v;
+				ssx += u * u;
+				ssy += v * v;
+			}
+		}
+		else
+		{
+			// Drop the samples that just left the window & add the ones that just entered it
+			const double* ox = wx - increment;
+			const double* oy = wy - increment;
+			const double* ix = wx + window - increment;
+			const double* iy = wy + window - increment;
+			for (int b = 0; b < increment; b++)
+			{
+				double u = ox[b] - cx;
+				double v = oy[b] - cy;
+				sx -= u;
+				sy -= v;
+				sxy -= u * v;
+				ssx -= u * u;
+				ssy -= v * v;
+
+				u = ix[b] - cx;
+				v = iy[b] - cy;
+				sx += u;
+				sy += v;
+				sxy += u * v;
+				ssx += u * u;
+				ssy += v * v;
+			}
+		}
+
+		double cov = (n * sxy) - (sx * sy);
+		double scale = sqrt((n * ssx) - (sx * sx)) * sqrt((n * ssy) - (sy * sy));
+		swc[a] = cov / scale;
+	}
+}
+/// <summary>
+/// Computes one chunk of windows from every (pair, chunk) task in a range.
+/// </summary>
+static void windowchunks(void* args, size_t first, size_t last, int worker)
+{
+	const Windows* w = (const Windows*)args;
+	char* buffer = w->Buffers ? w->Buffers + (size_t)worker * w->SizeBuffer : NULL;
+	int lastY = -1, lastChunk = -1;
+
+	for (size_t a = first; a < last; a++)
+	{
+		int chunk = (int)(a / w->NumPairs);
+		int pair = (int)(a % w->NumPairs);
+		int idxY = pair / w->NumX;
+		int start = chunk * w->ChunkSize;
+		int count = (w->NumWindows - start < w->ChunkSize) ? w->NumWindows - start : w->ChunkSize;
+
+		size_t offset = (size_t)start * w->Increment;
+		size_t idxX = (size_t)(pair % w->NumX) * w->LDX + offset;
+		size_t idxSWC = (size_t)pair * w->NumWindows + start;
+		double t;
+
+		if (w->Class == DoublePrecision)
+		{
+			t = phasestart();
+			const double* y = (const double*)w->Y + (size_t)idxY * w->LDY + offset;
+			swcorr((double*)w->SWC + idxSWC, (const double*)w->X + idxX, y, w->Window, w->Increment, count);
+			phaseend(DirectPhase, t);
+			continue;
+		}
+
+		// Only the samples that this chunk of windows slides across are widened
+		double* wx = (double*)buffer;
+		double* wy = (double*)(buffer + w->SizeColumn);
+		double* ws = (double*)(buffer + 2 * w->SizeColumn);
+		size_t span = (size_t)(count - 1) * w->Increment + w->Window;
+
+		t = phasestart();
+		if (idxY != lastY || chunk != lastChunk)
+		{
+			widen(wy, (const float*)w->Y + (size_t)idxY * w->LDY + offset, span);
+			lastY = idxY;
+			lastChunk = chunk;
+		}
+		widen(wx, (const float*)w->X + idxX, span);
+		phaseend(PreparePhase, t);
+
+		t = phasestart();
+		swcorr(ws, wx, wy, w->Window, w->Increment, count);
+		phaseend(DirectPhase, t);
+
+		t = phasestart();
+		narrow((float*)w->SWC + idxSWC, ws, (size_t)count);
+		phaseend(StorePhase, t);
+	}
+}
+
+
+
+/* FUNCTIONS */
+
+/// <summary>
+/// Calculates the number of correlation estimates that a sliding window correlation produces for each signal pairing.
+/// </summary>
+/// <param name="nsamples">The number of samples in the signals being correlated.</param>
+/// <param name="window">The number of samples in a single window.</param>
+/// <param name="noverlap">The number of samples that successive windows share.</param>
+/// <returns>The number of windows, i.e. floor((nsamples - window) / (window - noverlap)), or zero if there are none.</returns>
+int WindowCount(int nsamples, int window, int noverlap)
+{
+	// Integer division always rounds this downward, which keeps indexing in bounds even for very long signals where a
+	// floating point quotient might otherwise get rounded up.
+	int increment = window - noverlap;
+	if (window <= 0 || increment <= 0 || nsamples < window) { return 0; }
+	return (nsamples - window) / increment;
+}
+/// <summary>
+/// Computes the sliding window correlation between every signal in X and every signal in Y.
+/// </summary>
+/// <param name="swc">An [MC x (NX * NY)] output array that receives the correlation time series (see WindowCount).</param>
+/// <param name="x">An [M x NX] array of signals.</param>
+/// <param name="y">An [M x NY] array of signals.</param>
+/// <param name="window">The number of samples in a single window.</param>
+/// <param name="noverlap">The number of samples that successive windows share. This must be in [0, window - 1].</param>
+ErrorCode WindowCorrelate(double swc[], SignalArray x, SignalArray y, int window, int noverlap)
+{
+	if (x.NumSamples == 0 || y.NumSamples == 0)		{ return EmptyInput; }
+	if (x.NumSamples != y.NumSamples)				{ return SizeMismatch; }
+	if (window <= 0 || noverlap < 0 || noverlap >= window)	{ return InvalidArgument; }
+
+	int ncx = x.NumSignals;
+	int ncy = y.NumSignals;
+	int increment = window - noverlap;
+	int nswc = WindowCount(x.NumSamples, window, noverlap);
+
+	if (nswc == 0 || ncx == 0 || ncy == 0) { return Success; }
+
+	kernelbegin("WindowCorrelate");
+	profilecount(((size_t)x.NumSamples * (ncx + ncy) + (size_t)nswc * ncx * ncy) * sizeof(double), (size_t)ncx * ncy);
+
+	int chunk = chunksize(window, increment);
+	int nchunks = (nswc + chunk - 1) / chunk;
+	Windows w = { swc, x.Data, y.Data, x.Stride, y.Stride, ncx, ncx * ncy, nswc, chunk, window, increment, DoublePrecision, NULL, 0, 0 };
+	parallelfor((size_t)w.NumPairs * nchunks, windowchunks, &w);
+
+	kernelend();
+	return Success;
+}
+/// <summary>
+/// Computes the sliding window correlation between every single precision signal in X and every one in Y.
+/// </summary>
+/// <remarks>
+/// Each thread widens the chunk of samples that it is working on into double precision buffers, which are small enough
+/// to stay in cache while the running sums slide over them. Main memory only ever sees the single precision data.
+/// </remarks>
+/// <param name="swc">An [MC x (NX * NY)] output array that receives the correlation time series (see WindowCount).</param>
+/// <param name="x">An [M x NX] array of signals.</param>
+/// <param name="y">An [M x NY] array of signals.</param>
+/// <param name="window">The number of samples in a single window.</param>
+/// <param name="noverlap">The number of samples that successive windows share. This must be in [0, window - 1].</param>
+ErrorCode WindowCorrelateF(float swc[], SignalArrayF x, SignalArrayF y, int window, int noverlap)
+{
+	if (x.NumSamples == 0 || y.NumSamples == 0)		{ return EmptyInput; }
+	if (x.NumSamples != y.NumSamples)				{ return SizeMismatch; }
+	if (window <= 0 || noverlap < 0 || noverlap >= window)	{ return InvalidArgument; }
+
+	int nrx = x.NumSamples;
+	int ncx = x.NumSignals;
+	int npairs = ncx * y.NumSignals;
+	int increment = window - noverlap;
+	int nswc = WindowCount(nrx, window, noverlap);
+	if (nswc == 0 || npairs == 0) { return Success; }
+
+	kernelbegin("WindowCorrelateF");
+	profilecount(((size_t)nrx * (ncx + y.NumSignals) + (size_t)nswc * npairs) * sizeof(float), (size_t)npairs);
+
+	int chunk = chunksize(window, increment);
+	int nchunks = (nswc + chunk - 1) / chunk;
+	int nthreads = maxthreads();
+	size_t span = (size_t)(chunk - 1) * increment + window;
+	size_t szcol = aligned(((span < (size_t)nrx) ? span : (size_t)nrx) * sizeof(double));
+	size_t szthread = 2 * szcol + aligned((size_t)((chunk < nswc) ? chunk : nswc) * sizeof(double));
+
+	double t = phasestart();
+	Arena* arena = arenaacquire(nthreads * szthread);
+	phaseend(PlanPhase, t);
+	if (!arena)
+	{
+		kernelend();
+		return OutOfMemory;
+	}
+
+	Windows w = { swc, x.Data, y.Data, x.Stride, y.Stride, ncx, npairs, nswc, chunk, window, increment, SinglePrecision, NULL, szcol, szthread };
+	w.Buffers = (char*)arenaalloc(arena, nthreads * szthread);
+	parallelfor((size_t)npairs * nchunks, windowchunks, &w);
+
+	arenarelease(arena);
+	kernelend();
+	return Success;
+}
@@ -0,0 +1,2127 @@
+/* TESTKERNELS - Checks the kernels of the native statistics library against direct reference calculations.
+ *
+ *	Every kernel is run over random inputs whose shapes exercise its different engines (e.g. all-pairs products, pairs
+ *	split into sample chunks, direct & transform cross-correlation, short & long sliding windows), and its results are
+ *	compared against plain loops that compute each value straight from its definition. Each check is run once on a single
+ *	thread and once on several, so that serial and parallel schedules are both covered even on machines with only one
+ *	processor.
+ *
+ *	SYNTAX:
+ *		statistics_tests
+ *
+ *	The program prints one line per check and exits with status 1 if any of them failed.
+ */
+
+/* CHANGELOG
+ * Written by Josh Grooms on 20261017
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Arena.h"
+#include "Random.h"
+#include "Statistics.h"
+
+
+
+/* CONSTANTS */
+#define TOLERANCE		1e-10		// The largest error allowed in double precision results.
+#define TOLERANCEF		1e-5		// The largest error allowed in single precision results.
+#define SEED			1			// The seed that every input is generated from.
+#define PARALLELTHREADS	4			// The number of threads that parallel schedules are checked with.
+#define MAXFULL			5000		// The longest signals whose cross-correlations are checked at every lag.
+#define MAPPEDX			"statistics_tests_x.map"	// The mapped array file that signals are stored in.
+#define MAPPEDR			"statistics_tests_r.map"	// The mapped array file that correlations are stored in.
+#define TWOPI			6.283185307179586476925286766559
+
+
+
+/* DATA */
+/// <summary>
+/// The dimensions of the inputs that one check is run with.
+/// </summary>
+typedef struct
+{
+	int				Samples;		// The number of samples in each signal (M).
+	int				SignalsX;		// The number of signals in X (NX).
+	int				SignalsY;		// The number of signals in Y (NY).
+}Shape;
+
+/// <summary>
+/// Signals in X & Y along with copies of them that have been rounded to single precision.
+/// </summary>
+typedef struct
+{
+	Shape			Shape;
+	double*			X;
+	double*			Y;
+	float*			XF;
+	float*			YF;
+}Inputs;
+
+/// <summary>
+/// The input shapes that every kernel is checked with. These cover single samples & signals, all-pairs blocks and long
+/// signal pairs that are split across threads.
+/// </summary>
+static const Shape Shapes[] =
+{
+	{ 2, 1, 1 },
+	{ 7, 1, 4 },
+	{ 100, 5, 3 },
+	{ 257, 13, 7 },
+	{ 1000, 40, 1 },
+	{ 64, 30, 30 },
+	{ 40000, 1, 2 },
+};
+static const int NumShapes = sizeof(Shapes) / sizeof(Shapes[0]);
+
+/// <summary>
+/// The window lengths & overlaps that sliding window correlations are checked with.
+/// </summary>
+static const int Windows[][2] =
+{
+	{ 3, 2 },
+	{ 10, 0 },
+	{ 10, 9 },
+	{ 16, 13 },
+	{ 50, 45 },
+};
+static const int NumWindows = sizeof(Windows) / sizeof(Windows[0]);
+
+static int failures = 0;
+
+
+
+/* SUBROUTINES */
+/// <summary>
+/// Fills an array with uniform random numbers that are offset from zero.
+/// </summary>
+static void uniform(double x[], size_t n, Random* rng)
+{
+	for (size_t a = 0; a < n; a++)
+		x[a] = 2.0 * rnguniform(rng) - 0.7;
+}
+/// <summary>
+/// Orders doubles ascending for qsort.
+/// </summary>
+static int ascending(const void* a, const void* b)
+{
+	double x = *(const double*)a, y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+/// <summary>
+/// Creates the shape that a check of inputs with up to three sizes is reported with.
+/// </summary>
+static Shape sizes(int a, int b, int c)
+{
+	Shape s = { a, b, c };
+	return s;
+}
+/// <summary>
+/// Releases the signals of a check.
+/// </summary>
+static void freeinputs(Inputs* in)
+{
+	free(in->X);
+	free(in->Y);
+	free(in->XF);
+	free(in->YF);
+}
+/// <summary>
+/// Generates random signals of some shape.
+/// </summary>
+/// <remarks>
+/// The double precision signals are rounded to single precision as well, so that single precision kernels can be checked
+/// against the same references.
+/// </remarks>
+static int createinputs(Inputs* in, Shape s)
+{
+	size_t nx = (size_t)s.Samples * s.SignalsX;
+	size_t ny = (size_t)s.Samples * s.SignalsY;
+	in->Shape = s;
+	in->X = (double*)malloc(nx * sizeof(double));
+	in->Y = (double*)malloc(ny * sizeof(double));
+	in->XF = (float*)malloc(nx * sizeof(float));
+	in->YF = (float*)malloc(ny * sizeof(float));
+	if (!in->X || !in->Y || !in->XF || !in->YF)
+	{
+		freeinputs(in);
+		return 0;
+	}
+
+	Random rng;
+	rngseed(&rng, SEED, (uint64_t)s.Samples);
+	uniform(in->X, nx, &rng);
+	uniform(in->Y, ny, &rng);
+	for (size_t a = 0; a < nx; a++)
+	{
+		in->XF[a] = (float)in->X[a];
+		in->X[a] = in->XF[a];
+	}
+	for (size_t a = 0; a < ny; a++)
+	{
+		in->YF[a] = (float)in->Y[a];
+		in->Y[a] = in->YF[a];
+	}
+	return 1;
+}
+/// <summary>
+/// Computes the Pearson correlation between two signals straight from its definition.
+/// </summary>
+static double pearson(const double x[], const double y[], int nsamples)
+{
+	double mx = 0, my = 0;
+	for (int a = 0; a < nsamples; a++)
+	{
+		mx += x[a];
+		my += y[a];
+	}
+	mx /= nsamples;
+	my /= nsamples;
+
+	double sxy = 0, sxx = 0, syy = 0;
+	for (int a = 0; a < nsamples; a++)
+	{
+		sxy += (x[a] - mx) * (y[a] - my);
+		sxx += (x[a] - mx) * (x[a] - mx);
+		syy += (y[a] - my) * (y[a] - my);
+	}
+	return sxy / sqrt(sxx * syy);
+}
+/// <summary>
+/// Computes the normalized cross-correlation between two signals at one lag straight from its definition.
+/// </summary>
+/// <param name="lag">The shift of X relative to Y.</param>
+static double crosslag(const double x[], const double y[], int nsamples, int lag)
+{
+	double sxx = 0, syy = 0, sxy = 0;
+	for (int a = 0; a < nsamples; a++)
+	{
+		sxx += x[a] * x[a];
+		syy += y[a] * y[a];
+		int b = a + lag;
+		if (b >= 0 && b < nsamples) { sxy += x[b] * y[a]; }
+	}
+	return sxy / sqrt(sxx * syy);
+}
+/// <summary>
+/// Reports the result of one check.
+/// </summary>
+/// <param name="error">The largest difference between a kernel's results and the references, or NAN if it failed.</param>
+static void report(const char* kernel, Shape s, const char* detail, ErrorCode status, double error, double tolerance)
+{
+	int passed = (status == Success) && (error <= tolerance);
+	printf("%-22s %6d %4d %4d  %-14s %.3e  %s\n", kernel, s.Samples, s.SignalsX, s.SignalsY, detail,
+		error, passed ? "ok" : (status == Success ? "FAIL" : errormsg(status)));
+	if (!passed) { failures++; }
+}
+/// <summary>
+/// Gets the largest difference between results & their references, where NaNs only match other NaNs.
+/// </summary>
+static double maxerror(const double out[], const double ref[], size_t n)
+{
+	double error = 0;
+	for (size_t a = 0; a < n; a++)
+	{
+		double d = fabs(out[a] - ref[a]);
+		if (isnan(out[a]) != isnan(ref[a])) { return INFINITY; }
+		if (d > error) { error = d; }
+	}
+	return error;
+}
+/// <summary>
+/// Gets the largest difference between single precision results & their double precision references.
+/// </summary>
+static double maxerrorf(const float out[], const double ref[], size_t n)
+{
+	double error = 0;
+	for (size_t a = 0; a < n; a++)
+	{
+		double d = fabs((double)out[a] - ref[a]);
+		if (isnan(out[a]) != isnan(ref[a])) { return INFINITY; }
+		if (d > error) { error = d; }
+	}
+	return error;
+}
+/// <summary>
+/// Checks Correlate & CorrelateF against Pearson correlations of every pair of signals.
+/// </summary>
+static void checkcorrelate(const Inputs* in)
+{
+	Shape s = in->Shape;
+	size_t npairs = (size_t)s.SignalsX * s.SignalsY;
+	double* ref = (double*)malloc(npairs * sizeof(double));
+	double* out = (double*)malloc(npairs * sizeof(double));
+	float* outf = (float*)malloc(npairs * sizeof(float));
+	if (!ref || !out || !outf) { report("Correlate", s, "", OutOfMemory, NAN, 0); goto cleanup; }
+
+	for (int a = 0; a < s.SignalsY; a++)
+		for (int b = 0; b < s.SignalsX; b++)
+			ref[(size_t)a * s.SignalsX + b] = pearson(in->X + (size_t)b * s.Samples, in->Y + (size_t)a * s.Samples, s.Samples);
+
+	ErrorCode status = Correlate(out, signals(in->X, s.Samples, s.SignalsX), signals(in->Y, s.Samples, s.SignalsY));
+	report("Correlate", s, "", status, maxerror(out, ref, npairs), TOLERANCE);
+
+	status = CorrelateF(outf, signalsf(in->XF, s.Samples, s.SignalsX), signalsf(in->YF, s.Samples, s.SignalsY));
+	report("CorrelateF", s, "", status, maxerrorf(outf, ref, npairs), TOLERANCEF);
+
+cleanup:
+	free(ref);
+	free(out);
+	free(outf);
+}
+/// <summary>
+/// Fills in the lags of one of the lag sets that CrossCorrelateLags is checked with.
+/// </summary>
+/// <remarks>
+/// Few lags are computed directly while many use transforms. Every lag is within the [-(M - 1), M - 1] range that the
+/// kernels accept.
+/// </remarks>
+/// <returns>The number of lags in the set.</returns>
+static int lagset(int lags[], int set, int nsamples, const char** name)
+{
+	int nlags = 0;
+	switch (set)
+	{
+		case 0:
+			*name = "few lags";
+			for (int a = -3; a <= 3; a++)
+				if (abs(a) < nsamples) { lags[nlags++] = a; }
+			break;
+
+		case 1:
+			*name = "edge lags";
+			lags[nlags++] = nsamples - 1;
+			lags[nlags++] = -(nsamples - 1);
+			lags[nlags++] = 0;
+			lags[nlags++] = nsamples - 1;
+			break;
+
+		default:
+			*name = "many lags";
+			int step = (nsamples > 100) ? nsamples / 50 : 2;
+			for (int a = -(nsamples - 1); a < nsamples; a += step)
+				lags[nlags++] = a;
+			break;
+	}
+	return nlags;
+}
+/// <summary>
+/// Checks CrossCorrelate, CrossCorrelateLags & their single precision versions against cross-correlations computed one
+/// lag at a time.
+/// </summary>
+/// <remarks>
+/// Every lag is only checked for shorter signals, since the reference takes O(M^2) time per pair.
+/// </remarks>
+static void checkcrosscorrelate(const Inputs* in)
+{
+	Shape s = in->Shape;
+	// Short signals can have fewer lags than the fixed lag sets
+	int maxlags = 2 * s.Samples - 1;
+	int capacity = maxlags + 4;
+	size_t npairs = (size_t)s.SignalsX * s.SignalsY;
+	double* ref = (double*)malloc(npairs * capacity * sizeof(double));
+	double* out = (double*)malloc(npairs * capacity * sizeof(double));
+	float* outf = (float*)malloc(npairs * capacity * sizeof(float));
+	int* lags = (int*)malloc(capacity * sizeof(int));
+	if (!ref || !out || !outf || !lags) { report("CrossCorrelate", s, "", OutOfMemory, NAN, 0); goto cleanup; }
+
+	SignalArray x = signals(in->X, s.Samples, s.SignalsX);
+	SignalArray y = signals(in->Y, s.Samples, s.SignalsY);
+	SignalArrayF xf = signalsf(in->XF, s.Samples, s.SignalsX);
+	SignalArrayF yf = signalsf(in->YF, s.Samples, s.SignalsY);
+
+	for (int set = (s.Samples > MAXFULL) ? 0 : -1; set < 3; set++)
+	{
+		const char* name = "all lags";
+		int nlags = maxlags;
+		if (set < 0)
+		{
+			for (int a = 0; a < nlags; a++)
+				lags[a] = a - (s.Samples - 1);
+		}
+		else
+			nlags = lagset(lags, set, s.Samples, &name);
+
+		for (size_t a = 0; a < npairs; a++)
+		{
+			const double* xa = in->X + (a % s.SignalsX) * s.Samples;
+			const double* ya = in->Y + (a / s.SignalsX) * s.Samples;
+			for (int b = 0; b < nlags; b++)
+				ref[a * nlags + b] = crosslag(xa, ya, s.Samples, lags[b]);
+		}
+
+		ErrorCode status = (set < 0) ? CrossCorrelate(out, x, y) : CrossCorrelateLags(out, x, y, lags, nlags);
+		report((set < 0) ? "CrossCorrelate" : "CrossCorrelateLags", s, name, status, maxerror(out, ref, npairs * nlags), TOLERANCE);
+
+		status = (set < 0) ? CrossCorrelateF(outf, xf, yf) : CrossCorrelateLagsF(outf, xf, yf, lags, nlags);
+		report((set < 0) ? "CrossCorrelateF" : "CrossCorrelateLagsF", s, name, status, maxerrorf(outf, ref, npairs * nlags), TOLERANCEF);
+	}
+
+cleanup:
+	free(ref);
+	free(out);
+	free(outf);
+	free(lags);
+}
+/// <summary>
+/// Checks WindowCorrelate & WindowCorrelateF against Pearson correlations of every window of every pair of signals.
+/// </summary>
+static void checkwindowcorrelate(const Inputs* in)
+{
+	Shape s = in->Shape;
+	char detail[32];
+	for (int w = 0; w < NumWindows; w++)
+	{
+		int window = Windows[w][0], noverlap = Windows[w][1];
+		int nwindows = WindowCount(s.Samples, window, noverlap);
+		if (nwindows == 0) { continue; }
+
+		size_t npairs = (size_t)s.SignalsX * s.SignalsY;
+		size_t nout = npairs * nwindows;
+		double* ref = (double*)malloc(nout * sizeof(double));
+		double* out = (double*)malloc(nout * sizeof(double));
+		float* outf = (float*)malloc(nout * sizeof(float));
+		sprintf(detail, "w%d o%d", window, noverlap);
+		if (!ref || !out || !outf)
+		{
+			report("WindowCorrelate", s, detail, OutOfMemory, NAN, 0);
+			free(ref);
+			free(out);
+			free(outf);
+			continue;
+		}
+
+		int increment = window - noverlap;
+		for (size_t a = 0; a < npairs; a++)
+		{
+			const double* x = in->X + (a % s.SignalsX) * s.Samples;
+			const double* y = in->Y + (a / s.SignalsX) * s.Samples;
+			for (int b = 0; b < nwindows; b++)
+				ref[a * nwindows + b] = pearson(x + (size_t)b * increment, y + (size_t)b * increment, window);
+		}
+
+		ErrorCode status = WindowCorrelate(out, signals(in->X, s.Samples, s.SignalsX), signals(in->Y, s.Samples, s.SignalsY), window, noverlap);
+		report("WindowCorrelate", s, detail, status, maxerror(out, ref, nout), TOLERANCE);
+
+		status = WindowCorrelateF(outf, signalsf(in->XF, s.Samples, s.SignalsX), signalsf(in->YF, s.Samples, s.SignalsY), window, noverlap);
+		report("WindowCorrelateF", s, detail, status, maxerrorf(outf, ref, nout), TOLERANCEF);
+
+		free(ref);
+		free(out);
+		free(outf);
+	}
+}
+
+
+
+/// <summary>
+/// Gets the capacity of the calling thread's persistent arena, which is the most scratch memory that any kernel called
+/// from this thread has used since the workspace was last released.
+/// </summary>
+static size_t arenasize(void)
+{
+	Arena* arena = arenaacquire(0);
+	size_t capacity = arena ? arena->Capacity : 0;
+	arenarelease(arena);
+	return capacity;
+}
+/// <summary>
+/// Checks that cross-correlations still fit their scratch memory to budgets too small to hold even one batch of spectra.
+/// </summary>
+/// <remarks>
+/// Such budgets must be exceeded by as little as possible, so the scratch memory used under a 1-byte budget must be no
+/// more than what a 64 KB budget gets, and far less than what caching the spectra of all of X would take.
+/// </remarks>
+static void checkbudget(void)
+{
+	Shape s = sizes(256, 2000, 2);
+	Inputs in;
+	if (!createinputs(&in, s)) { report("CrossCorrelate", s, "tiny budget", OutOfMemory, NAN, 0); return; }
+
+	int nlags = 2 * s.Samples - 1;
+	size_t nout = (size_t)nlags * s.SignalsX * s.SignalsY;
+	double* ref = (double*)malloc(nout * sizeof(double));
+	double* out = (double*)malloc(nout * sizeof(double));
+	if (!ref || !out) { report("CrossCorrelate", s, "tiny budget", OutOfMemory, NAN, 0); goto cleanup; }
+
+	for (size_t a = 0; a < (size_t)s.SignalsX * s.SignalsY; a++)
+	{
+		const double* x = in.X + (a % s.SignalsX) * s.Samples;
+		const double* y = in.Y + (a / s.SignalsX) * s.Samples;
+		for (int b = 0; b < nlags; b++)
+			ref[a * nlags + b] = crosslag(x, y, s.Samples, b - (s.Samples - 1));
+	}
+
+	size_t budget = GetMemoryBudget();
+	size_t used[2];
+	size_t budgets[2] = { 1, 64 << 10 };
+	ErrorCode status = Success;
+	for (int a = 0; a < 2; a++)
+	{
+		ReleaseWorkspace();
+		SetMemoryBudget(budgets[a]);
+		ErrorCode result = CrossCorrelate(out, signals(in.X, s.Samples, s.SignalsX), signals(in.Y, s.Samples, s.SignalsY));
+		used[a] = arenasize();
+		status = (status == Success) ? result : status;
+		if (a == 0) { report("CrossCorrelate", s, "tiny budget", result, maxerror(out, ref, nout), TOLERANCE); }
+	}
+	SetMemoryBudget(budget);
+	ReleaseWorkspace();
+
+	// Every signal in X has a spectrum of at least M complex values
+	size_t allx = (size_t)s.SignalsX * s.Samples * 2 * sizeof(double);
+	int bounded = (used[0] <= used[1]) && (used[0] < allx / 16);
+	printf("%-22s %6d %4d %4d  %-14s %9zu  %s\n", "CrossCorrelate", s.Samples, s.SignalsX, s.SignalsY, "arena bytes", used[0],
+		(status == Success && bounded) ? "ok" : "FAIL");
+	if (status != Success || !bounded) { failures++; }
+
+cleanup:
+	free(ref);
+	free(out);
+	freeinputs(&in);
+}
+/// <summary>
+/// Counts the values in a sorted null distribution that are less than a value & turns that into a p-value of some tail.
+/// </summary>
+static double empiricalp(const double n[], size_t ln, double value, Tails t)
+{
+	size_t count = 0;
+	for (size_t a = 0; a < ln; a++)
+		count += (n[a] < value);
+
+	double p = (double)count / (double)ln;
+	switch (t)
+	{
+		case Both:	return 2.0 * fmin(p, 1.0 - p);
+		case Left:	return p;
+		default:	return 1.0 - p;
+	}
+}
+/// <summary>
+/// Checks EmpiricalCDF against p-values found by counting null values one at a time.
+/// </summary>
+/// <remarks>
+/// Values are rounded so that many of them tie with null values, and the smallest & largest null values along with values
+/// beyond both ends of the null distribution are always included.
+/// </remarks>
+static void checkempiricalcdf(void)
+{
+	const int lengths[][2] = { { 1000, 5000 }, { 1000, 4 }, { 7, 1 } };
+	const char* tails[] = { "both tails", "left tail", "right tail" };
+
+	Random rng;
+	rngseed(&rng, SEED, 0);
+	for (int a = 0; a < 3; a++)
+	{
+		int lr = lengths[a][0], ln = lengths[a][1];
+		double* r = (double*)malloc(lr * sizeof(double));
+		double* n = (double*)malloc(ln * sizeof(double));
+		double* ref = (double*)malloc(lr * sizeof(double));
+		double* out = (double*)malloc(lr * sizeof(double));
+		if (!r || !n || !ref || !out) { report("EmpiricalCDF", sizes(lr, ln, 0), "", OutOfMemory, NAN, 0); goto next; }
+
+		uniform(r, lr, &rng);
+		uniform(n, ln, &rng);
+		for (int b = 0; b < lr; b++)
+			r[b] = round(r[b] * 20) / 20;
+		for (int b = 0; b < ln; b++)
+			n[b] = round(n[b] * 20) / 20;
+		qsort(n, ln, sizeof(double), ascending);
+		r[0] = n[0];
+		r[1] = n[ln - 1];
+		r[2] = n[0] - 1;
+		r[3] = n[ln - 1] + 1;
+
+		for (int t = Both; t <= Right; t++)
+		{
+			for (int b = 0; b < lr; b++)
+				ref[b] = empiricalp(n, ln, r[b], (Tails)t);
+
+			ErrorCode status = EmpiricalCDF(out, r, lr, n, ln, (Tails)t);
+			report("EmpiricalCDF", sizes(lr, ln, 0), tails[t], status, maxerror(out, ref, lr), TOLERANCE);
+		}
+
+	next:
+		free(r);
+		free(n);
+		free(ref);
+		free(out);
+	}
+}
+/// <summary>
+/// Checks CorrelateMapped against Pearson correlations, along with the mapped array files it reads & writes.
+/// </summary>
+/// <remarks>
+/// Signals are written to a mapped array file in both precisions & correlated in tiles of several sizes. The output is
+/// compared once while it is still mapped and again after it has been closed & reopened, which shows that bands of the
+/// output released during the call were written back to the file. Mapped array files with empty signals, corrupt headers
+/// or impossible sizes must be rejected.
+/// </remarks>
+static void checkcorrelatemapped(void)
+{
+	Shape s = sizes(120, 1000, 3);
+	Inputs in;
+	if (!createinputs(&in, s)) { report("CorrelateMapped", s, "", OutOfMemory, NAN, 0); return; }
+
+	size_t npairs = (size_t)s.SignalsX * s.SignalsY;
+	double* ref = (double*)malloc(npairs * sizeof(double));
+	if (!ref) { report("CorrelateMapped", s, "", OutOfMemory, NAN, 0); goto cleanup; }
+
+	for (size_t a = 0; a < npairs; a++)
+		ref[a] = pearson(in.X + (a % s.SignalsX) * s.Samples, in.Y + (a / s.SignalsX) * s.Samples, s.Samples);
+
+	const int tiles[] = { 0, 7, 5000 };
+	char detail[32];
+	for (int precision = DoublePrecision; precision <= SinglePrecision; precision++)
+	{
+		for (int a = 0; a < 3; a++)
+		{
+			sprintf(detail, "%s tile %d", (precision == SinglePrecision) ? "single" : "double", tiles[a]);
+
+			MappedArray x, r;
+			ErrorCode status = CreateMappedArray(&x, MAPPEDX, (Precision)precision, s.Samples, s.SignalsX);
+			if (status != Success) { report("CorrelateMapped", s, detail, status, NAN, 0); continue; }
+			if (precision == SinglePrecision)
+				memcpy(x.Data, in.XF, (size_t)s.Samples * s.SignalsX * sizeof(float));
+			else
+				memcpy(x.Data, in.X, (size_t)s.Samples * s.SignalsX * sizeof(double));
+			CloseMappedArray(&x);
+
+			status = OpenMappedArray(&x, MAPPEDX, 0);
+			if (status != Success) { report("CorrelateMapped", s, detail, status, NAN, 0); continue; }
+			status = CreateMappedArray(&r, MAPPEDR, DoublePrecision, s.SignalsX, s.SignalsY);
+			if (status == Success)
+			{
+				status = CorrelateMapped(&r, &x, signals(in.Y, s.Samples, s.SignalsY), tiles[a]);
+				report("CorrelateMapped", s, detail, status, maxerror((double*)r.Data, ref, npairs), TOLERANCE);
+				CloseMappedArray(&r);
+			}
+			CloseMappedArray(&x);
+
+			status = OpenMappedArray(&r, MAPPEDR, 0);
+			report("CorrelateMapped", s, "reopened", status, (status == Success) ? maxerror((double*)r.Data, ref, npairs) : NAN, TOLERANCE);
+			if (status == Success) { CloseMappedArray(&r); }
+		}
+	}
+
+	// Correlating against no signals at all leaves nothing to size tiles by
+	MappedArray x, r;
+	ErrorCode status = CreateMappedArray(&x, MAPPEDX, DoublePrecision, s.Samples, s.SignalsX);
+	if (status == Success)
+	{
+		status = CreateMappedArray(&r, MAPPEDR, DoublePrecision, s.SignalsX, 0);
+		if (status == Success)
+		{
+			status = CorrelateMapped(&r, &x, signals(in.Y, s.Samples, 0), 0);
+			report("CorrelateMapped", sizes(s.Samples, s.SignalsX, 0), "no signals", Success, (status == EmptyInput) ? 0 : INFINITY, 0);
+			CloseMappedArray(&r);
+		}
+		CloseMappedArray(&x);
+	}
+
+	// Headers that claim more data than the file holds, or more than can be addressed, must be rejected
+	const uint64_t claims[][2] = { { 121, 1000 }, { (uint64_t)1 << 62, 4 } };
+	for (int a = 0; a < 2; a++)
+	{
+		FILE* file = fopen(MAPPEDX, "r+b");
+		if (!file) { report("OpenMappedArray", s, "corrupt header", FileError, NAN, 0); break; }
+		fseek(file, 16, SEEK_SET);
+		fwrite(claims[a], sizeof(uint64_t), 2, file);
+		fclose(file);
+
+		status = OpenMappedArray(&x, MAPPEDX, 0);
+		report("OpenMappedArray", s, "corrupt header", Success, (status == InvalidFile) ? 0 : INFINITY, 0);
+		if (status == Success) { CloseMappedArray(&x); }
+	}
+
+	status = CreateMappedArray(&x, MAPPEDX, DoublePrecision, SIZE_MAX / 2, 4);
+	report("CreateMappedArray", s, "huge", Success, (status == InvalidArgument) ? 0 : INFINITY, 0);
+	if (status == Success) { CloseMappedArray(&x); }
+
+	remove(MAPPEDX);
+	remove(MAPPEDR);
+
+cleanup:
+	free(ref);
+	freeinputs(&in);
+}
+
+/// <summary>
+/// Builds one surrogate of a signal straight from the definition of a surrogate method.
+/// </summary>
+/// <remarks>
+/// Random numbers are drawn from the same streams & in the same order as NullCorrelate draws them, and phase randomized
+/// surrogates are built from direct sums over the discrete Fourier basis. Surrogates are left unscaled because only their
+/// correlations are compared.
+/// </remarks>
+static void surrogate(double z[], const double x[], int nsamples, Surrogate method, int blocksize, uint64_t stream)
+{
+	Random rng;
+	rngseed(&rng, SEED, stream);
+	switch (method)
+	{
+		case CircularShift:
+		{
+			int shift = 1 + (int)rngbelow(&rng, (uint64_t)(nsamples - 1));
+			for (int a = 0; a < nsamples; a++)
+				z[a] = x[(a + shift) % nsamples];
+			break;
+		}
+
+		case PhaseRandomize:
+		{
+			// Only bins strictly between DC & Nyquist get random phases, and each stands in for its conjugate as well
+			int nbins = nsamples / 2 + 1;
+			int nrandom = (nsamples % 2 == 0) ? nbins - 1 : nbins;
+			for (int a = 0; a < nsamples; a++)
+				z[a] = 0;
+			for (int k = 0; k < nbins; k++)
+			{
+				double phi = (k > 0 && k < nrandom) ? TWOPI * rnguniform(&rng) : 0;
+				double re = 0, im = 0;
+				for (int a = 0; a < nsamples; a++)
+				{
+					double w = TWOPI * (double)((size_t)k * a % nsamples) / nsamples;
+					re += x[a] * cos(w);
+					im -= x[a] * sin(w);
+				}
+
+				double weight = (k == 0 || k >= nrandom) ? 1.0 : 2.0;
+				for (int a = 0; a < nsamples; a++)
+				{
+					double w = TWOPI * (double)((size_t)k * a % nsamples) / nsamples + phi;
+					z[a] += weight * (re * cos(w) - im * sin(w));
+				}
+			}
+			break;
+		}
+
+		default:
+		{
+			int nblocks = (nsamples + blocksize - 1) / blocksize;
+			int* blocks = (int*)malloc(nblocks * sizeof(int));
+			for (int a = 0; a < nblocks; a++)
+				blocks[a] = a;
+			for (int a = nblocks - 1; a > 0; a--)
+			{
+				int b = (int)rngbelow(&rng, (uint64_t)(a + 1));
+				int t = blocks[a];
+				blocks[a] = blocks[b];
+				blocks[b] = t;
+			}
+			for (int a = 0, idxZ = 0; a < nblocks; a++)
+				for (int b = blocks[a] * blocksize; b < nsamples && b < (blocks[a] + 1) * blocksize; b++)
+					z[idxZ++] = x[b];
+			free(blocks);
+			break;
+		}
+	}
+}
+/// <summary>
+/// Checks NullCorrelate against sorted correlations between Y & surrogates built from their definitions.
+/// </summary>
+/// <remarks>
+/// Signals of odd, even & power of two lengths cover phase randomization with & without a Nyquist bin, and a block size
+/// that doesn't divide the signals evenly leaves a short final block. Invalid counts & block sizes must be rejected.
+/// </remarks>
+static void checknullcorrelate(void)
+{
+	const int lengths[] = { 37, 50, 64 };
+	const char* methods[] = { "shift", "phase", "blocks" };
+	const int nsurrogates = 20;
+
+	for (int a = 0; a < 3; a++)
+	{
+		Shape s = sizes(lengths[a], 3, 2);
+		int blocksize = s.Samples / 6;
+		size_t nnull = (size_t)nsurrogates * s.SignalsX * s.SignalsY;
+
+		Inputs in;
+		if (!createinputs(&in, s)) { report("NullCorrelate", s, "", OutOfMemory, NAN, 0); continue; }
+		double* z = (double*)malloc(s.Samples * sizeof(double));
+		double* ref = (double*)malloc(nnull * sizeof(double));
+		double* out = (double*)malloc(nnull * sizeof(double));
+		if (!z || !ref || !out) { report("NullCorrelate", s, "", OutOfMemory, NAN, 0); goto next; }
+
+		SignalArray x = signals(in.X, s.Samples, s.SignalsX);
+		SignalArray y = signals(in.Y, s.Samples, s.SignalsY);
+		for (int m = CircularShift; m <= BlockPermute; m++)
+		{
+			size_t nref = 0;
+			for (int b = 0; b < nsurrogates; b++)
+				for (int c = 0; c < s.SignalsX; c++)
+				{
+					surrogate(z, in.X + c * s.Samples, s.Samples, (Surrogate)m, blocksize, (uint64_t)b);
+					for (int d = 0; d < s.SignalsY; d++)
+						ref[nref++] = pearson(z, in.Y + d * s.Samples, s.Samples);
+				}
+			qsort(ref, nref, sizeof(double), ascending);
+
+			size_t nout;
+			ErrorCode status = NullCorrelate(out, &nout, x, y, (Surrogate)m, nsurrogates, blocksize, SEED);
+			report("NullCorrelate", s, methods[m], status, (nout == nref) ? maxerror(out, ref, nref) : INFINITY, TOLERANCE);
+		}
+
+		size_t nout;
+		int rejected = (NullCorrelate(out, &nout, x, y, CircularShift, 0, 0, SEED) == InvalidArgument) &&
+			(NullCorrelate(out, &nout, x, y, BlockPermute, nsurrogates, s.Samples, SEED) == InvalidArgument) &&
+			(NullCorrelate(out, &nout, x, y, BlockPermute, nsurrogates, 0, SEED) == InvalidArgument);
+		report("NullCorrelate", s, "invalid", Success, rejected ? 0 : INFINITY, 0);
+
+	next:
+		free(z);
+		free(ref);
+		free(out);
+		freeinputs(&in);
+	}
+}
+
+/// <summary>
+/// Computes the probability that a binomial random variable X ~ B(ntrials, p) is greater than k by summing its terms.
+/// </summary>
+static double binomialtail(size_t ntrials, double p, size_t k)
+{
+	double tail = 0;
+	for (size_t a = k + 1; a <= ntrials; a++)
+		tail += exp(lgamma(ntrials + 1.0) - lgamma(a + 1.0) - lgamma(ntrials - a + 1.0) + a * log(p) + (ntrials - a) * log1p(-p));
+	return tail;
+}
+/// <summary>
+/// Gets the number of significant results that SGoF removes the way sgof.m does, by testing every count up to nsig.
+/// </summary>
+static size_t sgofexcess(size_t ntrials, size_t nsig, double alpha)
+{
+	size_t removed = 0;
+	for (size_t k = 1; k <= nsig; k++)
+	{
+		if (binomialtail(ntrials, alpha, k) > alpha)
+			removed = k;
+	}
+	return removed;
+}
+/// <summary>
+/// Thresholds a real data distribution the way threshold.m does, with the null distribution sorted in full.
+/// </summary>
+static void threshold(double cutoffs[2], double* pcutoff, const double r[], size_t lr, double n[], size_t ln, Tails t, double alpha, Correction method)
+{
+	qsort(n, ln, sizeof(double), ascending);
+	double N = (double)ln;
+	cutoffs[0] = (t == Right) ? NAN : n[(size_t)floor(((t == Both) ? 0.5 * alpha : alpha) * N) - 1];
+	cutoffs[1] = (t == Left) ? NAN : n[(size_t)ceil((1 - ((t == Both) ? 0.5 * alpha : alpha)) * N) - 1];
+	*pcutoff = alpha;
+
+	size_t nsig = 0;
+	for (size_t a = 0; a < lr; a++)
+		nsig += (r[a] <= cutoffs[0] || r[a] >= cutoffs[1]);
+
+	if (method == Binomial)
+	{
+		size_t removed = sgofexcess(lr, nsig, alpha);
+		if (removed == 0) { return; }
+		nsig -= removed;
+	}
+	else
+	{
+		// Benjamini-Hochberg control counts the ranked p-values of the significant data that fall under their weights
+		double* psig = (double*)malloc((nsig + 1) * sizeof(double));
+		size_t count = 0;
+		for (size_t a = 0; a < lr; a++)
+		{
+			if (r[a] <= cutoffs[0] || r[a] >= cutoffs[1])
+				psig[count++] = empiricalp(n, ln, r[a], t);
+		}
+		qsort(psig, count, sizeof(double), ascending);
+
+		nsig = 0;
+		for (size_t a = 0; a < count; a++)
+		{
+			if (psig[a] <= alpha * (double)(a + 1) / (double)lr)
+				nsig = a + 1;
+		}
+		free(psig);
+	}
+
+	if (nsig == 0) { return; }
+	switch (t)
+	{
+		case Both:
+			cutoffs[0] = n[(size_t)ceil(nsig / 2.0) - 1];
+			cutoffs[1] = n[ln - nsig / 2];
+			*pcutoff = fmax(empiricalp(n, ln, cutoffs[0], Both), empiricalp(n, ln, cutoffs[1], Both));
+			break;
+		case Left:
+			cutoffs[0] = n[nsig - 1];
+			*pcutoff = empiricalp(n, ln, cutoffs[0], Left);
+			break;
+		default:
+			cutoffs[1] = n[ln - nsig];
+			*pcutoff = empiricalp(n, ln, cutoffs[1], Right);
+			break;
+	}
+}
+/// <summary>
+/// Checks BinomialQuantile, SGoF, FDR & Threshold against sums of binomial terms, sorted p-values & threshold.m.
+/// </summary>
+/// <remarks>
+/// A fraction of the p-values & data are made much more significant than the rest, so that corrections remove some but
+/// not all significant results.
+/// </remarks>
+static void checkcomparisons(void)
+{
+	Random rng;
+	rngseed(&rng, SEED, 0);
+
+	// The quantile is the smallest count whose CDF reaches q
+	const size_t trials[] = { 1, 20, 500, 3000 };
+	const double probabilities[] = { 0.001, 0.05, 0.5 };
+	const double quantiles[] = { 0.01, 0.5, 0.95, 0.999 };
+	double error = 0;
+	for (int a = 0; a < 4; a++)
+		for (int b = 0; b < 3; b++)
+			for (int c = 0; c < 4; c++)
+			{
+				size_t k = 0;
+				while (1 - binomialtail(trials[a], probabilities[b], k) < quantiles[c]) { k++; }
+				if (BinomialQuantile(trials[a], probabilities[b], quantiles[c]) != k) { error = INFINITY; }
+			}
+	report("BinomialQuantile", sizes(0, 0, 0), "", Success, error, 0);
+
+	const int lengths[] = { 1, 40, 2000 };
+	for (int a = 0; a < 3; a++)
+	{
+		size_t np = lengths[a];
+		double* p = (double*)malloc(np * sizeof(double));
+		double* ps = (double*)malloc(np * sizeof(double));
+		if (!p || !ps) { report("SGoF", sizes((int)np, 0, 0), "", OutOfMemory, NAN, 0); goto nextp; }
+
+		for (size_t b = 0; b < np; b++)
+			p[b] = rnguniform(&rng) * ((b % 8 == 0) ? 0.001 : 1.0);
+		memcpy(ps, p, np * sizeof(double));
+		qsort(ps, np, sizeof(double), ascending);
+
+		size_t count = 0;
+		for (size_t b = 0; b < np; b++)
+			count += (ps[b] <= 0.05);
+
+		size_t nsig = count - sgofexcess(np, count, 0.05);
+		double ref = (nsig == 0) ? NAN : ps[nsig - 1];
+		double cutoff;
+		ErrorCode status = SGoF(&cutoff, p, np, 0.05);
+		report("SGoF", sizes((int)np, 0, 0), "", status, maxerror(&cutoff, &ref, 1), 0);
+
+		ref = NAN;
+		for (size_t b = count; b > 0; b--)
+		{
+			if (ps[b - 1] <= 0.05 * (double)b / (double)np) { ref = ps[b - 1]; break; }
+		}
+		status = FDR(&cutoff, p, np, 0.05);
+		report("FDR", sizes((int)np, 0, 0), "", status, maxerror(&cutoff, &ref, 1), 0);
+
+	nextp:
+		free(p);
+		free(ps);
+	}
+
+	const char* tails[] = { "both tails", "left tail", "right tail" };
+	size_t lr = 600, ln = 5000;
+	double* r = (double*)malloc(lr * sizeof(double));
+	double* n = (double*)malloc(ln * sizeof(double));
+	double* ns = (double*)malloc(ln * sizeof(double));
+	if (!r || !n || !ns) { report("Threshold", sizes((int)lr, (int)ln, 0), "", OutOfMemory, NAN, 0); goto cleanup; }
+
+	uniform(r, lr, &rng);
+	uniform(n, ln, &rng);
+	for (size_t b = 0; b < lr; b += 10)
+		r[b] = (b % 20 == 0) ? -1.0 - r[b] : 2.0 + r[b];
+
+	for (int m = Binomial; m <= FalseDiscovery; m++)
+		for (int t = Both; t <= Right; t++)
+		{
+			double cutoffs[2], pcutoff, ref[3];
+			memcpy(ns, n, ln * sizeof(double));
+			threshold(ref, ref + 2, r, lr, ns, ln, (Tails)t, 0.05, (Correction)m);
+
+			ErrorCode status = Threshold(cutoffs, &pcutoff, r, lr, n, ln, (Tails)t, 0.05, (Correction)m);
+			double out[3] = { cutoffs[0], cutoffs[1], pcutoff };
+			report(m == Binomial ? "Threshold SGoF" : "Threshold FDR", sizes((int)lr, (int)ln, 0), tails[t], status, maxerror(out, ref, 3), 0);
+		}
+
+cleanup:
+	free(r);
+	free(n);
+	free(ns);
+}
+
+/// <summary>
+/// Checks EmpiricalCDFRaw against p-values counted from null distributions that have been cleaned up & sorted separately.
+/// </summary>
+/// <remarks>
+/// Both distributions are seeded with NaNs, zeros & infinities, and are long enough for the null distribution to be
+/// compacted in several chunks & radix sorted. A null distribution without any valid values must give NaN p-values.
+/// </remarks>
+static void checkempiricalcdfraw(void)
+{
+	const int lengths[][2] = { { 1000, 100000 }, { 50, 3 }, { 20, 0 } };
+	const char* tails[] = { "both tails", "left tail", "right tail" };
+	const double missing[] = { NAN, 0.0, -0.0 };
+
+	Random rng;
+	rngseed(&rng, SEED, 1);
+	for (int a = 0; a < 3; a++)
+	{
+		int lr = lengths[a][0], ln = lengths[a][1];
+		int lnraw = ln + 40;
+		double* r = (double*)malloc(lr * sizeof(double));
+		double* n = (double*)malloc(lnraw * sizeof(double));
+		double* ns = (double*)malloc(lnraw * sizeof(double));
+		double* ref = (double*)malloc(lr * sizeof(double));
+		double* out = (double*)malloc(lr * sizeof(double));
+		if (!r || !n || !ns || !ref || !out) { report("EmpiricalCDFRaw", sizes(lr, ln, 0), "", OutOfMemory, NAN, 0); goto next; }
+
+		// Missing values are scattered through both distributions, but only the valid null values are counted
+		uniform(r, lr, &rng);
+		uniform(n, lnraw, &rng);
+		for (int b = 0; b < lr; b++)
+			r[b] = (b % 7 == 3) ? missing[b % 3] : round(r[b] * 50) / 50;
+		for (int b = 0; b < 40; b++)
+			n[(size_t)rngbelow(&rng, (uint64_t)lnraw)] = missing[b % 3];
+		if (ln == 0)
+		{
+			for (int b = 0; b < lnraw; b++)
+				n[b] = missing[b % 3];
+		}
+		else
+		{
+			n[0] = INFINITY;
+			n[lnraw - 1] = -INFINITY;
+		}
+
+		int nvalid = 0;
+		for (int b = 0; b < lnraw; b++)
+		{
+			if (!isnan(n[b]) && n[b] != 0)
+				ns[nvalid++] = n[b];
+		}
+		qsort(ns, nvalid, sizeof(double), ascending);
+
+		for (int t = Both; t <= Right; t++)
+		{
+			for (int b = 0; b < lr; b++)
+				ref[b] = (isnan(r[b]) || r[b] == 0 || nvalid == 0) ? NAN : empiricalp(ns, nvalid, r[b], (Tails)t);
+
+			ErrorCode status = EmpiricalCDFRaw(out, r, lr, n, lnraw, (Tails)t);
+			report("EmpiricalCDFRaw", sizes(lr, nvalid, 0), tails[t], status, maxerror(out, ref, lr), TOLERANCE);
+		}
+
+	next:
+		free(r);
+		free(n);
+		free(ns);
+		free(ref);
+		free(out);
+	}
+}
+
+/// <summary>
+/// Computes the residuals of a signal after a least squares fit of nuisance signals, found from the normal equations.
+/// </summary>
+/// <param name="z">An [M x K] array of linearly independent nuisance signals, where K is no more than four.</param>
+static void residual(double out[], const double x[], const double z[], int nsamples, int nnuisance)
+{
+	// Gaussian elimination with partial pivoting on [Z'Z | Z'x]
+	double A[4][5];
+	for (int a = 0; a < nnuisance; a++)
+	{
+		for (int b = 0; b <= nnuisance; b++)
+		{
+			const double* zb = (b < nnuisance) ? z + b * nsamples : x;
+			A[a][b] = 0;
+			for (int c = 0; c < nsamples; c++)
+				A[a][b] += z[a * nsamples + c] * zb[c];
+		}
+	}
+	for (int a = 0; a < nnuisance; a++)
+	{
+		int pivot = a;
+		for (int b = a + 1; b < nnuisance; b++)
+			if (fabs(A[b][a]) > fabs(A[pivot][a])) { pivot = b; }
+		for (int c = 0; c <= nnuisance; c++)
+		{
+			double t = A[a][c];
+			A[a][c] = A[pivot][c];
+			A[pivot][c] = t;
+		}
+		for (int b = a + 1; b < nnuisance; b++)
+		{
+			double f = A[b][a] / A[a][a];
+			for (int c = a; c <= nnuisance; c++)
+				A[b][c] -= f * A[a][c];
+		}
+	}
+
+	double beta[4];
+	for (int a = nnuisance - 1; a >= 0; a--)
+	{
+		beta[a] = A[a][nnuisance];
+		for (int b = a + 1; b < nnuisance; b++)
+			beta[a] -= A[a][b] * beta[b];
+		beta[a] /= A[a][a];
+	}
+
+	for (int c = 0; c < nsamples; c++)
+	{
+		out[c] = x[c];
+		for (int a = 0; a < nnuisance; a++)
+			out[c] -= beta[a] * z[a * nsamples + c];
+	}
+}
+/// <summary>
+/// Checks Residualize & PartialCrossCorrelateLags against least squares residuals & their cross-correlations.
+/// </summary>
+/// <remarks>
+/// The nuisance signals include a column of ones and one that is the sum of two others, which must add nothing to the
+/// basis. Y is checked both with nuisance signals regressed out and as it is, and X is also residualized one signal at a
+/// time under a tiny memory budget.
+/// </remarks>
+static void checkpartialcorrelate(void)
+{
+	Shape s = sizes(200, 4, 3);
+	const int nnuisance = 4, nindependent = 3;
+	int nlagsmax = 2 * s.Samples;
+	size_t nx = (size_t)s.Samples * s.SignalsX, ny = (size_t)s.Samples * s.SignalsY;
+	size_t npairs = (size_t)s.SignalsX * s.SignalsY;
+
+	Inputs in;
+	if (!createinputs(&in, s)) { report("Residualize", s, "", OutOfMemory, NAN, 0); return; }
+	double* z = (double*)malloc((size_t)s.Samples * nnuisance * sizeof(double));
+	double* rx = (double*)malloc(nx * sizeof(double));
+	double* ry = (double*)malloc(ny * sizeof(double));
+	double* out = (double*)malloc(npairs * nlagsmax * sizeof(double));
+	double* ref = (double*)malloc(npairs * nlagsmax * sizeof(double));
+	int* lags = (int*)malloc(nlagsmax * sizeof(int));
+	Nuisance q = { 0 };
+	if (!z || !rx || !ry || !out || !ref || !lags) { report("Residualize", s, "", OutOfMemory, NAN, 0); goto cleanup; }
+
+	Random rng;
+	rngseed(&rng, SEED, 2);
+	uniform(z + s.Samples, 2 * (size_t)s.Samples, &rng);
+	for (int a = 0; a < s.Samples; a++)
+	{
+		z[a] = 1;
+		z[3 * s.Samples + a] = z[s.Samples + a] + z[2 * s.Samples + a];
+	}
+
+	ErrorCode status = FactorNuisance(&q, signals(z, s.Samples, nnuisance));
+	report("FactorNuisance", s, "rank", status, (status == Success && q.Rank == nindependent) ? 0 : INFINITY, 0);
+	if (status != Success) { goto cleanup; }
+
+	for (int a = 0; a < s.SignalsX; a++)
+		residual(rx + a * s.Samples, in.X + a * s.Samples, z, s.Samples, nindependent);
+	for (int a = 0; a < s.SignalsY; a++)
+		residual(ry + a * s.Samples, in.Y + a * s.Samples, z, s.Samples, nindependent);
+
+	status = Residualize(out, signals(in.X, s.Samples, s.SignalsX), &q);
+	report("Residualize", s, "", status, maxerror(out, rx, nx), TOLERANCE);
+
+	SignalArray x = signals(in.X, s.Samples, s.SignalsX);
+	SignalArray y = signals(in.Y, s.Samples, s.SignalsY);
+	for (int set = 0; set < 3; set++)
+	{
+		const char* name;
+		int nlags = lagset(lags, set, s.Samples, &name);
+		for (int residualizey = 0; residualizey < 2; residualizey++)
+		{
+			const double* ys = residualizey ? ry : in.Y;
+			for (size_t a = 0; a < npairs; a++)
+				for (int b = 0; b < nlags; b++)
+					ref[a * nlags + b] = crosslag(rx + (a % s.SignalsX) * s.Samples, ys + (a / s.SignalsX) * s.Samples, s.Samples, lags[b]);
+
+			status = PartialCrossCorrelateLags(out, x, &q, y, residualizey ? &q : NULL, lags, nlags, NULL);
+			report(residualizey ? "PartialXCorr" : "PartialXCorr X only", s, name, status, maxerror(out, ref, npairs * nlags), TOLERANCE);
+		}
+
+		// A budget too small for more than one residual signal makes every signal in X a tile of its own
+		size_t budget = GetMemoryBudget();
+		SetMemoryBudget(1);
+		status = PartialCrossCorrelateLags(out, x, &q, y, &q, lags, nlags, NULL);
+		report("PartialXCorr", s, "tiny budget", status, maxerror(out, ref, npairs * nlags), TOLERANCE);
+		SetMemoryBudget(budget);
+	}
+
+cleanup:
+	FreeNuisance(&q);
+	free(z);
+	free(rx);
+	free(ry);
+	free(out);
+	free(ref);
+	free(lags);
+	freeinputs(&in);
+}
+
+/// <summary>
+/// Applies an epilogue to one coefficient straight from its definition.
+/// </summary>
+static double epiloguevalue(const Epilogue* e, double r)
+{
+	double v = (e->FisherN != 0) ? 0.5 * log((1 + r) / (1 - r)) * sqrt(e->FisherN - 3) : r;
+	if (e->Threshold == KeepAll || isnan(v)) { return v; }
+	if (v > e->Cutoffs[0] && v < e->Cutoffs[1]) { return 0; }
+	return (e->Threshold == Significance) ? 1 : v;
+}
+/// <summary>
+/// Checks the epilogues of CrossCorrelateLagsEx & PartialCrossCorrelateLags against coefficients processed one at a time.
+/// </summary>
+/// <remarks>
+/// Epilogues transform, threshold in both & one tails and scatter signals into the rows of a larger output. Epilogues
+/// that threshold without finite, ordered cutoffs or map signals outside of the output must be rejected.
+/// </remarks>
+static void checkepilogue(void)
+{
+	Shape s = sizes(100, 5, 3);
+	const int lags[] = { -4, 0, 1, 7 };
+	const int nlags = 4;
+	const size_t map[] = { 0, 2, 3, 5, 7 };
+	const size_t nrows = 8;
+	size_t npairs = (size_t)s.SignalsX * s.SignalsY;
+	size_t nout = nrows * nlags * s.SignalsY;
+
+	Inputs in;
+	if (!createinputs(&in, s)) { report("Epilogue", s, "", OutOfMemory, NAN, 0); return; }
+	double* cc = (double*)malloc(npairs * nlags * sizeof(double));
+	double* ref = (double*)malloc(nout * sizeof(double));
+	double* out = (double*)malloc(nout * sizeof(double));
+	if (!cc || !ref || !out) { report("Epilogue", s, "", OutOfMemory, NAN, 0); goto cleanup; }
+
+	for (size_t a = 0; a < npairs; a++)
+		for (int b = 0; b < nlags; b++)
+			cc[a * nlags + b] = crosslag(in.X + (a % s.SignalsX) * s.Samples, in.Y + (a / s.SignalsX) * s.Samples, s.Samples, lags[b]);
+
+	// Cutoffs halfway between coefficients near their quartiles leave plenty of values on both sides, none of them close
+	size_t ncc = npairs * nlags;
+	memcpy(out, cc, ncc * sizeof(double));
+	qsort(out, ncc, sizeof(double), ascending);
+	double q1 = 0.5 * (out[ncc / 4] + out[ncc / 4 + 1]);
+	double q2 = 0.5 * (out[ncc / 2] + out[ncc / 2 + 1]);
+	double q3 = 0.5 * (out[3 * ncc / 4] + out[3 * ncc / 4 + 1]);
+
+	const char* names[] = { "fisher", "zero", "one tail", "mapped" };
+	Epilogue epilogues[] =
+	{
+		{ 100, KeepAll, { NAN, NAN }, NULL, 0, 0 },
+		{ 100, ZeroInsignificant, { atanh(q1) * sqrt(97), atanh(q3) * sqrt(97) }, NULL, 0, 0 },
+		{ 0, Significance, { -DBL_MAX, q2 }, NULL, 0, 0 },
+		{ 4, ZeroInsignificant, { atanh(q1), atanh(q2) }, map, nrows, NAN },
+	};
+
+	SignalArray x = signals(in.X, s.Samples, s.SignalsX);
+	SignalArray y = signals(in.Y, s.Samples, s.SignalsY);
+	for (int a = 0; a < 4; a++)
+	{
+		const Epilogue* e = &epilogues[a];
+		size_t n = e->Map ? nout : npairs * nlags;
+		for (size_t b = 0; b < n; b++)
+			ref[b] = e->Fill;
+		for (size_t b = 0; b < npairs; b++)
+		{
+			int idxX = (int)(b % s.SignalsX), idxY = (int)(b / s.SignalsX);
+			for (int c = 0; c < nlags; c++)
+			{
+				size_t idx = e->Map ? ((size_t)idxY * nlags + c) * nrows + e->Map[idxX] : b * nlags + c;
+				ref[idx] = epiloguevalue(e, cc[b * nlags + c]);
+			}
+		}
+
+		ErrorCode status = CrossCorrelateLagsEx(out, x, y, lags, nlags, e);
+		report("CrossCorrelateLagsEx", s, names[a], status, maxerror(out, ref, n), TOLERANCE);
+		status = PartialCrossCorrelateLags(out, x, NULL, y, NULL, lags, nlags, e);
+		report("PartialXCorr", s, names[a], status, maxerror(out, ref, n), TOLERANCE);
+	}
+
+	// Cutoffs left at NaN would otherwise zero every coefficient without a word
+	const size_t badmap[] = { 0, 2, 3, 5, 8 };
+	Epilogue invalid[] =
+	{
+		{ 0, ZeroInsignificant, { NAN, NAN }, NULL, 0, 0 },
+		{ 0, Significance, { 0.1, INFINITY }, NULL, 0, 0 },
+		{ 0, Significance, { 0.1, -0.1 }, NULL, 0, 0 },
+		{ 0, KeepAll, { NAN, NAN }, badmap, nrows, NAN },
+	};
+	int rejected = 1;
+	for (int a = 0; a < 4; a++)
+		rejected &= (CrossCorrelateLagsEx(out, x, y, lags, nlags, &invalid[a]) == InvalidArgument);
+	report("CrossCorrelateLagsEx", s, "invalid", Success, rejected ? 0 : INFINITY, 0);
+
+cleanup:
+	free(cc);
+	free(ref);
+	free(out);
+	freeinputs(&in);
+}
+
+/// <summary>
+/// Computes one frequency bin of the transform of a windowed segment with a direct sum over its samples.
+/// </summary>
+/// <remarks>
+/// The complex exponential is periodic in NFFT, so windows longer than the transform are wrapped around by the sum itself.
+/// </remarks>
+static void segmentbin(double* re, double* im, const double x[], const Welch* w, int idx, int bin)
+{
+	const double* xs = x + (size_t)idx * (w->WindowLength - w->Overlap);
+	*re = *im = 0;
+	for (int a = 0; a < w->WindowLength; a++)
+	{
+		double phi = TWOPI * (double)((size_t)bin * a % w->NFFT) / w->NFFT;
+		*re += xs[a] * w->Window[a] * cos(phi);
+		*im -= xs[a] * w->Window[a] * sin(phi);
+	}
+}
+/// <summary>
+/// Checks WelchSpectra & Coherence against averaged periodograms & cross-spectra built from direct transforms.
+/// </summary>
+/// <remarks>
+/// Windows shorter than, equal to & longer than the transform are used with both scalings. Coherence is checked for
+/// every pair & for a list of pairs, and also with a memory budget that only holds the spectra of one signal at a time.
+/// </remarks>
+static void checkspectral(void)
+{
+	Shape s = sizes(300, 3, 2);
+	const int configs[][3] = { { 64, 32, 128 }, { 64, 0, 64 }, { 100, 60, 64 } };
+	const int pairs[] = { 2, 1, 0, 0, 2, 0 };
+	const int npairs = 3;
+	int nbinsmax = 128 / 2 + 1;
+	size_t nall = (size_t)s.SignalsX * s.SignalsY;
+
+	Inputs in;
+	if (!createinputs(&in, s)) { report("WelchSpectra", s, "", OutOfMemory, NAN, 0); return; }
+	double* window = (double*)malloc(100 * sizeof(double));
+	double* psd = (double*)malloc(nbinsmax * nall * sizeof(double));
+	double* ref = (double*)malloc(nbinsmax * nall * sizeof(double));
+	double* out = (double*)malloc(nbinsmax * nall * sizeof(double));
+	if (!window || !psd || !ref || !out) { report("WelchSpectra", s, "", OutOfMemory, NAN, 0); goto cleanup; }
+
+	SignalArray x = signals(in.X, s.Samples, s.SignalsX);
+	SignalArray y = signals(in.Y, s.Samples, s.SignalsY);
+	char detail[32];
+	for (int a = 0; a < 3; a++)
+	{
+		Welch w = { window, configs[a][0], configs[a][1], configs[a][2], 250.0, PowerSpectralDensity };
+		for (int b = 0; b < w.WindowLength; b++)
+			window[b] = 0.5 - 0.5 * cos(TWOPI * b / (w.WindowLength - 1));
+
+		int nbins = w.NFFT / 2 + 1;
+		int nsegments = WelchSegments(&w, s.Samples);
+		double sum = 0, energy = 0;
+		for (int b = 0; b < w.WindowLength; b++)
+		{
+			sum += window[b];
+			energy += window[b] * window[b];
+		}
+		sprintf(detail, "%d/%d/%d", w.WindowLength, w.Overlap, w.NFFT);
+
+		// One-sided spectra double every bin but DC & Nyquist
+		for (int scale = PowerSpectralDensity; scale <= PowerSpectrum; scale++)
+		{
+			w.Scale = (Scaling)scale;
+			double norm = (scale == PowerSpectralDensity) ? energy * w.SamplingRate : sum * sum;
+			for (int b = 0; b < s.SignalsX; b++)
+				for (int k = 0; k < nbins; k++)
+				{
+					double P = 0, re, im;
+					for (int c = 0; c < nsegments; c++)
+					{
+						segmentbin(&re, &im, in.X + b * s.Samples, &w, c, k);
+						P += re * re + im * im;
+					}
+					ref[b * nbins + k] = P * ((k == 0 || k == nbins - 1) ? 1.0 : 2.0) / (norm * nsegments);
+				}
+
+			char name[48];
+			sprintf(name, "%s %s", detail, (scale == PowerSpectralDensity) ? "psd" : "power");
+			ErrorCode status = WelchSpectra(out, x, &w);
+			report("WelchSpectra", s, name, status, maxerror(out, ref, (size_t)nbins * s.SignalsX), TOLERANCE);
+		}
+
+		// Coherence is |Pxy|^2 / (Pxx * Pyy), in which every scale factor cancels
+		for (size_t b = 0; b < nall; b++)
+			for (int k = 0; k < nbins; k++)
+			{
+				double pxx = 0, pyy = 0, pre = 0, pim = 0;
+				for (int c = 0; c < nsegments; c++)
+				{
+					double xre, xim, yre, yim;
+					segmentbin(&xre, &xim, in.X + (b % s.SignalsX) * s.Samples, &w, c, k);
+					segmentbin(&yre, &yim, in.Y + (b / s.SignalsX) * s.Samples, &w, c, k);
+					pxx += xre * xre + xim * xim;
+					pyy += yre * yre + yim * yim;
+					pre += xre * yre + xim * yim;
+					pim += xim * yre - xre * yim;
+				}
+				psd[b * nbins + k] = (pre * pre + pim * pim) / (pxx * pyy);
+			}
+
+		ErrorCode status = Coherence(out, x, y, NULL, 0, &w);
+		report("Coherence", s, detail, status, maxerror(out, psd, (size_t)nbins * nall), TOLERANCE);
+
+		for (int b = 0; b < npairs; b++)
+			memcpy(ref + b * nbins, psd + (pairs[2 * b + 1] * s.SignalsX + pairs[2 * b]) * nbins, nbins * sizeof(double));
+		status = Coherence(out, x, y, pairs, npairs, &w);
+		report("Coherence", s, "pairs", status, maxerror(out, ref, (size_t)nbins * npairs), TOLERANCE);
+
+		size_t budget = GetMemoryBudget();
+		SetMemoryBudget(1);
+		status = Coherence(out, x, y, NULL, 0, &w);
+		report("Coherence", s, "tiny budget", status, maxerror(out, psd, (size_t)nbins * nall), TOLERANCE);
+		SetMemoryBudget(budget);
+	}
+
+cleanup:
+	free(window);
+	free(psd);
+	free(ref);
+	free(out);
+	freeinputs(&in);
+}
+
+/// <summary>
+/// Filters a signal with direct-form convolution, holding every sample before its start at a constant value.
+/// </summary>
+/// <remarks>
+/// A constant of zero is what filter does from rest, and a constant equal to the first sample is the steady state that
+/// filtfilt starts both of its passes from.
+/// </remarks>
+static void directfilter(double y[], const double x[], int nsamples, const double b[], int ntaps, double pre)
+{
+	for (int a = 0; a < nsamples; a++)
+	{
+		y[a] = 0;
+		for (int k = 0; k < ntaps; k++)
+			y[a] += b[k] * ((a - k >= 0) ? x[a - k] : pre);
+	}
+}
+/// <summary>
+/// Filters a signal forward & backward the way filtfilt does, including its odd reflections at both ends.
+/// </summary>
+static void directfiltfilt(double y[], const double x[], int nsamples, const double b[], int ntaps)
+{
+	int nfact = 3 * (ntaps - 1);
+	int n = nsamples + 2 * nfact;
+	double* xt = (double*)malloc(2 * (size_t)n * sizeof(double));
+	double* yt = xt + n;
+
+	for (int a = 0; a < nfact; a++)
+	{
+		xt[a] = 2 * x[0] - x[nfact - a];
+		xt[nfact + nsamples + a] = 2 * x[nsamples - 1] - x[nsamples - 2 - a];
+	}
+	memcpy(xt + nfact, x, (size_t)nsamples * sizeof(double));
+
+	directfilter(yt, xt, n, b, ntaps, xt[0]);
+	for (int a = 0; a < n; a++)
+		xt[a] = yt[n - 1 - a];
+	directfilter(yt, xt, n, b, ntaps, xt[0]);
+	for (int a = 0; a < nsamples; a++)
+		y[a] = yt[n - 1 - nfact - a];
+
+	free(xt);
+}
+/// <summary>
+/// Checks FIRFilter against direct-form filter & filtfilt.
+/// </summary>
+/// <remarks>
+/// Filter lengths on both sides of the switch from direct to overlap-save convolution are used, along with one that is
+/// long enough for its reflections to cover most of the signal.
+/// </remarks>
+static void checkfilter(void)
+{
+	Shape s = sizes(2000, 3, 0);
+	const int lengths[] = { 1, 5, 63, 64, 301, 666 };
+	size_t nx = (size_t)s.Samples * s.SignalsX;
+
+	Inputs in;
+	if (!createinputs(&in, s)) { report("FIRFilter", s, "", OutOfMemory, NAN, 0); return; }
+	double* b = (double*)malloc(666 * sizeof(double));
+	double* ref = (double*)malloc(nx * sizeof(double));
+	double* out = (double*)malloc(nx * sizeof(double));
+	if (!b || !ref || !out) { report("FIRFilter", s, "", OutOfMemory, NAN, 0); goto cleanup; }
+
+	Random rng;
+	rngseed(&rng, SEED, 3);
+	SignalArray x = signals(in.X, s.Samples, s.SignalsX);
+	char detail[32];
+	for (int a = 0; a < 6; a++)
+	{
+		int ntaps = lengths[a];
+		uniform(b, ntaps, &rng);
+		for (int k = 0; k < ntaps; k++)
+			b[k] /= ntaps;
+
+		for (int zerophase = 0; zerophase < 2; zerophase++)
+		{
+			for (int c = 0; c < s.SignalsX; c++)
+			{
+				if (zerophase)
+					directfiltfilt(ref + c * s.Samples, in.X + c * s.Samples, s.Samples, b, ntaps);
+				else
+					directfilter(ref + c * s.Samples, in.X + c * s.Samples, s.Samples, b, ntaps, 0);
+			}
+
+			sprintf(detail, "%d taps%s", ntaps, zerophase ? " zero" : "");
+			ErrorCode status = FIRFilter(out, x, b, ntaps, zerophase);
+			report("FIRFilter", s, detail, status, maxerror(out, ref, nx), TOLERANCE);
+		}
+	}
+
+cleanup:
+	free(b);
+	free(ref);
+	free(out);
+	freeinputs(&in);
+}
+
+/// <summary>
+/// Partitions one signal into levels straight from the definitions of the partitions.
+/// </summary>
+/// <param name="sorted">A buffer of M elements.</param>
+/// <returns>The number of levels.</returns>
+static int partition(int codes[], const double x[], int nsamples, int nbins, Partition method, double sorted[])
+{
+	int count = 0;
+	for (int a = 0; a < nsamples; a++)
+		if (!isnan(x[a])) { sorted[count++] = x[a]; }
+	qsort(sorted, count, sizeof(double), ascending);
+
+	if (method == Distinct)
+	{
+		int nunique = 0;
+		for (int a = 0; a < count; a++)
+			if (nunique == 0 || sorted[a] != sorted[nunique - 1]) { sorted[nunique++] = sorted[a]; }
+		for (int a = 0; a < nsamples; a++)
+		{
+			codes[a] = -1;
+			for (int b = 0; b < nunique; b++)
+				if (sorted[b] == x[a]) { codes[a] = b; }
+		}
+		return nunique;
+	}
+
+	// Each value lands in the first bin whose upper edge is at least as large as it is
+	double lo = sorted[0], hi = sorted[count - 1];
+	for (int a = 0; a < nsamples; a++)
+	{
+		codes[a] = -1;
+		for (int k = 0; !isnan(x[a]) && k < nbins && codes[a] < 0; k++)
+		{
+			double edge;
+			if (method == Equidistant)
+				edge = (k == nbins - 1) ? hi : lo + (k + 1) * ((hi - lo) / nbins);
+			else
+			{
+				long long rank = (long long)(k + 1) * count / nbins;
+				edge = (rank > 0) ? sorted[rank - 1] : -INFINITY;
+			}
+			if (x[a] <= edge) { codes[a] = k; }
+		}
+	}
+	return nbins;
+}
+/// <summary>
+/// Computes the entropy in bits of the joint levels of two discrete signals, or of one when Y is NULL.
+/// </summary>
+/// <param name="z">Another discrete signal whose missing samples are left out as well, or NULL.</param>
+static double entropy(const int cx[], int lx, const int cy[], int ly, const int z[], int nsamples)
+{
+	int* counts = (int*)calloc((size_t)lx * ly, sizeof(int));
+	int total = 0;
+	for (int a = 0; a < nsamples; a++)
+	{
+		if (cx[a] < 0 || (cy && cy[a] < 0) || (z && z[a] < 0)) { continue; }
+		counts[cx[a] * ly + (cy ? cy[a] : 0)]++;
+		total++;
+	}
+
+	double h = (total > 0) ? 0 : NAN;
+	for (size_t a = 0; a < (size_t)lx * ly; a++)
+		if (counts[a] > 0) { h -= ((double)counts[a] / total) * log2((double)counts[a] / total); }
+	free(counts);
+	return h;
+}
+/// <summary>
+/// Checks Discretize, Entropy & PairwiseInformation against partitions & histograms built one value at a time.
+/// </summary>
+/// <remarks>
+/// Signals have missing samples, tied values and a constant signal among them. Partitions with few bins keep joint
+/// histograms dense, while distinct levels of continuous signals make them too large to keep dense. Pairs are measured
+/// across all signals, from lists, and between an array & itself.
+/// </remarks>
+static void checkinformation(void)
+{
+	Shape s = sizes(600, 4, 3);
+	const int bins[] = { 1, 6, 17 };
+	const char* methods[] = { "equidistant", "equiprobable", "distinct" };
+	const char* measures[] = { "joint", "conditional", "mutual" };
+	const int pairs[] = { 3, 2, 0, 0, 1, 0, 3, 0 };
+	const int npairs = 4;
+	size_t nx = (size_t)s.Samples * s.SignalsX, ny = (size_t)s.Samples * s.SignalsY;
+	size_t nall = (size_t)s.SignalsX * s.SignalsY;
+
+	Inputs in;
+	if (!createinputs(&in, s)) { report("Discretize", s, "", OutOfMemory, NAN, 0); return; }
+	int* cx = (int*)malloc(nx * sizeof(int));
+	int* cy = (int*)malloc(ny * sizeof(int));
+	int* rx = (int*)malloc(nx * sizeof(int));
+	int* ry = (int*)malloc(ny * sizeof(int));
+	double* sorted = (double*)malloc(s.Samples * sizeof(double));
+	double* ref = (double*)malloc(nall * sizeof(double));
+	double* out = (double*)malloc(nall * sizeof(double));
+	if (!cx || !cy || !rx || !ry || !sorted || !ref || !out) { report("Discretize", s, "", OutOfMemory, NAN, 0); goto cleanup; }
+
+	// The first signal in X is rounded so that it ties often, the second is missing samples & the last is constant
+	for (int a = 0; a < s.Samples; a++)
+	{
+		in.X[a] = round(in.X[a] * 8) / 8;
+		in.X[s.Samples + a] = (a % 9 == 4) ? NAN : in.X[s.Samples + a];
+		in.X[3 * s.Samples + a] = 0.25;
+		in.Y[a] = (a % 13 == 0) ? NAN : in.Y[a];
+	}
+
+	SignalArray x = signals(in.X, s.Samples, s.SignalsX);
+	SignalArray y = signals(in.Y, s.Samples, s.SignalsY);
+	char detail[32];
+	for (int m = Equidistant; m <= Distinct; m++)
+	{
+		for (int b = 0; b < ((m == Distinct) ? 1 : 3); b++)
+		{
+			int lx[4], ly[3], lrx[4], lry[3];
+			for (int a = 0; a < s.SignalsX; a++)
+				lrx[a] = partition(rx + a * s.Samples, in.X + a * s.Samples, s.Samples, bins[b], (Partition)m, sorted);
+			for (int a = 0; a < s.SignalsY; a++)
+				lry[a] = partition(ry + a * s.Samples, in.Y + a * s.Samples, s.Samples, bins[b], (Partition)m, sorted);
+
+			// Codes are compared exactly, along with the number of levels of every signal
+			sprintf(detail, (m == Distinct) ? "%s" : "%s %d", methods[m], bins[b]);
+			ErrorCode status = Discretize(cx, lx, x, bins[b], (Partition)m);
+			if (status == Success) { status = Discretize(cy, ly, y, bins[b], (Partition)m); }
+			int same = !memcmp(cx, rx, nx * sizeof(int)) && !memcmp(cy, ry, ny * sizeof(int)) &&
+				!memcmp(lx, lrx, sizeof(lx)) && !memcmp(ly, lry, sizeof(ly));
+			report("Discretize", s, detail, status, same ? 0 : INFINITY, 0);
+			if (!same) { continue; }
+
+			LevelArray dx = discrete(cx, lx, s.Samples, s.SignalsX);
+			LevelArray dy = discrete(cy, ly, s.Samples, s.SignalsY);
+			for (int a = 0; a < s.SignalsX; a++)
+				ref[a] = entropy(cx + a * s.Samples, lx[a], NULL, 1, NULL, s.Samples);
+			status = Entropy(out, dx);
+			report("Entropy", s, detail, status, maxerror(out, ref, s.SignalsX), TOLERANCE);
+
+			for (int measure = JointEntropy; measure <= MutualInformation; measure++)
+			{
+				for (size_t a = 0; a < nall; a++)
+				{
+					const int* ca = cx + (a % s.SignalsX) * s.Samples;
+					const int* cb = cy + (a / s.SignalsX) * s.Samples;
+					int la = lx[a % s.SignalsX], lb = ly[a / s.SignalsX];
+					double hab = entropy(ca, la, cb, lb, NULL, s.Samples);
+					double ha = entropy(ca, la, NULL, 1, cb, s.Samples);
+					double hb = entropy(cb, lb, NULL, 1, ca, s.Samples);
+					ref[a] = (measure == JointEntropy) ? hab : (measure == ConditionalEntropy) ? hab - hb : ha + hb - hab;
+				}
+				sprintf(detail, (m == Distinct) ? "%s" : "%s %d", measures[measure], bins[b]);
+				status = PairwiseInformation(out, dx, dy, NULL, 0, (Information)measure);
+				report("PairwiseInformation", s, detail, status, maxerror(out, ref, nall), TOLERANCE);
+
+				for (int a = 0; a < npairs; a++)
+					sorted[a] = ref[pairs[2 * a + 1] * s.SignalsX + pairs[2 * a]];
+				status = PairwiseInformation(out, dx, dy, pairs, npairs, (Information)measure);
+				report("PairwiseInformation", s, "pairs", status, maxerror(out, sorted, npairs), TOLERANCE);
+
+				// Symmetric measures of an array against itself only measure half of the pairs
+				for (int a = 0; a < s.SignalsX * s.SignalsX; a++)
+				{
+					const int* ca = cx + (a % s.SignalsX) * s.Samples;
+					const int* cb = cx + (a / s.SignalsX) * s.Samples;
+					int la = lx[a % s.SignalsX], lb = lx[a / s.SignalsX];
+					double hab = entropy(ca, la, cb, lb, NULL, s.Samples);
+					double ha = entropy(ca, la, NULL, 1, cb, s.Samples);
+					double hb = entropy(cb, lb, NULL, 1, ca, s.Samples);
+					sorted[a] = (measure == JointEntropy) ? hab : (measure == ConditionalEntropy) ? hab - hb : ha + hb - hab;
+				}
+				status = PairwiseInformation(sorted + s.SignalsX * s.SignalsX, dx, dx, NULL, 0, (Information)measure);
+				report("PairwiseInformation", s, "self", status, maxerror(sorted + s.SignalsX * s.SignalsX, sorted, s.SignalsX * s.SignalsX), TOLERANCE);
+			}
+		}
+	}
+
+cleanup:
+	free(cx);
+	free(cy);
+	free(rx);
+	free(ry);
+	free(sorted);
+	free(ref);
+	free(out);
+	freeinputs(&in);
+}
+
+/// <summary>
+/// Reads one element of an array of any class as a double.
+/// </summary>
+static double element(const void* data, Precision class, size_t idx)
+{
+	switch (class)
+	{
+		case DoublePrecision:	return ((const double*)data)[idx];
+		case SinglePrecision:	return ((const float*)data)[idx];
+		case Int8Precision:		return ((const int8_t*)data)[idx];
+		case UInt8Precision:	return ((const uint8_t*)data)[idx];
+		case Int16Precision:	return ((const int16_t*)data)[idx];
+		case UInt16Precision:	return ((const uint16_t*)data)[idx];
+		case Int32Precision:	return ((const int32_t*)data)[idx];
+		default:				return ((const uint32_t*)data)[idx];
+	}
+}
+/// <summary>
+/// Checks FrameCorrelate against Pearson correlations between frames over the voxels that every frame has.
+/// </summary>
+/// <remarks>
+/// X holds doubles with NaNs & infinities at a few voxels, and Y is checked as every class. Frames are correlated with
+/// & without a mask, against themselves, and under a memory budget that splits voxels into many blocks.
+/// </remarks>
+static void checkframecorrelate(void)
+{
+	Shape s = sizes(3000, 5, 4);
+	const char* classes[] = { "double", "single", "int8", "uint8", "int16", "uint16", "int32", "uint32" };
+	size_t nvox = s.Samples;
+	size_t ny = nvox * s.SignalsY;
+
+	Inputs in;
+	if (!createinputs(&in, s)) { report("FrameCorrelate", s, "", OutOfMemory, NAN, 0); return; }
+	void* y = malloc(ny * sizeof(double));
+	uint8_t* mask = (uint8_t*)malloc(nvox);
+	double* a0 = (double*)malloc(nvox * sizeof(double));
+	double* b0 = (double*)malloc(nvox * sizeof(double));
+	double* ref = (double*)malloc((size_t)s.SignalsX * s.SignalsX * sizeof(double));
+	double* out = (double*)malloc((size_t)s.SignalsX * s.SignalsX * sizeof(double));
+	if (!y || !mask || !a0 || !b0 || !ref || !out) { report("FrameCorrelate", s, "", OutOfMemory, NAN, 0); goto cleanup; }
+
+	for (size_t a = 0; a < nvox; a++)
+		mask[a] = (a % 5 != 2);
+	in.X[7] = NAN;
+	in.X[nvox + 100] = INFINITY;
+	in.X[4 * nvox + 2999] = -INFINITY;
+
+	FrameArray x = { in.X, DoublePrecision, nvox, s.SignalsX };
+	char detail[32];
+	for (int c = DoublePrecision; c <= UInt32Precision; c++)
+	{
+		// Signals are scaled to fill most of the range of each integer class
+		double scale = (c == Int8Precision || c == UInt8Precision) ? 90 : (c <= SinglePrecision) ? 1 : 20000;
+		double offset = (c == UInt8Precision || c == UInt16Precision || c == UInt32Precision) ? scale : 0;
+		for (size_t a = 0; a < ny; a++)
+		{
+			double v = round(in.Y[a] * scale + offset);
+			switch (c)
+			{
+				case DoublePrecision:	((double*)y)[a] = in.Y[a];			break;
+				case SinglePrecision:	((float*)y)[a] = in.YF[a];			break;
+				case Int8Precision:		((int8_t*)y)[a] = (int8_t)v;		break;
+				case UInt8Precision:	((uint8_t*)y)[a] = (uint8_t)v;		break;
+				case Int16Precision:	((int16_t*)y)[a] = (int16_t)v;		break;
+				case UInt16Precision:	((uint16_t*)y)[a] = (uint16_t)v;	break;
+				case Int32Precision:	((int32_t*)y)[a] = (int32_t)v;		break;
+				default:				((uint32_t*)y)[a] = (uint32_t)v;	break;
+			}
+		}
+		FrameArray fy = { y, (Precision)c, nvox, s.SignalsY };
+
+		for (int masked = 0; masked < 2; masked++)
+		{
+			for (int b = 0; b < s.SignalsX * s.SignalsY; b++)
+			{
+				int tx = b % s.SignalsX, ty = b / s.SignalsX;
+				size_t n = 0;
+				for (size_t v = 0; v < nvox; v++)
+				{
+					int keep = !masked || mask[v];
+					for (int t = 0; t < s.SignalsX; t++)
+						keep &= isfinite(in.X[t * nvox + v]);
+					if (!keep) { continue; }
+					a0[n] = in.X[tx * nvox + v];
+					b0[n++] = element(y, (Precision)c, ty * nvox + v);
+				}
+				ref[b] = pearson(a0, b0, (int)n);
+			}
+
+			sprintf(detail, "%s%s", classes[c], masked ? " masked" : "");
+			ErrorCode status = FrameCorrelate(out, x, fy, masked ? mask : NULL);
+			report("FrameCorrelate", s, detail, status, maxerror(out, ref, (size_t)s.SignalsX * s.SignalsY), TOLERANCE);
+		}
+	}
+
+	// Correlating a series with itself, also with voxels split into the smallest blocks
+	for (int b = 0; b < s.SignalsX * s.SignalsX; b++)
+	{
+		int tx = b % s.SignalsX, ty = b / s.SignalsX;
+		size_t n = 0;
+		for (size_t v = 0; v < nvox; v++)
+		{
+			int keep = mask[v];
+			for (int t = 0; t < s.SignalsX; t++)
+				keep &= isfinite(in.X[t * nvox + v]);
+			if (!keep) { continue; }
+			a0[n] = in.X[tx * nvox + v];
+			b0[n++] = in.X[ty * nvox + v];
+		}
+		ref[b] = pearson(a0, b0, (int)n);
+	}
+
+	size_t budget = GetMemoryBudget();
+	for (int tiny = 0; tiny < 2; tiny++)
+	{
+		SetMemoryBudget(tiny ? 1 : budget);
+		ErrorCode status = FrameCorrelate(out, x, x, mask);
+		report("FrameCorrelate", sizes(s.Samples, s.SignalsX, s.SignalsX), tiny ? "self tiny" : "self", status,
+			maxerror(out, ref, (size_t)s.SignalsX * s.SignalsX), TOLERANCE);
+	}
+	SetMemoryBudget(budget);
+
+cleanup:
+	free(y);
+	free(mask);
+	free(a0);
+	free(b0);
+	free(ref);
+	free(out);
+	freeinputs(&in);
+}
+
+/// <summary>
+/// Checks Summarize against statistics & histograms found with two plain passes over each column.
+/// </summary>
+/// <remarks>
+/// Columns are long enough to be split into several chunks, and hold NaNs, a single value & nothing but NaNs. Histograms
+/// are counted both within fixed limits & across the range of each column.
+/// </remarks>
+static void checksummarize(void)
+{
+	Shape s = sizes(150000, 4, 0);
+	const int nbins = 7;
+	const double limits[2] = { -0.5, 1.0 };
+	size_t nx = (size_t)s.Samples * s.SignalsX;
+
+	Inputs in;
+	if (!createinputs(&in, s)) { report("Summarize", s, "", OutOfMemory, NAN, 0); return; }
+	void* x = malloc(nx * sizeof(double));
+	double* values = (double*)malloc(s.Samples * sizeof(double));
+	size_t* counts = (size_t*)malloc((size_t)nbins * s.SignalsX * sizeof(size_t));
+	size_t* refcounts = (size_t*)malloc((size_t)nbins * s.SignalsX * sizeof(size_t));
+	if (!x || !values || !counts || !refcounts) { report("Summarize", s, "", OutOfMemory, NAN, 0); goto cleanup; }
+
+	// The second column is sprinkled with NaNs, the third holds one value & the last has nothing else
+	for (int a = 0; a < s.Samples; a++)
+	{
+		in.X[s.Samples + a] = (a % 11 == 0) ? NAN : in.X[s.Samples + a];
+		in.X[2 * s.Samples + a] = (a == 70000) ? 0.375 : NAN;
+		in.X[3 * s.Samples + a] = NAN;
+	}
+
+	const char* classes[] = { "double", "single", "int16" };
+	const Precision precisions[] = { DoublePrecision, SinglePrecision, Int16Precision };
+	char detail[32];
+	for (int c = 0; c < 3; c++)
+	{
+		// Integers can't hold NaNs, so those columns are only checked in floating point
+		int ncols = (precisions[c] == Int16Precision) ? 1 : s.SignalsX;
+		double scale = (precisions[c] == Int16Precision) ? 10000 : 1;
+		for (size_t a = 0; a < (size_t)s.Samples * ncols; a++)
+		{
+			switch (precisions[c])
+			{
+				case DoublePrecision:	((double*)x)[a] = in.X[a];							break;
+				case SinglePrecision:	((float*)x)[a] = in.XF[a];							break;
+				default:				((int16_t*)x)[a] = (int16_t)round(in.X[a] * scale);	break;
+			}
+		}
+
+		for (int fixed = 0; fixed < 2; fixed++)
+		{
+			Summary out[4], ref[4];
+			for (int a = 0; a < ncols; a++)
+			{
+				Summary r = { INFINITY, -INFINITY, 0, 0, 0, NAN, NAN };
+				for (int b = 0; b < s.Samples; b++)
+				{
+					double v = element(x, precisions[c], (size_t)a * s.Samples + b);
+					values[b] = v;
+					if (isnan(v)) { r.NumNaNs++; continue; }
+					r.Count++;
+					r.Sum += v;
+					r.Min = fmin(r.Min, v);
+					r.Max = fmax(r.Max, v);
+				}
+				r.Min = r.Count ? r.Min : NAN;
+				r.Max = r.Count ? r.Max : NAN;
+				r.Mean = r.Count ? r.Sum / r.Count : NAN;
+
+				double m2 = 0;
+				for (int b = 0; b < s.Samples; b++)
+					if (!isnan(values[b])) { m2 += (values[b] - r.Mean) * (values[b] - r.Mean); }
+				r.Variance = (r.Count > 1) ? m2 / (r.Count - 1) : (r.Count == 1) ? 0 : NAN;
+				ref[a] = r;
+
+				// The last bin includes its upper edge
+				double lo = fixed ? limits[0] * scale : r.Min, hi = fixed ? limits[1] * scale : r.Max;
+				size_t* rc = refcounts + (size_t)a * nbins;
+				memset(rc, 0, nbins * sizeof(size_t));
+				for (int b = 0; b < s.Samples; b++)
+				{
+					if (!(values[b] >= lo && values[b] <= hi)) { continue; }
+					int bin = (hi > lo) ? (int)((values[b] - lo) * (nbins / (hi - lo))) : 0;
+					rc[(bin >= nbins) ? nbins - 1 : bin]++;
+				}
+			}
+
+			FrameArray fx = { x, precisions[c], (size_t)s.Samples, ncols };
+			double scaled[2] = { limits[0] * scale, limits[1] * scale };
+			ErrorCode status = Summarize(out, fx, counts, nbins, fixed ? scaled : NULL);
+
+			// Statistics are compared relative to their size, and counts & histograms exactly
+			double error = 0;
+			for (int a = 0; status == Success && a < ncols; a++)
+			{
+				double o[] = { out[a].Min, out[a].Max, out[a].Mean, out[a].Variance, out[a].Sum };
+				double r[] = { ref[a].Min, ref[a].Max, ref[a].Mean, ref[a].Variance, ref[a].Sum };
+				for (int b = 0; b < 5; b++)
+				{
+					o[b] /= fmax(1, fabs(r[b]));
+					r[b] /= fmax(1, fabs(r[b]));
+				}
+				error = fmax(error, maxerror(o, r, 5));
+				if (out[a].Count != ref[a].Count || out[a].NumNaNs != ref[a].NumNaNs) { error = INFINITY; }
+			}
+			if (memcmp(counts, refcounts, (size_t)nbins * ncols * sizeof(size_t))) { error = INFINITY; }
+
+			sprintf(detail, "%s %s", classes[c], fixed ? "limits" : "range");
+			report("Summarize", sizes(s.Samples, ncols, 0), detail, status, error, TOLERANCE);
+		}
+	}
+
+cleanup:
+	free(x);
+	free(values);
+	free(counts);
+	free(refcounts);
+	freeinputs(&in);
+}
+
+
+/// <summary>
+/// Checks Accumulate & AccumulatorMoments against NaN-aware means, variances & t statistics found with two passes.
+/// </summary>
+/// <remarks>
+/// Every column of X is ingested as one array of elements, which spans several chunks. Elements are sprinkled with NaNs,
+/// and some are NaN in all but one array or in every array. A large offset checks that the running sums stay stable.
+/// Moments are found once into separate outputs & once into the accumulator's own fields.
+/// </remarks>
+static void checkaccumulate(void)
+{
+	Shape s = sizes(40000, 30, 0);
+	size_t n = (size_t)s.Samples;
+
+	Inputs in;
+	if (!createinputs(&in, s)) { report("Accumulate", s, "", OutOfMemory, NAN, 0); return; }
+	double* fields = (double*)calloc(3 * n, sizeof(double));
+	double* out = (double*)malloc(3 * n * sizeof(double));
+	double* ref = (double*)malloc(3 * n * sizeof(double));
+	if (!fields || !out || !ref) { report("Accumulate", s, "", OutOfMemory, NAN, 0); goto cleanup; }
+
+	for (int a = 0; a < s.SignalsX; a++)
+	{
+		for (size_t b = 0; b < n; b++)
+		{
+			double* v = in.X + (size_t)a * n + b;
+			*v += 1000;
+			if ((b * 7 + a) % 13 == 0 || b % 97 == 0 || (b % 89 == 0 && a > 0)) { *v = NAN; }
+		}
+	}
+
+	for (size_t b = 0; b < n; b++)
+	{
+		double count = 0, sum = 0, m2 = 0;
+		for (int a = 0; a < s.SignalsX; a++)
+		{
+			double v = in.X[(size_t)a * n + b];
+			if (!isnan(v)) { count++; sum += v; }
+		}
+		double mean = count ? sum / count : NAN;
+		for (int a = 0; a < s.SignalsX; a++)
+		{
+			double v = in.X[(size_t)a * n + b];
+			if (!isnan(v)) { m2 += (v - mean) * (v - mean); }
+		}
+		double variance = (count > 1) ? m2 / (count - 1) : (count == 1) ? 0 : NAN;
+		ref[b] = mean;
+		ref[n + b] = variance;
+		ref[2 * n + b] = (count > 1) ? mean / sqrt(variance / count) : NAN;
+	}
+
+	Accumulator acc = { fields, fields + n, fields + 2 * n, n };
+	ErrorCode status = Success;
+	for (int a = 0; status == Success && a < s.SignalsX; a++)
+		status = Accumulate(&acc, in.X + (size_t)a * n);
+
+	// Statistics are compared relative to their size
+	for (int alias = 0; alias < 2; alias++)
+	{
+		double* o = alias ? fields : out;
+		if (status == Success)
+			status = AccumulatorMoments(o, o + n, o + 2 * n, &acc);
+
+		double error = 0;
+		for (size_t b = 0; status == Success && b < 3 * n; b++)
+		{
+			double scale = fmax(1, fabs(ref[b]));
+			double ob = o[b] / scale, rb = ref[b] / scale;
+			error = fmax(error, maxerror(&ob, &rb, 1));
+		}
+		report("AccumulatorMoments", s, alias ? "aliased" : "", status, error, TOLERANCE);
+	}
+
+cleanup:
+	free(fields);
+	free(out);
+	free(ref);
+	freeinputs(&in);
+}
+
+/// <summary>
+/// Checks CreateCorrelator & CorrelatorApply against Pearson correlations & cross-correlations computed one pair at a time.
+/// </summary>
+/// <remarks>
+/// Correlators are created without lags, with few lags (which keep a copy of X) and with every lag (which keep spectra).
+/// Each one is applied both plainly & with an epilogue that transforms, thresholds and scatters signals into the rows of a
+/// larger output, where correlators without lags count as having the single lag zero.
+/// </remarks>
+static void checkcorrelator(void)
+{
+	Shape s = sizes(200, 6, 4);
+	const size_t map[] = { 1, 0, 4, 6, 7, 9 };
+	const size_t nrows = 10;
+	int capacity = 2 * s.Samples + 4;
+	size_t npairs = (size_t)s.SignalsX * s.SignalsY;
+	size_t nout = (size_t)capacity * nrows * s.SignalsY;
+
+	Inputs in;
+	if (!createinputs(&in, s)) { report("Correlator", s, "", OutOfMemory, NAN, 0); return; }
+	int* lags = (int*)malloc(capacity * sizeof(int));
+	double* cc = (double*)malloc(npairs * capacity * sizeof(double));
+	double* ref = (double*)malloc(nout * sizeof(double));
+	double* out = (double*)malloc(nout * sizeof(double));
+	if (!lags || !cc || !ref || !out) { report("Correlator", s, "", OutOfMemory, NAN, 0); goto cleanup; }
+
+	Epilogue e = { 4, ZeroInsignificant, { -0.05, 0.05 }, map, nrows, NAN };
+	SignalArray x = signals(in.X, s.Samples, s.SignalsX);
+	SignalArray y = signals(in.Y, s.Samples, s.SignalsY);
+	char detail[32];
+	for (int set = -1; set < 2; set++)
+	{
+		const char* name = (set < 0) ? "no lags" : "all lags";
+		int nlags = (set < 0) ? 1 : 2 * s.Samples - 1;
+		if (set == 0)
+			nlags = lagset(lags, set, s.Samples, &name);
+		else if (set > 0)
+		{
+			for (int a = 0; a < nlags; a++)
+				lags[a] = a - (s.Samples - 1);
+		}
+
+		for (size_t a = 0; a < npairs; a++)
+		{
+			const double* xa = in.X + (a % s.SignalsX) * s.Samples;
+			const double* ya = in.Y + (a / s.SignalsX) * s.Samples;
+			for (int b = 0; b < nlags; b++)
+				cc[a * nlags + b] = (set < 0) ? pearson(xa, ya, s.Samples) : crosslag(xa, ya, s.Samples, lags[b]);
+		}
+
+		Correlator c;
+		ErrorCode status = CreateCorrelator(&c, x, (set < 0) ? NULL : lags, nlags);
+		if (status != Success) { report("CreateCorrelator", s, name, status, NAN, 0); continue; }
+
+		status = CorrelatorApply(out, &c, y, NULL);
+		report("CorrelatorApply", s, name, status, maxerror(out, cc, npairs * nlags), TOLERANCE);
+
+		size_t n = nrows * nlags * s.SignalsY;
+		for (size_t a = 0; a < n; a++)
+			ref[a] = e.Fill;
+		for (size_t a = 0; a < npairs; a++)
+		{
+			int idxX = (int)(a % s.SignalsX), idxY = (int)(a / s.SignalsX);
+			for (int b = 0; b < nlags; b++)
+				ref[((size_t)idxY * nlags + b) * nrows + map[idxX]] = epiloguevalue(&e, cc[a * nlags + b]);
+		}
+
+		status = CorrelatorApply(out, &c, y, &e);
+		sprintf(detail, "mapped L=%d", nlags);
+		report("CorrelatorApply", s, detail, status, maxerror(out, ref, n), TOLERANCE);
+		FreeCorrelator(&c);
+	}
+
+cleanup:
+	free(lags);
+	free(cc);
+	free(ref);
+	free(out);
+	freeinputs(&in);
+}
+
+
+/* MAIN */
+int main(void)
+{
+	// Every check runs serially and then in parallel
+	int threads[] = { 1, PARALLELTHREADS };
+	for (int t = 0; t < 2; t++)
+	{
+		SetThreads(threads[t]);
+		printf("Threads: %d\n", GetThreads());
+
+		for (int a = 0; a < NumShapes; a++)
+		{
+			Inputs in;
+			if (!createinputs(&in, Shapes[a]))
+			{
+				report("Inputs", Shapes[a], "", OutOfMemory, NAN, 0);
+				continue;
+			}
+
+			checkcorrelate(&in);
+			checkcrosscorrelate(&in);
+			checkwindowcorrelate(&in);
+			freeinputs(&in);
+		}
+
+		checkbudget();
+		checkempiricalcdf();
+		checkcorrelatemapped();
+		checknullcorrelate();
+		checkcomparisons();
+		checkempiricalcdfraw();
+		checkpartialcorrelate();
+		checkepilogue();
+		checkspectral();
+		checkfilter();
+		checkinformation();
+		checkframecorrelate();
+		checksummarize();
+		checkaccumulate();
+		checkcorrelator();
+	}
+
+	ReleaseWorkspace();
+	printf(failures ? "%d checks failed.\n" : "All checks passed.\n", failures);
+	return failures ? 1 : 0;
+}
@@ -41,10 +41,15 @@
 %                       to vary but must be a positive integer. The number of samples M must always equal M from X.
 %                       DEFAULT: X
 %
-%       maxlag:         INTEGER
+%       maxlag:         INTEGER or [ MC x 1 INTEGERS ]
 %                       The maximum number of sample shifts to use when calculating the cross-correlation. The output lags
 %                       will then be the vector -MAXLAG : MAXLAG. The default value of this argument is the maximum possible
 %                       sample shift, which is derived from the number of samples in X and Y.
+%
+%                       Alternatively, a vector of specific sample shifts may be provided here, in which case only those
+%                       lags are calculated and the output LAGS will be equal to this vector. Either way, only the lags that
+%                       are requested are ever computed, which saves a great deal of time and memory when the signals are
+%                       long but only a few lags are needed. An empty array selects the default.
 %                       DEFAULT: M - 1
 %
 %	See also: CORR2, CORR3, CORRCOEF, XCORR, XCORRARR
@@ -59,6 +64,10 @@
 %					Updated the documentation of this function to reflect this change and to improve clarity.
 %		20150527:	Re-implemented the C subroutine behind the cross-correlation calculations in native MATLAB code so that
 %					this function can still be used even when the MEX files I've written cannot.
+%		20261017:	Passed the requested lags through to the MEX function so that unwanted lags are never computed or stored.
+%					Also implemented the ability to request an arbitrary list of lags instead of a maximum lag.
+%		20261017:	Single precision data are now passed to the MEX function as-is instead of needing to be converted.
+%		20261017:	An empty MAXLAG now selects the default maximum lag instead of returning every lag alongside empty LAGS.
 
 
 
@@ -71,7 +80,7 @@ function [cc, lags] = ccorr(x, y, maxlag)
     
     % Fill in any missing inputs & error check Y
     if nargin < 2;	y = x;                      end
-    if nargin < 3;  maxlag = size(x, 1) - 1;    end
+    if nargin < 3;  maxlag = [];                end
     if isempty(y);	y = x;                      end
     assert(ismatrix(y), 'Y must be a vector or a two-dimensional array.');
     
@@ -80,28 +89,30 @@ function [cc, lags] = ccorr(x, y, maxlag)
     if isvector(y); y = y(:); end
     szx = size(x);
     szy = size(y);
+    if isempty(maxlag); maxlag = szx(1) - 1; end
     
     % Constrain the size of X & Y
     assert(szx(1) == szy(1), 'X and Y must always contain the same number of samples.');
     
+    % Determine which shifts are needed
+    if isscalar(maxlag); lags = -maxlag : maxlag;
+    else lags = maxlag(:)';
+    end
+    assert(all(lags == round(lags)) && all(abs(lags) < szx(1)),...
+        'Lags must be integers whose magnitudes are smaller than the number of samples in X and Y.');
+    
+    % The MEX function handles single precision data natively, but X and Y have to be of the same class
+    if (isa(x, 'single') || isa(y, 'single')); x = single(x); y = single(y); end
+
 	if (exist('MexCrossCorrelate', 'file') == 3)	
-		% Let the MEX function do the heavy lifting to calculate cross-correlation
-		if (szx(2) == 1 && szy(2) ~= 1)
-			cc = flip(MexCrossCorrelate(y, x));
-		else
-			cc = MexCrossCorrelate(x, y);
-		end
+		% Let the MEX function do the heavy lifting to calculate cross-correlation only at the requested lags
+		cc = MexCrossCorrelate(x, y, lags);
 	else
-		% Use native MATLAB code if the MEX function can't be used
+		% Use native MATLAB code if the MEX function can't be used & then remove unwanted shifts
 		cc = CrossCorrelate(x, y);
+		cc = cc(lags + szx(1), :);
 	end
 	
-    % Remove unwanted shifts
-    allLags = -(szx(1) - 1) : (szx(1) - 1);
-    lags = -maxlag : maxlag;
-    idsLagsToKeep = ismember(allLags, lags);
-    cc = cc(idsLagsToKeep, :);
-    
 	% Rearrange the output to a more intuitive format
 	cc = reshape(cc, size(cc, 1), szx(2), szy(2));
 	lags = lags';
@@ -4,35 +4,82 @@
 %   from those by accepting volumetric arrays. If one- or two-dimensional arrays are to be used, those builtin functions must
 %   be used instead. Attempting to input them to this function will result in errors.
 %
+%   Four-dimensional arrays are treated as series of volumes indexed by their fourth dimension, in which case every volume
+%   of the first series is correlated with every volume of the second. A single 4-D array produces the spatial similarity
+%   matrix between all of its own volumes.
+%
 %   SYNTAX:
+%   r = corr3(a)
 %   r = corr3(a, b)
+%   r = corr3(a, b, mask)
 %
 %   OUTPUT:
-%   r:      DOUBLE
-%           The Pearson product-moment correlation coefficient between the two inputted volumetric arrays.
+%   r:      DOUBLE or [ TA x TB DOUBLES ]
+%           The Pearson product-moment correlation coefficient between the two inputted volumetric arrays. For series of
+%           volumes, this is the coefficient between every volume of A (rows) & every volume of B (columns).
 %
 %   INPUTS:
-%   a:      [ 3D DOUBLE ]
-%           A volumetric (three-dimensional) array of double-precision numbers. This array can be any size over each of
-%           its dimensions.
+%   a:      [ 3D NUMERICS ] or [ 4D NUMERICS ]
+%           A volumetric (three-dimensional) array of real numbers, or a series of TA such volumes. This array can be any
+%           size over each of its dimensions and may be of any numeric class (e.g. INT16 or SINGLE).
+%
+%   OPTIONAL INPUTS:
+%   b:      [ 3D NUMERICS ] or [ 4D NUMERICS ]
+%           A second volumetric array or series of TB volumes. Its volumes must be exactly the same size as the volumes of
+%           A. Omitting this (or using []) correlates the volumes of A with each other.
 %
-%   b:      [ 3D DOUBLE ]
-%           A second volumetric array of double-precision numbers. This array must be exactly the same size as the other
-%           inputted 3D array.
+%   mask:   [ 3D LOGICALS ]
+%           The voxels to include in every coefficient, such as a brain mask. Voxels that are NaN or infinite in any volume
+%           of A or B are always left out.
+%           DEFAULT: [] (every voxel)
 %
-% See also CORR, CORR2, CORRCOEF
+% See also CORR, CORR2, CORRCOEF, MEXFRAMECORRELATE
 
 %% CHANGELOG
 %   Written by Josh Grooms on 20141001
+%       20261017:   Added support for 4-D series of volumes, self-similarity matrices and masking. Volumes are now
+%                   correlated by MEXFRAMECORRELATE when it is available, which reads inputs of any class in place instead
+%                   of converting them to double and making three full temporary products for every pair of volumes.
 
 
 
 %% FUNCTION DEFINITION
-function r = corr3(a, b)
+function r = corr3(a, b, mask)
 	
+	% Fill in missing inputs
+	if (nargin == 1 || isempty(b)); b = a; end
+	if (nargin < 3); mask = []; end
+
 	% Check for dimensionality mismatches
-	if (ndims(a) ~= 3 || ndims(b) ~= 3); error('Inputted arrays must be 3-dimensional only.'); end
-	if (any(size(a) ~= size(b))); error('Inputted volume arrays must be identical in size'); end
+	if (~any(ndims(a) == [3 4]) || ~any(ndims(b) == [3 4])); error('Inputted arrays must be 3- or 4-dimensional only.'); end
+	if (any(size(a(:, :, :, 1)) ~= size(b(:, :, :, 1)))); error('Inputted volume arrays must be identical in size'); end
+
+	if (exist('MexFrameCorrelate', 'file') == 3)
+		r = MexFrameCorrelate(a, b, mask);
+		return;
+	end
+
+	% Leave out masked voxels & any voxels that are NaN in some volume
+	szVolume = size(a(:, :, :, 1));
+	a = reshape(a, prod(szVolume), []);
+	b = reshape(b, prod(szVolume), []);
+	if (isempty(mask)); mask = true(prod(szVolume), 1); end
+	mask = mask(:) & all(isfinite(a), 2) & all(isfinite(b), 2);
+
+	r = zeros(size(a, 2), size(b, 2));
+	for c = 1:size(a, 2)
+		for d = 1:size(b, 2)
+			r(c, d) = volumecorr(a(mask, c), b(mask, d));
+		end
+	end
+	
+end
+
+
+
+%% NESTED FUNCTIONS
+function r = volumecorr(a, b)
+% VOLUMECORR - Calculates the Pearson correlation coefficient between the voxels of two volumes.
 
 	% Ensure that everything is double-precision
 	a = double(a);
@@ -50,4 +97,4 @@ function r = corr3(a, b)
 	% Compute the 3D Pearson correlation coefficient
 	r = sum(ab(:)) / sqrt(sum(a2(:)) * sum(b2(:)));
 	
-end
\ No newline at end of file
+end
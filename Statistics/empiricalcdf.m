@@ -35,6 +35,8 @@
 %		20150225:	Implemented CDF generation for one-tailed hypothesis testing.
 %		20150527:	Re-implemented the C subroutine behind empirical CDF calculations in native MATLAB code so that this
 %					function can still be used even when the MEX files I've written cannot.
+%		20261017:	The MEX function now removes null values, sorts the null distribution and reshapes p-values natively, so
+%					none of that is done here unless the MEX function is unavailable.
 
 
 
@@ -49,6 +51,12 @@ function p = empiricalcdf(r, n, t)
 	assert(isnumeric(n), 'The null data distribution n must be an array of single- or double-precision values.');
 	assert(ischar(t), 'The tail selection argument t must be a string.');
 
+	if (exist('MexEmpiricalCDF', 'file') == 3)
+		% Call the MEX function to do the heavy lifting, including all of the clean up & sorting below
+		p = MexEmpiricalCDF(double(r), double(n), Tail2Num(t));
+		return;
+	end
+
 	% Flatten the data distributions
 	szr = size(r);
 	r = r(:);
@@ -60,13 +68,8 @@ function p = empiricalcdf(r, n, t)
 	n(isnan(n) | n == 0) = [];
 	n = sort(n);
 
-	if (exist('MexEmpiricalCDF', 'file') == 3)
-		% Call the MEX function to do the heavy lifting
-		fp = MexEmpiricalCDF(r, n, Tail2Num(t));
-	else
-		% Use native MATLAB code if the MEX function can't be used
-		fp = ComputeCDF(r, n, t);
-	end
+	% Use native MATLAB code if the MEX function can't be used
+	fp = ComputeCDF(r, n, t);
 
 	% Reshape the p-values to match the inputted real data
 	p = nan(length(idsRemoved), 1);
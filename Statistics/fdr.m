@@ -19,12 +19,20 @@
 
 %% CHANGELOG
 %   Written by Josh Grooms on 20141106
+%		20261017:	Moved the cutoff calculation into the native statistics library (see MEXFDR), which only sorts the
+%					p-values that are at or below alpha. The original code below is kept for when the MEX function is
+%					unavailable.
 
 
 
 %% FUNCTION DEFINITION
 function cutoff = fdr(p, alpha)
 	
+	if (exist('MexFDR', 'file') == 3 && ~isempty(p))
+		cutoff = MexFDR(double(p), alpha);
+		return;
+	end
+
 	% Sort the p-values into ascending order
 	p = sort(p(:));
 
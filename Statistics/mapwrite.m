@@ -0,0 +1,77 @@
+% MAPWRITE - Writes a two-dimensional array to a mapped array file.
+%
+%   This function writes a matrix to a file in the format that the native statistics library maps directly into memory
+%   (see MEXCORRELATEMAPPED). Files are written one block of columns at a time and may be extended with further columns by
+%   later calls, so arrays that are larger than the available memory (e.g. BOLD data from many scans) can be assembled
+%   piece by piece. The data can also be read back in MATLAB without loading the whole file:
+%
+%       m = memmapfile(file, 'Offset', 64, 'Format', {'double', [M, N], 'x'});
+%
+%   Mapped array files start with a 64-byte header that holds the characters 'STATMAT' followed by a null character, a
+%   32-bit format version, a 32-bit precision code (0 for double, 1 for single), and the 64-bit number of rows and columns,
+%   all in native byte order. The array elements follow in column-major order.
+%
+%   SYNTAX:
+%       mapwrite(file, x)
+%       mapwrite(file, x, 'append')
+%
+%   INPUT:
+%       file:       STRING
+%                   The path to the mapped array file that will be written.
+%
+%       x:          [ M x N DOUBLES or SINGLES ]
+%                   The array to write. For signal data, each column should hold one signal with M time points (e.g. the
+%                   transpose of BOLDOBJ.TOMATRIX).
+%
+%   OPTIONAL INPUT:
+%       'append':   Add the columns of X to the end of an existing file instead of overwriting it. The number of rows and
+%                   the class of X must match what is already stored in the file.
+%
+%   See also: MEMMAPFILE, MEXCORRELATEMAPPED
+
+%% CHANGELOG
+%   Written by Josh Grooms on 20261017
+
+
+
+%% FUNCTION DEFINITION
+function mapwrite(file, x, mode)
+
+    assert(ismatrix(x) && (isa(x, 'double') || isa(x, 'single')) && isreal(x), ...
+        'Only real, two-dimensional arrays of singles or doubles can be written to mapped array files.');
+
+    append = nargin == 3 && strcmpi(mode, 'append') && exist(file, 'file');
+    precision = double(isa(x, 'single'));
+
+    if (append)
+        fid = fopen(file, 'r+');
+        assert(fid ~= -1, 'The file %s could not be opened.', file);
+        magic = fread(fid, 8, '*uint8')';
+        header = fread(fid, 2, 'uint32');
+        dims = fread(fid, 2, 'uint64');
+        if (~isequal(magic, [uint8('STATMAT'), 0]) || header(1) ~= 1)
+            fclose(fid);
+            error('%s is not a valid mapped array file.', file);
+        end
+        if (header(2) ~= precision || dims(1) ~= size(x, 1))
+            fclose(fid);
+            error('The array being appended must have the same class and number of rows as the array in %s.', file);
+        end
+        ncols = dims(2) + size(x, 2);
+    else
+        fid = fopen(file, 'w');
+        assert(fid ~= -1, 'The file %s could not be created.', file);
+        fwrite(fid, [uint8('STATMAT'), 0], 'uint8');
+        fwrite(fid, [1, precision], 'uint32');
+        ncols = size(x, 2);
+    end
+
+    % Update the dimensions, then write the new columns at the end of the file
+    fseek(fid, 16, 'bof');
+    fwrite(fid, [size(x, 1), ncols], 'uint64');
+    fwrite(fid, zeros(1, 32, 'uint8'), 'uint8');
+    fseek(fid, 0, 'eof');
+    fwrite(fid, x, class(x));
+    fclose(fid);
+
+end
@@ -0,0 +1,139 @@
+% NULLCORR - Builds a null distribution of correlation coefficients from surrogate signals.
+%
+%	NULLCORR estimates what correlations between two sets of signals would look like if they were unrelated, while keeping
+%	the temporal structure (e.g. autocorrelation or power spectra) of the signals intact. It does this by correlating
+%	randomly transformed surrogates of the signals in X with the signals in Y. Each surrogate data set applies the same
+%	random transformation to every signal in X, so relationships between signals within X are preserved. The result is
+%	already sorted and stripped of NaNs and zeros, so it can be passed directly to EMPIRICALCDF.
+%
+%	SYNTAX:
+%		n = nullcorr(x, y, nsurrogates)
+%		n = nullcorr(x, y, nsurrogates, method)
+%		n = nullcorr(x, y, nsurrogates, method, seed)
+%		n = nullcorr(x, y, nsurrogates, method, seed, blocksize)
+%
+%	OUTPUT:
+%		n:				[ L x 1 DOUBLES ]
+%						The null distribution of correlation coefficients, sorted into ascending order. Its length L is at
+%						most NSURROGATES * NX * NY.
+%
+%	INPUTS:
+%		x:				[ M x NX DOUBLES ]
+%						An array of signals from which surrogates are generated. Each column of this array represents a
+%						single signal with M time points.
+%
+%		y:				[ M x NY DOUBLES ]
+%						An array of signals that the surrogates are correlated with. The number of time points M must always
+%						equal M from X.
+%
+%		nsurrogates:	INTEGER
+%						The number of surrogate data sets to generate.
+%
+%	OPTIONAL INPUTS:
+%		method:			STRING
+%						The method used to generate surrogate signals.
+%						DEFAULT: 'Shift'
+%						OPTIONS:
+%							'Shift'	- Circularly shifts signals by a random number of samples.
+%							'Phase'	- Randomizes the phase of every frequency component, preserving power spectra.
+%							'Block'	- Shuffles the order of blocks of BLOCKSIZE samples.
+%
+%		seed:			INTEGER
+%						The seed for the random number generators. The same seed always produces the same distribution.
+%						DEFAULT: 0
+%
+%		blocksize:		INTEGER
+%						The number of samples in each block when using block permutation.
+%						DEFAULT: round(sqrt(M))
+%
+%	See also: EMPIRICALCDF, MEXNULLCORRELATE
+
+%% CHANGELOG
+%	Written by Josh Grooms on 20261017
+
+
+
+%% FUNCTION DEFINITION
+function n = nullcorr(x, y, nsurrogates, method, seed, blocksize)
+
+	% Fill in missing inputs
+	if (nargin < 4);	method = 'Shift';	end
+	if (nargin < 5);	seed = 0;			end
+
+	if isvector(x); x = x(:); end
+	if isvector(y); y = y(:); end
+	assert(size(x, 1) == size(y, 1), 'X and Y must always contain the same number of time points.');
+	assert(size(x, 1) > 1, 'Signals must contain at least two time points.');
+	assert(nsurrogates >= 1 && nsurrogates == round(nsurrogates), 'The number of surrogates must be a positive integer.');
+
+	if (nargin < 6); blocksize = round(sqrt(size(x, 1))); end
+	assert(blocksize >= 1 && blocksize < size(x, 1), 'The block size must be an integer in the range [1, M - 1].');
+
+	if (exist('MexNullCorrelate', 'file') == 3)
+		% Let the MEX function do the heavy lifting
+		n = MexNullCorrelate(double(x), double(y), Method2Num(method), nsurrogates, seed, blocksize);
+	else
+		% Use native MATLAB code if the MEX function can't be used
+		n = NullCorrelate(double(x), double(y), Method2Num(method), nsurrogates, seed, blocksize);
+	end
+
+end
+
+
+
+%% SUBROUTINES
+function n = Method2Num(method)
+% METHOD2NUM - Converts a surrogate method string into the enumerator that the C subroutine uses.
+	switch lower(method)
+		case 'shift';	n = 0;
+		case 'phase';	n = 1;
+		case 'block';	n = 2;
+		otherwise
+			error('Unrecognized surrogate method %s. See documentation for available options.', method);
+	end
+end
+function n = NullCorrelate(x, y, method, nsurrogates, seed, blocksize)
+% NULLCORRELATE - Builds a null distribution using MATLAB language functions.
+%
+%	This subroutine is used whenever the compiled MEX routine is unavailable. It uses MATLAB's own random number generator,
+%	so its output will not match the MEX function's for the same seed.
+
+	rng(seed);
+	[m, nx] = size(x);
+	ny = size(y, 2);
+
+	zy = bsxfun(@minus, y, mean(y, 1));
+	zy = bsxfun(@rdivide, zy, sqrt(sum(zy.^2, 1)));
+	if (method == 1); F = fft(bsxfun(@minus, x, mean(x, 1))); end
+
+	n = zeros(nx * ny, nsurrogates);
+	for a = 1:nsurrogates
+		switch method
+			case 0
+				xs = circshift(x, -randi(m - 1));
+			case 1
+				% Rotate positive frequencies and mirror them so that the surrogates stay real
+				nh = floor((m - 1) / 2);
+				phi = exp(2i * pi * rand(nh, 1));
+				P = ones(m, 1);
+				P(2:nh + 1) = phi;
+				P(end:-1:end - nh + 1) = conj(phi);
+				xs = real(ifft(bsxfun(@times, F, P)));
+			case 2
+				nblocks = ceil(m / blocksize);
+				idsBlock = ceil((1:m)' / blocksize);
+				order = randperm(nblocks);
+				idsSample = cell2mat(arrayfun(@(b) find(idsBlock == b), order', 'UniformOutput', false));
+				xs = x(idsSample, :);
+		end
+
+		zx = bsxfun(@minus, xs, mean(xs, 1));
+		zx = bsxfun(@rdivide, zx, sqrt(sum(zx.^2, 1)));
+		n(:, a) = reshape(zx' * zy, [], 1);
+	end
+
+	n = n(:);
+	n(isnan(n) | n == 0) = [];
+	n = sort(n);
+
+end
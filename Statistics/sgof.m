@@ -27,6 +27,9 @@ function cutoff = sgof(p, alpha)
 %   Written by Josh Grooms on 20130627
 %       20140127:   Implemented a much faster version of binocdf by increasing memory limits within that function.
 %       20141021:   Updated the documentation for this function.
+%		20261017:	Moved the FWER correction into the native statistics library (see MEXSGOF), which finds the binomial
+%					tail with a recurrence and the cutoff by selection instead of sorting. The original code below is
+%					kept for when the MEX function is unavailable.
 
 
 
@@ -35,6 +38,11 @@ if nargin == 1
     alpha = 0.05;
 end
 
+if (exist('MexSGoF', 'file') == 3 && ~isempty(p))
+    cutoff = MexSGoF(double(p), alpha);
+    return;
+end
+
 % Sort the CDF values
 p = sort(p(:));
 
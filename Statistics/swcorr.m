@@ -63,6 +63,7 @@
 %	Written by Josh Grooms on 20150204
 %		20150511:	Re-implemented the C subroutine behind the actual SWC calculations in native MATLAB code so that this
 %					function can still be used even when the MEX files I've written cannot.
+%		20261017:	Single precision data are now passed to the MEX function as-is instead of needing to be converted.
 
 
 
@@ -105,6 +106,9 @@ function swc = swcorr(x, y, window, noverlap, offset)
 		end
 	end
 	
+	% The MEX function handles single precision data natively, but X and Y have to be of the same class
+	if (isa(x, 'single') || isa(y, 'single')); x = single(x); y = single(y); end
+
 	if (exist('MexWindowCorrelate', 'file') == 3)
 		% Let the MEX function do the heavy lifting & then rearrange the output to the final format
 		swc = MexWindowCorrelate(x, y, window, noverlap);
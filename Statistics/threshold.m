@@ -56,6 +56,11 @@
 %% CHANGELOG
 %   Written by Josh Grooms on 20150206
 %		20150528:	Implemented FDR as a method of controlling family-wise error rate. Also filled out more documentation.
+%		20261017:	Moved thresholding into the native statistics library (see MEXTHRESHOLD), which selects the null
+%					quantiles it needs instead of sorting the whole null distribution. Its 'Bino' option counts the same
+%					excess of significant results that SGOF does. The original code below is kept for when the MEX
+%					function is unavailable.
+%		20261017:	The original 'Bino' code now removes the same excess that SGOF and MEXTHRESHOLD do.
 
 
 
@@ -74,6 +79,15 @@ function varargout = threshold(r, n, varargin)
 	
     r = FormatDist(r);
     n = FormatDist(n);
+
+	if (exist('MexThreshold', 'file') == 3 && ~isempty(r) && ~isempty(n))
+		if (CorrectFWER); correction = Method2Num(MethodFWER); else correction = 0; end
+		[cutoffs, p] = MexThreshold(double(r), double(n), Tail2Num(Tails), Alpha, correction);
+		varargout = { };
+		assign(varargout, nargout, cutoffs, p);
+		return;
+	end
+
     n = sort(n);
     
     ntrials = length(r);
@@ -203,6 +217,10 @@ function n = BinoTest(ntrials, nsig, alpha)
 %	of trials. However, because no closed-form inverse CDF formula exists for it, applying this test is extremely slow when
 %	the number of trials is large. When correcting FWER for more than ~100 trials, the G-test is recommended instead.
 %
+%	The excess removed is the largest number of significant results k that the binomial distribution still considers
+%	likely by chance (P(X > k) > alpha), just as in SGOF. When there is no such k, N is empty and the uncorrected cutoffs
+%	are kept.
+%
 %	OUTPUT:
 %		n:			INTEGER
 %					The estimated number of significant results after FWER correction is applied.
@@ -218,7 +236,7 @@ function n = BinoTest(ntrials, nsig, alpha)
 %		alpha:		DOUBLE
 %					The desired family-wise error rate (FWER).
 
-    p = binocdf(1:nsig, ntrials, alpha);
+    p = 1 - binocdf(1:nsig, ntrials, alpha);
     nremove = find(p > alpha, 1, 'last');
     n = nsig - nremove;
 end
@@ -262,4 +280,24 @@ function n = GTest(ntrials, nsig, alpha)
     gcutoff = chi2inv(1 - alpha, 1);
     nremove = find(g < gcutoff, 1, 'last');
     n = nsig - nremove;
-end
\ No newline at end of file
+end
+function n = Method2Num(method)
+% METHOD2NUM - Converts a FWER correction method string into the enumerator that the C subroutine uses.
+	switch lower(method)
+		case 'bino';	n = 1;
+		case 'fdr';		n = 2;
+		case 'g';		n = 3;
+		otherwise
+			error('Unrecognized FWER correction method name. See documentation for supported options.');
+	end
+end
+function n = Tail2Num(tails)
+% TAIL2NUM - Converts a distribution tail string into the enumerator that the C subroutine uses.
+	switch lower(tails)
+		case 'both';	n = 0;
+		case 'left';	n = 1;
+		case 'right';	n = 2;
+		otherwise
+			error('Unrecognized distribution tail selection %s. See documentation for available options.', tails);
+	end
+end